@@ -0,0 +1,166 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+#include "ogs.hpp"
+
+// usage: mpirun -np 4 ./ogsBenchmarkBlocked CUDA 16 16 16 7 100
+//  runs:
+// - on an OCCA CUDA device (Serial, OpenMP, OpenCL, CUDA)
+// - a 16x16x16 brick of hexes per rank, ranks stacked in z
+// - degree 7 element nodes
+// - 100 timed repetitions of each gather-scatter
+
+// global id of node (i,j,k) of element (ex,ey,ez) in a conforming brick
+static hlong brickNodeId(int N, int NX, int NY,
+                         hlong ex, hlong ey, hlong ez,
+                         int i, int j, int k){
+  hlong gx = ex*N + i;
+  hlong gy = ey*N + j;
+  hlong gz = ez*N + k;
+  hlong NXN = (hlong)NX*N+1;
+  hlong NYN = (hlong)NY*N+1;
+  return 1 + gx + gy*NXN + gz*NXN*NYN;
+}
+
+static double timeGatherScatter(occa::memory &o_q, ogs_t *ogs, int Ntests){
+
+  ogsGatherScatter(o_q, ogsDfloat, ogsAdd, ogs); //warm up
+
+  ogs->device.finish();
+  MPI_Barrier(ogs->comm);
+  double t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsGatherScatter(o_q, ogsDfloat, ogsAdd, ogs);
+  ogs->device.finish();
+  double t = (MPI_Wtime()-t0)/Ntests;
+
+  double tmax;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, ogs->comm);
+  return tmax;
+}
+
+int main(int argc, char **argv){
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  const char *mode = (argc>=2) ? argv[1]:"Serial";
+  int NX = (argc>=3) ? atoi(argv[2]):16;
+  int NY = (argc>=4) ? atoi(argv[3]):16;
+  int NZ = (argc>=5) ? atoi(argv[4]):16;
+  int N  = (argc>=6) ? atoi(argv[5]):7;
+  int Ntests = (argc>=7) ? atoi(argv[6]):100;
+
+  int Nq = N+1;
+  int Np = Nq*Nq*Nq;
+  dlong Nelements = NX*NY*NZ;
+  dlong Nnodes = Nelements*Np;
+
+  // element-local node numbering of this rank's slab of the brick
+  hlong *ids = (hlong*) calloc(Nnodes, sizeof(hlong));
+  for(int ez=0;ez<NZ;++ez){
+    for(int ey=0;ey<NY;++ey){
+      for(int ex=0;ex<NX;++ex){
+        dlong e = ex + ey*NX + ez*NX*NY;
+        for(int k=0;k<Nq;++k){
+          for(int j=0;j<Nq;++j){
+            for(int i=0;i<Nq;++i){
+              ids[e*Np + i + j*Nq + k*Nq*Nq] =
+                brickNodeId(N, NX, NY, ex, ey, (hlong)rank*NZ + ez, i, j, k);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  char deviceConfig[BUFSIZ];
+  if(!strcmp(mode, "CUDA") || !strcmp(mode, "OpenCL"))
+    sprintf(deviceConfig, "mode: '%s', device_id: 0, platform_id: 0", mode);
+  else
+    sprintf(deviceConfig, "mode: '%s'", mode);
+
+  occa::device device;
+  device.setup(deviceConfig);
+
+  // two handles on the same numbering, one left in CSR form
+  ogs_t *ogsCSR     = ogsSetup(Nnodes, ids, comm, 0, 0, device);
+  ogs_t *ogsBlocked = ogsSetup(Nnodes, ids, comm, 0, 0, device);
+  ogsSetupBlocks(ogsBlocked, 1);
+
+  dfloat *q    = (dfloat*) calloc(Nnodes, sizeof(dfloat));
+  dfloat *qCSR = (dfloat*) calloc(Nnodes, sizeof(dfloat));
+  for(dlong n=0;n<Nnodes;++n) q[n] = drand48();
+
+  occa::memory o_q = device.malloc(Nnodes*sizeof(dfloat), q);
+
+  // check blocked against CSR
+  ogsGatherScatter(o_q, ogsDfloat, ogsAdd, ogsCSR);
+  o_q.copyTo(qCSR);
+  o_q.copyFrom(q);
+  ogsGatherScatter(o_q, ogsDfloat, ogsAdd, ogsBlocked);
+  o_q.copyTo(q);
+
+  dfloat maxErr = 0, globalMaxErr = 0;
+  for(dlong n=0;n<Nnodes;++n){
+    dfloat err = fabs(q[n]-qCSR[n]);
+    maxErr = (err>maxErr) ? err:maxErr;
+  }
+  MPI_Allreduce(&maxErr, &globalMaxErr, 1, MPI_DFLOAT, MPI_MAX, comm);
+
+  double tCSR     = timeGatherScatter(o_q, ogsCSR, Ntests);
+  double tBlocked = timeGatherScatter(o_q, ogsBlocked, Ntests);
+
+  if(rank==0){
+    // bytes moved by the local gather scatter: ids plus a read and write of q
+    hlong Nlocal = ogsCSR->Nlocal;
+    printf("ogsBenchmarkBlocked: mode=%s, ranks=%d, N=%d, nodes/rank=" dlongFormat "\n",
+           mode, size, N, Nnodes);
+    printf("max |csr - blocked| = %g\n", globalMaxErr);
+    printf("CSR     %8.3e s (%6.2f GB/s)\n", tCSR,
+           Nlocal*(sizeof(dlong)+2*sizeof(dfloat))/(1.e9*tCSR));
+    printf("BLOCKED %8.3e s (%6.2f GB/s), speedup %5.2f\n", tBlocked,
+           Nlocal*(sizeof(dlong)+2*sizeof(dfloat))/(1.e9*tBlocked), tCSR/tBlocked);
+  }
+
+  ogsFree(ogsCSR);
+  ogsFree(ogsBlocked);
+
+  free(ids); free(q); free(qCSR);
+
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,209 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "mpi.h"
+#include "ogs.hpp"
+#include "ogsInterface.h"
+
+// usage: mpirun -np 4 ./ogsBenchmarkHost 8 8 8 4 3 50
+//  runs:
+// - a 8x8x8 brick of hexes per rank, ranks stacked in z
+// - degree 4 element nodes
+// - 3 fields for the Vec and Many variants
+// - 50 timed repetitions of each gather-scatter
+
+// global id of node (i,j,k) of element (ex,ey,ez) in a conforming brick
+static hlong brickNodeId(int N, int NX, int NY,
+                         hlong ex, hlong ey, hlong ez,
+                         int i, int j, int k){
+  hlong gx = ex*N + i;
+  hlong gy = ey*N + j;
+  hlong gz = ez*N + k;
+  hlong NXN = (hlong)NX*N+1;
+  hlong NYN = (hlong)NY*N+1;
+  return 1 + gx + gy*NXN + gz*NXN*NYN;
+}
+
+static double maxTime(double t, MPI_Comm comm){
+  double tmax;
+  MPI_Allreduce(&t, &tmax, 1, MPI_DOUBLE, MPI_MAX, comm);
+  return tmax;
+}
+
+static dfloat maxDiff(dlong N, dfloat *a, dfloat *b, MPI_Comm comm){
+  dfloat maxErr = 0, globalMaxErr = 0;
+  for(dlong n=0;n<N;++n){
+    dfloat err = fabs(a[n]-b[n]);
+    maxErr = (err>maxErr) ? err:maxErr;
+  }
+  MPI_Allreduce(&maxErr, &globalMaxErr, 1, MPI_DFLOAT, MPI_MAX, comm);
+  return globalMaxErr;
+}
+
+int main(int argc, char **argv){
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm comm = MPI_COMM_WORLD;
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int NX = (argc>=2) ? atoi(argv[1]):8;
+  int NY = (argc>=3) ? atoi(argv[2]):8;
+  int NZ = (argc>=4) ? atoi(argv[3]):8;
+  int N  = (argc>=5) ? atoi(argv[4]):4;
+  int Nfields = (argc>=6) ? atoi(argv[5]):3;
+  int Ntests  = (argc>=7) ? atoi(argv[6]):50;
+
+  int Nq = N+1;
+  int Np = Nq*Nq*Nq;
+  dlong Nelements = NX*NY*NZ;
+  dlong Nnodes = Nelements*Np;
+
+  // element-local node numbering of this rank's slab of the brick
+  hlong *ids = (hlong*) calloc(Nnodes, sizeof(hlong));
+  for(int ez=0;ez<NZ;++ez){
+    for(int ey=0;ey<NY;++ey){
+      for(int ex=0;ex<NX;++ex){
+        dlong e = ex + ey*NX + ez*NX*NY;
+        for(int k=0;k<Nq;++k){
+          for(int j=0;j<Nq;++j){
+            for(int i=0;i<Nq;++i){
+              ids[e*Np + i + j*Nq + k*Nq*Nq] =
+                brickNodeId(N, NX, NY, ex, ey, (hlong)rank*NZ + ez, i, j, k);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  occa::device device;
+  device.setup("mode: 'Serial'");
+
+  ogs_t *ogs = ogsSetup(Nnodes, ids, comm, 0, 0, device);
+
+  dfloat *q   = (dfloat*) calloc(Nnodes*Nfields, sizeof(dfloat));
+  dfloat *qgs = (dfloat*) calloc(Nnodes*Nfields, sizeof(dfloat));
+
+  for(dlong n=0;n<Nnodes*Nfields;++n){
+    q[n] = drand48();
+  }
+
+  dfloat *qcsr = (dfloat*) calloc(Nnodes*Nfields, sizeof(dfloat));
+
+  void *V[Nfields];
+  for(int f=0;f<Nfields;++f) V[f] = qgs + f*Nnodes;
+
+  // check the CSR host paths against gslib
+  memcpy(qgs,  q, Nnodes*sizeof(dfloat));
+  memcpy(qcsr, q, Nnodes*sizeof(dfloat));
+  ogsHostGatherScatter(qgs, ogsDfloat, ogsAdd, ogs->hostGsh);
+  ogsGatherScatter(qcsr, ogsDfloat, ogsAdd, ogs);
+  dfloat errGS = maxDiff(Nnodes, qgs, qcsr, comm);
+
+  memcpy(qgs,  q, Nnodes*Nfields*sizeof(dfloat));
+  memcpy(qcsr, q, Nnodes*Nfields*sizeof(dfloat));
+  ogsHostGatherScatterVec(qgs, Nfields, ogsDfloat, ogsAdd, ogs->hostGsh);
+  ogsGatherScatterVec(qcsr, Nfields, ogsDfloat, ogsAdd, ogs);
+  dfloat errVec = maxDiff(Nnodes*Nfields, qgs, qcsr, comm);
+
+  memcpy(qgs,  q, Nnodes*Nfields*sizeof(dfloat));
+  memcpy(qcsr, q, Nnodes*Nfields*sizeof(dfloat));
+  ogsHostGatherScatterMany(V, Nfields, ogsDfloat, ogsAdd, ogs->hostGsh);
+  ogsGatherScatterMany(qcsr, Nfields, Nnodes, ogsDfloat, ogsAdd, ogs);
+  dfloat errMany = maxDiff(Nnodes*Nfields, qgs, qcsr, comm);
+
+  double t0, tgslib, tcsr;
+
+  // single field
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsHostGatherScatter(qgs, ogsDfloat, ogsAdd, ogs->hostGsh);
+  tgslib = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsGatherScatter(qcsr, ogsDfloat, ogsAdd, ogs);
+  tcsr = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  if(rank==0){
+    printf("ogsBenchmarkHost: ranks=%d, elements/rank=" dlongFormat ", N=%d, nodes/rank=" dlongFormat "\n",
+           size, Nelements, N, Nnodes);
+    printf("max |gslib - csr| = %g (single), %g (vec), %g (many)\n", errGS, errVec, errMany);
+    printf("%-22s gslib %8.3e s, csr %8.3e s, speedup %5.2f\n",
+           "GatherScatter", tgslib, tcsr, tgslib/tcsr);
+  }
+
+  // interleaved fields
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsHostGatherScatterVec(qgs, Nfields, ogsDfloat, ogsAdd, ogs->hostGsh);
+  tgslib = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsGatherScatterVec(qcsr, Nfields, ogsDfloat, ogsAdd, ogs);
+  tcsr = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  if(rank==0)
+    printf("%-22s gslib %8.3e s, csr %8.3e s, speedup %5.2f\n",
+           "GatherScatterVec", tgslib, tcsr, tgslib/tcsr);
+
+  // strided fields
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsHostGatherScatterMany(V, Nfields, ogsDfloat, ogsAdd, ogs->hostGsh);
+  tgslib = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  MPI_Barrier(comm);
+  t0 = MPI_Wtime();
+  for(int test=0;test<Ntests;++test)
+    ogsGatherScatterMany(qcsr, Nfields, Nnodes, ogsDfloat, ogsAdd, ogs);
+  tcsr = maxTime(MPI_Wtime()-t0, comm)/Ntests;
+
+  if(rank==0)
+    printf("%-22s gslib %8.3e s, csr %8.3e s, speedup %5.2f\n",
+           "GatherScatterMany", tgslib, tcsr, tgslib/tcsr);
+
+  ogsFree(ogs);
+
+  free(ids); free(q); free(qgs); free(qcsr);
+
+  MPI_Finalize();
+  return 0;
+}
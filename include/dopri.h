@@ -0,0 +1,114 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef DOPRI_H
+#define DOPRI_H 1
+
+#include "mesh.h"
+
+// block size for the error reduction
+#define DOPRI_BLOCKSIZE 256
+
+// evaluate rhsq = F(time, q). The callback may write halo data past the
+// N local entries of q, so q must be allocated with room for the halo.
+typedef void (*dopriRhs_t)(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq);
+
+typedef struct {
+
+  mesh_t *mesh;
+
+  dlong N;        // number of local entries integrated
+  dlong Nhalo;    // extra entries the RHS may write past N
+  hlong Nglobal;  // number of entries on all ranks
+
+  // solver plugged into the integrator
+  void *solver;
+  dopriRhs_t rhs;
+
+  // Butcher tableau with embedded error weights and dense output weights
+  int Nrk;
+  dfloat *rkA, *rkC, *rkE, *rkoutB;
+  occa::memory o_rkA, o_rkE, o_rkoutB;
+
+  occa::memory o_rkq;     // stage solution, holds the new solution after a step
+  occa::memory o_rkrhsq;  // stage derivatives
+
+  // first same as last: the last stage derivative is the first of the next step
+  int fsal;
+
+  // the RHS forms rkq itself from o_q, o_rkrhsq and row rk of rkA, saving a
+  // pass over the stage state. rk is 0 when the RHS is evaluated at o_q.
+  int fusedStage;
+  int rk;
+  dfloat stageDt;
+  occa::memory o_q;
+
+  // error estimate reduction
+  dlong Nblock;
+  occa::memory o_errtmp, o_errsum;
+  dfloat localErr, globalErr;
+
+  // step size controller
+  dfloat ATOL, RTOL;
+  dfloat dtMIN, dtMAX;
+  dfloat safe, beta, exp1, facold;
+  dfloat factor1, invfactor1;
+  dfloat factor2, invfactor2;
+
+  occa::kernel stageKernel;
+  occa::kernel errorEstimateKernel;
+  occa::kernel embeddedErrorEstimateKernel;
+  occa::kernel outputKernel;
+  occa::kernel sumKernel;
+
+} dopri_t;
+
+dopri_t *dopriSetup(mesh_t *mesh, dlong N, dlong Nhalo, occa::properties kernelInfo,
+                    void *solver, dopriRhs_t rhs);
+
+// try a step of size dt from q at time, leaves the new solution in o_rkq
+// and reduces the error estimate over all ranks
+void dopriStep(dopri_t *dopri, dfloat time, dfloat dt, occa::memory &o_q);
+
+// reduce the error for a solver running its own embedded stages
+void dopriErrorEstimate(dopri_t *dopri, occa::memory &o_q, occa::memory &o_rkq, occa::memory &o_rkerr);
+
+// scaled error norm of the last step or error reduction
+dfloat dopriEstimate(dopri_t *dopri);
+
+// next step size from the error norm, err<1 accepts the step
+dfloat dopriController(dopri_t *dopri, dfloat err, dfloat dt);
+
+void dopriAccept(dopri_t *dopri, occa::memory &o_q);
+
+// interpolate the accepted step to outTime in [time, time+dt], call before dopriAccept
+void dopriOutputStep(dopri_t *dopri, dfloat time, dfloat dt, dfloat outTime,
+                     occa::memory &o_q, occa::memory &o_outq);
+
+// q was changed outside of the integrator, recompute the first stage
+void dopriReset(dopri_t *dopri);
+
+#endif
@@ -68,6 +68,11 @@ typedef struct {
 
   int *elementInfo; //type of element
 
+  int NpartitionConstraints; // number of weights per element used by the last weighted partition
+  dfloat *partitionWeights;  // those weights, migrated with the elements
+  int   *migrationSourceRanks; // rank and local id of each element before the last weighted partition
+  dlong *migrationSourceIds;
+
   // boundary faces
   hlong NboundaryFaces; // number of boundary faces
   hlong *boundaryInfo; // list of boundary faces (type, vertex-1, vertex-2, vertex-3)
@@ -440,6 +445,16 @@ typedef struct {
   occa::kernel haloGetKernel;
   occa::kernel haloPutKernel;
 
+  // DG state vector layout, see meshFieldLayoutSetup
+  int fieldLayout;       // FIELD_LAYOUT_AOS, FIELD_LAYOUT_SOA or FIELD_LAYOUT_AOSOA
+  int fieldBlock;        // elements per block of the AOSOA layout
+  dlong fieldNelements;  // elements stored per field: local, halo and block padding
+  dlong fieldStride;     // entries between the same node of consecutive fields
+  occa::kernel fieldHaloExtractKernel;
+  occa::kernel fieldHaloScatterKernel;
+  occa::kernel fieldHaloTraceExtractKernel;
+  occa::kernel fieldHaloTracePutKernel;
+
   // Just for test will be deleted after temporal testsAK
   occa::kernel RKupdateKernel;
   occa::kernel RKpmlUpdateKernel;
@@ -496,6 +511,9 @@ void meshConnect(mesh_t *mesh);
 /* build parallel face connectivity */
 void meshParallelConnect(mesh_t *mesh);
 
+/* reorder local elements (RCM, interior first) and rebuild connectivity */
+void meshLocalReorder(mesh_t *mesh);
+
 /* build global connectivity in parallel */
 void meshParallelConnectNodes(mesh_t *mesh);
 
@@ -523,9 +541,55 @@ void meshHaloExchangeBlocking(mesh_t *mesh,
 			     void *sendBuffer,    // temporary buffer
 			      void *recvBuffer);
 
+/* DG state vector layouts, node n of field fld on element e is stored at
+   AOS:   q[e][fld][n]          (element-major, fields strided by Np)
+   SOA:   q[fld][e][n]          (field-major, halo elements included per field)
+   AOSOA: q[e/B][fld][e%B][n]   (blocks of B elements)  */
+#define FIELD_LAYOUT_AOS   0
+#define FIELD_LAYOUT_SOA   1
+#define FIELD_LAYOUT_AOSOA 2
+
+/* read FIELD LAYOUT, add the layout defines to kernelInfo and build the layout-aware halo kernels */
+void meshFieldLayoutSetup(mesh_t *mesh, setupAide &options, occa::properties &kernelInfo);
+
+/* index of node n of field fld on element e in a state vector with Nfields fields */
+dlong meshFieldId(mesh_t *mesh, int Nfields, dlong e, int fld, int n);
+
+/* entries of a state vector with Nfields fields, including halo and padding */
+dlong meshFieldNentries(mesh_t *mesh, int Nfields);
+
+/* copy the local elements of a device state vector to/from an element-major host array */
+void meshFieldCopyTo(mesh_t *mesh, int Nfields, occa::memory &o_q, dfloat *q);
+void meshFieldCopyFrom(mesh_t *mesh, int Nfields, dfloat *q, occa::memory &o_q);
+
+/* pack the halo elements of o_q element-major into o_haloBuffer */
+void meshFieldHaloExtract(mesh_t *mesh, int Nfields, occa::memory &o_q, occa::memory &o_haloBuffer);
+
+/* place the received element-major halo into the halo elements of o_q */
+void meshFieldHaloScatter(mesh_t *mesh, int Nfields, dfloat *recvBuffer,
+                          occa::memory &o_haloBuffer, occa::memory &o_q);
+
+/* pack the face traces of the halo pairs of Narrays state vectors, the a-th with
+   Nfields[a] fields, into one message of Nfp*sum(Nfields) entries per halo pair */
+void meshFieldHaloTraceExtract(mesh_t *mesh, int Narrays, int *Nfields,
+                               occa::memory *o_q, occa::memory &o_haloBuffer);
+
+/* place a received trace message on the halo faces of the Narrays state vectors */
+void meshFieldHaloTracePut(mesh_t *mesh, int Narrays, int *Nfields, dfloat *recvBuffer,
+                           occa::memory &o_haloBuffer, occa::memory *o_q);
+
 // print out parallel partition i
 void meshPartitionStatistics(mesh_t *mesh);
 
+#define meshMaxPartitionConstraints 8
+
+/* weighted multi-constraint space filling curve partition (vertex data only) */
+void meshWeightedPartition(mesh_t *mesh, int Nconstraints, dfloat *weights);
+
+/* move per-element data to the partition made by meshWeightedPartition */
+void meshMigrateElementData(mesh_t *mesh, size_t bytesPerElement,
+                            void *oldData, void *newData);
+
 // build element-boundary connectivity
 void meshConnectBoundary(mesh_t *mesh);
 
@@ -584,11 +648,38 @@ extern "C"
 void readDfloatArray(FILE *fp, const char *label, dfloat **A, int *Nrows, int* Ncols);
 void readIntArray   (FILE *fp, const char *label, int **A   , int *Nrows, int* Ncols);
 
+// cached reference node file, read by rank 0 and broadcast (collective on first load)
+typedef struct referenceData_t referenceData_t;
+referenceData_t *meshReferenceDataLoad(const char *fname);
+void readDfloatArray(referenceData_t *data, const char *label, dfloat **A, int *Nrows, int* Ncols);
+void readIntArray   (referenceData_t *data, const char *label, int **A   , int *Nrows, int* Ncols);
+
 void meshApplyElementMatrix(mesh_t *mesh, dfloat *A, dfloat *q, dfloat *Aq);
+void meshApplyElementMatrixFields(mesh_t *mesh, int Nfields, dfloat *A, dfloat *q, dfloat *Aq);
 
 void matrixInverse(int N, dfloat *A);
 dfloat matrixConditionNumber(int N, dfloat *A);
 
+// orthonormal Jacobi polynomials and polynomial bases with their derivatives
+dfloat meshBasisJacobiP(dfloat a, dfloat alpha, dfloat beta, int N);
+dfloat meshBasisGradJacobiP(dfloat a, dfloat alpha, dfloat beta, int N);
+void meshOrthonormalBasis1D(dfloat a, int i, dfloat *P, dfloat *Pr);
+void meshOrthonormalBasisTri2D(dfloat a, dfloat b, int i, int j, dfloat *P, dfloat *Pr, dfloat *Ps);
+void meshOrthonormalBasisQuad2D(dfloat a, dfloat b, int i, int j, dfloat *P, dfloat *Pr, dfloat *Ps);
+void meshOrthonormalBasisTet3D(dfloat a, dfloat b, dfloat c, int i, int j, int k,
+                               dfloat *P, dfloat *Pr, dfloat *Ps, dfloat *Pt);
+void meshOrthonormalBasisHex3D(dfloat a, dfloat b, dfloat c, int i, int j, int k,
+                               dfloat *P, dfloat *Pr, dfloat *Ps, dfloat *Pt);
+
+// orthonormal Vandermonde matrices V[point*Np+mode] and their derivatives (allocated here)
+int meshVandermonde1D(int N, int Npoints, dfloat *r, dfloat **V, dfloat **Vr);
+int meshVandermondeTri2D(int N, int Npoints, dfloat *r, dfloat *s, dfloat **V, dfloat **Vr, dfloat **Vs);
+int meshVandermondeQuad2D(int N, int Npoints, dfloat *r, dfloat *s, dfloat **V, dfloat **Vr, dfloat **Vs);
+int meshVandermondeTet3D(int N, int Npoints, dfloat *r, dfloat *s, dfloat *t,
+                         dfloat **V, dfloat **Vr, dfloat **Vs, dfloat **Vt);
+int meshVandermondeHex3D(int N, int Npoints, dfloat *r, dfloat *s, dfloat *t,
+                         dfloat **V, dfloat **Vr, dfloat **Vs, dfloat **Vt);
+
 void occaDeviceConfig(mesh_t *mesh, setupAide &newOptions);
 
 void *occaHostMallocPinned(occa::device &device, size_t size, void *source, occa::memory &mem);
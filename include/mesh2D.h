@@ -133,6 +133,9 @@ mesh2D *meshSetupQuad2D(char *filename, int N);
 // set up OCCA device and copy generic element info to device
 void meshOccaSetup2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kernelInfo);
 
+// copy generic element info to an already configured device
+void meshOccaPopulateDevice2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kernelInfo);
+
 // void meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels); 
 dfloat meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels, dfloat finalTime); 
 
@@ -141,6 +144,12 @@ dfloat meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
 void meshMRABWeightedPartition2D(mesh2D *mesh, dfloat *weights,
                                       int numLevels, int *levels);
 
+// weighted multi-constraint repartition of a set up mesh (host data rebuilt)
+void meshRepartition2D(mesh2D *mesh, int Nconstraints, dfloat *weights);
+
+// rebuild the host mesh data for the current element distribution
+void meshReconnect2D(mesh2D *mesh);
+
 
 // Setup probe information
 // Probe Setup : AK
@@ -95,6 +95,7 @@ void meshOccaSetupQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &
 void meshOccaSetupTri3D(mesh_t *mesh, setupAide &newOptions, occa::properties &kernelInfo);
 
 void meshOccaPopulateDevice3D(mesh3D *mesh, setupAide &newOptions, occa::properties &kernelInfo);
+void meshOccaPopulateDeviceQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &kernelInfo);
 void meshOccaCloneDevice(mesh_t *donorMesh, mesh_t *mesh);
 
 // functions that call OCCA kernels
@@ -144,6 +145,12 @@ dfloat meshMRABSetup3D(mesh3D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
 void meshMRABWeightedPartition3D(mesh3D *mesh, dfloat *weights,
                                       int numLevels, int *levels);
 
+// weighted multi-constraint repartition of a set up mesh (host data rebuilt)
+void meshRepartition3D(mesh3D *mesh, int Nconstraints, dfloat *weights);
+
+// rebuild the host mesh data for the current element distribution
+void meshReconnect3D(mesh3D *mesh);
+
 void interpolateHex3D(dfloat *Inter, dfloat *x, int N, dfloat *Ix, int M);
 
 #define norm3(a,b,c) ( sqrt((a)*(a)+(b)*(b)+(c)*(c)) )
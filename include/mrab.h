@@ -0,0 +1,81 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#ifndef MRAB_H
+#define MRAB_H 1
+
+#include "mesh.h"
+
+// block size for the level updates
+#define MRAB_BLOCKSIZE 256
+
+// evaluate rhsq = F(time, q) on the elements of MRAB levels 0,..,lev-1,
+// which are the first NlevelElements[lev] elements on this rank. Elements
+// of level lev next to them hold q predicted to time. The callback may
+// write halo data past the local entries of q.
+typedef void (*mrabRhs_t)(void *solver, dfloat time, int lev, occa::memory &o_q, occa::memory &o_rhsq);
+
+typedef struct {
+
+  mesh_t *mesh;
+
+  int Nentries;   // entries per element (Np*Nfields)
+  dlong N;        // number of local entries integrated
+  dlong Nhalo;    // extra entries the RHS may write past N
+
+  // solver plugged into the integrator
+  void *solver;
+  mrabRhs_t rhs;
+
+  int Nlevels;
+  dfloat dt;                 // step of level 0, level l steps with dt*2^l
+  dlong *NlevelElements;     // number of elements in levels 0,..,l-1
+  int Nsteps;                // steps taken since the last reset
+
+  // third order Adams Bashforth weights [order][level][3] for a full
+  // step (A) and for the prediction to half a step (B) of each level
+  dfloat *MRAB_A, *MRAB_B;
+
+  occa::memory o_qMR;     // q at the current tick as seen by the RHS
+  occa::memory o_rhsq;    // RHS at the start of the current step of each level
+  occa::memory o_rhsqMR;  // RHS of the two previous steps of each level
+
+  occa::kernel updateKernel;
+  occa::kernel traceUpdateKernel;
+
+} mrab_t;
+
+// meshMRABSetup2D/3D must have been called, so the elements are grouped by level
+mrab_t *mrabSetup(mesh_t *mesh, int Nfields, dfloat dt, occa::properties kernelInfo,
+                  void *solver, mrabRhs_t rhs);
+
+// advance q from time by one step of the coarsest level, dt*2^(Nlevels-1)
+void mrabStep(mrab_t *mrab, dfloat time, occa::memory &o_q);
+
+// q was changed outside of the integrator, restart from first order
+void mrabReset(mrab_t *mrab, occa::memory &o_q);
+
+#endif
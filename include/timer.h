@@ -106,6 +106,9 @@ namespace occa {
 
 
     void printTimer();
+
+    // total time accumulated under key (at any depth)
+    double queryTime(std::string key);
   };
 
 
@@ -130,6 +133,8 @@ namespace occa {
   double toc(std::string key, occa::kernel &kernel, double fp, double bw);
 
   void printTimer();
+
+  double queryTime(std::string key);
 }
 
 void occaTimerTic(occa::device device,std::string name);
@@ -36,6 +36,7 @@ void gather_add(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -58,6 +59,7 @@ void gather_mul(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -80,6 +82,7 @@ void gather_min(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -103,6 +106,7 @@ void gather_max(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -40,6 +40,7 @@ void gatherMany_add(const  dlong Ngather,
                    const  T     *  q,
                           T     *  gatherq) {
   for (int k=0;k<Nentries;k++) {
+#pragma omp parallel for
     for(dlong g=0;g<Ngather;++g){
 
       const dlong start = gatherStarts[g];
@@ -67,6 +68,7 @@ void gatherMany_mul(const  dlong Ngather,
                    const  T     *  q,
                           T     *  gatherq) {
   for (int k=0;k<Nentries;k++) {
+#pragma omp parallel for
     for(dlong g=0;g<Ngather;++g){
 
       const dlong start = gatherStarts[g];
@@ -94,6 +96,7 @@ void gatherMany_min(const  dlong Ngather,
                    const  T     *  q,
                           T     *  gatherq) {
   for (int k=0;k<Nentries;k++) {
+#pragma omp parallel for
     for(dlong g=0;g<Ngather;++g){
 
       const dlong start = gatherStarts[g];
@@ -122,6 +125,7 @@ void gatherMany_max(const  dlong Ngather,
                    const  T     *  q,
                           T     *  gatherq) {
   for (int k=0;k<Nentries;k++) {
+#pragma omp parallel for
     for(dlong g=0;g<Ngather;++g){
 
       const dlong start = gatherStarts[g];
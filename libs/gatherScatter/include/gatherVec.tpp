@@ -37,6 +37,7 @@ void gatherVec_add(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -63,6 +64,7 @@ void gatherVec_mul(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -89,6 +91,7 @@ void gatherVec_min(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -116,6 +119,7 @@ void gatherVec_max(const  dlong Ngather,
                    const  dlong *  gatherIds,
                    const  T     *  q,
                           T     *  gatherq) {
+#pragma omp parallel for
   for(dlong g=0;g<Ngather;++g){
 
     const dlong start = gatherStarts[g];
@@ -105,6 +105,28 @@ namespace ogs {
 
 
 
+  extern occa::kernel gatherScatterBlockedKernel_floatAdd;
+  extern occa::kernel gatherScatterBlockedKernel_floatMul;
+  extern occa::kernel gatherScatterBlockedKernel_floatMin;
+  extern occa::kernel gatherScatterBlockedKernel_floatMax;
+
+  extern occa::kernel gatherScatterBlockedKernel_doubleAdd;
+  extern occa::kernel gatherScatterBlockedKernel_doubleMul;
+  extern occa::kernel gatherScatterBlockedKernel_doubleMin;
+  extern occa::kernel gatherScatterBlockedKernel_doubleMax;
+
+  extern occa::kernel gatherScatterBlockedKernel_intAdd;
+  extern occa::kernel gatherScatterBlockedKernel_intMul;
+  extern occa::kernel gatherScatterBlockedKernel_intMin;
+  extern occa::kernel gatherScatterBlockedKernel_intMax;
+
+  extern occa::kernel gatherScatterBlockedKernel_longAdd;
+  extern occa::kernel gatherScatterBlockedKernel_longMul;
+  extern occa::kernel gatherScatterBlockedKernel_longMin;
+  extern occa::kernel gatherScatterBlockedKernel_longMax;
+
+
+
   extern occa::kernel gatherKernel_floatAdd;
   extern occa::kernel gatherKernel_floatMul;
   extern occa::kernel gatherKernel_floatMin;
@@ -200,6 +222,14 @@ void occaGatherScatter(const  dlong Ngather,
                 const char* op,
                 occa::memory  o_v);
 
+void occaGatherScatterBlocked(const dlong Npairs,
+                const dlong Nquads,
+                occa::memory o_pairIds,
+                occa::memory o_quadIds,
+                const char* type,
+                const char* op,
+                occa::memory  o_v);
+
 void occaGatherScatterVec(const  dlong Ngather,
                 const int Nentries,
                 occa::memory o_gatherStarts,
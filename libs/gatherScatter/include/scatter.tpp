@@ -36,6 +36,7 @@ void scatter(const  dlong Nscatter,
              const  dlong *  scatterIds,
              const  T     *  q,
                     T     *  scatterq) {
+#pragma omp parallel for
   
   for(dlong s=0;s<Nscatter;++s){
 
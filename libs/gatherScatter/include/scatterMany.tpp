@@ -41,6 +41,7 @@ void scatterMany(const  dlong Nscatter,
                     T     *  scatterq) {
 
   for(int k=0;k<Nentries;++k){
+#pragma omp parallel for
     for(dlong s=0;s<Nscatter;++s){
 
       const dlong start = scatterStarts[s];
@@ -37,6 +37,7 @@ void scatterVec(const  dlong Nscatter,
              const  dlong *  scatterIds,
              const  T     *  q,
                     T     *  scatterq) {
+#pragma omp parallel for
   
   for(dlong s=0;s<Nscatter;++s){
 
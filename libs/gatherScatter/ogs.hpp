@@ -145,11 +145,31 @@ typedef struct {
   dlong         NhaloGather;    //  number of gathered nodes on halo
   dlong         NownedHalo;     //  number of owned halo nodes
 
+  int           unique;         //  nonsymmetric (flagged) handle
+
   dlong         *localGatherOffsets;
   dlong         *localGatherIds;
   occa::memory o_localGatherOffsets;
   occa::memory o_localGatherIds;
 
+  dlong         NsharedGather;  //  number of local gathered nodes with more than one member
+  dlong         *sharedGatherOffsets;
+  dlong         *sharedGatherIds;
+
+  // conflict-free split of the local groups (see ogsSetupBlocks)
+  int           blocked;
+  dlong         NlocalPairs;    //  number of local two-member groups
+  dlong         NlocalQuads;    //  number of local four-member groups
+  dlong         NlocalRest;     //  number of other local groups with more than one member
+  dlong         *localPairIds;
+  dlong         *localQuadIds;
+  dlong         *localRestOffsets;
+  dlong         *localRestIds;
+  occa::memory o_localPairIds;
+  occa::memory o_localQuadIds;
+  occa::memory o_localRestOffsets;
+  occa::memory o_localRestIds;
+
   dlong         *haloGatherOffsets;
   dlong         *haloGatherIds;
   occa::memory o_haloGatherOffsets;
@@ -170,6 +190,9 @@ typedef struct {
 ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
                 int ogsUnique, int verbose, occa::device device);
 
+// split the local gather scatter into dense two- and four-member ranges
+void ogsSetupBlocks(ogs_t *ogs, int verbose);
+
 void ogsFree(ogs_t* ogs);
 
 // Host array versions
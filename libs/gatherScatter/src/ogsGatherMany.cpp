@@ -151,6 +151,7 @@ void ogsGatherMany(void *gv,
     if (ogs::hostBufSize < ogs->NhaloGather*Nbytes*k) {
       if (ogs::hostBufSize) free(ogs::hostBuf);
       ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes*k);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes*k;
     }
   }
 
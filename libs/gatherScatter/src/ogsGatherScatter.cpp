@@ -28,11 +28,252 @@ SOFTWARE.
 #include "ogsKernels.hpp"
 #include "ogsInterface.h"
 
+#include "gather.tpp"
+#include "scatter.tpp"
+#include "gatherScatter.tpp"
+
+void ogsGatherScatter_add(void *v, const char *type, ogs_t *ogs);
+void ogsGatherScatter_mul(void *v, const char *type, ogs_t *ogs);
+void ogsGatherScatter_min(void *v, const char *type, ogs_t *ogs);
+void ogsGatherScatter_max(void *v, const char *type, ogs_t *ogs);
+
 void ogsGatherScatter(void *v, 
                       const char *type, 
                       const char *op, 
                       ogs_t *ogs){
-  ogsHostGatherScatter(v, type, op, ogs->hostGsh);
+
+  // nonsymmetric handles rely on gslib's flagged id behavior
+  if (ogs->unique) {
+    ogsHostGatherScatter(v, type, op, ogs->hostGsh);
+    return;
+  }
+
+  size_t Nbytes;
+  if (!strcmp(type, "float")) 
+    Nbytes = sizeof(float);
+  else if (!strcmp(type, "double")) 
+    Nbytes = sizeof(double);
+  else if (!strcmp(type, "int")) 
+    Nbytes = sizeof(int);
+  else if (!strcmp(type, "long long int")) 
+    Nbytes = sizeof(long long int);
+
+  if (ogs->NhaloGather) {
+    if (ogs::hostBufSize < ogs->NhaloGather*Nbytes) {
+      if (ogs::hostBufSize) free(ogs::hostBuf);
+      ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes;
+    }
+  }
+
+  if (!strcmp(op, "add")) 
+    ogsGatherScatter_add(v, type, ogs);
+  else if (!strcmp(op, "mul")) 
+    ogsGatherScatter_mul(v, type, ogs);
+  else if (!strcmp(op, "min")) 
+    ogsGatherScatter_min(v, type, ogs);
+  else if (!strcmp(op, "max")) 
+    ogsGatherScatter_max(v, type, ogs);
+}
+
+void ogsGatherScatter_add(void *v, const char *type, ogs_t *ogs){
+
+  // gather halo nodes into the host buffer
+  if (!strcmp(type, "float")) 
+    gather_add<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gather_add<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gather_add<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gather_add<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatter(ogs::hostBuf, type, ogsAdd, ogs->haloGshSym);
+  }
+
+  // local gather scatter
+  if (!strcmp(type, "float")) 
+    gatherScatter_add<float>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatter_add<double>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatter_add<int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatter_add<long long int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  // scatter totally gathered halo data back to local nodes
+  if (!strcmp(type, "float")) 
+    scatter<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatter<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatter<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatter<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatter_mul(void *v, const char *type, ogs_t *ogs){
+
+  // gather halo nodes into the host buffer
+  if (!strcmp(type, "float")) 
+    gather_mul<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gather_mul<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gather_mul<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gather_mul<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatter(ogs::hostBuf, type, ogsMul, ogs->haloGshSym);
+  }
+
+  // local gather scatter
+  if (!strcmp(type, "float")) 
+    gatherScatter_mul<float>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatter_mul<double>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatter_mul<int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatter_mul<long long int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  // scatter totally gathered halo data back to local nodes
+  if (!strcmp(type, "float")) 
+    scatter<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatter<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatter<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatter<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatter_min(void *v, const char *type, ogs_t *ogs){
+
+  // gather halo nodes into the host buffer
+  if (!strcmp(type, "float")) 
+    gather_min<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gather_min<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gather_min<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gather_min<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatter(ogs::hostBuf, type, ogsMin, ogs->haloGshSym);
+  }
+
+  // local gather scatter
+  if (!strcmp(type, "float")) 
+    gatherScatter_min<float>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatter_min<double>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatter_min<int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatter_min<long long int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  // scatter totally gathered halo data back to local nodes
+  if (!strcmp(type, "float")) 
+    scatter<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatter<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatter<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatter<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatter_max(void *v, const char *type, ogs_t *ogs){
+
+  // gather halo nodes into the host buffer
+  if (!strcmp(type, "float")) 
+    gather_max<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gather_max<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gather_max<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gather_max<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatter(ogs::hostBuf, type, ogsMax, ogs->haloGshSym);
+  }
+
+  // local gather scatter
+  if (!strcmp(type, "float")) 
+    gatherScatter_max<float>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatter_max<double>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatter_max<int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatter_max<long long int>(ogs->NsharedGather, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  // scatter totally gathered halo data back to local nodes
+  if (!strcmp(type, "float")) 
+    scatter<float>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatter<double>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatter<int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatter<long long int>(ogs->NhaloGather, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
 }
 
 void ogsGatherScatter(occa::memory o_v, 
@@ -91,7 +332,12 @@ void ogsGatherScatterFinish(occa::memory o_v,
   else if (!strcmp(type, "long long int")) 
     Nbytes = sizeof(long long int);
 
-  if(ogs->NlocalGather) {
+  if (ogs->blocked) {
+    if(ogs->NlocalPairs+ogs->NlocalQuads)
+      occaGatherScatterBlocked(ogs->NlocalPairs, ogs->NlocalQuads, ogs->o_localPairIds, ogs->o_localQuadIds, type, op, o_v);
+    if(ogs->NlocalRest)
+      occaGatherScatter(ogs->NlocalRest, ogs->o_localRestOffsets, ogs->o_localRestIds, type, op, o_v);
+  } else if(ogs->NlocalGather) {
     occaGatherScatter(ogs->NlocalGather, ogs->o_localGatherOffsets, ogs->o_localGatherIds, type, op, o_v);
   }
 
@@ -151,4 +397,46 @@ void occaGatherScatter(const  dlong Ngather,
     ogs::gatherScatterKernel_longMin(Ngather, o_gatherStarts, o_gatherIds, o_v);
   else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "max"))) 
     ogs::gatherScatterKernel_longMax(Ngather, o_gatherStarts, o_gatherIds, o_v);
-}
\ No newline at end of file
+}
+
+void occaGatherScatterBlocked(const dlong Npairs,
+                const dlong Nquads,
+                occa::memory o_pairIds,
+                occa::memory o_quadIds,
+                const char* type,
+                const char* op,
+                occa::memory  o_v) {
+  
+  if      ((!strcmp(type, "float"))&&(!strcmp(op, "add"))) 
+    ogs::gatherScatterBlockedKernel_floatAdd(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "float"))&&(!strcmp(op, "mul"))) 
+    ogs::gatherScatterBlockedKernel_floatMul(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "float"))&&(!strcmp(op, "min"))) 
+    ogs::gatherScatterBlockedKernel_floatMin(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "float"))&&(!strcmp(op, "max"))) 
+    ogs::gatherScatterBlockedKernel_floatMax(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "double"))&&(!strcmp(op, "add"))) 
+    ogs::gatherScatterBlockedKernel_doubleAdd(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "double"))&&(!strcmp(op, "mul"))) 
+    ogs::gatherScatterBlockedKernel_doubleMul(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "double"))&&(!strcmp(op, "min"))) 
+    ogs::gatherScatterBlockedKernel_doubleMin(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "double"))&&(!strcmp(op, "max"))) 
+    ogs::gatherScatterBlockedKernel_doubleMax(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "int"))&&(!strcmp(op, "add"))) 
+    ogs::gatherScatterBlockedKernel_intAdd(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "int"))&&(!strcmp(op, "mul"))) 
+    ogs::gatherScatterBlockedKernel_intMul(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "int"))&&(!strcmp(op, "min"))) 
+    ogs::gatherScatterBlockedKernel_intMin(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "int"))&&(!strcmp(op, "max"))) 
+    ogs::gatherScatterBlockedKernel_intMax(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "add"))) 
+    ogs::gatherScatterBlockedKernel_longAdd(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "mul"))) 
+    ogs::gatherScatterBlockedKernel_longMul(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "min"))) 
+    ogs::gatherScatterBlockedKernel_longMin(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+  else if ((!strcmp(type, "long long int"))&&(!strcmp(op, "max"))) 
+    ogs::gatherScatterBlockedKernel_longMax(Npairs, Nquads, o_pairIds, o_quadIds, o_v);
+}
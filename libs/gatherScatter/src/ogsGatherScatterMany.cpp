@@ -28,6 +28,15 @@ SOFTWARE.
 #include "ogsKernels.hpp"
 #include "ogsInterface.h"
 
+#include "gatherMany.tpp"
+#include "scatterMany.tpp"
+#include "gatherScatterMany.tpp"
+
+void ogsGatherScatterMany_add(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs);
+void ogsGatherScatterMany_mul(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs);
+void ogsGatherScatterMany_min(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs);
+void ogsGatherScatterMany_max(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs);
+
 void ogsGatherScatterMany(void *v, 
                       const int k,
                       const dlong stride,
@@ -45,10 +54,263 @@ void ogsGatherScatterMany(void *v,
   else if (!strcmp(type, "long long int")) 
     Nbytes = sizeof(long long int);
 
-  void* V[k];
-  for (int i=0;i<k;i++) V[i] = (char*)v + i*stride*Nbytes;
+  // nonsymmetric handles rely on gslib's flagged id behavior
+  if (ogs->unique) {
+    void* V[k];
+    for (int i=0;i<k;i++) V[i] = (char*)v + i*stride*Nbytes;
+
+    ogsHostGatherScatterMany(V, k, type, op, ogs->hostGsh);
+    return;
+  }
+
+  if (ogs->NhaloGather) {
+    if (ogs::hostBufSize < ogs->NhaloGather*Nbytes*k) {
+      if (ogs::hostBufSize) free(ogs::hostBuf);
+      ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes*k);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes*k;
+    }
+  }
+
+  if (!strcmp(op, "add")) 
+    ogsGatherScatterMany_add(v, k, stride, Nbytes, type, ogs);
+  else if (!strcmp(op, "mul")) 
+    ogsGatherScatterMany_mul(v, k, stride, Nbytes, type, ogs);
+  else if (!strcmp(op, "min")) 
+    ogsGatherScatterMany_min(v, k, stride, Nbytes, type, ogs);
+  else if (!strcmp(op, "max")) 
+    ogsGatherScatterMany_max(v, k, stride, Nbytes, type, ogs);
+}
+
+void ogsGatherScatterMany_add(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherMany_add<float>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherMany_add<double>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherMany_add<int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherMany_add<long long int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    void* H[k];
+    for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
+
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterMany(H, k, type, ogsAdd, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterMany_add<float>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterMany_add<double>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterMany_add<int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterMany_add<long long int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterMany<float>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterMany<double>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterMany<int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterMany<long long int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterMany_mul(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherMany_mul<float>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherMany_mul<double>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherMany_mul<int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherMany_mul<long long int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    void* H[k];
+    for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
+
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterMany(H, k, type, ogsMul, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterMany_mul<float>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterMany_mul<double>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterMany_mul<int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterMany_mul<long long int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterMany<float>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterMany<double>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterMany<int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterMany<long long int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterMany_min(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherMany_min<float>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherMany_min<double>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherMany_min<int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherMany_min<long long int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    void* H[k];
+    for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
+
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterMany(H, k, type, ogsMin, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterMany_min<float>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterMany_min<double>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterMany_min<int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterMany_min<long long int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterMany<float>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterMany<double>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterMany<int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterMany<long long int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterMany_max(void *v, const int k, const dlong stride, const size_t Nbytes, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherMany_max<float>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherMany_max<double>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherMany_max<int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherMany_max<long long int>(ogs->NhaloGather, k, stride, ogs->NhaloGather,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    void* H[k];
+    for (int i=0;i<k;i++) H[i] = (char*)ogs::hostBuf + i*ogs->NhaloGather*Nbytes;
+
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterMany(H, k, type, ogsMax, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterMany_max<float>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterMany_max<double>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterMany_max<int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterMany_max<long long int>(ogs->NsharedGather, k, stride, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
 
-  ogsHostGatherScatterMany(V, k, type, op, ogs->hostGsh);
+  if (!strcmp(type, "float")) 
+    scatterMany<float>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterMany<double>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterMany<int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterMany<long long int>(ogs->NhaloGather, k, ogs->NhaloGather, stride,
+                      ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
 }
 
 void ogsGatherScatterMany(occa::memory o_v, 
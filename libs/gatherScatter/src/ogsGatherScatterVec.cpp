@@ -28,12 +28,241 @@ SOFTWARE.
 #include "ogsKernels.hpp"
 #include "ogsInterface.h"
 
+#include "gatherVec.tpp"
+#include "scatterVec.tpp"
+#include "gatherScatterVec.tpp"
+
+void ogsGatherScatterVec_add(void *v, const int k, const char *type, ogs_t *ogs);
+void ogsGatherScatterVec_mul(void *v, const int k, const char *type, ogs_t *ogs);
+void ogsGatherScatterVec_min(void *v, const int k, const char *type, ogs_t *ogs);
+void ogsGatherScatterVec_max(void *v, const int k, const char *type, ogs_t *ogs);
+
 void ogsGatherScatterVec(void *v, 
                       const int k,
                       const char *type, 
                       const char *op, 
                       ogs_t *ogs){
-  ogsHostGatherScatterVec(v, k, type, op, ogs->hostGsh);
+
+  // nonsymmetric handles rely on gslib's flagged id behavior
+  if (ogs->unique) {
+    ogsHostGatherScatterVec(v, k, type, op, ogs->hostGsh);
+    return;
+  }
+
+  size_t Nbytes;
+  if (!strcmp(type, "float")) 
+    Nbytes = sizeof(float);
+  else if (!strcmp(type, "double")) 
+    Nbytes = sizeof(double);
+  else if (!strcmp(type, "int")) 
+    Nbytes = sizeof(int);
+  else if (!strcmp(type, "long long int")) 
+    Nbytes = sizeof(long long int);
+
+  if (ogs->NhaloGather) {
+    if (ogs::hostBufSize < ogs->NhaloGather*Nbytes*k) {
+      if (ogs::hostBufSize) free(ogs::hostBuf);
+      ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes*k);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes*k;
+    }
+  }
+
+  if (!strcmp(op, "add")) 
+    ogsGatherScatterVec_add(v, k, type, ogs);
+  else if (!strcmp(op, "mul")) 
+    ogsGatherScatterVec_mul(v, k, type, ogs);
+  else if (!strcmp(op, "min")) 
+    ogsGatherScatterVec_min(v, k, type, ogs);
+  else if (!strcmp(op, "max")) 
+    ogsGatherScatterVec_max(v, k, type, ogs);
+}
+
+void ogsGatherScatterVec_add(void *v, const int k, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherVec_add<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherVec_add<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherVec_add<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherVec_add<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterVec(ogs::hostBuf, k, type, ogsAdd, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterVec_add<float>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterVec_add<double>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterVec_add<int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterVec_add<long long int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterVec<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterVec<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterVec<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterVec<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterVec_mul(void *v, const int k, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherVec_mul<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherVec_mul<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherVec_mul<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherVec_mul<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterVec(ogs::hostBuf, k, type, ogsMul, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterVec_mul<float>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterVec_mul<double>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterVec_mul<int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterVec_mul<long long int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterVec<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterVec<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterVec<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterVec<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterVec_min(void *v, const int k, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherVec_min<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherVec_min<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherVec_min<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherVec_min<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterVec(ogs::hostBuf, k, type, ogsMin, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterVec_min<float>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterVec_min<double>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterVec_min<int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterVec_min<long long int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterVec<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterVec<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterVec<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterVec<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
+}
+
+void ogsGatherScatterVec_max(void *v, const int k, const char *type, ogs_t *ogs){
+
+  if (!strcmp(type, "float")) 
+    gatherVec_max<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)v, (float*)ogs::hostBuf);
+  else if (!strcmp(type, "double")) 
+    gatherVec_max<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)v, (double*)ogs::hostBuf);
+  else if (!strcmp(type, "int")) 
+    gatherVec_max<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)v, (int*)ogs::hostBuf);
+  else if (!strcmp(type, "long long int")) 
+    gatherVec_max<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)v, (long long int*)ogs::hostBuf);
+
+  if (ogs->NhaloGather) {
+    // MPI based gather scatter using gslib
+    ogsHostGatherScatterVec(ogs::hostBuf, k, type, ogsMax, ogs->haloGshSym);
+  }
+
+  if (!strcmp(type, "float")) 
+    gatherScatterVec_max<float>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (float*)v);
+  else if (!strcmp(type, "double")) 
+    gatherScatterVec_max<double>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (double*)v);
+  else if (!strcmp(type, "int")) 
+    gatherScatterVec_max<int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    gatherScatterVec_max<long long int>(ogs->NsharedGather, k, ogs->sharedGatherOffsets,
+                      ogs->sharedGatherIds, (long long int*)v);
+
+  if (!strcmp(type, "float")) 
+    scatterVec<float>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (float*)ogs::hostBuf, (float*)v);
+  else if (!strcmp(type, "double")) 
+    scatterVec<double>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (double*)ogs::hostBuf, (double*)v);
+  else if (!strcmp(type, "int")) 
+    scatterVec<int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (int*)ogs::hostBuf, (int*)v);
+  else if (!strcmp(type, "long long int")) 
+    scatterVec<long long int>(ogs->NhaloGather, k, ogs->haloGatherOffsets,
+                      ogs->haloGatherIds, (long long int*)ogs::hostBuf, (long long int*)v);
 }
 
 void ogsGatherScatterVec(occa::memory o_v, 
@@ -138,6 +138,7 @@ void ogsGatherVec(void *gv,
     if (ogs::hostBufSize < ogs->NhaloGather*Nbytes*k) {
       if (ogs::hostBufSize) free(ogs::hostBuf);
       ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes*k);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes*k;
     }
   }
 
@@ -89,6 +89,23 @@ namespace ogs {
   occa::kernel gatherScatterManyKernel_longMin;
   occa::kernel gatherScatterManyKernel_longMax;
 
+  occa::kernel gatherScatterBlockedKernel_floatAdd;
+  occa::kernel gatherScatterBlockedKernel_floatMul;
+  occa::kernel gatherScatterBlockedKernel_floatMin;
+  occa::kernel gatherScatterBlockedKernel_floatMax;
+  occa::kernel gatherScatterBlockedKernel_doubleAdd;
+  occa::kernel gatherScatterBlockedKernel_doubleMul;
+  occa::kernel gatherScatterBlockedKernel_doubleMin;
+  occa::kernel gatherScatterBlockedKernel_doubleMax;
+  occa::kernel gatherScatterBlockedKernel_intAdd;
+  occa::kernel gatherScatterBlockedKernel_intMul;
+  occa::kernel gatherScatterBlockedKernel_intMin;
+  occa::kernel gatherScatterBlockedKernel_intMax;
+  occa::kernel gatherScatterBlockedKernel_longAdd;
+  occa::kernel gatherScatterBlockedKernel_longMul;
+  occa::kernel gatherScatterBlockedKernel_longMin;
+  occa::kernel gatherScatterBlockedKernel_longMax;
+
   occa::kernel gatherKernel_floatAdd;
   occa::kernel gatherKernel_floatMul;
   occa::kernel gatherKernel_floatMin;
@@ -263,6 +280,26 @@ void ogs::initKernels(MPI_Comm comm, occa::device device) {
 
 
 
+      ogs::gatherScatterBlockedKernel_floatAdd = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_floatAdd", kernelInfo);
+      ogs::gatherScatterBlockedKernel_floatMul = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_floatMul", kernelInfo);
+      ogs::gatherScatterBlockedKernel_floatMin = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_floatMin", kernelInfo);
+      ogs::gatherScatterBlockedKernel_floatMax = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_floatMax", kernelInfo);
+
+      ogs::gatherScatterBlockedKernel_doubleAdd = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_doubleAdd", kernelInfo);
+      ogs::gatherScatterBlockedKernel_doubleMul = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_doubleMul", kernelInfo);
+      ogs::gatherScatterBlockedKernel_doubleMin = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_doubleMin", kernelInfo);
+      ogs::gatherScatterBlockedKernel_doubleMax = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_doubleMax", kernelInfo);
+
+      ogs::gatherScatterBlockedKernel_intAdd = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_intAdd", kernelInfo);
+      ogs::gatherScatterBlockedKernel_intMul = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_intMul", kernelInfo);
+      ogs::gatherScatterBlockedKernel_intMin = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_intMin", kernelInfo);
+      ogs::gatherScatterBlockedKernel_intMax = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_intMax", kernelInfo);
+
+      ogs::gatherScatterBlockedKernel_longAdd = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_longAdd", kernelInfo);
+      ogs::gatherScatterBlockedKernel_longMul = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_longMul", kernelInfo);
+      ogs::gatherScatterBlockedKernel_longMin = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_longMin", kernelInfo);
+      ogs::gatherScatterBlockedKernel_longMax = device.buildKernel(DOGS "/okl/gatherScatterBlocked.okl", "gatherScatterBlocked_longMax", kernelInfo);
+
       ogs::gatherKernel_floatAdd = device.buildKernel(DOGS "/okl/gather.okl", "gather_floatAdd", kernelInfo);
       ogs::gatherKernel_floatMul = device.buildKernel(DOGS "/okl/gather.okl", "gather_floatMul", kernelInfo);
       ogs::gatherKernel_floatMin = device.buildKernel(DOGS "/okl/gather.okl", "gather_floatMin", kernelInfo);
@@ -396,6 +433,23 @@ void ogs::freeKernels() {
   ogs::gatherScatterManyKernel_longMin.free();
   ogs::gatherScatterManyKernel_longMax.free();
 
+  ogs::gatherScatterBlockedKernel_floatAdd.free();
+  ogs::gatherScatterBlockedKernel_floatMul.free();
+  ogs::gatherScatterBlockedKernel_floatMin.free();
+  ogs::gatherScatterBlockedKernel_floatMax.free();
+  ogs::gatherScatterBlockedKernel_doubleAdd.free();
+  ogs::gatherScatterBlockedKernel_doubleMul.free();
+  ogs::gatherScatterBlockedKernel_doubleMin.free();
+  ogs::gatherScatterBlockedKernel_doubleMax.free();
+  ogs::gatherScatterBlockedKernel_intAdd.free();
+  ogs::gatherScatterBlockedKernel_intMul.free();
+  ogs::gatherScatterBlockedKernel_intMin.free();
+  ogs::gatherScatterBlockedKernel_intMax.free();
+  ogs::gatherScatterBlockedKernel_longAdd.free();
+  ogs::gatherScatterBlockedKernel_longMul.free();
+  ogs::gatherScatterBlockedKernel_longMin.free();
+  ogs::gatherScatterBlockedKernel_longMax.free();
+
   ogs::gatherKernel_floatAdd.free();
   ogs::gatherKernel_floatMul.free();
   ogs::gatherKernel_floatMin.free();
@@ -460,5 +514,9 @@ void ogs::freeKernels() {
 
   ogs::o_haloBuf.free();
   ogs::haloBuf = NULL;
+
+  if (ogs::hostBufSize) free(ogs::hostBuf);
+  ogs::hostBuf = NULL;
+  ogs::hostBufSize = 0;
 }
 
@@ -132,6 +132,7 @@ void ogsScatter(void *sv,
     if (ogs::hostBufSize < ogs->NhaloGather*Nbytes) {
       if (ogs::hostBufSize) free(ogs::hostBuf);
       ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes;
     }
   }
 
@@ -155,6 +155,7 @@ void ogsScatterMany(void *sv,
     if (ogs::hostBufSize < ogs->NhaloGather*Nbytes*k) {
       if (ogs::hostBufSize) free(ogs::hostBuf);
       ogs::hostBuf = (void *) malloc(ogs->NhaloGather*Nbytes*k);
+      ogs::hostBufSize = ogs->NhaloGather*Nbytes*k;
     }
   }
 
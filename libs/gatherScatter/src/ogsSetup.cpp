@@ -77,6 +77,7 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
 
   ogs->N = N;
   ogs->comm = comm;
+  ogs->unique = ogsUnique;
 
   int rank, size;
   MPI_Comm_rank(ogs->comm, &rank);
@@ -192,6 +193,32 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
 
   free(localNodes);
 
+  //compressed copy of the local groups with more than one member for the
+  // host gather scatter, singleton groups are a no-op there
+  ogs->NsharedGather = 0;
+  dlong NsharedLocal = 0;
+  for (dlong i=0;i<ogs->NlocalGather;i++) {
+    dlong Nmembers = ogs->localGatherOffsets[i+1]-ogs->localGatherOffsets[i];
+    if (Nmembers>1) {
+      ogs->NsharedGather++;
+      NsharedLocal += Nmembers;
+    }
+  }
+
+  ogs->sharedGatherOffsets = (dlong*) calloc(ogs->NsharedGather+1,sizeof(dlong));
+  ogs->sharedGatherIds     = (dlong*) calloc(NsharedLocal,sizeof(dlong));
+  cnt = 0;
+  for (dlong i=0;i<ogs->NlocalGather;i++) {
+    const dlong start = ogs->localGatherOffsets[i];
+    const dlong end   = ogs->localGatherOffsets[i+1];
+    if (end-start>1) {
+      dlong offset = ogs->sharedGatherOffsets[cnt];
+      for (dlong n=start;n<end;n++)
+        ogs->sharedGatherIds[offset++] = ogs->localGatherIds[n];
+      ogs->sharedGatherOffsets[++cnt] = offset;
+    }
+  }
+
   //-----------Halo GS setup -------------
 
   //set up the halo gatherScatter
@@ -353,6 +380,22 @@ ogs_t *ogsSetup(dlong N, hlong *ids, MPI_Comm &comm,
 
 void ogsFree(ogs_t *ogs) {
 
+  free(ogs->sharedGatherOffsets);
+  free(ogs->sharedGatherIds);
+
+  if (ogs->blocked) {
+    free(ogs->localPairIds);
+    free(ogs->localQuadIds);
+    free(ogs->localRestOffsets);
+    free(ogs->localRestIds);
+    if (ogs->NlocalPairs) ogs->o_localPairIds.free();
+    if (ogs->NlocalQuads) ogs->o_localQuadIds.free();
+    if (ogs->NlocalRest) {
+      ogs->o_localRestOffsets.free();
+      ogs->o_localRestIds.free();
+    }
+  }
+
   if (ogs->Nlocal) {
     free(ogs->localGatherOffsets);
     free(ogs->localGatherIds);
@@ -0,0 +1,114 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "ogs.hpp"
+#include "ogsKernels.hpp"
+
+/*
+  The local gather groups are numbered in order of their first (smallest)
+  local id, i.e. element by element. On hex/quad meshes the groups with
+  more than one member are dominated by face nodes (two members) and edge
+  nodes (four members). Here they are split into dense, fixed width ranges
+  that are gathered and scattered without indirection through offsets, and
+  the remaining groups (vertices, irregular connectivity) stay in CSR form.
+  Singleton groups are dropped since gather-scatter leaves them unchanged.
+*/
+void ogsSetupBlocks(ogs_t *ogs, int verbose){
+
+  if (ogs->blocked) return;
+
+  ogs->NlocalPairs = 0;
+  ogs->NlocalQuads = 0;
+  ogs->NlocalRest  = 0;
+
+  dlong NrestIds = 0;
+  for (dlong g=0;g<ogs->NlocalGather;g++) {
+    const dlong Nmembers = ogs->localGatherOffsets[g+1]-ogs->localGatherOffsets[g];
+
+    if (Nmembers==2)
+      ogs->NlocalPairs++;
+    else if (Nmembers==4)
+      ogs->NlocalQuads++;
+    else if (Nmembers>1) {
+      ogs->NlocalRest++;
+      NrestIds += Nmembers;
+    }
+  }
+
+  ogs->localPairIds     = (dlong*) calloc(2*ogs->NlocalPairs, sizeof(dlong));
+  ogs->localQuadIds     = (dlong*) calloc(4*ogs->NlocalQuads, sizeof(dlong));
+  ogs->localRestOffsets = (dlong*) calloc(ogs->NlocalRest+1,  sizeof(dlong));
+  ogs->localRestIds     = (dlong*) calloc(NrestIds,           sizeof(dlong));
+
+  // keep the element ordering of the groups within each range and store
+  // the members slab-wise so that member n of consecutive groups is contiguous
+  dlong cntPairs = 0, cntQuads = 0, cntRest = 0;
+  for (dlong g=0;g<ogs->NlocalGather;g++) {
+    const dlong start = ogs->localGatherOffsets[g];
+    const dlong end   = ogs->localGatherOffsets[g+1];
+    const dlong Nmembers = end-start;
+
+    if (Nmembers==2) {
+      for (int n=0;n<2;n++)
+        ogs->localPairIds[cntPairs+n*ogs->NlocalPairs] = ogs->localGatherIds[start+n];
+      cntPairs++;
+    } else if (Nmembers==4) {
+      for (int n=0;n<4;n++)
+        ogs->localQuadIds[cntQuads+n*ogs->NlocalQuads] = ogs->localGatherIds[start+n];
+      cntQuads++;
+    } else if (Nmembers>1) {
+      dlong offset = ogs->localRestOffsets[cntRest];
+      for (dlong n=start;n<end;n++)
+        ogs->localRestIds[offset++] = ogs->localGatherIds[n];
+      ogs->localRestOffsets[++cntRest] = offset;
+    }
+  }
+
+  if (ogs->NlocalPairs)
+    ogs->o_localPairIds = ogs->device.malloc(2*ogs->NlocalPairs*sizeof(dlong), ogs->localPairIds);
+  if (ogs->NlocalQuads)
+    ogs->o_localQuadIds = ogs->device.malloc(4*ogs->NlocalQuads*sizeof(dlong), ogs->localQuadIds);
+  if (ogs->NlocalRest) {
+    ogs->o_localRestOffsets = ogs->device.malloc((ogs->NlocalRest+1)*sizeof(dlong), ogs->localRestOffsets);
+    ogs->o_localRestIds     = ogs->device.malloc(NrestIds*sizeof(dlong), ogs->localRestIds);
+  }
+
+  ogs->blocked = 1;
+
+  if (verbose) {
+    int rank;
+    MPI_Comm_rank(ogs->comm, &rank);
+
+    hlong localCounts[4] = {ogs->NlocalGather, ogs->NlocalPairs, ogs->NlocalQuads, ogs->NlocalRest};
+    hlong globalCounts[4];
+    MPI_Reduce(localCounts, globalCounts, 4, MPI_HLONG, MPI_SUM, 0, ogs->comm);
+
+    if (rank==0)
+      printf("ogsSetupBlocks: " hlongFormat " local groups, " hlongFormat " pairs, "
+             hlongFormat " quads, " hlongFormat " in CSR\n",
+             globalCounts[0], globalCounts[1], globalCounts[2], globalCounts[3]);
+  }
+}
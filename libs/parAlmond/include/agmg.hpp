@@ -40,6 +40,28 @@ public:
 
   int ChebyshevIterations;
 
+  //work of one smoothing pass, in units of this level's SpMV
+  dfloat smootherCost=0.;
+
+  //how A was formed from the finer level, replayed when the values are refreshed
+  int agglomerationStride=1;
+  bool tripleProduct=false; //Galerkin product with R instead of one-entry P
+
+  //aggregate of each local row (from coarsening), used for the smoother blocks
+  dlong *blockIds=NULL;
+
+  //block Jacobi data: rows grouped by block, with dense inverted diagonal blocks
+  dlong Nblocks=0;
+  dlong *blockStarts=NULL, *blockRows=NULL, *blockInvStarts=NULL;
+  dfloat *blockInv=NULL;
+  occa::memory o_blockStarts, o_blockRows, o_blockInvStarts, o_blockInv;
+
+  //multicolor Gauss-Seidel data: rows grouped by color of the local graph
+  int Ncolors=0;
+  dlong *colorStarts=NULL, *colorRows=NULL;
+  occa::memory o_colorRows;
+  occa::memory o_diagRowStarts, o_diagCols, o_diagVals;
+
   bool gatherLevel;
   ogs_t *ogs;
   dfloat *Gx, *Sx;
@@ -47,6 +69,7 @@ public:
 
   agmgLevel(parCSR *AA, KrylovType Ktype);
   agmgLevel(parCSR *AA, parCSR *PP, parCSR *RR, KrylovType Ktype);
+  agmgLevel(parCSR *PP, parCSR *RR, KrylovType Ktype); //idle (agglomerated away) level
   ~agmgLevel();
 
   void Ax(dfloat        *x, dfloat        *Ax);
@@ -67,10 +90,19 @@ public:
   void smoothJacobi(dfloat *r, dfloat *x, const bool x_is_zero);
   void smoothDampedJacobi(dfloat *r, dfloat *x, const bool x_is_zero);
   void smoothChebyshev(dfloat *r, dfloat *x, const bool x_is_zero);
+  void smoothFourthKindChebyshev(dfloat *r, dfloat *x, const bool x_is_zero);
+  void smoothBlockJacobi(dfloat *r, dfloat *x, const bool x_is_zero);
+  void smoothGaussSeidel(dfloat *r, dfloat *x, const bool x_is_zero);
 
   void smoothJacobi(occa::memory o_r, occa::memory o_x, bool x_is_zero);
   void smoothDampedJacobi(occa::memory o_r, occa::memory o_x, bool x_is_zero);
   void smoothChebyshev(occa::memory o_r, occa::memory o_x, bool x_is_zero);
+  void smoothFourthKindChebyshev(occa::memory o_r, occa::memory o_x, bool x_is_zero);
+  void smoothBlockJacobi(occa::memory o_r, occa::memory o_x, bool x_is_zero);
+  void smoothGaussSeidel(occa::memory o_r, occa::memory o_x, bool x_is_zero);
+
+  void blockJacobi(dfloat alpha, dfloat *x, dfloat beta, dfloat *y);
+  void gaussSeidelSweeps(dfloat *r, dfloat *d);
 
   void Report();
 };
@@ -91,14 +123,29 @@ parCSR *constructProlongation(parCSR *A, hlong *FineToCoarse,
 parCSR *transpose(parCSR *A);
 
 parCSR *galerkinProd(parCSR *A, parCSR *P);
+parCSR *galerkinProd(parCSR *A, parCSR *P, parCSR *R);
 
+parCSR *SpMM(parCSR *A, parCSR *B);
 
+parCSR *smoothProlongation(parCSR *A, parCSR *C, parCSR *T);
 
-void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations);
+int agglomeratePartition(hlong *globalAggStarts, MPI_Comm comm, setupAide options);
+
+parCSR *agglomerateMatrix(parCSR *A, int stride, MPI_Comm *subComm);
+
+
+
+void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations, int blockJacobiSize);
+
+void setupAgmgBlocks(agmgLevel *level, int blockJacobiSize);
+void invertAgmgBlocks(agmgLevel *level);
+void setupAgmgColors(agmgLevel *level);
 
 void allocateAgmgVectors(agmgLevel *level, int k, int numLevels, CycleType ctype);
 
-void syncAgmgToDevice(agmgLevel *level, int k, int numLevels, CycleType ctype);
+void syncAgmgToDevice(agmgLevel *level, int k, int numLevels, CycleType ctype, SpMVFormat format);
+
+void refreshAgmgSmoother(agmgLevel *level);
 
 }
 
@@ -37,13 +37,23 @@ SOFTWARE.
 #define COARSENTHREASHOLD 0.5
 #define KCYCLETOL 0.2
 
+#define AGGLOMERATION_ROWS 100 //default min rows per rank before a coarse level is agglomerated
+
+#define SELL_C 32          //slice height of the SELL-C-sigma format
+#define SELL_SIGMA 256     //window in which rows are sorted by length
+#define SELL_SWITCH 1.2    //auto-select SELL when ELL padding is this much larger
+
+#define CHEBYSHEV_LMIN_SAFETY 0.5 //scale on the Lanczos lmin, Ritz values overestimate it
+#define CHEBYSHEV_MAX_RATIO 30.   //largest lambda1/lambda0 so the smoother still targets the top of the spectrum
+
 namespace parAlmond {
 
 extern int ChebyshevIterations;
 
 typedef enum {VCYCLE=0,KCYCLE=1,EXACT=3} CycleType;
 typedef enum {PCG=0,GMRES=1} KrylovType;
-typedef enum {JACOBI=0,DAMPED_JACOBI=1,CHEBYSHEV=2} SmoothType;
+typedef enum {JACOBI=0,DAMPED_JACOBI=1,CHEBYSHEV=2,CHEBYSHEV4=3,BLOCK_JACOBI=4,GAUSS_SEIDEL=5} SmoothType;
+typedef enum {FORMAT_AUTO=0,FORMAT_ELL=1,FORMAT_SELL=2} SpMVFormat;
 
 } //namespace parAlmond
 
@@ -41,6 +41,8 @@ namespace parAlmond {
   extern occa::kernel SpMVcsrKernel2;
   extern occa::kernel SpMVellKernel1;
   extern occa::kernel SpMVellKernel2;
+  extern occa::kernel SpMVsellKernel1;
+  extern occa::kernel SpMVsellKernel2;
   extern occa::kernel SpMVmcsrKernel1;
   extern occa::kernel SpMVmcsrKernel2;
 
@@ -59,6 +61,9 @@ namespace parAlmond {
   extern occa::kernel kcycleWeightedCombinedOp1Kernel;
   extern occa::kernel kcycleWeightedCombinedOp2Kernel;
 
+  extern occa::kernel blockJacobiKernel;
+  extern occa::kernel gaussSeidelColorKernel;
+
 } //namespace parAlmond
 
 #endif
\ No newline at end of file
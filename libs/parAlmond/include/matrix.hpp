@@ -88,6 +88,36 @@ public:
   void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
 };
 
+//sliced ELL (SELL-C-sigma). Rows are sorted by length inside windows of
+// SELL_SIGMA rows and stored in slices of SELL_C rows, each slice padded
+// to its own longest row and stored column-major
+class SELL: public matrix_t {
+
+public:
+  dlong Nslices;
+  dlong nnz; //padded storage size
+
+  dlong  *rowPerm=NULL;     //original row of each sorted row
+  dlong  *sliceStarts=NULL;
+  dlong  *cols=NULL;
+  dfloat *vals=NULL;
+
+  occa::memory o_rowPerm;
+  occa::memory o_sliceStarts;
+  occa::memory o_cols;
+  occa::memory o_vals;
+
+  SELL(CSR *A);
+  ~SELL();
+
+  void syncToDevice(occa::device device);
+
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, dfloat *y);
+  void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, const dfloat *y, dfloat *z);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, const occa::memory o_y);
+  void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, occa::memory o_y, occa::memory o_z);
+};
+
 class MCSR: public matrix_t {
 
 public:
@@ -134,6 +164,10 @@ public:
   dfloat *null=NULL;
   occa::memory o_null;
 
+  //near-nullspace used to build the tentative prolongator (when more than one vector)
+  int NnullVectors=1;
+  dfloat *nullVectors=NULL; //NnullVectors entries per row
+
   //partition info
   MPI_Comm comm;
   hlong *globalRowStarts=NULL;
@@ -176,7 +210,23 @@ public:
   void haloExchangeStart (occa::memory o_x);
   void haloExchangeFinish(occa::memory o_x);
 
+  //overwrite the values with those of B, a matrix on the same partition.
+  // Entries of B outside this sparsity pattern are dropped
+  void copyValues(parCSR *B);
+
+  //recompute diagA and diagInv from the current values
+  void refreshDiagonal();
+
+  //spectral radius of invD*A, also for nonsymmetric A
   dfloat rhoDinvA();
+  void boundsDinvA(dfloat *lmin, dfloat *lmax);
+
+  //spectral radius of S*A for a symmetric smoother S
+  dfloat rhoSA(void (*S)(void *ctx, dfloat *r, dfloat *z), void *ctx, const char *tag);
+
+  //estimated extremal eigenvalues of S*A for a symmetric smoother S
+  void boundsSA(void (*S)(void *ctx, dfloat *r, dfloat *z), void *ctx, const char *tag,
+                dfloat *lmin, dfloat *lmax);
 
   void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, dfloat *y);
   void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, const dfloat *y, dfloat *z);
@@ -190,6 +240,7 @@ class parHYB: public matrix_t {
 public:
 
   ELL  *E;
+  SELL *S=NULL; //replaces E when the local rows are uneven
   MCSR *C;
 
   dfloat *diagA=NULL;
@@ -221,7 +272,7 @@ public:
   occa::device device;
 
   parHYB(dlong N=0, dlong M=0);
-  parHYB(parCSR *A); //build from parCSR
+  parHYB(parCSR *A, SpMVFormat format=FORMAT_AUTO); //build from parCSR
 
   ~parHYB();
 
@@ -232,6 +283,9 @@ public:
 
   void syncToDevice();
 
+  //repack the values of the parCSR this was built from and copy them to the device
+  void refreshValues(parCSR *A);
+
   void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, dfloat *y);
   void SpMV(const dfloat alpha,        dfloat *x, const dfloat beta, const dfloat *y, dfloat *z);
   void SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta, const occa::memory o_y);
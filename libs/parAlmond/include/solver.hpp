@@ -42,6 +42,7 @@ public:
   CycleType    ctype;
   KrylovType   ktype;
   SmoothType stype;
+  SpMVFormat format;
 
   int numLevels;
   int AMGstartLev, baseLevel;
@@ -50,6 +51,7 @@ public:
   coarseSolver *coarseLevel;
 
   int ChebyshevIterations;
+  int blockJacobiSize;
 
   solver_t(occa::device otherdevice, MPI_Comm othercomm,
                          setupAide otheroptions);
@@ -57,6 +59,7 @@ public:
   ~solver_t();
 
   void AMGSetup(parCSR *A);
+  void AMGRefresh(parCSR *A);
 
   void Report();
 
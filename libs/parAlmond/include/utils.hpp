@@ -94,12 +94,24 @@ extern "C"{
   void dgetri_(int* N, double* A, int* lda, int* IPIV, double* WORK, int* lwork, int* INFO);
   void dgeev_(char *JOBVL, char *JOBVR, int *N, double *A, int *LDA, double *WR, double *WI,
   double *VL, int *LDVL, double *VR, int *LDVR, double *WORK, int *LWORK, int *INFO );
+  void dstev_(char *JOBZ, int *N, double *D, double *E, double *Z, int *LDZ, double *WORK, int *INFO);
 }
 
 void eig(const int Nrows, double *A, double *WR, double *WI);
 
 void matrixInverse(int N, dfloat *A);
 
+//extremal eigenvalue estimates of a preconditioned operator from k PCG steps
+void lanczosBounds(int k, dfloat *alpha, dfloat *beta, dfloat *lmin, dfloat *lmax);
+
+//spectral bounds cache, reused across solver setups with the same operator
+bool spectralBoundsLookup(const char *key, dfloat *lmin, dfloat *lmax);
+void spectralBoundsStore(const char *key, dfloat lmin, dfloat lmax);
+void spectralBoundsClear();
+
+//lower end of the first-kind Chebyshev interval from the estimated bounds of S*A
+dfloat chebyshevLowerBound(dfloat lmin, dfloat lmax);
+
 } //namespace parAlmond
 
 #endif
\ No newline at end of file
@@ -60,6 +60,29 @@ void AMGSetup(solver_t* M,
              bool nullSpace,
              dfloat nullSpacePenalty);
 
+//AMG setup with a multi-vector near-nullspace (e.g. rigid body modes)
+void AMGSetup(solver_t* M,
+             hlong* rowStarts,
+             dlong nnz,
+             hlong* Ai,
+             hlong* Aj,
+             dfloat* Avals,
+             bool nullSpace,
+             dfloat nullSpacePenalty,
+             int NnullVectors,
+             dfloat *nullVectors);
+
+//refresh the values of an existing hierarchy when only the operator
+// coefficients changed. The sparsity pattern of A must be unchanged
+void AMGRefresh(solver_t* M,
+               hlong* rowStarts,
+               dlong nnz,
+               hlong* Ai,
+               hlong* Aj,
+               dfloat* Avals,
+               bool nullSpace,
+               dfloat nullSpacePenalty);
+
 void Precon(solver_t* M, occa::memory o_x, occa::memory o_rhs);
 
 void Report(solver_t *M);
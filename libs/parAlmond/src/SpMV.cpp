@@ -164,6 +164,85 @@ void ELL::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
   }
 }
 
+//------------------------------------------------------------------------
+//
+//  SELL-C-sigma matrix
+//
+//------------------------------------------------------------------------
+void SELL::SpMV(const dfloat alpha, dfloat *x,
+                const dfloat beta, dfloat *y) {
+  // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  #pragma omp parallel for
+  for(dlong s=0; s<Nslices; s++){
+    const dlong start = sliceStarts[s];
+    const dlong width = (sliceStarts[s+1]-start)/SELL_C;
+
+    dfloat result[SELL_C];
+    for(int r=0; r<SELL_C; r++) result[r] = 0.0;
+
+    for(dlong c=0; c<width; c++) {
+      const dlong *colsc = cols + start + c*SELL_C;
+      const dfloat *valsc = vals + start + c*SELL_C;
+      #pragma omp simd
+      for(int r=0; r<SELL_C; r++)
+        result[r] += valsc[r]*x[colsc[r]];
+    }
+
+    for(int r=0; r<SELL_C; r++) {
+      const dlong p = s*SELL_C+r;
+      if (p<Nrows) {
+        const dlong row = rowPerm[p];
+        y[row] = (beta) ? alpha*result[r] + beta*y[row] : alpha*result[r];
+      }
+    }
+  }
+}
+
+void SELL::SpMV(const dfloat alpha, dfloat *x,
+                const dfloat beta, const dfloat *y, dfloat *z) {
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  #pragma omp parallel for
+  for(dlong s=0; s<Nslices; s++){
+    const dlong start = sliceStarts[s];
+    const dlong width = (sliceStarts[s+1]-start)/SELL_C;
+
+    dfloat result[SELL_C];
+    for(int r=0; r<SELL_C; r++) result[r] = 0.0;
+
+    for(dlong c=0; c<width; c++) {
+      const dlong *colsc = cols + start + c*SELL_C;
+      const dfloat *valsc = vals + start + c*SELL_C;
+      #pragma omp simd
+      for(int r=0; r<SELL_C; r++)
+        result[r] += valsc[r]*x[colsc[r]];
+    }
+
+    for(int r=0; r<SELL_C; r++) {
+      const dlong p = s*SELL_C+r;
+      if (p<Nrows) {
+        const dlong row = rowPerm[p];
+        z[row] = alpha*result[r] + beta*y[row];
+      }
+    }
+  }
+}
+
+void SELL::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+                occa::memory o_y) {
+  // y[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  if (Nrows)
+    SpMVsellKernel1(Nrows, alpha, beta,
+                    o_sliceStarts, o_rowPerm, o_cols, o_vals, o_x, o_y);
+}
+
+void SELL::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
+                occa::memory o_y, occa::memory o_z) {
+  // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
+  if (Nrows)
+    SpMVsellKernel2(Nrows, alpha, beta,
+                    o_sliceStarts, o_rowPerm, o_cols, o_vals, o_x, o_y, o_z);
+}
+
 //------------------------------------------------------------------------
 //
 //  MCSR matrix
@@ -324,7 +403,8 @@ void parHYB::SpMV(const dfloat alpha, dfloat *x,
   this->haloExchangeStart(x);
 
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  E->SpMV(alpha, x, beta, y);
+  if (S) S->SpMV(alpha, x, beta, y);
+  else   E->SpMV(alpha, x, beta, y);
 
   this->haloExchangeFinish(x);
 
@@ -343,7 +423,8 @@ void parHYB::SpMV(const dfloat alpha, dfloat *x,
   this->haloExchangeStart(x);
 
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  E->SpMV(alpha, x, beta, y, z);
+  if (S) S->SpMV(alpha, x, beta, y, z);
+  else   E->SpMV(alpha, x, beta, y, z);
 
   this->haloExchangeFinish(x);
 
@@ -362,7 +443,8 @@ void parHYB::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
   this->haloExchangeStart(o_x);
 
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  E->SpMV(alpha, o_x, beta, o_y);
+  if (S) S->SpMV(alpha, o_x, beta, o_y);
+  else   E->SpMV(alpha, o_x, beta, o_y);
 
   this->haloExchangeFinish(o_x);
 
@@ -381,7 +463,8 @@ void parHYB::SpMV(const dfloat alpha, occa::memory o_x, const dfloat beta,
   this->haloExchangeStart(o_x);
 
   // z[i] = beta*y[i] + alpha* (sum_{ij} Aij*x[j])
-  E->SpMV(alpha, o_x, beta, o_y, o_z);
+  if (S) S->SpMV(alpha, o_x, beta, o_y, o_z);
+  else   E->SpMV(alpha, o_x, beta, o_y, o_z);
 
   this->haloExchangeFinish(o_x);
 
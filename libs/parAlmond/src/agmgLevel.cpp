@@ -51,11 +51,34 @@ agmgLevel::agmgLevel(parCSR *A_, parCSR *P_, parCSR *R_, KrylovType ktype_):
   R = R_;
 }
 
+//level on a rank which owns no coarse rows after agglomeration. Only
+// P and R are kept so the rank can take part in restriction and prolongation.
+agmgLevel::agmgLevel(parCSR *P_, parCSR *R_, KrylovType ktype_):
+  multigridLevel(0, P_->Ncols, ktype_, MPI_COMM_NULL) {
+
+  weighted = false;
+  gatherLevel = false;
+
+  A = NULL;
+  P = P_;
+  R = R_;
+
+  o_A = NULL;
+}
+
 agmgLevel::~agmgLevel() {
 
   delete   A; delete   P; delete   R;
   delete o_A; delete o_P; delete o_R;
 
+  if (blockIds)       free(blockIds);
+  if (blockStarts)    free(blockStarts);
+  if (blockRows)      free(blockRows);
+  if (blockInvStarts) free(blockInvStarts);
+  if (blockInv)       free(blockInv);
+  if (colorStarts)    free(colorStarts);
+  if (colorRows)      free(colorRows);
+
 }
 
 void agmgLevel::Ax        (dfloat *x, dfloat *Ax){ A->SpMV(1.0, x, 0.0, Ax); }
@@ -113,6 +136,12 @@ void agmgLevel::smooth(dfloat *rhs, dfloat *x, bool x_is_zero){
     this->smoothDampedJacobi(rhs, x, x_is_zero);
   } else if(stype == CHEBYSHEV){
     this->smoothChebyshev(rhs, x, x_is_zero);
+  } else if(stype == CHEBYSHEV4){
+    this->smoothFourthKindChebyshev(rhs, x, x_is_zero);
+  } else if(stype == BLOCK_JACOBI){
+    this->smoothBlockJacobi(rhs, x, x_is_zero);
+  } else if(stype == GAUSS_SEIDEL){
+    this->smoothGaussSeidel(rhs, x, x_is_zero);
   }
 }
 
@@ -123,6 +152,12 @@ void agmgLevel::smooth(occa::memory o_rhs, occa::memory o_x, bool x_is_zero){
     this->smoothDampedJacobi(o_rhs, o_x, x_is_zero);
   } else if(stype == CHEBYSHEV){
     this->smoothChebyshev(o_rhs, o_x, x_is_zero);
+  } else if(stype == CHEBYSHEV4){
+    this->smoothFourthKindChebyshev(o_rhs, o_x, x_is_zero);
+  } else if(stype == BLOCK_JACOBI){
+    this->smoothBlockJacobi(o_rhs, o_x, x_is_zero);
+  } else if(stype == GAUSS_SEIDEL){
+    this->smoothGaussSeidel(o_rhs, o_x, x_is_zero);
   }
 }
 
@@ -175,10 +210,16 @@ void agmgLevel::Report() {
     strcpy(smootherString, "Damped Jacobi   ");
   else if (stype==CHEBYSHEV)
     strcpy(smootherString, "Chebyshev       ");
+  else if (stype==CHEBYSHEV4)
+    strcpy(smootherString, "Chebyshev (4th) ");
+  else if (stype==BLOCK_JACOBI)
+    strcpy(smootherString, "Block Jacobi    ");
+  else if (stype==GAUSS_SEIDEL)
+    strcpy(smootherString, "Multicolor SGS  ");
 
   if (rank==0){
     printf(     "|  parAlmond |  %12d  | %13d   |   %s|\n", minNrows, (int)minNnzPerRow, smootherString);
-    printf("     |            |  %12d  | %13d   |                   |\n", maxNrows, (int)maxNnzPerRow);
+    printf("     |            |  %12d  | %13d   |   %6.2f SpMVs    |\n", maxNrows, (int)maxNnzPerRow, smootherCost);
     printf("     |            |  %12d  | %13d   |                   |\n", (int)avgNrows, (int)avgNnzPerRow);
   }
 }
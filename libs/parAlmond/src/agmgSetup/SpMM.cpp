@@ -0,0 +1,306 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+
+namespace parAlmond {
+
+//fetch the rows of B matching the halo columns of A (in colMap order)
+static void fetchHaloRows(parCSR *A, parCSR *B,
+                          dlong **haloRowStarts, nonzero_t **haloNonZeros,
+                          MPI_Datatype MPI_NONZERO_T) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  const dlong NhaloCols = A->Ncols - A->NlocalCols;
+  hlong *haloCols = A->colMap + A->NlocalCols; //sorted global ids
+
+  const hlong globalOffset = B->globalRowStarts[rank];
+
+  int *sendCounts  = (int *) calloc(size,sizeof(int));
+  int *recvCounts  = (int *) calloc(size,sizeof(int));
+  int *sendOffsets = (int *) calloc(size+1,sizeof(int));
+  int *recvOffsets = (int *) calloc(size+1,sizeof(int));
+
+  //request the rows from their owners
+  int r=0;
+  for (dlong n=0;n<NhaloCols;n++) {
+    while(haloCols[n]>=B->globalRowStarts[r+1]) r++;
+    sendCounts[r]++;
+  }
+
+  MPI_Alltoall(sendCounts, 1, MPI_INT,
+               recvCounts, 1, MPI_INT, A->comm);
+
+  for (r=0;r<size;r++) {
+    sendOffsets[r+1] = sendOffsets[r]+sendCounts[r];
+    recvOffsets[r+1] = recvOffsets[r]+recvCounts[r];
+  }
+  const dlong Nrequests = recvOffsets[size];
+
+  hlong *requests = (hlong *) calloc(Nrequests+1,sizeof(hlong));
+  MPI_Alltoallv(haloCols, sendCounts, sendOffsets, MPI_HLONG,
+                requests, recvCounts, recvOffsets, MPI_HLONG,
+                A->comm);
+
+  //reply with the row lengths
+  int *requestNnz  = (int *) calloc(Nrequests+1,sizeof(int));
+  int *haloRowNnz  = (int *) calloc(NhaloCols+1,sizeof(int));
+  for (dlong n=0;n<Nrequests;n++) {
+    dlong row = (dlong) (requests[n]-globalOffset);
+    requestNnz[n] = (B->diag->rowStarts[row+1]-B->diag->rowStarts[row])
+                   +(B->offd->rowStarts[row+1]-B->offd->rowStarts[row]);
+  }
+
+  MPI_Alltoallv(requestNnz, recvCounts, recvOffsets, MPI_INT,
+                haloRowNnz, sendCounts, sendOffsets, MPI_INT,
+                A->comm);
+
+  //send the rows
+  int *sendNnzCounts  = (int *) calloc(size,sizeof(int));
+  int *recvNnzCounts  = (int *) calloc(size,sizeof(int));
+  int *sendNnzOffsets = (int *) calloc(size+1,sizeof(int));
+  int *recvNnzOffsets = (int *) calloc(size+1,sizeof(int));
+
+  for (r=0;r<size;r++) {
+    for (dlong n=recvOffsets[r];n<recvOffsets[r+1];n++) sendNnzCounts[r] += requestNnz[n];
+    for (dlong n=sendOffsets[r];n<sendOffsets[r+1];n++) recvNnzCounts[r] += haloRowNnz[n];
+    sendNnzOffsets[r+1] = sendNnzOffsets[r]+sendNnzCounts[r];
+    recvNnzOffsets[r+1] = recvNnzOffsets[r]+recvNnzCounts[r];
+  }
+
+  nonzero_t *sendNonZeros = (nonzero_t *) calloc(sendNnzOffsets[size]+1,sizeof(nonzero_t));
+  dlong cnt=0;
+  for (dlong n=0;n<Nrequests;n++) {
+    dlong row = (dlong) (requests[n]-globalOffset);
+    for (dlong j=B->diag->rowStarts[row];j<B->diag->rowStarts[row+1];j++) {
+      sendNonZeros[cnt].row = requests[n];
+      sendNonZeros[cnt].col = B->diag->cols[j] + B->globalColStarts[rank];
+      sendNonZeros[cnt].val = B->diag->vals[j];
+      cnt++;
+    }
+    for (dlong j=B->offd->rowStarts[row];j<B->offd->rowStarts[row+1];j++) {
+      sendNonZeros[cnt].row = requests[n];
+      sendNonZeros[cnt].col = B->colMap[B->offd->cols[j]];
+      sendNonZeros[cnt].val = B->offd->vals[j];
+      cnt++;
+    }
+  }
+
+  *haloNonZeros = (nonzero_t *) calloc(recvNnzOffsets[size]+1,sizeof(nonzero_t));
+  MPI_Alltoallv(sendNonZeros, sendNnzCounts, sendNnzOffsets, MPI_NONZERO_T,
+                *haloNonZeros, recvNnzCounts, recvNnzOffsets, MPI_NONZERO_T,
+                A->comm);
+
+  //the replies arrive in request order, i.e. in halo column order
+  *haloRowStarts = (dlong *) calloc(NhaloCols+1,sizeof(dlong));
+  for (dlong n=0;n<NhaloCols;n++)
+    (*haloRowStarts)[n+1] = (*haloRowStarts)[n] + haloRowNnz[n];
+
+  MPI_Barrier(A->comm);
+  free(requests); free(requestNnz); free(haloRowNnz);
+  free(sendNonZeros);
+  free(sendCounts); free(recvCounts);
+  free(sendOffsets); free(recvOffsets);
+  free(sendNnzCounts); free(recvNnzCounts);
+  free(sendNnzOffsets); free(recvNnzOffsets);
+}
+
+//distributed sparse matrix-matrix product C = A*B. The rows of B must be
+// partitioned like the columns of A. C has the row partition of A and
+// the column partition of B.
+parCSR *SpMM(parCSR *A, parCSR *B) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  // Make the MPI_NONZERO_T data type
+  nonzero_t NZ;
+  MPI_Datatype MPI_NONZERO_T;
+  MPI_Datatype dtype[3] = {MPI_HLONG, MPI_HLONG, MPI_DFLOAT};
+  int blength[3] = {1, 1, 1};
+  MPI_Aint addr[3], displ[3];
+  MPI_Get_address ( &(NZ.row), addr+0);
+  MPI_Get_address ( &(NZ.col), addr+1);
+  MPI_Get_address ( &(NZ.val), addr+2);
+  displ[0] = 0;
+  displ[1] = addr[1] - addr[0];
+  displ[2] = addr[2] - addr[0];
+  MPI_Type_create_struct (3, blength, displ, dtype, &MPI_NONZERO_T);
+  MPI_Type_commit (&MPI_NONZERO_T);
+
+  dlong *haloRowStarts;
+  nonzero_t *haloNonZeros;
+  fetchHaloRows(A, B, &haloRowStarts, &haloNonZeros, MPI_NONZERO_T);
+
+  const dlong N = A->Nrows;
+  const dlong NlocalCols = A->NlocalCols;
+  const hlong globalRowOffset = A->globalRowStarts[rank];
+  const hlong globalColOffset = B->globalColStarts[rank];
+
+  //longest row of B seen by this rank
+  dlong maxRowNnz = 0;
+  for (dlong i=0;i<B->Nrows;i++) {
+    dlong nnz = (B->diag->rowStarts[i+1]-B->diag->rowStarts[i])
+               +(B->offd->rowStarts[i+1]-B->offd->rowStarts[i]);
+    maxRowNnz = (nnz>maxRowNnz) ? nnz : maxRowNnz;
+  }
+  for (dlong n=0;n<A->Ncols-NlocalCols;n++) {
+    dlong nnz = haloRowStarts[n+1]-haloRowStarts[n];
+    maxRowNnz = (nnz>maxRowNnz) ? nnz : maxRowNnz;
+  }
+
+  dlong Cmax = N*maxRowNnz + 1;
+  nonzero_t *Cnz = (nonzero_t *) malloc(Cmax*sizeof(nonzero_t));
+  nonzero_t *rowNz = NULL;
+  dlong rowMax = 0;
+
+  dlong Cnnz = 0;
+  for (dlong i=0;i<N;i++) {
+    const dlong Arow = (A->diag->rowStarts[i+1]-A->diag->rowStarts[i])
+                      +(A->offd->rowStarts[i+1]-A->offd->rowStarts[i]);
+    if (Arow*maxRowNnz>rowMax) {
+      rowMax = Arow*maxRowNnz;
+      rowNz = (nonzero_t *) realloc(rowNz, rowMax*sizeof(nonzero_t));
+    }
+
+    //expand row i of A*B
+    dlong cnt = 0;
+    for (int block=0;block<2;block++) {
+      CSR *Ablock = (block==0) ? A->diag : A->offd;
+      for (dlong jj=Ablock->rowStarts[i];jj<Ablock->rowStarts[i+1];jj++) {
+        const dlong  col = Ablock->cols[jj];
+        const dfloat val = Ablock->vals[jj];
+
+        if (col<NlocalCols) {
+          for (dlong k=B->diag->rowStarts[col];k<B->diag->rowStarts[col+1];k++) {
+            rowNz[cnt].col = B->diag->cols[k] + globalColOffset;
+            rowNz[cnt].val = val*B->diag->vals[k];
+            cnt++;
+          }
+          for (dlong k=B->offd->rowStarts[col];k<B->offd->rowStarts[col+1];k++) {
+            rowNz[cnt].col = B->colMap[B->offd->cols[k]];
+            rowNz[cnt].val = val*B->offd->vals[k];
+            cnt++;
+          }
+        } else {
+          const dlong h = col-NlocalCols;
+          for (dlong k=haloRowStarts[h];k<haloRowStarts[h+1];k++) {
+            rowNz[cnt].col = haloNonZeros[k].col;
+            rowNz[cnt].val = val*haloNonZeros[k].val;
+            cnt++;
+          }
+        }
+      }
+    }
+
+    for (dlong k=0;k<cnt;k++) rowNz[k].row = i + globalRowOffset;
+    qsort(rowNz, cnt, sizeof(nonzero_t), compareNonZeroByRow);
+
+    //compress
+    dlong rowNnz = 0;
+    for (dlong k=0;k<cnt;k++) {
+      if (rowNnz && (rowNz[k].col==Cnz[Cnnz+rowNnz-1].col)) {
+        Cnz[Cnnz+rowNnz-1].val += rowNz[k].val;
+      } else {
+        if (Cnnz+rowNnz==Cmax) {
+          Cmax *= 2;
+          Cnz = (nonzero_t *) realloc(Cnz, Cmax*sizeof(nonzero_t));
+        }
+        Cnz[Cnnz+rowNnz] = rowNz[k];
+        rowNnz++;
+      }
+    }
+    Cnnz += rowNnz;
+  }
+
+  free(rowNz);
+  free(haloRowStarts);
+  free(haloNonZeros);
+
+  //assemble C
+  const dlong NCcols = (dlong) (B->globalColStarts[rank+1]-B->globalColStarts[rank]);
+  parCSR *C = new parCSR(N, NCcols, A->comm, A->device);
+
+  C->globalRowStarts = A->globalRowStarts;
+  C->globalColStarts = B->globalColStarts;
+
+  C->diag->rowStarts = (dlong *) calloc(N+1, sizeof(dlong));
+  C->offd->rowStarts = (dlong *) calloc(N+1, sizeof(dlong));
+
+  for (dlong n=0;n<Cnnz;n++) {
+    dlong row = (dlong) (Cnz[n].row - globalRowOffset);
+    if ((Cnz[n].col>globalColOffset-1)&&(Cnz[n].col<globalColOffset+NCcols))
+      C->diag->rowStarts[row+1]++;
+    else
+      C->offd->rowStarts[row+1]++;
+  }
+  for(dlong i=0; i<N; i++) {
+    C->diag->rowStarts[i+1] += C->diag->rowStarts[i];
+    C->offd->rowStarts[i+1] += C->offd->rowStarts[i];
+  }
+  C->diag->nnz = C->diag->rowStarts[N];
+  C->offd->nnz = C->offd->rowStarts[N];
+
+  // Halo setup
+  hlong *colIds = (hlong *) malloc((C->offd->nnz+1)*sizeof(hlong));
+  dlong cnt=0;
+  for (dlong n=0;n<Cnnz;n++) {
+    if ((Cnz[n].col<globalColOffset)||(Cnz[n].col>globalColOffset+NCcols-1))
+      colIds[cnt++] = Cnz[n].col;
+  }
+  C->haloSetup(colIds);
+
+  C->diag->cols = (dlong *)  calloc(C->diag->nnz, sizeof(dlong));
+  C->diag->vals = (dfloat *) calloc(C->diag->nnz, sizeof(dfloat));
+  C->offd->cols = (dlong *)  calloc(C->offd->nnz, sizeof(dlong));
+  C->offd->vals = (dfloat *) calloc(C->offd->nnz, sizeof(dfloat));
+
+  dlong diagCnt = 0;
+  dlong offdCnt = 0;
+  for (dlong n=0;n<Cnnz;n++) {
+    if ((Cnz[n].col>globalColOffset-1)&&(Cnz[n].col<globalColOffset+NCcols)) {
+      C->diag->cols[diagCnt  ] = (dlong) (Cnz[n].col - globalColOffset); //local index
+      C->diag->vals[diagCnt++] = Cnz[n].val;
+    } else {
+      C->offd->cols[offdCnt  ] = colIds[offdCnt];
+      C->offd->vals[offdCnt++] = Cnz[n].val;
+    }
+  }
+
+  //clean up
+  MPI_Barrier(A->comm);
+  MPI_Type_free(&MPI_NONZERO_T);
+  free(colIds);
+  free(Cnz);
+
+  return C;
+}
+
+} //namespace parAlmond
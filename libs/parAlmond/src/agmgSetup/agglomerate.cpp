@@ -0,0 +1,136 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+
+namespace parAlmond {
+
+//Decide whether a coarse level is too small to stay spread across every
+// rank of comm. If so, merge the aggregate ownership of each group of
+// 'stride' consecutive ranks onto the first rank in the group by rewriting
+// globalAggStarts in place. The aggregate ids themselves are unchanged, so
+// P, R, and the Galerkin product route data to the owning ranks without
+// further bookkeeping. Returns the stride (1 means no agglomeration).
+int agglomeratePartition(hlong *globalAggStarts, MPI_Comm comm, setupAide options) {
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  if (size==1) return 1;
+
+  //minimum number of rows per rank before a level is agglomerated
+  int minRows = AGGLOMERATION_ROWS;
+  options.getArgs("PARALMOND AGGLOMERATION ROWS", minRows);
+  if (minRows<=0) return 1;
+
+  hlong globalCoarseSize = globalAggStarts[size];
+
+  int newSize = (int) ((globalCoarseSize+minRows-1)/minRows);
+  if (newSize<1) newSize = 1;
+  if (newSize>=size) return 1;
+
+  const int stride = (size+newSize-1)/newSize;
+  if (stride==1) return 1;
+
+  //each rank r owns the aggregates of ranks [r, r+stride) if r%stride==0, else nothing
+  hlong *oldStarts = (hlong *) malloc((size+1)*sizeof(hlong));
+  memcpy(oldStarts, globalAggStarts, (size+1)*sizeof(hlong));
+
+  for (int r=0;r<size+1;r++) {
+    int owner = ((r+stride-1)/stride)*stride;
+    if (owner>size) owner = size;
+    globalAggStarts[r] = oldStarts[owner];
+  }
+
+  free(oldStarts);
+  return stride;
+}
+
+//Move an agglomerated coarse operator onto the sub-communicator of the
+// ranks which own its rows. Idle ranks (those with rank%stride!=0) get
+// MPI_COMM_NULL and a NULL matrix.
+parCSR *agglomerateMatrix(parCSR *A, int stride, MPI_Comm *subComm) {
+
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  const int active = (rank%stride==0);
+
+  MPI_Comm_split(A->comm, active ? 0 : MPI_UNDEFINED, rank, subComm);
+
+  if (!active) return NULL;
+
+  int subSize;
+  MPI_Comm_size(*subComm, &subSize);
+
+  //the active ranks keep their order, so the sub partition is a subset of the parent one
+  hlong *subStarts = (hlong *) calloc(subSize+1,sizeof(hlong));
+  for (int s=0;s<subSize+1;s++) {
+    int r = s*stride;
+    if (r>size) r = size;
+    subStarts[s] = A->globalRowStarts[r];
+  }
+
+  //collect the local entries in COO form (grouped by row)
+  const dlong N = A->Nrows;
+  const dlong nnz = A->diag->nnz + A->offd->nnz;
+  const hlong globalOffset = A->globalRowStarts[rank];
+
+  hlong  *Ai   = (hlong *)  malloc((nnz ? nnz : 1)*sizeof(hlong));
+  hlong  *Aj   = (hlong *)  malloc((nnz ? nnz : 1)*sizeof(hlong));
+  dfloat *vals = (dfloat *) malloc((nnz ? nnz : 1)*sizeof(dfloat));
+
+  dlong cnt = 0;
+  for (dlong n=0;n<N;n++) {
+    for (dlong j=A->diag->rowStarts[n];j<A->diag->rowStarts[n+1];j++) {
+      Ai[cnt]   = n + globalOffset;
+      Aj[cnt]   = A->diag->cols[j] + globalOffset;
+      vals[cnt] = A->diag->vals[j];
+      cnt++;
+    }
+    for (dlong j=A->offd->rowStarts[n];j<A->offd->rowStarts[n+1];j++) {
+      Ai[cnt]   = n + globalOffset;
+      Aj[cnt]   = A->colMap[A->offd->cols[j]];
+      vals[cnt] = A->offd->vals[j];
+      cnt++;
+    }
+  }
+
+  parCSR *subA = new parCSR(N, subStarts, nnz, Ai, Aj, vals,
+                            A->nullSpace, A->null, A->nullSpacePenalty,
+                            *subComm, A->device);
+
+  subA->NnullVectors = A->NnullVectors;
+  subA->nullVectors  = A->nullVectors;
+
+  free(Ai); free(Aj); free(vals);
+
+  return subA;
+}
+
+} //namespace parAlmond
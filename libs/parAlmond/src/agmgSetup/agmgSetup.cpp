@@ -39,8 +39,6 @@ void solver_t::AMGSetup(parCSR *A){
   agmgLevel *L = new agmgLevel(A, ktype);
   levels[numLevels] = L;
 
-  setupAgmgSmoother((agmgLevel*)(levels[numLevels]), stype, ChebyshevIterations);
-
   hlong globalSize = L->A->globalRowStarts[size];
 
   //if the system if already small, dont create MG levels
@@ -55,9 +53,18 @@ void solver_t::AMGSetup(parCSR *A){
   while(!done){
     L = coarsenAgmgLevel((agmgLevel*)(levels[numLevels-1]), ktype, options);
     levels[numLevels] = L;
-    hlong globalCoarseSize = L->A->globalRowStarts[size];
     numLevels++;
 
+    //this rank was agglomerated away, the remaining levels live on other ranks
+    if (L->comm==MPI_COMM_NULL) {
+      baseLevel = -1;
+      break;
+    }
+
+    int levelSize;
+    MPI_Comm_size(L->A->comm, &levelSize);
+    hlong globalCoarseSize = L->A->globalRowStarts[levelSize];
+
     if(globalCoarseSize <= gCoarseSize || globalSize < 2*globalCoarseSize){
       coarseLevel->setup(L->A);
       baseLevel = numLevels-1;
@@ -70,13 +77,67 @@ void solver_t::AMGSetup(parCSR *A){
   allocateScratchSpace(requiredBytes, device);
 
   for (int n=AMGstartLev;n<numLevels;n++) {
-    setupAgmgSmoother((agmgLevel*)(levels[n]), stype, ChebyshevIterations);
+    //explicit blocks (e.g. IPDG elements) only make sense on the input matrix
+    setupAgmgSmoother((agmgLevel*)(levels[n]), stype, ChebyshevIterations,
+                      (n==AMGstartLev) ? blockJacobiSize : 0);
     allocateAgmgVectors((agmgLevel*)(levels[n]), n, AMGstartLev, ctype);
-    syncAgmgToDevice((agmgLevel*)(levels[n]), n, AMGstartLev, ctype);
+    syncAgmgToDevice((agmgLevel*)(levels[n]), n, AMGstartLev, ctype, format);
   }
   coarseLevel->syncToDevice();
 }
 
+//refresh the values of the hierarchy from a new fine matrix with the same
+// sparsity pattern. The aggregates, prolongators and smoother structure are kept,
+// the coarse matrices are recomputed as Galerkin products with the stored P and R
+void solver_t::AMGRefresh(parCSR *A){
+
+  //the caller may have replaced the first AMG level with its own (e.g. pMG)
+  agmgLevel *L = dynamic_cast<agmgLevel*>(levels[AMGstartLev]);
+
+  parCSR *fineA = A;
+  if (L) {
+    L->A->copyValues(A);
+    refreshAgmgSmoother(L);
+    fineA = L->A;
+  }
+  if (baseLevel==AMGstartLev) coarseLevel->setup(fineA);
+
+  for (int n=AMGstartLev+1;n<numLevels;n++) {
+    agmgLevel *C = (agmgLevel*) levels[n];
+
+    parCSR *Ac;
+    if (C->tripleProduct)
+      Ac = galerkinProd(fineA, C->P, C->R);
+    else
+      Ac = galerkinProd(fineA, C->P);
+
+    parCSR *subA = NULL;
+    MPI_Comm subComm = MPI_COMM_NULL;
+    if (C->agglomerationStride>1) {
+      Ac->null = (dfloat *) calloc(Ac->Nrows+1, sizeof(dfloat)); //the stored null vector is kept
+      subA = agglomerateMatrix(Ac, C->agglomerationStride, &subComm);
+    }
+
+    if (C->A) {
+      C->A->copyValues((subA) ? subA : Ac);
+      refreshAgmgSmoother(C);
+      if (n==baseLevel) coarseLevel->setup(C->A);
+    }
+
+    //Ac borrows its partitions from P
+    Ac->globalRowStarts = NULL;
+    Ac->globalColStarts = NULL;
+    delete Ac;
+    if (subA) delete subA;
+    if (subComm!=MPI_COMM_NULL) MPI_Comm_free(&subComm);
+
+    //this rank was agglomerated away, the remaining levels live on other ranks
+    if (C->comm==MPI_COMM_NULL) break;
+
+    fineA = C->A;
+  }
+}
+
 //create coarsened problem
 agmgLevel *coarsenAgmgLevel(agmgLevel *level, KrylovType ktype, setupAide options){
 
@@ -93,14 +154,81 @@ agmgLevel *coarsenAgmgLevel(agmgLevel *level, KrylovType ktype, setupAide option
 
   // adjustPartition(FineToCoarse, options);
 
+  //the local aggregates double as the blocks of the block Jacobi smoother
+  if (options.compareArgs("PARALMOND SMOOTHER", "BLOCKJACOBI")) {
+    const hlong aggOffset = globalAggStarts[rank];
+    const dlong NaggLocal = (dlong) (globalAggStarts[rank+1]-aggOffset);
+
+    level->blockIds = (dlong *) malloc((level->Nrows+1)*sizeof(dlong));
+    for (dlong i=0;i<level->Nrows;i++) {
+      const hlong agg = FineToCoarse[i];
+      if ((agg>=aggOffset)&&(agg<aggOffset+NaggLocal))
+        level->blockIds[i] = (dlong) (agg-aggOffset);
+      else //aggregate is owned by another rank, make a singleton block
+        level->blockIds[i] = NaggLocal+i;
+    }
+  }
+
+  //merge the coarse level onto fewer ranks if it has too few rows per rank
+  int stride = agglomeratePartition(globalAggStarts, level->comm, options);
+
   dfloat *nullCoarseA;
   parCSR *P = constructProlongation(level->A, FineToCoarse, globalAggStarts, &nullCoarseA);
+
+  const int NnullVectors = level->A->NnullVectors;
+  const bool smoothed = options.compareArgs("PARALMOND PROLONGATION", "SMOOTHED");
+
+  if (smoothed) {
+    parCSR *T = P;
+    P = smoothProlongation(level->A, C, T);
+
+    //T shares its partitions with A and P
+    T->globalRowStarts = NULL;
+    T->globalColStarts = NULL;
+    delete T;
+  }
+
   parCSR *R = transpose(P);
-  parCSR *A = galerkinProd(level->A, P);
 
-  A->null = nullCoarseA;
+  //the one-entry-per-row product only applies to the plain tentative prolongator
+  parCSR *A;
+  if (smoothed || NnullVectors>1)
+    A = galerkinProd(level->A, P, R);
+  else
+    A = galerkinProd(level->A, P);
+
+  if (NnullVectors>1) {
+    //keep the first coarse near-nullspace vector for the nullspace penalty
+    A->NnullVectors = NnullVectors;
+    A->nullVectors = nullCoarseA;
+    A->null = (dfloat *) calloc(A->Nrows+1, sizeof(dfloat));
+    for (dlong n=0;n<A->Nrows;n++) A->null[n] = nullCoarseA[n*NnullVectors];
+  } else {
+    A->null = nullCoarseA;
+  }
+
+  agmgLevel *coarseLevel;
+  if (stride>1) {
+    MPI_Comm subComm;
+    parCSR *subA = agglomerateMatrix(A, stride, &subComm);
+
+    if (subComm==MPI_COMM_NULL)
+      coarseLevel = new agmgLevel(P,R, ktype);
+    else
+      coarseLevel = new agmgLevel(subA,P,R, ktype);
+
+    //only the gathered copy is kept. A borrows its partitions from P and
+    // shares its near-nullspace vectors with subA
+    A->globalRowStarts = NULL;
+    A->globalColStarts = NULL;
+    if (subA) A->nullVectors = NULL;
+    delete A;
+  } else {
+    coarseLevel = new agmgLevel(A,P,R, ktype);
+  }
 
-  agmgLevel *coarseLevel = new agmgLevel(A,P,R, ktype);
+  coarseLevel->agglomerationStride = stride;
+  coarseLevel->tripleProduct = smoothed || (NnullVectors>1);
 
   //update the number of columns required for this level (from R)
   level->Ncols = (level->Ncols > R->Ncols) ? level->Ncols : R->Ncols;
@@ -108,22 +236,246 @@ agmgLevel *coarsenAgmgLevel(agmgLevel *level, KrylovType ktype, setupAide option
   return coarseLevel;
 }
 
-void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations){
+static void agmgBlockJacobi(void *ctx, dfloat *r, dfloat *z){
+  agmgLevel *level = (agmgLevel *) ctx;
+  level->blockJacobi(1.0, r, 0.0, z);
+}
+
+//spectral estimates used to scale the smoother
+static void setupAgmgSmootherBounds(agmgLevel *level){
 
-  level->stype = s;
-  level->ChebyshevIterations = ChebIterations;
+  parCSR *A = level->A;
+  SmoothType s = level->stype;
 
-  if((s == DAMPED_JACOBI)||(s == CHEBYSHEV)){
-    // estimate rho(invD * A)
-    dfloat rho = level->A->rhoDinvA();
+  if((s == DAMPED_JACOBI)||(s == CHEBYSHEV)||(s == CHEBYSHEV4)){
+    // estimate the spectral bounds of invD * A
+    dfloat lmin, rho;
+    A->boundsDinvA(&lmin, &rho);
 
     if (s == DAMPED_JACOBI) {
       level->lambda = (4./3.)/rho;
-    } else if (s == CHEBYSHEV) {
+    } else {
       level->lambda1 = rho;
-      level->lambda0 = rho/10.;
+      level->lambda0 = chebyshevLowerBound(lmin, rho); //unused by the fourth-kind polynomial
+    }
+  } else if (s == BLOCK_JACOBI) {
+    hlong Nblocks = (hlong) level->Nblocks, totalNblocks = 0;
+    MPI_Allreduce(&Nblocks, &totalNblocks, 1, MPI_HLONG, MPI_SUM, level->comm);
+
+    char tag[BUFSIZ];
+    sprintf(tag, "BlockDinvA Nblocks=%lld", (long long int) totalNblocks);
+
+    // estimate rho(invB * A)
+    dfloat rho = A->rhoSA(agmgBlockJacobi, level, tag);
+    level->lambda = (4./3.)/rho;
+  }
+}
+
+void setupAgmgSmoother(agmgLevel *level, SmoothType s, int ChebIterations, int blockJacobiSize){
+
+  level->stype = s;
+  level->ChebyshevIterations = ChebIterations;
+
+  if (level->comm==MPI_COMM_NULL) return; //idle level
+
+  parCSR *A = level->A;
+
+  if (s == BLOCK_JACOBI) {
+    setupAgmgBlocks(level, blockJacobiSize);
+  } else if (s == GAUSS_SEIDEL) {
+    setupAgmgColors(level);
+  }
+
+  setupAgmgSmootherBounds(level);
+
+  //smoothing work, counting the residual SpMV
+  long long int localWork[3], work[3];
+  localWork[0] = A->diag->nnz + A->offd->nnz;
+  localWork[1] = A->diag->nnz;
+  localWork[2] = (level->Nblocks) ? level->blockInvStarts[level->Nblocks] : 0;
+  MPI_Allreduce(localWork, work, 3, MPI_LONG_LONG_INT, MPI_SUM, level->comm);
+
+  const dfloat nnz = (work[0]) ? (dfloat) work[0] : 1.0;
+  if ((s == CHEBYSHEV)||(s == CHEBYSHEV4))
+    level->smootherCost = ChebIterations+1;
+  else if (s == BLOCK_JACOBI)
+    level->smootherCost = 1.0 + work[2]/nnz;
+  else if (s == GAUSS_SEIDEL)
+    level->smootherCost = 1.0 + 2*work[1]/nnz;
+  else
+    level->smootherCost = 1.0;
+}
+
+//refresh the value-dependent smoother data after the values of A changed.
+// The blocks and colors only depend on the sparsity pattern and are kept
+void refreshAgmgSmoother(agmgLevel *level){
+
+  if (level->comm==MPI_COMM_NULL) return; //idle level
+
+  if (level->Nblocks) invertAgmgBlocks(level);
+
+  setupAgmgSmootherBounds(level);
+
+  //update the device copies
+  if (level->o_A) level->o_A->refreshValues(level->A);
+
+  if (level->Nblocks && level->blockInvStarts[level->Nblocks])
+    level->o_blockInv.copyFrom(level->blockInv, level->blockInvStarts[level->Nblocks]*sizeof(dfloat));
+
+  if (level->Ncolors && level->A->diag->nnz)
+    level->o_diagVals.copyFrom(level->A->diag->vals, level->A->diag->nnz*sizeof(dfloat));
+}
+
+// group the local rows into blocks and invert the dense diagonal blocks.
+// Blocks are fixed runs of blockJacobiSize rows when given, else the level's aggregates
+void setupAgmgBlocks(agmgLevel *level, int blockJacobiSize){
+
+  parCSR *A = level->A;
+  const dlong N = level->Nrows;
+
+  dlong *ids = (dlong *) malloc((N+1)*sizeof(dlong));
+  for (dlong i=0;i<N;i++) {
+    if (blockJacobiSize>0)
+      ids[i] = i/blockJacobiSize;
+    else if (level->blockIds)
+      ids[i] = level->blockIds[i];
+    else
+      ids[i] = i;
+  }
+
+  dlong maxId = -1;
+  for (dlong i=0;i<N;i++) maxId = (ids[i]>maxId) ? ids[i] : maxId;
+
+  //compact the block ids
+  dlong *blockMap = (dlong *) calloc(maxId+2, sizeof(dlong));
+  for (dlong i=0;i<N;i++) blockMap[ids[i]] = 1;
+
+  dlong Nblocks = 0;
+  for (dlong b=0;b<=maxId;b++) {
+    if (blockMap[b]) blockMap[b] = Nblocks++;
+    else blockMap[b] = -1;
+  }
+  for (dlong i=0;i<N;i++) ids[i] = blockMap[ids[i]];
+  free(blockMap);
+
+  //bucket the rows by block
+  level->Nblocks = Nblocks;
+  level->blockStarts = (dlong *) calloc(Nblocks+1, sizeof(dlong));
+  level->blockRows   = (dlong *) calloc(N+1, sizeof(dlong));
+
+  for (dlong i=0;i<N;i++) level->blockStarts[ids[i]+1]++;
+  for (dlong b=0;b<Nblocks;b++) level->blockStarts[b+1] += level->blockStarts[b];
+
+  dlong *pos = (dlong *) calloc(N+1, sizeof(dlong)); //position of each row in its block
+  dlong *cnt = (dlong *) calloc(Nblocks+1, sizeof(dlong));
+  for (dlong i=0;i<N;i++) {
+    const dlong b = ids[i];
+    pos[i] = cnt[b]++;
+    level->blockRows[level->blockStarts[b]+pos[i]] = i;
+  }
+  free(cnt);
+
+  level->blockInvStarts = (dlong *) calloc(Nblocks+1, sizeof(dlong));
+  for (dlong b=0;b<Nblocks;b++) {
+    const dlong Nb = level->blockStarts[b+1]-level->blockStarts[b];
+    level->blockInvStarts[b+1] = level->blockInvStarts[b] + Nb*Nb;
+  }
+
+  level->blockInv = (dfloat *) calloc(level->blockInvStarts[Nblocks]+1, sizeof(dfloat));
+  invertAgmgBlocks(level);
+
+  free(ids); free(pos);
+}
+
+//gather and invert the diagonal blocks of the local matrix
+void invertAgmgBlocks(agmgLevel *level){
+
+  parCSR *A = level->A;
+  const dlong N = level->Nrows;
+  const dlong Nblocks = level->Nblocks;
+
+  //block and position in the block of each row
+  dlong *ids = (dlong *) malloc((N+1)*sizeof(dlong));
+  dlong *pos = (dlong *) malloc((N+1)*sizeof(dlong));
+  for (dlong b=0;b<Nblocks;b++) {
+    for (dlong n=level->blockStarts[b];n<level->blockStarts[b+1];n++) {
+      const dlong row = level->blockRows[n];
+      ids[row] = b;
+      pos[row] = n-level->blockStarts[b];
     }
   }
+
+  for (dlong n=0;n<level->blockInvStarts[Nblocks];n++) level->blockInv[n] = 0.;
+
+  for (dlong b=0;b<Nblocks;b++) {
+    const dlong start = level->blockStarts[b];
+    const int Nb = (int) (level->blockStarts[b+1]-start);
+    dfloat *B = level->blockInv + level->blockInvStarts[b];
+
+    for (int i=0;i<Nb;i++) {
+      const dlong row = level->blockRows[start+i];
+      for (dlong jj=A->diag->rowStarts[row];jj<A->diag->rowStarts[row+1];jj++) {
+        const dlong col = A->diag->cols[jj];
+        if (ids[col]==b) B[i*Nb+pos[col]] += A->diag->vals[jj];
+      }
+    }
+
+    if (Nb==1)
+      B[0] = 1.0/B[0];
+    else
+      matrixInverse(Nb, B);
+  }
+
+  free(ids); free(pos);
+}
+
+// greedy coloring of the local matrix graph for the multicolor Gauss-Seidel sweeps
+void setupAgmgColors(agmgLevel *level){
+
+  parCSR *A = level->A;
+  const dlong N = level->Nrows;
+
+  int maxNnzPerRow = 0;
+  for (dlong i=0;i<N;i++) {
+    int rowNnz = (int) (A->diag->rowStarts[i+1]-A->diag->rowStarts[i]);
+    maxNnzPerRow = (rowNnz>maxNnzPerRow) ? rowNnz : maxNnzPerRow;
+  }
+
+  int *colors = (int *) malloc((N+1)*sizeof(int));
+  dlong *mark = (dlong *) malloc((maxNnzPerRow+1)*sizeof(dlong));
+  for (dlong i=0;i<N;i++) colors[i] = -1;
+  for (int c=0;c<=maxNnzPerRow;c++) mark[c] = -1;
+
+  int Ncolors = 0;
+  for (dlong i=0;i<N;i++) {
+    //mark the colors taken by the neighbours
+    for (dlong jj=A->diag->rowStarts[i];jj<A->diag->rowStarts[i+1];jj++) {
+      const dlong col = A->diag->cols[jj];
+      if ((col!=i)&&(colors[col]>=0)) mark[colors[col]] = i;
+    }
+
+    int c = 0;
+    while (mark[c]==i) c++;
+    colors[i] = c;
+    Ncolors = (c+1>Ncolors) ? c+1 : Ncolors;
+  }
+  free(mark);
+
+  //bucket the rows by color
+  level->Ncolors = Ncolors;
+  level->colorStarts = (dlong *) calloc(Ncolors+1, sizeof(dlong));
+  level->colorRows   = (dlong *) calloc(N+1, sizeof(dlong));
+
+  for (dlong i=0;i<N;i++) level->colorStarts[colors[i]+1]++;
+  for (int c=0;c<Ncolors;c++) level->colorStarts[c+1] += level->colorStarts[c];
+
+  dlong *cnt = (dlong *) calloc(Ncolors+1, sizeof(dlong));
+  for (dlong i=0;i<N;i++) {
+    const int c = colors[i];
+    level->colorRows[level->colorStarts[c]+cnt[c]++] = i;
+  }
+  free(cnt);
+  free(colors);
 }
 
 void allocateAgmgVectors(agmgLevel *level, int k, int AMGstartLev, CycleType ctype) {
@@ -143,19 +495,35 @@ void allocateAgmgVectors(agmgLevel *level, int k, int AMGstartLev, CycleType cty
   }
 }
 
-void syncAgmgToDevice(agmgLevel *level, int k, int AMGstartLev, CycleType ctype) {
+void syncAgmgToDevice(agmgLevel *level, int k, int AMGstartLev, CycleType ctype, SpMVFormat format) {
 
-  occa::device device = level->A->device;
+  occa::device device = level->A ? level->A->device : level->P->device;
 
-  level->o_A = new parHYB(level->A);
-  level->o_A->syncToDevice();
+  if (level->A) {
+    level->o_A = new parHYB(level->A, format);
+    level->o_A->syncToDevice();
+  }
   if (k>AMGstartLev) {
-    level->o_R = new parHYB(level->R);
-    level->o_P = new parHYB(level->P);
+    level->o_R = new parHYB(level->R, format);
+    level->o_P = new parHYB(level->P, format);
     level->o_R->syncToDevice();
     level->o_P->syncToDevice();
   }
 
+  if (level->Nblocks) {
+    level->o_blockStarts    = device.malloc((level->Nblocks+1)*sizeof(dlong), level->blockStarts);
+    level->o_blockRows      = device.malloc(level->Nrows*sizeof(dlong), level->blockRows);
+    level->o_blockInvStarts = device.malloc((level->Nblocks+1)*sizeof(dlong), level->blockInvStarts);
+    level->o_blockInv       = device.malloc(level->blockInvStarts[level->Nblocks]*sizeof(dfloat), level->blockInv);
+  }
+
+  if (level->Ncolors) {
+    level->o_colorRows     = device.malloc(level->Nrows*sizeof(dlong), level->colorRows);
+    level->o_diagRowStarts = device.malloc((level->Nrows+1)*sizeof(dlong), level->A->diag->rowStarts);
+    level->o_diagCols      = device.malloc(level->A->diag->nnz*sizeof(dlong), level->A->diag->cols);
+    level->o_diagVals      = device.malloc(level->A->diag->nnz*sizeof(dfloat), level->A->diag->vals);
+  }
+
   if (level->x  ) level->o_x   = device.malloc(level->Ncols*sizeof(dfloat),level->x);
   if (level->rhs) level->o_rhs = device.malloc(level->Nrows*sizeof(dfloat),level->rhs);
   if (level->res) level->o_res = device.malloc(level->Ncols*sizeof(dfloat),level->res);
@@ -28,8 +28,15 @@ SOFTWARE.
 
 namespace parAlmond {
 
+static parCSR *constructBlockProlongation(parCSR *A, hlong *FineToCoarse,
+                                          hlong *globalAggStarts, dfloat **nullCoarseA);
+
 parCSR *constructProlongation(parCSR *A, hlong *FineToCoarse,
                             hlong *globalAggStarts, dfloat **nullCoarseA){
+
+  if (A->NnullVectors>1)
+    return constructBlockProlongation(A, FineToCoarse, globalAggStarts, nullCoarseA);
+
   // MPI info
   int rank, size;
   MPI_Comm_rank(A->comm, &rank);
@@ -121,4 +128,171 @@ parCSR *constructProlongation(parCSR *A, hlong *FineToCoarse,
   return P;
 }
 
+//Tentative prolongator for a multi-vector near-nullspace B. Each aggregate
+// gets K coarse dofs, and its block of B is factored as B_agg = Q R with a
+// Cholesky QR of the Gram matrix B_agg^T B_agg. P holds Q and the coarse
+// near-nullspace is R. Vectors which are dependent on an aggregate give a
+// zero column of Q.
+static parCSR *constructBlockProlongation(parCSR *A, hlong *FineToCoarse,
+                                          hlong *globalAggStarts, dfloat **nullCoarseA){
+  // MPI info
+  int rank, size;
+  MPI_Comm_rank(A->comm, &rank);
+  MPI_Comm_size(A->comm, &size);
+
+  const int K  = A->NnullVectors;
+  const int K2 = K*K;
+
+  const dlong N = A->Nrows;
+
+  const hlong globalAggOffset = globalAggStarts[rank];
+  const dlong NAgg = (dlong) (globalAggStarts[rank+1]-globalAggStarts[rank]); //local num agg
+
+  //K coarse dofs per aggregate
+  hlong *globalCoarseStarts = (hlong *) calloc(size+1,sizeof(hlong));
+  for (int r=0;r<size+1;r++) globalCoarseStarts[r] = K*globalAggStarts[r];
+
+  const hlong globalCoarseOffset = globalCoarseStarts[rank];
+  const dlong NCoarse = K*NAgg;
+
+  //gather scatter over the aggregates. The local rows come first, followed by
+  // the owned aggregates (which may have no local rows after agglomeration)
+  hlong *aggIds = (hlong *) malloc((N+NAgg+1)*sizeof(hlong));
+  for (dlong i=0;i<N;i++)    aggIds[i]   = FineToCoarse[i]+1;
+  for (dlong a=0;a<NAgg;a++) aggIds[N+a] = globalAggOffset+a+1;
+
+  int verbose = 0;
+  ogs_t *aggOgs = ogsSetup(N+NAgg, aggIds, A->comm, 0, verbose, A->device);
+  free(aggIds);
+
+  //Gram matrices of each aggregate's block of B
+  dfloat *G = (dfloat *) calloc((N+NAgg)*K2+1,sizeof(dfloat));
+  for (dlong i=0;i<N;i++) {
+    dfloat *Bi = A->nullVectors + i*K;
+    for (int a=0;a<K;a++)
+      for (int b=0;b<K;b++)
+        G[i*K2+a*K+b] = Bi[a]*Bi[b];
+  }
+  ogsGatherScatterVec(G, K2, ogsDfloat, ogsAdd, aggOgs);
+
+  //factor on the owning rank only, then share R so every copy agrees
+  for (dlong i=0;i<N*K2;i++) G[i] = 0.;
+
+  for (dlong a=0;a<NAgg;a++) {
+    dfloat *R = G + (N+a)*K2;
+
+    //G = R^T R, upper triangular R overwrites G
+    for (int j=0;j<K;j++) {
+      const dfloat Gjj = R[j*K+j];
+
+      dfloat d = Gjj;
+      for (int p=0;p<j;p++) d -= R[p*K+j]*R[p*K+j];
+
+      if ((Gjj<=0.) || (d<=1.0e-10*Gjj)) { //dependent vector
+        for (int m=0;m<K;m++) R[j*K+m] = 0.;
+        continue;
+      }
+
+      const dfloat Rjj = sqrt(d);
+      R[j*K+j] = Rjj;
+      for (int m=j+1;m<K;m++) {
+        dfloat v = R[j*K+m];
+        for (int p=0;p<j;p++) v -= R[p*K+j]*R[p*K+m];
+        R[j*K+m] = v/Rjj;
+      }
+    }
+    for (int j=0;j<K;j++)
+      for (int m=0;m<j;m++)
+        R[j*K+m] = 0.;
+  }
+
+  ogsGatherScatterVec(G, K2, ogsDfloat, ogsAdd, aggOgs);
+  ogsFree(aggOgs);
+
+  parCSR* P = new parCSR(N, NCoarse, A->comm, A->device);
+
+  P->globalRowStarts = A->globalRowStarts;
+  P->globalColStarts = globalCoarseStarts;
+
+  P->diag->rowStarts = (dlong *) calloc(N+1, sizeof(dlong));
+  P->offd->rowStarts = (dlong *) calloc(N+1, sizeof(dlong));
+
+  // each row has exactly K nonzeros
+  for(dlong i=0; i<N; i++) {
+    hlong agg = FineToCoarse[i];
+    if ((agg>globalAggOffset-1)&&(agg<globalAggOffset+NAgg)) {
+      P->diag->rowStarts[i+1] = K;
+    } else {
+      P->offd->rowStarts[i+1] = K;
+    }
+  }
+  for(dlong i=0; i<N; i++) {
+    P->diag->rowStarts[i+1] += P->diag->rowStarts[i];
+    P->offd->rowStarts[i+1] += P->offd->rowStarts[i];
+  }
+  P->diag->nnz = P->diag->rowStarts[N];
+  P->offd->nnz = P->offd->rowStarts[N];
+
+  // Halo setup
+  hlong *colIds = (hlong *) malloc((P->offd->nnz+1)*sizeof(hlong));
+  dlong cnt=0;
+  for (dlong i=0;i<N;i++) {
+    hlong agg = FineToCoarse[i];
+    if ((agg<globalAggOffset)||(agg>globalAggOffset+NAgg-1))
+      for (int c=0;c<K;c++)
+        colIds[cnt++] = K*agg+c;
+  }
+  P->haloSetup(colIds);
+
+  P->diag->cols = (dlong *)  calloc(P->diag->nnz, sizeof(dlong));
+  P->diag->vals = (dfloat *) calloc(P->diag->nnz, sizeof(dfloat));
+  P->offd->cols = (dlong *)  calloc(P->offd->nnz, sizeof(dlong));
+  P->offd->vals = (dfloat *) calloc(P->offd->nnz, sizeof(dfloat));
+
+  dfloat *q = (dfloat *) calloc(K,sizeof(dfloat));
+
+  dlong diagCnt = 0;
+  dlong offdCnt = 0;
+  for(dlong i=0; i<N; i++) {
+    hlong agg = FineToCoarse[i];
+    dfloat *Bi = A->nullVectors + i*K;
+    dfloat *R  = G + i*K2;
+
+    //solve q R = B_i for this row of Q
+    for (int j=0;j<K;j++) {
+      if (R[j*K+j]==0.) { q[j] = 0.; continue; }
+      dfloat v = Bi[j];
+      for (int p=0;p<j;p++) v -= q[p]*R[p*K+j];
+      q[j] = v/R[j*K+j];
+    }
+
+    if ((agg>globalAggOffset-1)&&(agg<globalAggOffset+NAgg)) {
+      for (int c=0;c<K;c++) {
+        P->diag->cols[diagCnt  ] = (dlong) (K*agg + c - globalCoarseOffset); //local index
+        P->diag->vals[diagCnt++] = q[c];
+      }
+    } else {
+      for (int c=0;c<K;c++) {
+        P->offd->cols[offdCnt  ] = colIds[offdCnt];
+        P->offd->vals[offdCnt++] = q[c];
+      }
+    }
+  }
+  free(q);
+
+  //the coarse near-nullspace is R, K vectors per coarse dof
+  *nullCoarseA = (dfloat *) calloc(NCoarse*K+1,sizeof(dfloat));
+  for (dlong a=0;a<NAgg;a++) {
+    dfloat *R = G + (N+a)*K2;
+    for (int c=0;c<K;c++)
+      for (int m=0;m<K;m++)
+        (*nullCoarseA)[(K*a+c)*K+m] = R[c*K+m];
+  }
+
+  free(colIds);
+  free(G);
+
+  return P;
+}
+
 } //namespace parAlmond
\ No newline at end of file
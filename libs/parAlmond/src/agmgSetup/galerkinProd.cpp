@@ -270,4 +270,42 @@ parCSR *galerkinProd(parCSR *A, parCSR *P){
   return Ac;
 }
 
+//Galerkin product R A P for a general prolongator (smoothed, or with more
+// than one near-nullspace vector), formed with two distributed SpMMs
+parCSR *galerkinProd(parCSR *A, parCSR *P, parCSR *R){
+
+  parCSR *AP = SpMM(A, P);
+  parCSR *Ac = SpMM(R, AP);
+
+  //AP borrows its partitions from A and P
+  AP->globalRowStarts = NULL;
+  AP->globalColStarts = NULL;
+  delete AP;
+
+  //record the diagonal. Coarse dofs from dependent near-nullspace vectors
+  // have empty rows and get an identity row instead
+  Ac->diagA   = (dfloat *) calloc(Ac->Ncols, sizeof(dfloat));
+  Ac->diagInv = (dfloat *) calloc(Ac->Ncols, sizeof(dfloat));
+  for (dlong i=0;i<Ac->Nrows;i++) {
+    for (dlong jj=Ac->diag->rowStarts[i];jj<Ac->diag->rowStarts[i+1];jj++) {
+      if (Ac->diag->cols[jj]==i) {
+        if (Ac->diag->vals[jj]==0.) Ac->diag->vals[jj] = 1.0;
+        Ac->diagA[i] = Ac->diag->vals[jj];
+      }
+    }
+  }
+
+  //fill the halo region
+  ogsGatherScatter(Ac->diagA, ogsDfloat, ogsAdd, Ac->ogs);
+
+  //compute the inverse diagonal
+  for (dlong n=0;n<Ac->Nrows;n++) Ac->diagInv[n] = 1.0/Ac->diagA[n];
+
+  //propagate nullspace flag
+  Ac->nullSpace = A->nullSpace;
+  Ac->nullSpacePenalty = A->nullSpacePenalty;
+
+  return Ac;
+}
+
 } //namespace parAlmond
\ No newline at end of file
@@ -0,0 +1,123 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+
+namespace parAlmond {
+
+//Smoothed aggregation prolongator P = (I - omega D_F^{-1} A_F) T, where
+// A_F keeps the strong connections of A (the sparsity of the strength
+// graph C) and lumps the weak ones onto the diagonal. The weight is
+// omega = 4/(3 rho(D_F^{-1} A_F)).
+parCSR *smoothProlongation(parCSR *A, parCSR *C, parCSR *T){
+
+  const dlong N = A->Nrows;
+
+  //filtered operator, reusing the column space and halo of A
+  parCSR *S = new parCSR(N, A->NlocalCols, A->comm, A->device);
+
+  S->Ncols      = A->Ncols;
+  S->NlocalCols = A->NlocalCols;
+  S->Nhalo      = A->Nhalo;
+  S->Nshared    = A->Nshared;
+  S->colMap     = A->colMap;
+  S->haloIds    = A->haloIds;
+  S->ogs        = A->ogs;
+  S->ogsHalo    = A->ogsHalo;
+  S->globalRowStarts = A->globalRowStarts;
+  S->globalColStarts = A->globalColStarts;
+
+  CSR *blocks[2]  = {A->diag, A->offd};
+  CSR *Cblocks[2] = {C->diag, C->offd};
+  CSR *Sblocks[2] = {S->diag, S->offd};
+
+  S->diagA   = (dfloat *) calloc(S->Ncols, sizeof(dfloat));
+  S->diagInv = (dfloat *) calloc(S->Ncols, sizeof(dfloat));
+
+  for (int b=0;b<2;b++) {
+    CSR *Ab = blocks[b], *Cb = Cblocks[b], *Sb = Sblocks[b];
+
+    Sb->nnz = Cb->nnz;
+    Sb->rowStarts = (dlong *)  calloc(N+1, sizeof(dlong));
+    Sb->cols      = (dlong *)  calloc(Sb->nnz, sizeof(dlong));
+    Sb->vals      = (dfloat *) calloc(Sb->nnz, sizeof(dfloat));
+    memcpy(Sb->rowStarts, Cb->rowStarts, (N+1)*sizeof(dlong));
+    memcpy(Sb->cols, Cb->cols, Sb->nnz*sizeof(dlong));
+
+    //the strong entries of each row of C are a subsequence of the row of A
+    for (dlong i=0;i<N;i++) {
+      dlong jj = Sb->rowStarts[i];
+      for (dlong k=Ab->rowStarts[i];k<Ab->rowStarts[i+1];k++) {
+        const dlong  col = Ab->cols[k];
+        const dfloat val = Ab->vals[k];
+
+        if ((jj<Sb->rowStarts[i+1]) && (Sb->cols[jj]==col)) {
+          Sb->vals[jj++] = val;
+          if ((b==0) && (col==i)) S->diagA[i] += val;
+        } else {
+          S->diagA[i] += val; //lump weak connection
+        }
+      }
+    }
+  }
+
+  //put the lumped diagonal into the diagonal entry
+  for (dlong i=0;i<N;i++) {
+    for (dlong jj=S->diag->rowStarts[i];jj<S->diag->rowStarts[i+1];jj++)
+      if (S->diag->cols[jj]==i) S->diag->vals[jj] = S->diagA[i];
+
+    S->diagInv[i] = (S->diagA[i]!=0.) ? 1.0/S->diagA[i] : 0.;
+  }
+
+  const dfloat rho = S->rhoDinvA();
+  const dfloat omega = (4./3.)/rho;
+
+  //S = I - omega D_F^{-1} A_F
+  for (int b=0;b<2;b++) {
+    CSR *Sb = Sblocks[b];
+    for (dlong i=0;i<N;i++) {
+      for (dlong jj=Sb->rowStarts[i];jj<Sb->rowStarts[i+1];jj++) {
+        Sb->vals[jj] *= -omega*S->diagInv[i];
+        if ((b==0) && (Sb->cols[jj]==i)) Sb->vals[jj] += 1.0;
+      }
+    }
+  }
+
+  parCSR *P = SpMM(S, T);
+
+  //release S without freeing the halo data it borrowed from A
+  S->colMap  = NULL;
+  S->haloIds = NULL;
+  S->ogs     = NULL;
+  S->ogsHalo = NULL;
+  S->globalRowStarts = NULL;
+  S->globalColStarts = NULL;
+  delete S;
+
+  return P;
+}
+
+} //namespace parAlmond
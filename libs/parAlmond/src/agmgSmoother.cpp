@@ -106,6 +106,123 @@ void agmgLevel::smoothChebyshev(dfloat *r, dfloat *x,
   vectorAdd(Nrows, 1.0, d, 1.0, x);
 }
 
+// fourth-kind Chebyshev smoothing (Lottes), only needs rho = lambda1
+//  d_0 = 4/(3 rho) D^{-1}r_0
+//  d_k = (2k-1)/(2k+3) d_{k-1} + (8k+4)/((2k+3) rho) D^{-1}r_k
+void agmgLevel::smoothFourthKindChebyshev(dfloat *r, dfloat *x,
+                                          const bool x_is_zero) {
+
+  const dfloat invRho = 1.0/lambda1;
+
+  static dfloat *res = ((dfloat*) scratch) + 0*Ncols;
+  static dfloat *Ad  = ((dfloat*) scratch) + 1*Ncols;
+  static dfloat *d   = ((dfloat*) scratch) + 2*Ncols;
+
+  if(x_is_zero){ //skip the Ax if x is zero
+    //res = D^{-1}r
+    vectorDotStar(Nrows, 1.0, A->diagInv, r, 0.0, res);
+    vectorSet(Nrows, 0.0, x);
+  } else {
+    //res = D^{-1}(r-Ax)
+    A->SpMV(-1.0, x, 1.0, r, res);
+    vectorDotStar(Nrows, A->diagInv, res);
+  }
+
+  //d = 4/(3 rho)*res
+  vectorAdd(Nrows, (4./3.)*invRho, res, 0.0, d);
+
+  for (int k=1;k<=ChebyshevIterations;k++) {
+    //x_k+1 = x_k + d_k
+    vectorAdd(Nrows, 1.0, d, 1.0, x);
+
+    //r_k+1 = r_k - D^{-1}Ad_k
+    A->SpMV(1.0, d, 0.0, Ad);
+    vectorDotStar(Nrows, -1.0, A->diagInv, Ad, 1.0, res);
+
+    //d_k+1 = (2k-1)/(2k+3)*d_k + (8k+4)/((2k+3) rho)*r_k+1
+    vectorAdd(Nrows, (8.*k+4.)/(2.*k+3.)*invRho, res, (2.*k-1.)/(2.*k+3.), d);
+  }
+  //x_k+1 = x_k + d_k
+  vectorAdd(Nrows, 1.0, d, 1.0, x);
+}
+
+// y = alpha*invB*x + beta*y over the dense diagonal blocks
+void agmgLevel::blockJacobi(dfloat alpha, dfloat *x, dfloat beta, dfloat *y) {
+
+  for (dlong b=0;b<Nblocks;b++) {
+    const dlong start = blockStarts[b];
+    const int Nb = (int) (blockStarts[b+1]-start);
+    const dfloat *invB = blockInv + blockInvStarts[b];
+
+    for (int i=0;i<Nb;i++) {
+      dfloat result = 0.;
+      for (int j=0;j<Nb;j++)
+        result += invB[i*Nb+j]*x[blockRows[start+j]];
+
+      const dlong row = blockRows[start+i];
+      dfloat betay = 0.;
+      if (beta)
+        betay = beta*y[row];
+
+      y[row] = alpha*result + betay;
+    }
+  }
+}
+
+void agmgLevel::smoothBlockJacobi(dfloat *r, dfloat *x,
+                                  const bool x_is_zero) {
+
+  // x = x + alpha*inv(B)*(b-A*x)
+  if(x_is_zero){
+    this->blockJacobi(lambda, r, 0.0, x);
+    return;
+  }
+
+  static dfloat *res = (dfloat *) scratch;
+
+  A->SpMV(-1.0, x, 1.0, r, res);
+  this->blockJacobi(lambda, res, 1.0, x);
+}
+
+// symmetric Gauss-Seidel on the local block, sweeping the colors forward
+// then backward. Coupling to other ranks is handled through the residual.
+void agmgLevel::gaussSeidelSweeps(dfloat *r, dfloat *d) {
+
+  vectorSet(Nrows, 0.0, d);
+
+  for (int c=0;c<2*Ncolors;c++) {
+    const int color = (c<Ncolors) ? c : 2*Ncolors-1-c;
+
+    for (dlong n=colorStarts[color];n<colorStarts[color+1];n++) {
+      const dlong row = colorRows[n];
+
+      dfloat result = r[row];
+      for (dlong i=A->diag->rowStarts[row];i<A->diag->rowStarts[row+1];i++) {
+        const dlong col = A->diag->cols[i];
+        if (col!=row) result -= A->diag->vals[i]*d[col];
+      }
+      d[row] = result*A->diagInv[row];
+    }
+  }
+}
+
+void agmgLevel::smoothGaussSeidel(dfloat *r, dfloat *x,
+                                  const bool x_is_zero) {
+
+  if(x_is_zero){
+    this->gaussSeidelSweeps(r, x);
+    return;
+  }
+
+  static dfloat *res = ((dfloat*) scratch) + 0*Ncols;
+  static dfloat *d   = ((dfloat*) scratch) + 1*Ncols;
+
+  // x = x + SGS(r-A*x)
+  A->SpMV(-1.0, x, 1.0, r, res);
+  this->gaussSeidelSweeps(res, d);
+  vectorAdd(Nrows, 1.0, d, 1.0, x);
+}
+
 void agmgLevel::smoothJacobi(occa::memory o_r, occa::memory o_x,
                              bool x_is_zero) {
 
@@ -197,4 +314,96 @@ void agmgLevel::smoothChebyshev(occa::memory o_r, occa::memory o_x,
   // occaTimerToc(parAlmond->device,"device smoothChebyshev");
 }
 
+void agmgLevel::smoothFourthKindChebyshev(occa::memory o_r, occa::memory o_x,
+                                          bool x_is_zero) {
+
+  const dfloat invRho = 1.0/lambda1;
+
+  static occa::memory o_res = o_scratch + 0*Ncols*sizeof(dfloat);
+  static occa::memory o_Ad  = o_scratch + 1*Ncols*sizeof(dfloat);
+  static occa::memory o_d   = o_scratch + 2*Ncols*sizeof(dfloat);
+
+  if(x_is_zero){ //skip the Ax if x is zero
+    //res = D^{-1}r
+    vectorDotStar(Nrows, 1.0, o_A->o_diagInv, o_r, 0.0, o_res);
+    vectorSet(Nrows, 0.0, o_x);
+  } else {
+    //res = D^{-1}(r-Ax)
+    o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
+    vectorDotStar(Nrows, o_A->o_diagInv, o_res);
+  }
+
+  //d = 4/(3 rho)*res
+  vectorAdd(Nrows, (4./3.)*invRho, o_res, 0.0, o_d);
+
+  for (int k=1;k<=ChebyshevIterations;k++) {
+    //x_k+1 = x_k + d_k
+    vectorAdd(Nrows, 1.0, o_d, 1.0, o_x);
+
+    //r_k+1 = r_k - D^{-1}Ad_k
+    o_A->SpMV(1.0, o_d, 0.0, o_Ad);
+    vectorDotStar(Nrows, -1.0, o_A->o_diagInv, o_Ad, 1.0, o_res);
+
+    //d_k+1 = (2k-1)/(2k+3)*d_k + (8k+4)/((2k+3) rho)*r_k+1
+    vectorAdd(Nrows, (8.*k+4.)/(2.*k+3.)*invRho, o_res, (2.*k-1.)/(2.*k+3.), o_d);
+  }
+  //x_k+1 = x_k + d_k
+  vectorAdd(Nrows, 1.0, o_d, 1.0, o_x);
+}
+
+void agmgLevel::smoothBlockJacobi(occa::memory o_r, occa::memory o_x,
+                                  bool x_is_zero) {
+
+  const dfloat zero = 0., one = 1.;
+
+  if(x_is_zero){
+    if (Nblocks)
+      blockJacobiKernel(Nblocks, lambda, zero, o_blockStarts, o_blockRows,
+                        o_blockInvStarts, o_blockInv, o_r, o_x);
+    return;
+  }
+
+  static occa::memory o_res = o_scratch;
+
+  // res = r-A*x
+  o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
+
+  // x = x + alpha*inv(B)*res
+  if (Nblocks)
+    blockJacobiKernel(Nblocks, lambda, one, o_blockStarts, o_blockRows,
+                      o_blockInvStarts, o_blockInv, o_res, o_x);
+}
+
+void agmgLevel::smoothGaussSeidel(occa::memory o_r, occa::memory o_x,
+                                  bool x_is_zero) {
+
+  static occa::memory o_res = o_scratch + 0*Ncols*sizeof(dfloat);
+  static occa::memory o_d   = o_scratch + 1*Ncols*sizeof(dfloat);
+
+  occa::memory o_rhs = o_r;
+  occa::memory o_dx  = o_x;
+  if (!x_is_zero) {
+    // res = r-A*x
+    o_A->SpMV(-1.0, o_x, 1.0, o_r, o_res);
+    o_rhs = o_res;
+    o_dx  = o_d;
+  }
+
+  vectorSet(Nrows, 0.0, o_dx);
+
+  // sweep the colors forward then backward
+  for (int c=0;c<2*Ncolors;c++) {
+    const int color = (c<Ncolors) ? c : 2*Ncolors-1-c;
+    const dlong NcolorRows = colorStarts[color+1]-colorStarts[color];
+
+    if (NcolorRows)
+      gaussSeidelColorKernel(NcolorRows,
+                             o_colorRows + colorStarts[color]*sizeof(dlong),
+                             o_diagRowStarts, o_diagCols, o_diagVals,
+                             o_A->o_diagInv, o_rhs, o_dx);
+  }
+
+  if (!x_is_zero) vectorAdd(Nrows, 1.0, o_d, 1.0, o_x);
+}
+
 } //namespace parAlmond
\ No newline at end of file
@@ -46,6 +46,12 @@ void coarseSolver::setup(parCSR *A) {
   MPI_Comm_rank(comm,&rank);
   MPI_Comm_size(comm,&size);
 
+  //release a previous factorization when the matrix values were refreshed
+  free(coarseOffsets); free(coarseCounts);
+  free(invCoarseA);
+  free(xLocal); free(rhsLocal);
+  free(xCoarse); free(rhsCoarse);
+
   //copy the global coarse partition as ints
   coarseOffsets = (int* ) calloc(size+1,sizeof(int));
   for (int r=0;r<size+1;r++) coarseOffsets[r] = (int) A->globalRowStarts[r];
@@ -36,6 +36,8 @@ occa::kernel SpMVcsrKernel1;
 occa::kernel SpMVcsrKernel2;
 occa::kernel SpMVellKernel1;
 occa::kernel SpMVellKernel2;
+occa::kernel SpMVsellKernel1;
+occa::kernel SpMVsellKernel2;
 occa::kernel SpMVmcsrKernel1;
 occa::kernel SpMVmcsrKernel2;
 
@@ -54,6 +56,9 @@ occa::kernel kcycleWeightedCombinedOp2Kernel;
 occa::kernel vectorAddInnerProdKernel;
 occa::kernel vectorAddWeightedInnerProdKernel;
 
+occa::kernel blockJacobiKernel;
+occa::kernel gaussSeidelColorKernel;
+
 void buildParAlmondKernels(MPI_Comm comm, occa::device device){
 
   int rank, size;
@@ -86,6 +91,7 @@ void buildParAlmondKernels(MPI_Comm comm, occa::device device){
   }
 
   kernelInfo["defines/" "p_BLOCKSIZE"]= BLOCKSIZE;
+  kernelInfo["defines/" "p_SELL_C"]= SELL_C;
 
   if(device.mode()=="OpenCL"){
     //kernelInfo["compiler_flags"] += "-cl-opt-disable";
@@ -107,6 +113,8 @@ void buildParAlmondKernels(MPI_Comm comm, occa::device device){
       SpMVcsrKernel2  = device.buildKernel(DPARALMOND"/okl/SpMVcsr.okl",  "SpMVcsr2",  kernelInfo);
       SpMVellKernel1  = device.buildKernel(DPARALMOND"/okl/SpMVell.okl",  "SpMVell1",  kernelInfo);
       SpMVellKernel2  = device.buildKernel(DPARALMOND"/okl/SpMVell.okl",  "SpMVell2",  kernelInfo);
+      SpMVsellKernel1 = device.buildKernel(DPARALMOND"/okl/SpMVsell.okl", "SpMVsell1", kernelInfo);
+      SpMVsellKernel2 = device.buildKernel(DPARALMOND"/okl/SpMVsell.okl", "SpMVsell2", kernelInfo);
       SpMVmcsrKernel1 = device.buildKernel(DPARALMOND"/okl/SpMVmcsr.okl", "SpMVmcsr1", kernelInfo);
       SpMVmcsrKernel2 = device.buildKernel(DPARALMOND"/okl/SpMVmcsr.okl", "SpMVmcsr2", kernelInfo);
 
@@ -128,6 +136,9 @@ void buildParAlmondKernels(MPI_Comm comm, occa::device device){
       kcycleWeightedCombinedOp2Kernel = device.buildKernel(DPARALMOND"/okl/kcycleCombinedOp.okl", "kcycleWeightedCombinedOp2", kernelInfo);
 
       haloExtractKernel = device.buildKernel(DPARALMOND"/okl/haloExtract.okl", "haloExtract", kernelInfo);
+
+      blockJacobiKernel      = device.buildKernel(DPARALMOND"/okl/blockJacobi.okl", "blockJacobi", kernelInfo);
+      gaussSeidelColorKernel = device.buildKernel(DPARALMOND"/okl/gaussSeidel.okl", "gaussSeidelColor", kernelInfo);
     }
     MPI_Barrier(comm);
   }
@@ -142,6 +153,8 @@ void freeParAlmondKernels() {
   SpMVcsrKernel2.free();
   SpMVellKernel1.free();
   SpMVellKernel2.free();
+  SpMVsellKernel1.free();
+  SpMVsellKernel2.free();
   SpMVmcsrKernel1.free();
   SpMVmcsrKernel2.free();
 
@@ -160,6 +173,9 @@ void freeParAlmondKernels() {
   vectorAddInnerProdKernel.free();
   vectorAddWeightedInnerProdKernel.free();
 
+  blockJacobiKernel.free();
+  gaussSeidelColorKernel.free();
+
 }
 
 
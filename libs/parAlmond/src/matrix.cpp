@@ -84,6 +84,118 @@ void ELL::syncToDevice(occa::device device) {
   free(colsT); free(valsT);
 }
 
+//------------------------------------------------------------------------
+//
+//  SELL-C-sigma matrix
+//
+//------------------------------------------------------------------------
+
+typedef struct {
+  dlong row;
+  dlong nnz;
+} rowLength_t;
+
+static int compareRowLength(const void *a, const void *b){
+  rowLength_t *pa = (rowLength_t *) a;
+  rowLength_t *pb = (rowLength_t *) b;
+
+  //longest first, original order for ties
+  if (pa->nnz > pb->nnz) return -1;
+  if (pa->nnz < pb->nnz) return +1;
+
+  if (pa->row < pb->row) return -1;
+  if (pa->row > pb->row) return +1;
+
+  return 0;
+}
+
+SELL::SELL(CSR *A): matrix_t(A->Nrows, A->Ncols) {
+
+  Nslices = (Nrows+SELL_C-1)/SELL_C;
+
+  //sort the rows by length inside each window
+  rowLength_t *rows = (rowLength_t *) malloc((Nrows+1)*sizeof(rowLength_t));
+  for (dlong i=0;i<Nrows;i++) {
+    rows[i].row = i;
+    rows[i].nnz = A->rowStarts[i+1]-A->rowStarts[i];
+  }
+  for (dlong w=0;w<Nrows;w+=SELL_SIGMA) {
+    dlong Nw = (Nrows-w < SELL_SIGMA) ? Nrows-w : SELL_SIGMA;
+    qsort(rows+w, Nw, sizeof(rowLength_t), compareRowLength);
+  }
+
+  rowPerm = (dlong *) malloc((Nrows+1)*sizeof(dlong));
+  for (dlong p=0;p<Nrows;p++) rowPerm[p] = rows[p].row;
+
+  //each slice is as wide as its longest row
+  sliceStarts = (dlong *) calloc(Nslices+1, sizeof(dlong));
+  for (dlong s=0;s<Nslices;s++) {
+    dlong width = 0;
+    for (int r=0;r<SELL_C;r++) {
+      dlong p = s*SELL_C+r;
+      if (p<Nrows) width = (rows[p].nnz>width) ? rows[p].nnz : width;
+    }
+    sliceStarts[s+1] = sliceStarts[s] + width*SELL_C;
+  }
+  nnz = sliceStarts[Nslices];
+
+  cols = (dlong *)  calloc(nnz+1, sizeof(dlong));
+  vals = (dfloat *) calloc(nnz+1, sizeof(dfloat));
+
+  for (dlong s=0;s<Nslices;s++) {
+    const dlong start = sliceStarts[s];
+    const dlong width = (sliceStarts[s+1]-start)/SELL_C;
+
+    for (int r=0;r<SELL_C;r++) {
+      const dlong p = s*SELL_C+r;
+
+      const dlong row = (p<Nrows) ? rowPerm[p] : 0;
+      const dlong rowNnz = (p<Nrows) ? rows[p].nnz : 0;
+      const dlong Jstart = (p<Nrows) ? A->rowStarts[row] : 0;
+
+      //padding repeats the row's last column with a zero value (column 0
+      // for empty rows), so it stays inside x for rectangular blocks
+      const dlong padCol = (rowNnz>0) ? A->cols[Jstart+rowNnz-1] : 0;
+
+      for (dlong c=0;c<width;c++) {
+        const dlong id = start + c*SELL_C + r;
+        if (c<rowNnz) {
+          cols[id] = A->cols[Jstart+c];
+          vals[id] = A->vals[Jstart+c];
+        } else {
+          cols[id] = padCol;
+          vals[id] = 0.;
+        }
+      }
+    }
+  }
+
+  free(rows);
+}
+
+SELL::~SELL() {
+  free(rowPerm);
+  free(sliceStarts);
+  free(cols);
+  free(vals);
+
+  if (o_rowPerm.size()) o_rowPerm.free();
+  if (o_sliceStarts.size()) o_sliceStarts.free();
+  if (o_cols.size()) o_cols.free();
+  if (o_vals.size()) o_vals.free();
+}
+
+void SELL::syncToDevice(occa::device device) {
+  if (Nrows) {
+    o_rowPerm     = device.malloc(Nrows*sizeof(dlong), rowPerm);
+    o_sliceStarts = device.malloc((Nslices+1)*sizeof(dlong), sliceStarts);
+  }
+  if (nnz) {
+    o_cols = device.malloc(nnz*sizeof(dlong),  cols);
+    o_vals = device.malloc(nnz*sizeof(dfloat), vals);
+  }
+}
+
 //------------------------------------------------------------------------
 //
 //  MCSR matrix
@@ -391,9 +503,11 @@ parCSR::~parCSR() {
 
   free(null);
   if (o_null.size()) o_null.free();
+  free(nullVectors);
 
+  //square operators may share one partition array
+  if (globalColStarts!=globalRowStarts) free(globalColStarts);
   free(globalRowStarts);
-  free(globalColStarts);
 
   free(colMap);
   free(haloIds);
@@ -402,6 +516,82 @@ parCSR::~parCSR() {
   if (ogsHalo)   ogsFree(ogsHalo);
 }
 
+//overwrite the values with those of B, a matrix on the same partition.
+// Entries of B outside this sparsity pattern are dropped (they only
+// appear when a value crosses the assembly drop tolerance)
+void parCSR::copyValues(parCSR *B) {
+
+  for (dlong n=0;n<diag->nnz;n++) diag->vals[n] = 0.;
+  for (dlong n=0;n<offd->nnz;n++) offd->vals[n] = 0.;
+
+  //the nonlocal columns are numbered in increasing global order
+  const dlong Noffdcols = Ncols-NlocalCols;
+  hlong *offdMap = colMap+NlocalCols;
+
+  for (dlong i=0;i<Nrows;i++) {
+    const dlong diagStart = diag->rowStarts[i];
+    const dlong diagEnd   = diag->rowStarts[i+1];
+    for (dlong jj=B->diag->rowStarts[i];jj<B->diag->rowStarts[i+1];jj++) {
+      const dlong col = B->diag->cols[jj];
+      for (dlong j=diagStart;j<diagEnd;j++) {
+        if (diag->cols[j]==col) {
+          diag->vals[j] = B->diag->vals[jj];
+          break;
+        }
+      }
+    }
+
+    const dlong offdStart = offd->rowStarts[i];
+    const dlong offdEnd   = offd->rowStarts[i+1];
+    for (dlong jj=B->offd->rowStarts[i];jj<B->offd->rowStarts[i+1];jj++) {
+      const hlong gcol = B->colMap[B->offd->cols[jj]];
+
+      //binary search for the local column
+      dlong lo = 0, hi = Noffdcols;
+      while (lo<hi) {
+        dlong mid = (lo+hi)/2;
+        if (offdMap[mid]<gcol) lo = mid+1;
+        else hi = mid;
+      }
+      if ((lo==Noffdcols) || (offdMap[lo]!=gcol)) continue;
+
+      const dlong col = NlocalCols+lo;
+      for (dlong j=offdStart;j<offdEnd;j++) {
+        if (offd->cols[j]==col) {
+          offd->vals[j] = B->offd->vals[jj];
+          break;
+        }
+      }
+    }
+  }
+
+  this->refreshDiagonal();
+}
+
+void parCSR::refreshDiagonal() {
+
+  for (dlong n=0;n<Ncols;n++) diagA[n] = 0.;
+
+  for (dlong i=0;i<Nrows;i++) {
+    for (dlong jj=diag->rowStarts[i];jj<diag->rowStarts[i+1];jj++) {
+      if (diag->cols[jj]==i) diagA[i] = diag->vals[jj];
+    }
+  }
+
+  //fill the halo region
+  ogsGatherScatter(diagA, ogsDfloat, ogsAdd, ogs);
+
+  //compute the inverse diagonal
+  for (dlong n=0;n<Nrows;n++) diagInv[n] = 1.0/diagA[n];
+}
+
+static void parCSRDinv(void *ctx, dfloat *r, dfloat *z){
+  parCSR *A = (parCSR *) ctx;
+  vectorDotStar(A->Nrows, 1.0, A->diagInv, r, 0.0, z);
+}
+
+//spectral radius of invD*A from Arnoldi, which does not need A to be symmetric
+// (the filtered matrix of the smoothed prolongation is not)
 dfloat parCSR::rhoDinvA(){
 
   int rank, size;
@@ -491,6 +681,117 @@ dfloat parCSR::rhoDinvA(){
   return rho;
 }
 
+void parCSR::boundsDinvA(dfloat *lmin, dfloat *lmax){
+  this->boundsSA(parCSRDinv, this, "DinvA", lmin, lmax);
+}
+
+dfloat parCSR::rhoSA(void (*S)(void *ctx, dfloat *r, dfloat *z), void *ctx, const char *tag){
+  dfloat lmin, lmax;
+  this->boundsSA(S, ctx, tag, &lmin, &lmax);
+  return lmax;
+}
+
+void parCSR::boundsSA(void (*S)(void *ctx, dfloat *r, dfloat *z), void *ctx, const char *tag,
+                      dfloat *lmin, dfloat *lmax){
+
+  int rank, size;
+  MPI_Comm_rank(comm, &rank);
+  MPI_Comm_size(comm, &size);
+
+  int k = 10;
+
+  hlong Ntotal = globalRowStarts[size];
+  if(k > Ntotal) k = (int) Ntotal;
+
+  // key the cached bounds on the global size and a checksum of the entries
+  long long int nnz = diag->nnz + offd->nnz, totalNnz = 0;
+  MPI_Allreduce(&nnz, &totalNnz, 1, MPI_LONG_LONG_INT, MPI_SUM, comm);
+
+  dfloat sums[2] = {0., 0.}, totalSums[2] = {0., 0.};
+  for (dlong i=0;i<Nrows;i++) sums[0] += diagA[i];
+  for (dlong n=0;n<diag->nnz;n++) sums[1] += fabs(diag->vals[n]);
+  for (dlong n=0;n<offd->nnz;n++) sums[1] += fabs(offd->vals[n]);
+  MPI_Allreduce(sums, totalSums, 2, MPI_DFLOAT, MPI_SUM, comm);
+
+  char key[BUFSIZ];
+  sprintf(key, "parCSR %s N=%lld nnz=%lld diag=%.15e abs=%.15e",
+          tag, (long long int) Ntotal, totalNnz, totalSums[0], totalSums[1]);
+
+  if (spectralBoundsLookup(key, lmin, lmax)) return;
+
+  // run k steps of CG preconditioned with S from a random rhs and
+  // read the spectral bounds of S*A off the implied Lanczos matrix
+  dfloat *alpha = (dfloat *) calloc(k, sizeof(dfloat));
+  dfloat *beta  = (dfloat *) calloc(k, sizeof(dfloat));
+
+  dfloat *r  = (dfloat *) calloc(Nrows, sizeof(dfloat));
+  dfloat *z  = (dfloat *) calloc(Nrows, sizeof(dfloat));
+  dfloat *Ap = (dfloat *) calloc(Nrows, sizeof(dfloat));
+  dfloat *p  = (dfloat *) calloc(Ncols, sizeof(dfloat));
+
+  vectorRandomize(Nrows, r);
+
+  // z = S*r, p = z
+  S(ctx, r, z);
+  vectorAdd(Nrows, 1.0, z, 0.0, p);
+
+  dfloat rdotz = vectorInnerProd(Nrows, r, z, comm);
+
+  int Nsteps = 0;
+  for(int j=0; j<k; j++){
+
+    this->SpMV(1.0, p, 0., Ap);
+
+    dfloat pAp = vectorInnerProd(Nrows, p, Ap, comm);
+    if (pAp<=0.0 || rdotz<=0.0) break; //breakdown
+
+    alpha[j] = rdotz/pAp;
+    Nsteps++;
+
+    // r = r - alpha*A*p, z = S*r
+    vectorAdd(Nrows, -alpha[j], Ap, 1.0, r);
+    S(ctx, r, z);
+
+    dfloat rdotzNew = vectorInnerProd(Nrows, r, z, comm);
+    beta[j] = rdotzNew/rdotz;
+    rdotz = rdotzNew;
+
+    // p = z + beta*p
+    vectorAdd(Nrows, 1.0, z, beta[j], p);
+  }
+
+  if (Nsteps) {
+    lanczosBounds(Nsteps, alpha, beta, lmin, lmax);
+  } else {
+    // CG broke down on the first step (e.g. S*A is not positive on the
+    // random vector): fall back to a power estimate of the spectral radius
+    // with no usable lower bound
+    vectorRandomize(Nrows, p);
+
+    dfloat rho = 0.;
+    for (int j=0; j<k; j++) {
+      dfloat pnorm = sqrt(vectorInnerProd(Nrows, p, p, comm));
+      if (pnorm==0.0) break;
+      vectorScale(Nrows, 1.0/pnorm, p);
+
+      this->SpMV(1.0, p, 0., Ap);
+      S(ctx, Ap, z);
+
+      rho = sqrt(vectorInnerProd(Nrows, z, z, comm));
+      vectorAdd(Nrows, 1.0, z, 0.0, p);
+    }
+
+    *lmin = 0.;
+    *lmax = (rho>0.) ? rho : 1.;
+  }
+  spectralBoundsStore(key, *lmin, *lmax);
+
+  free(alpha); free(beta);
+  free(r); free(z); free(Ap); free(p);
+
+  // printf("weight = %g \n", *lmax);
+}
+
 
 
 
@@ -501,7 +802,7 @@ dfloat parCSR::rhoDinvA(){
 //------------------------------------------------------------------------
 
 //build from parCSR
-parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
+parHYB::parHYB(parCSR *A, SpMVFormat format): matrix_t(A->Nrows, A->Ncols) {
 
   int *rowCounters = (int*) calloc(A->Nrows, sizeof(int));
 
@@ -554,11 +855,22 @@ parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
 
   int nnzPerRow = maxNnzPerRow;
 
+  //uneven rows waste ELL storage on padding, compare with sliced ELL
+  if ((format==FORMAT_SELL) || ((format==FORMAT_AUTO) && Nrows)) {
+    S = new SELL(A->diag);
+
+    const dfloat ellStorage = (dfloat) Nrows*maxNnzPerRow;
+    if ((format==FORMAT_AUTO) && (ellStorage <= SELL_SWITCH*S->nnz)) {
+      delete S;
+      S = NULL;
+    }
+  }
+
   //build the ELL matrix from the local CSR
   E = new ELL(Nrows, Ncols);
   C = new MCSR(Nrows, Ncols);
 
-  E->nnzPerRow = nnzPerRow;
+  E->nnzPerRow = (S) ? 0 : nnzPerRow; //the whole diag block lives in S
 
   E->cols  = (dlong *) calloc(Nrows*E->nnzPerRow, sizeof(dlong));
   E->vals = (dfloat *) calloc(Nrows*E->nnzPerRow, sizeof(dfloat));
@@ -574,13 +886,15 @@ parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
     // store only min of nnzPerRow and rowNnz
     int maxNnz = (nnzPerRow >= rowNnz) ? rowNnz : nnzPerRow;
 
-    for(int c=0; c<maxNnz; c++){
-      E->cols[i*nnzPerRow+c] = A->diag->cols[Jstart+c];
-      E->vals[i*nnzPerRow+c] = A->diag->vals[Jstart+c];
-    }
+    if (!S) {
+      for(int c=0; c<maxNnz; c++){
+        E->cols[i*nnzPerRow+c] = A->diag->cols[Jstart+c];
+        E->vals[i*nnzPerRow+c] = A->diag->vals[Jstart+c];
+      }
 
-    for(int c=maxNnz; c<nnzPerRow; c++){
-      E->cols[i*nnzPerRow+c] = -1; //ignore this column
+      for(int c=maxNnz; c<nnzPerRow; c++){
+        E->cols[i*nnzPerRow+c] = -1; //ignore this column
+      }
     }
 
     // count the number of nonzeros to be stored in MCSR format
@@ -667,6 +981,7 @@ parHYB::parHYB(parCSR *A): matrix_t(A->Nrows, A->Ncols) {
 
 parHYB::~parHYB() {
   delete E;
+  if (S) delete S;
   delete C;
 
   free(diagA);
@@ -691,6 +1006,7 @@ parHYB::~parHYB() {
 void parHYB::syncToDevice() {
 
   E->syncToDevice(device);
+  if (S) S->syncToDevice(device);
   C->syncToDevice(device);
 
   if (Nrows) {
@@ -705,6 +1021,70 @@ void parHYB::syncToDevice() {
     o_haloIds = device.malloc(Nshared*sizeof(dlong), haloIds);
 }
 
+//repack the values of A in the same layout as the constructor
+void parHYB::refreshValues(parCSR *A) {
+
+  //when S holds the diag block no diag entries spill into C
+  const int nnzPerRow = (S) ? 0 : E->nnzPerRow;
+
+  if (S) {
+    for (dlong s=0;s<S->Nslices;s++) {
+      const dlong start = S->sliceStarts[s];
+      const dlong width = (S->sliceStarts[s+1]-start)/SELL_C;
+
+      for (int r=0;r<SELL_C;r++) {
+        const dlong p = s*SELL_C+r;
+        if (p>=Nrows) continue;
+
+        const dlong row = S->rowPerm[p];
+        const dlong Jstart = A->diag->rowStarts[row];
+        const dlong rowNnz = A->diag->rowStarts[row+1]-Jstart;
+        for (dlong c=0;c<rowNnz && c<width;c++)
+          S->vals[start + c*SELL_C + r] = A->diag->vals[Jstart+c];
+      }
+    }
+  } else {
+    for (dlong i=0;i<Nrows;i++) {
+      const dlong Jstart = A->diag->rowStarts[i];
+      const int rowNnz = (int) (A->diag->rowStarts[i+1]-Jstart);
+      const int maxNnz = (nnzPerRow >= rowNnz) ? rowNnz : nnzPerRow;
+      for (int c=0;c<maxNnz;c++)
+        E->vals[i*nnzPerRow+c] = A->diag->vals[Jstart+c];
+    }
+  }
+
+  dlong cnt = 0;
+  for (dlong i=0;i<Nrows;i++) {
+    dlong Jstart = A->diag->rowStarts[i];
+    int rowNnz = (int) (A->diag->rowStarts[i+1]-Jstart);
+
+    if ((!S) && (rowNnz > nnzPerRow))
+      for (int c=nnzPerRow;c<rowNnz;c++)
+        C->vals[cnt++] = A->diag->vals[Jstart+c];
+
+    for (dlong j=A->offd->rowStarts[i];j<A->offd->rowStarts[i+1];j++)
+      C->vals[cnt++] = A->offd->vals[j];
+  }
+
+  //the device copy of E is stored column-major
+  if (E->nnzPerRow && Nrows) {
+    dfloat *valsT = (dfloat *) malloc(Nrows*E->nnzPerRow*sizeof(dfloat));
+    for (dlong n=0;n<Nrows;n++)
+      for (int i=0;i<E->nnzPerRow;i++)
+        valsT[n+i*Nrows] = E->vals[n*E->nnzPerRow+i];
+    E->o_vals.copyFrom(valsT, Nrows*E->nnzPerRow*sizeof(dfloat));
+    free(valsT);
+  }
+  if (S && S->nnz) S->o_vals.copyFrom(S->vals, S->nnz*sizeof(dfloat));
+  if (C->nnz) C->o_vals.copyFrom(C->vals, C->nnz*sizeof(dfloat));
+
+  //diagA and diagInv are shared with A
+  if (Nrows) {
+    o_diagA.copyFrom(diagA, Nrows*sizeof(dfloat));
+    o_diagInv.copyFrom(diagInv, Nrows*sizeof(dfloat));
+  }
+}
+
 void parHYB::haloExchangeStart(dfloat *x) {
   // copy data from outgoing elements into temporary send buffer
   for(int i=0;i<Nshared;++i){
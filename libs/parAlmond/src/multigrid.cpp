@@ -56,31 +56,34 @@ void solver_t::kcycle(int k){
   // rhsC = P^T res
   levelC->coarsen(res, rhsC);
 
-  if(k+1>NUMKCYCLES) {
-    this->vcycle(k+1);
-  } else{
-    // first inner krylov iteration
-    this->kcycle(k+1);
-
-    // ck = x
-    // alpha1=ck*rhsC, rho1=ck*Ack, norm_rhs=sqrt(rhsC*rhsC)
-    // rhsC = rhsC - (alpha1/rho1)*vkp1
-    // norm_rtilde = sqrt(rhsC*rhsC)
-    dfloat rho1, alpha1, norm_rhs, norm_rhstilde;
-    levelC->kcycleOp1(&alpha1, &rho1, &norm_rhs, &norm_rhstilde);
-
-    if(norm_rhstilde < KCYCLETOL*norm_rhs){
-      // xC = (alpha1/rho1)*xC
-      vectorScale(mCoarse, alpha1/rho1, xC);
+  //skip levels this rank was agglomerated out of
+  if (levelC->comm!=MPI_COMM_NULL) {
+    if(k+1>NUMKCYCLES) {
+      this->vcycle(k+1);
     } else{
-
-      // second inner krylov iteration
+      // first inner krylov iteration
       this->kcycle(k+1);
 
-      // gamma=xC*Ack, beta=xC*AxC, alpha2=xC*rhsC
-      // rho2=beta - gamma*gamma/rho1
-      // xC = (alpha1/rho1 - (gam*alpha2)/(rho1*rho2))*ck + (alpha2/rho2)*xC
-      levelC->kcycleOp2(alpha1, rho1);
+      // ck = x
+      // alpha1=ck*rhsC, rho1=ck*Ack, norm_rhs=sqrt(rhsC*rhsC)
+      // rhsC = rhsC - (alpha1/rho1)*vkp1
+      // norm_rtilde = sqrt(rhsC*rhsC)
+      dfloat rho1, alpha1, norm_rhs, norm_rhstilde;
+      levelC->kcycleOp1(&alpha1, &rho1, &norm_rhs, &norm_rhstilde);
+
+      if(norm_rhstilde < KCYCLETOL*norm_rhs){
+        // xC = (alpha1/rho1)*xC
+        vectorScale(mCoarse, alpha1/rho1, xC);
+      } else{
+
+        // second inner krylov iteration
+        this->kcycle(k+1);
+
+        // gamma=xC*Ack, beta=xC*AxC, alpha2=xC*rhsC
+        // rho2=beta - gamma*gamma/rho1
+        // xC = (alpha1/rho1 - (gam*alpha2)/(rho1*rho2))*ck + (alpha2/rho2)*xC
+        levelC->kcycleOp2(alpha1, rho1);
+      }
     }
   }
 
@@ -127,30 +130,33 @@ void solver_t::device_kcycle(int k){
   // rhsC = P^T res
   levelC->coarsen(o_res, o_rhsC);
 
-  if(k+1>NUMKCYCLES) {
-    this->device_vcycle(k+1);
-  } else{
-    // first inner krylov iteration
-    this->device_kcycle(k+1);
-
-    // alpha1=ck*rhsC, rho1=ck*Ack, norm_rhs=sqrt(rhsC*rhsC)
-    // rhsC = rhsC - (alpha1/rho1)*vkp1
-    // norm_rtilde = sqrt(rhsC*rhsC)
-    dfloat rho1, alpha1, norm_rhs, norm_rhstilde;
-    levelC->device_kcycleOp1(&alpha1, &rho1, &norm_rhs, &norm_rhstilde);
-
-    if(norm_rhstilde < KCYCLETOL*norm_rhs){
-      // xC = (alpha1/rho1)*xC
-      vectorScale(mCoarse, alpha1/rho1, o_xC);
+  //skip levels this rank was agglomerated out of
+  if (levelC->comm!=MPI_COMM_NULL) {
+    if(k+1>NUMKCYCLES) {
+      this->device_vcycle(k+1);
     } else{
-
-      // second inner krylov iteration
+      // first inner krylov iteration
       this->device_kcycle(k+1);
 
-      // gamma=xC*Ack, beta=xC*AxC, alpha2=xC*rhsC
-      // rho2=beta - gamma*gamma/rho1
-      // xC = (alpha1/rho1 - (gam*alpha2)/(rho1*rho2))*ck + (alpha2/rho2)*xC
-      levelC->device_kcycleOp2(alpha1, rho1);
+      // alpha1=ck*rhsC, rho1=ck*Ack, norm_rhs=sqrt(rhsC*rhsC)
+      // rhsC = rhsC - (alpha1/rho1)*vkp1
+      // norm_rtilde = sqrt(rhsC*rhsC)
+      dfloat rho1, alpha1, norm_rhs, norm_rhstilde;
+      levelC->device_kcycleOp1(&alpha1, &rho1, &norm_rhs, &norm_rhstilde);
+
+      if(norm_rhstilde < KCYCLETOL*norm_rhs){
+        // xC = (alpha1/rho1)*xC
+        vectorScale(mCoarse, alpha1/rho1, o_xC);
+      } else{
+
+        // second inner krylov iteration
+        this->device_kcycle(k+1);
+
+        // gamma=xC*Ack, beta=xC*AxC, alpha2=xC*rhsC
+        // rho2=beta - gamma*gamma/rho1
+        // xC = (alpha1/rho1 - (gam*alpha2)/(rho1*rho2))*ck + (alpha2/rho2)*xC
+        levelC->device_kcycleOp2(alpha1, rho1);
+      }
     }
   }
 
@@ -189,7 +195,10 @@ void solver_t::vcycle(int k) {
   // rhsC = P^T res
   levelC->coarsen(res, rhsC);
 
-  this->vcycle(k+1);
+  //skip levels this rank was agglomerated out of
+  if (levelC->comm!=MPI_COMM_NULL) {
+    this->vcycle(k+1);
+  }
 
   // x = x + P xC
   levelC->prolongate(xC, x);
@@ -234,7 +243,10 @@ void solver_t::device_vcycle(int k){
   // rhsC = P^T res
   levelC->coarsen(o_res, o_rhsC);
 
-  this->device_vcycle(k+1);
+  //skip levels this rank was agglomerated out of
+  if (levelC->comm!=MPI_COMM_NULL) {
+    this->device_vcycle(k+1);
+  }
 
   // x = x + P xC
   levelC->prolongate(o_xC, o_x);
@@ -49,18 +49,55 @@ void AMGSetup(solver_t *MM,
 
   solver_t *M = (solver_t *) MM;
 
+  dlong numLocalRows = (dlong) (globalRowStarts[M->rank+1]-globalRowStarts[M->rank]);
+
+  //the constant vector is the near-nullspace
+  dfloat *ones = (dfloat *) calloc(numLocalRows+1, sizeof(dfloat));
+  for (dlong i=0;i<numLocalRows;i++) ones[i] = 1.0;
+
+  AMGSetup(M, globalRowStarts, nnz, Ai, Aj, Avals,
+           nullSpace, nullSpacePenalty, 1, ones);
+
+  free(ones);
+}
+
+void AMGSetup(solver_t *MM,
+               hlong* globalRowStarts,       //global partition
+               dlong nnz,                    //--
+               hlong* Ai,                    //-- Local A matrix data (globally indexed, COO storage, row sorted)
+               hlong* Aj,                    //--
+               dfloat* Avals,                //--
+               bool nullSpace,
+               dfloat nullSpacePenalty,
+               int NnullVectors,             //number of near-nullspace vectors
+               dfloat *nullVectors){         //NnullVectors entries per local row
+
+  solver_t *M = (solver_t *) MM;
+
   int rank, size;
   MPI_Comm_rank(M->comm, &rank);
   MPI_Comm_size(M->comm, &size);
 
-  hlong TotalRows = globalRowStarts[M->size];
   dlong numLocalRows = (dlong) (globalRowStarts[M->rank+1]-globalRowStarts[M->rank]);
 
   if(rank==0) printf("Setting up AMG...");fflush(stdout);
 
-  //populate null space vector
-  dfloat *null = (dfloat *) calloc(numLocalRows, sizeof(dfloat));
-  for (dlong i=0;i<numLocalRows;i++) null[i] = 1/sqrt(TotalRows);
+  //normalize the near-nullspace vectors
+  const int K = NnullVectors;
+  dfloat *B = (dfloat *) calloc(numLocalRows*K+1, sizeof(dfloat));
+  memcpy(B, nullVectors, numLocalRows*K*sizeof(dfloat));
+  for (int m=0;m<K;m++) {
+    dfloat localNorm = 0., norm = 0.;
+    for (dlong i=0;i<numLocalRows;i++) localNorm += B[i*K+m]*B[i*K+m];
+    MPI_Allreduce(&localNorm, &norm, 1, MPI_DFLOAT, MPI_SUM, M->comm);
+    norm = sqrt(norm);
+    if (norm>0.)
+      for (dlong i=0;i<numLocalRows;i++) B[i*K+m] /= norm;
+  }
+
+  //the first vector is the null vector used for the nullspace penalty
+  dfloat *null = (dfloat *) calloc(numLocalRows+1, sizeof(dfloat));
+  for (dlong i=0;i<numLocalRows;i++) null[i] = B[i*K];
 
   parCSR *A = new parCSR(numLocalRows,globalRowStarts,
                           nnz, Ai, Aj, Avals,
@@ -68,11 +105,50 @@ void AMGSetup(solver_t *MM,
                           M->comm, M->device);
   free(null);
 
+  if (K>1) {
+    A->NnullVectors = K;
+    A->nullVectors = B;
+  } else {
+    free(B);
+  }
+
   M->AMGSetup(A);
 
   if(rank==0) printf("done.\n");
 }
 
+void AMGRefresh(solver_t *MM,
+               hlong* globalRowStarts,       //global partition
+               dlong nnz,                    //--
+               hlong* Ai,                    //-- Local A matrix data (globally indexed, COO storage, row sorted)
+               hlong* Aj,                    //--
+               dfloat* Avals,                //--
+               bool nullSpace,
+               dfloat nullSpacePenalty){
+
+  solver_t *M = (solver_t *) MM;
+
+  dlong numLocalRows = (dlong) (globalRowStarts[M->rank+1]-globalRowStarts[M->rank]);
+
+  //normalized constant null vector, only used if A itself is the coarse level
+  hlong globalRows = globalRowStarts[M->size];
+  dfloat *null = (dfloat *) calloc(numLocalRows+1, sizeof(dfloat));
+  for (dlong i=0;i<numLocalRows;i++) null[i] = 1.0/sqrt((dfloat) globalRows);
+
+  parCSR *A = new parCSR(numLocalRows,globalRowStarts,
+                          nnz, Ai, Aj, Avals,
+                          nullSpace, null, nullSpacePenalty,
+                          M->comm, M->device);
+  free(null);
+
+  M->AMGRefresh(A);
+
+  //A borrows the caller's partition
+  A->globalRowStarts = NULL;
+  A->globalColStarts = NULL;
+  delete A;
+}
+
 void Precon(solver_t *M, occa::memory o_x, occa::memory o_rhs) {
 
   M->levels[0]->o_x   = o_x;
@@ -58,14 +58,34 @@ solver_t::solver_t(occa::device device_, MPI_Comm comm_,
   else
     ctype = KCYCLE;
 
+  //local SpMV storage of the AMG levels
+  if (options.compareArgs("PARALMOND SPMV FORMAT", "SELL"))
+    format = FORMAT_SELL;
+  else if (options.compareArgs("PARALMOND SPMV FORMAT", "ELL"))
+    format = FORMAT_ELL;
+  else
+    format = FORMAT_AUTO;
+
   if (options.compareArgs("PARALMOND SMOOTHER", "CHEBYSHEV")) {
     stype = CHEBYSHEV;
     ChebyshevIterations = 0;
     options.getArgs("PARALMOND CHEBYSHEV DEGREE", ChebyshevIterations);
     if (!ChebyshevIterations) ChebyshevIterations=2; //default to 2
+
+    //fourth-kind polynomial only needs the upper spectral bound
+    if (options.compareArgs("PARALMOND SMOOTHER", "FOURTHKIND"))
+      stype = CHEBYSHEV4;
+  } else if (options.compareArgs("PARALMOND SMOOTHER", "BLOCKJACOBI")) {
+    stype = BLOCK_JACOBI;
+  } else if (options.compareArgs("PARALMOND SMOOTHER", "GAUSSSEIDEL")) {
+    stype = GAUSS_SEIDEL;
   } else { //default to DAMPED_JACOBI
     stype = DAMPED_JACOBI;
   }
+
+  //rows per block of the finest AMG level for block Jacobi (0 uses aggregates)
+  blockJacobiSize = 0;
+  options.getArgs("PARALMOND BLOCK SIZE", blockJacobiSize);
 }
 
 solver_t::~solver_t() {
@@ -87,12 +107,36 @@ void solver_t::Report() {
   }
 
   for(int lev=0; lev<numLevels; lev++) {
+    if (levels[lev]->comm==MPI_COMM_NULL) continue; //agglomerated away
+
     if(rank==0) {printf(" %3d ", lev);fflush(stdout);}
     levels[lev]->Report();
   }
 
   if(rank==0)
     printf("--------------------------------------------------------------------------\n");
+
+  //operator complexity of the AMG levels, relative to the first AMG level
+  long long int fineNnz=0, totalNnz=0;
+  for(int lev=AMGstartLev; lev<numLevels; lev++) {
+    if (levels[lev]->comm==MPI_COMM_NULL) continue; //agglomerated away
+
+    parCSR *A = ((agmgLevel*)levels[lev])->A;
+    long long int nnz = A->diag->nnz+A->offd->nnz, levelNnz=0;
+    MPI_Allreduce(&nnz, &levelNnz, 1, MPI_LONG_LONG_INT, MPI_SUM, levels[lev]->comm);
+
+    if (lev==AMGstartLev) fineNnz = levelNnz;
+    totalNnz += levelNnz;
+
+    const char *formatString = (((agmgLevel*)levels[lev])->o_A->S) ? "SELL" : "ELL";
+
+    if(rank==0) printf(" %3d  AMG level nnz = %12lld, operator complexity = %5.3f, SpMV %s\n",
+                       lev, levelNnz, (double) levelNnz/fineNnz, formatString);
+  }
+  if(rank==0) {
+    printf("     AMG total operator complexity = %5.3f\n", (double) totalNnz/fineNnz);
+    printf("--------------------------------------------------------------------------\n");
+  }
 }
 
 }
@@ -0,0 +1,106 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "parAlmond.hpp"
+#include <map>
+#include <string>
+#include <utility>
+
+namespace parAlmond {
+
+//spectral bounds of the smoothed operators, kept for the life of the run so
+// solvers rebuilt with the same operator (e.g. INS substeps) skip the estimate
+static std::map<std::string, std::pair<dfloat,dfloat> > spectralBoundsCache;
+
+bool spectralBoundsLookup(const char *key, dfloat *lmin, dfloat *lmax){
+
+  std::map<std::string, std::pair<dfloat,dfloat> >::iterator it
+                                        = spectralBoundsCache.find(std::string(key));
+  if (it==spectralBoundsCache.end()) return false;
+
+  *lmin = it->second.first;
+  *lmax = it->second.second;
+  return true;
+}
+
+void spectralBoundsStore(const char *key, dfloat lmin, dfloat lmax){
+  spectralBoundsCache[std::string(key)] = std::make_pair(lmin, lmax);
+}
+
+void spectralBoundsClear(){
+  spectralBoundsCache.clear();
+}
+
+// The Ritz lmin lies inside the spectrum, so it is scaled down by a safety
+// factor. A smoother only has to damp the upper part of the spectrum, so the
+// interval is not stretched beyond lmax/CHEBYSHEV_MAX_RATIO when S*A is ill
+// conditioned
+dfloat chebyshevLowerBound(dfloat lmin, dfloat lmax){
+
+  dfloat lambda0 = CHEBYSHEV_LMIN_SAFETY*lmin;
+  dfloat lambdaFloor = lmax/CHEBYSHEV_MAX_RATIO;
+
+  return (lambda0 > lambdaFloor) ? lambda0 : lambdaFloor;
+}
+
+// Extremal Ritz values of the preconditioned operator from k steps of PCG.
+// The Lanczos tridiagonal is recovered from the PCG coefficients as
+//   T(j,j)   = 1/alpha_j + beta_{j-1}/alpha_{j-1}
+//   T(j,j+1) = sqrt(beta_j)/alpha_j
+void lanczosBounds(int k, dfloat *alpha, dfloat *beta, dfloat *lmin, dfloat *lmax){
+
+  *lmin = 0.; *lmax = 0.;
+  if (k<1) return;
+
+  double *D = (double *) calloc(k, sizeof(double));
+  double *E = (double *) calloc(k, sizeof(double));
+
+  for (int j=0;j<k;j++) {
+    D[j] = 1.0/alpha[j];
+    if (j>0) D[j] += beta[j-1]/alpha[j-1];
+    if (j<k-1) E[j] = sqrt(beta[j])/alpha[j];
+  }
+
+  char JOBZ = 'N';
+  int N = k;
+  int LDZ = 1;
+  int INFO = -999;
+  double Z = 0.;
+  double *WORK = (double *) calloc(2*k, sizeof(double));
+
+  //eigenvalues are returned in ascending order in D
+  dstev_(&JOBZ, &N, D, E, &Z, &LDZ, WORK, &INFO);
+
+  if (INFO)
+    printf("lanczosBounds: dstev reports info = %d\n", INFO);
+
+  *lmin = (dfloat) D[0];
+  *lmax = (dfloat) D[k-1];
+
+  free(D); free(E); free(WORK);
+}
+
+} //namespace parAlmond
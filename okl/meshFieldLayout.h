@@ -24,35 +24,19 @@ SOFTWARE.
 
 */
 
-#include "acoustics.h"
-
-dfloat acousticsDopriEstimate(acoustics_t *acoustics){
-  
-  mesh_t *mesh = acoustics->mesh;
-  
-  // should insert err = acousticsDopriEstimate2D() here
-  //Error estimation 
-  //E. HAIRER, S.P. NORSETT AND G. WANNER, SOLVING ORDINARY
-  //      DIFFERENTIAL EQUATIONS I. NONSTIFF PROBLEMS. 2ND EDITION.
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  acoustics->rkErrorEstimateKernel(Ntotal, 
-				   acoustics->ATOL,
-				   acoustics->RTOL,
-				   acoustics->o_q,
-				   acoustics->o_rkq,
-				   acoustics->o_rkerr,
-				   acoustics->o_errtmp);
-  
-  acoustics->o_errtmp.copyTo(acoustics->errtmp);
-  dfloat localerr = 0;
-  dfloat err = 0;
-  for(dlong n=0;n<acoustics->Nblock;++n){
-    localerr += acoustics->errtmp[n];
-  }
-  MPI_Allreduce(&localerr, &err, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
-
-  err = sqrt(err/(mesh->Np*acoustics->totalElements*acoustics->Nfields));
-  
-  return err;
-}
-  
+// DG state vector layouts selected by FIELD LAYOUT (see meshFieldLayoutSetup):
+// node n of field fld on element e lives at meshFieldBase(Nfields,e,n) + fld*p_fieldStride
+
+#if p_fieldLayout==1 // SOA
+
+#define meshFieldBase(Nfields,e,n) ((e)*p_Np + (n))
+
+#elif p_fieldLayout==2 // AOSOA
+
+#define meshFieldBase(Nfields,e,n) (((e)/p_fieldBlock)*p_fieldBlock*p_Np*(Nfields) + ((e)%p_fieldBlock)*p_Np + (n))
+
+#else // AOS
+
+#define meshFieldBase(Nfields,e,n) ((e)*p_Np*(Nfields) + (n))
+
+#endif
@@ -33,6 +33,8 @@ SOFTWARE.
 #include "mesh.h"
 #include "mesh2D.h"
 #include "mesh3D.h"
+#include "dopri.h"
+#include "mrab.h"
 
 // block size for reduction (hard coded)
 #define blockSize 256
@@ -44,15 +46,19 @@ typedef struct{
   
   int Nfields;
 
+  int Nensemble; // number of independent fields advanced together, q[e][member][field][node]
+
+  int wadgFlag;  // ACOUSTICS FORMULATION is WADG, variable wave speed c2
+  int wadgLowStorageFlag; // c2 stored per element vertex instead of per cubature node
+
+  int bernFlag; // BASIS is BERN, q holds Bernstein-Bezier coefficients
+
   hlong totalElements;
-  dlong Nblock;
 
   dfloat *q, *rhsq, *resq;
 
   dfloat *Vort;
 
-  dfloat *rkq, *rkrhsq, *rkerr;
-  dfloat *errtmp;
   int frame;
 
   mesh_t *mesh;
@@ -60,17 +66,17 @@ typedef struct{
   occa::kernel volumeKernel;
   occa::kernel surfaceKernel;
   occa::kernel updateKernel;
-  occa::kernel rkStageKernel;
-  occa::kernel rkUpdateKernel;
-  occa::kernel rkErrorEstimateKernel;
+  occa::kernel wadgKernel;
 
   occa::memory o_q;
   occa::memory o_rhsq;
   occa::memory o_resq;
   occa::memory o_saveq;
-  
-  occa::memory o_rkq, o_rkrhsq, o_rkerr;
-  occa::memory o_errtmp;
+
+  // WADG wave speed: c2 at cubature nodes, or at element vertices with the
+  // vertex to cubature node interpolation in o_c2Interp
+  occa::memory o_c2;
+  occa::memory o_c2Interp;
   
   //halo data
   dlong haloBytes;
@@ -82,13 +88,28 @@ typedef struct{
 
   // DOPRI5 RK data
   int advSwitch;
-  int Nrk;
-  dfloat ATOL, RTOL;
-  dfloat factor1, invfactor1;
-  dfloat factor2, invfactor2;
-  dfloat exp1, facold,  dtMIN, safe, beta;
-  dfloat *rkA, *rkC, *rkE;
-  occa::memory o_rkA, o_rkC, o_rkE;
+  dopri_t *dopri;
+
+  // multirate Adams Bashforth data
+  mrab_t *mrab;
+
+  // receivers: element ids and nodal interpolation weights per receiver, samples
+  // are gathered on the device into a [receiverBufferSteps][Nreceivers][Nensemble]
+  // ring buffer and written to the trace file when it fills
+  int Nreceivers;
+  int *receiverIds;
+  int receiverBufferSteps;
+  int receiverNsamples;
+  dfloat *receiverTimes;
+  dfloat *receiverSamples;
+  FILE *receiverFile;
+
+  occa::kernel receiverKernel;
+
+  occa::memory o_receiverElementIds;
+  occa::memory o_receiverInterp;
+  occa::memory o_receiverSamples;
+  occa::memory o_receiverSamplesH;
   
 }acoustics_t;
 
@@ -105,15 +126,23 @@ void acousticsCavitySolution(dfloat x, dfloat y, dfloat z, dfloat t,
 void acousticsGaussianPulse(dfloat x, dfloat y, dfloat z, dfloat t,
 		      dfloat *u, dfloat *v, dfloat *w, dfloat *p);
 
+dfloat acousticsWaveSpeed2(dfloat x, dfloat y, dfloat z);
+
 void acousticsReport(acoustics_t *acoustics, dfloat time, setupAide &newOptions);
 
 void acousticsPlotVTU(acoustics_t *acoustics, char *fileName);
 
-void acousticsDopriStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time);
+void acousticsRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq);
 
-void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOoptions, const dfloat time);
+void acousticsMRABRhs(void *solver, dfloat time, int lev, occa::memory &o_q, occa::memory &o_rhsq);
+
+void acousticsReceiversSetup(acoustics_t *acoustics, setupAide &newOptions, occa::properties &kernelInfo);
+
+void acousticsReceiversRecord(acoustics_t *acoustics, dfloat time);
 
-dfloat acousticsDopriEstimate(acoustics_t *acoustics);
+void acousticsReceiversFlush(acoustics_t *acoustics);
+
+void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOoptions, const dfloat time);
 
 #define TRIANGLES 3
 #define QUADRILATERALS 4
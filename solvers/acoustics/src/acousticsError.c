@@ -35,29 +35,29 @@ void acousticsError(acoustics_t *acoustics, dfloat time){
 
   mesh_t *mesh = acoustics->mesh;
 
-  dfloat maxR = 0;
-  dfloat minR = 1E9;
-  for(int e=0;e<mesh->Nelements;++e){
-    for(int n=0;n<mesh->Np;++n){
-      dfloat u,v,w, p;
-      int id = n+e*mesh->Np;
-      dfloat x = mesh->x[id];
-      dfloat y = mesh->y[id];
-      dfloat z = mesh->z[id];
-
-      int qbase = n+e*mesh->Np*mesh->Nfields;
-      maxR = mymax(maxR, acoustics->q[qbase]);
-      minR = mymin(minR, acoustics->q[qbase]);
+  // density range of each ensemble member
+  for(int k=0;k<acoustics->Nensemble;++k){
+    dfloat maxR = 0;
+    dfloat minR = 1E9;
+    for(int e=0;e<mesh->Nelements;++e){
+      for(int n=0;n<mesh->Np;++n){
+        dlong qbase = n+(e*acoustics->Nensemble+k)*mesh->Np*mesh->Nfields;
+        maxR = mymax(maxR, acoustics->q[qbase]);
+        minR = mymin(minR, acoustics->q[qbase]);
+      }
     }
-  }
-
-  // compute maximum over all processes
-  dfloat globalMaxR;
-  dfloat globalMinR;
-  MPI_Allreduce(&maxR, &globalMaxR, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
-  MPI_Allreduce(&minR, &globalMinR, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
 
-  if(mesh->rank==0)
-    printf("%g, %g, %g ( time, min density, max density)\n", time, globalMinR, globalMaxR);
-  
+    // compute maximum over all processes
+    dfloat globalMaxR;
+    dfloat globalMinR;
+    MPI_Allreduce(&maxR, &globalMaxR, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+    MPI_Allreduce(&minR, &globalMinR, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+
+    if(mesh->rank==0){
+      if(acoustics->Nensemble>1)
+        printf("%g, %g, %g ( time, min density, max density) member %d\n", time, globalMinR, globalMaxR, k);
+      else
+        printf("%g, %g, %g ( time, min density, max density)\n", time, globalMinR, globalMaxR);
+    }
+  }
 }
@@ -0,0 +1,335 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "acoustics.h"
+
+// reference coordinates (r,s,t) of the physical point (x,y,z) in element e,
+// returns 1 if the point lies in the element
+static int acousticsReceiverLocate(acoustics_t *acoustics, dlong e,
+                                   dfloat x, dfloat y, dfloat z,
+                                   dfloat *r, dfloat *s, dfloat *t){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  const dfloat tol = 1e-8;
+
+  dfloat *EX = mesh->EX + e*mesh->Nverts;
+  dfloat *EY = mesh->EY + e*mesh->Nverts;
+  dfloat *EZ = (acoustics->dim==3) ? mesh->EZ + e*mesh->Nverts : NULL;
+
+  *r = 0; *s = 0; *t = -1;
+
+  if(acoustics->elementType==TRIANGLES){
+    // x = xA + (xB-xA)*(1+r)/2 + (xC-xA)*(1+s)/2
+    dfloat a11 = EX[1]-EX[0], a12 = EX[2]-EX[0];
+    dfloat a21 = EY[1]-EY[0], a22 = EY[2]-EY[0];
+    dfloat bx = x-EX[0], by = y-EY[0];
+    dfloat det = a11*a22 - a12*a21;
+    dfloat lB = ( a22*bx - a12*by)/det;
+    dfloat lC = (-a21*bx + a11*by)/det;
+    *r = 2*lB-1; *s = 2*lC-1;
+    return (lB>-tol && lC>-tol && lB+lC<1+tol);
+  }
+
+  if(acoustics->elementType==TETRAHEDRA){
+    // x = xA + (xB-xA)*(1+r)/2 + (xC-xA)*(1+s)/2 + (xD-xA)*(1+t)/2
+    dfloat A[3][3] = {{EX[1]-EX[0], EX[2]-EX[0], EX[3]-EX[0]},
+                      {EY[1]-EY[0], EY[2]-EY[0], EY[3]-EY[0]},
+                      {EZ[1]-EZ[0], EZ[2]-EZ[0], EZ[3]-EZ[0]}};
+    dfloat b[3] = {x-EX[0], y-EY[0], z-EZ[0]};
+    dfloat det = A[0][0]*(A[1][1]*A[2][2]-A[1][2]*A[2][1])
+                -A[0][1]*(A[1][0]*A[2][2]-A[1][2]*A[2][0])
+                +A[0][2]*(A[1][0]*A[2][1]-A[1][1]*A[2][0]);
+    dfloat l[3];
+    for(int c=0;c<3;++c){ // Cramer's rule
+      dfloat Ac[3][3];
+      for(int i=0;i<3;++i)
+        for(int j=0;j<3;++j)
+          Ac[i][j] = (j==c) ? b[i] : A[i][j];
+      l[c] = (Ac[0][0]*(Ac[1][1]*Ac[2][2]-Ac[1][2]*Ac[2][1])
+             -Ac[0][1]*(Ac[1][0]*Ac[2][2]-Ac[1][2]*Ac[2][0])
+             +Ac[0][2]*(Ac[1][0]*Ac[2][1]-Ac[1][1]*Ac[2][0]))/det;
+    }
+    *r = 2*l[0]-1; *s = 2*l[1]-1; *t = 2*l[2]-1;
+    return (l[0]>-tol && l[1]>-tol && l[2]>-tol && l[0]+l[1]+l[2]<1+tol);
+  }
+
+  // quadrilaterals and hexahedra: Newton iteration on the (multi)linear vertex map
+  const int Ncorners = (acoustics->elementType==QUADRILATERALS) ? 4:8;
+  const dfloat cr[8] = {-1, 1, 1,-1,-1, 1, 1,-1};
+  const dfloat cs[8] = {-1,-1, 1, 1,-1,-1, 1, 1};
+  const dfloat ct[8] = {-1,-1,-1,-1, 1, 1, 1, 1};
+  const dfloat scale = (Ncorners==4) ? 0.25:0.125;
+
+  *t = 0;
+  for(int it=0;it<20;++it){
+    dfloat F[3] = {-x,-y,-z}, J[3][3] = {{0,0,0},{0,0,0},{0,0,0}};
+    for(int v=0;v<Ncorners;++v){
+      dfloat lr = 1+cr[v]*(*r), ls = 1+cs[v]*(*s), lt = (Ncorners==8) ? 1+ct[v]*(*t) : 2;
+      dfloat X[3] = {EX[v], EY[v], (Ncorners==8) ? EZ[v] : 0};
+      for(int d=0;d<3;++d){
+        F[d]    += scale*lr*ls*lt*X[d];
+        J[d][0] += scale*cr[v]*ls*lt*X[d];
+        J[d][1] += scale*lr*cs[v]*lt*X[d];
+        J[d][2] += scale*lr*ls*ct[v]*X[d];
+      }
+    }
+    if(Ncorners==4){
+      dfloat det = J[0][0]*J[1][1]-J[0][1]*J[1][0];
+      *r -= ( J[1][1]*F[0] - J[0][1]*F[1])/det;
+      *s -= (-J[1][0]*F[0] + J[0][0]*F[1])/det;
+    } else {
+      dfloat det = J[0][0]*(J[1][1]*J[2][2]-J[1][2]*J[2][1])
+                  -J[0][1]*(J[1][0]*J[2][2]-J[1][2]*J[2][0])
+                  +J[0][2]*(J[1][0]*J[2][1]-J[1][1]*J[2][0]);
+      dfloat dr = ( F[0]*(J[1][1]*J[2][2]-J[1][2]*J[2][1])
+                   -J[0][1]*(F[1]*J[2][2]-J[1][2]*F[2])
+                   +J[0][2]*(F[1]*J[2][1]-J[1][1]*F[2]))/det;
+      dfloat ds = ( J[0][0]*(F[1]*J[2][2]-J[1][2]*F[2])
+                   -F[0]*(J[1][0]*J[2][2]-J[1][2]*J[2][0])
+                   +J[0][2]*(J[1][0]*F[2]-F[1]*J[2][0]))/det;
+      dfloat dt = ( J[0][0]*(J[1][1]*F[2]-F[1]*J[2][1])
+                   -J[0][1]*(J[1][0]*F[2]-F[1]*J[2][0])
+                   +F[0]*(J[1][0]*J[2][1]-J[1][1]*J[2][0]))/det;
+      *r -= dr; *s -= ds; *t -= dt;
+    }
+    // far outside this element
+    if(fabs(*r)>3 || fabs(*s)>3 || fabs(*t)>3) return 0;
+  }
+  if(Ncorners==4) *t = 0;
+
+  return (fabs(*r)<1+tol && fabs(*s)<1+tol && fabs(*t)<1+tol);
+}
+
+// orthonormal Vandermonde of the element's polynomial space at Npoints points
+static dfloat *acousticsReceiverVandermonde(acoustics_t *acoustics, int Npoints,
+                                            dfloat *r, dfloat *s, dfloat *t){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  dfloat *V = NULL, *Vr = NULL, *Vs = NULL, *Vt = NULL;
+  switch(acoustics->elementType){
+  case TRIANGLES:      meshVandermondeTri2D (mesh->N, Npoints, r, s, &V, &Vr, &Vs); break;
+  case QUADRILATERALS: meshVandermondeQuad2D(mesh->N, Npoints, r, s, &V, &Vr, &Vs); break;
+  case TETRAHEDRA:     meshVandermondeTet3D (mesh->N, Npoints, r, s, t, &V, &Vr, &Vs, &Vt); break;
+  case HEXAHEDRA:      meshVandermondeHex3D (mesh->N, Npoints, r, s, t, &V, &Vr, &Vs, &Vt); break;
+  }
+  free(Vr); free(Vs); free(Vt);
+
+  return V;
+}
+
+// nodal interpolation weights at (r,s,t), I[n] = sum_m V(r,s,t)[m]*invV[m][n]
+static void acousticsReceiverInterp(acoustics_t *acoustics, dfloat r, dfloat s, dfloat t,
+                                    dfloat *invV, dfloat *I){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  dfloat *V = acousticsReceiverVandermonde(acoustics, 1, &r, &s, &t);
+
+  for(int n=0;n<mesh->Np;++n){
+    I[n] = 0;
+    for(int m=0;m<mesh->Np;++m)
+      I[n] += V[m]*invV[m*mesh->Np+n];
+  }
+
+  free(V);
+}
+
+// locate the receivers listed in RECEIVERS FILE (one "x y [z]" per line) and
+// set up the device ring buffer their samples are gathered into
+void acousticsReceiversSetup(acoustics_t *acoustics, setupAide &newOptions, occa::properties &kernelInfo){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  acoustics->Nreceivers = 0;
+  acoustics->receiverNsamples = 0;
+  acoustics->receiverFile = NULL;
+
+  string fileName;
+  if(!newOptions.getArgs("RECEIVERS FILE", fileName)) return;
+
+  FILE *fp = fopen(fileName.c_str(), "r");
+  if(!fp){
+    if(mesh->rank==0) printf("ERROR: could not open RECEIVERS FILE %s\n", fileName.c_str());
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  int NreceiversTotal = 0, maxReceivers = 16;
+  dfloat *xyz = (dfloat*) calloc(3*maxReceivers, sizeof(dfloat));
+  char buf[BUFSIZ];
+  while(fgets(buf, BUFSIZ, fp)){
+    dfloat x = 0, y = 0, z = 0;
+    if(sscanf(buf, dfloatFormat " " dfloatFormat " " dfloatFormat, &x, &y, &z)<2) continue;
+    if(NreceiversTotal==maxReceivers){
+      maxReceivers *= 2;
+      xyz = (dfloat*) realloc(xyz, 3*maxReceivers*sizeof(dfloat));
+    }
+    xyz[3*NreceiversTotal+0] = x;
+    xyz[3*NreceiversTotal+1] = y;
+    xyz[3*NreceiversTotal+2] = z;
+    ++NreceiversTotal;
+  }
+  fclose(fp);
+
+  // inverse of the orthonormal Vandermonde at the element nodes
+  dfloat *invV = acousticsReceiverVandermonde(acoustics, mesh->Np, mesh->r, mesh->s, mesh->t);
+  matrixInverse(mesh->Np, invV);
+
+  // a receiver on an element boundary belongs to the lowest rank containing it
+  int *owner = (int*) calloc(NreceiversTotal, sizeof(int));
+  int *globalOwner = (int*) calloc(NreceiversTotal, sizeof(int));
+  dlong *elementIds = (dlong*) calloc(NreceiversTotal, sizeof(dlong));
+  dfloat *rst = (dfloat*) calloc(3*NreceiversTotal, sizeof(dfloat));
+
+  for(int n=0;n<NreceiversTotal;++n){
+    owner[n] = mesh->size;
+    for(dlong e=0;e<mesh->Nelements;++e){
+      dfloat r, s, t;
+      if(acousticsReceiverLocate(acoustics, e, xyz[3*n+0], xyz[3*n+1], xyz[3*n+2], &r, &s, &t)){
+        owner[n] = mesh->rank;
+        elementIds[n] = e;
+        rst[3*n+0] = r; rst[3*n+1] = s; rst[3*n+2] = t;
+        break;
+      }
+    }
+  }
+  MPI_Allreduce(owner, globalOwner, NreceiversTotal, MPI_INT, MPI_MIN, mesh->comm);
+
+  int Nreceivers = 0;
+  for(int n=0;n<NreceiversTotal;++n)
+    if(globalOwner[n]==mesh->rank) ++Nreceivers;
+
+  acoustics->Nreceivers = Nreceivers;
+  acoustics->receiverIds = (int*) calloc(Nreceivers, sizeof(int));
+  dlong *receiverElementIds = (dlong*) calloc(Nreceivers, sizeof(dlong));
+  dfloat *receiverInterp = (dfloat*) calloc(Nreceivers*mesh->Np, sizeof(dfloat));
+
+  Nreceivers = 0;
+  for(int n=0;n<NreceiversTotal;++n){
+    if(globalOwner[n]!=mesh->rank) continue;
+
+    acoustics->receiverIds[Nreceivers] = n;
+    receiverElementIds[Nreceivers] = elementIds[n];
+
+    dfloat *I = receiverInterp + Nreceivers*mesh->Np;
+    acousticsReceiverInterp(acoustics, rst[3*n+0], rst[3*n+1], rst[3*n+2], invV, I);
+
+    // q holds Bernstein-Bezier coefficients: sample = I*VB*q
+    if(acoustics->bernFlag){
+      dfloat *IB = (dfloat*) calloc(mesh->Np, sizeof(dfloat));
+      for(int m=0;m<mesh->Np;++m)
+        for(int i=0;i<mesh->Np;++i)
+          IB[m] += I[i]*mesh->VB[i*mesh->Np+m];
+      for(int m=0;m<mesh->Np;++m) I[m] = IB[m];
+      free(IB);
+    }
+    ++Nreceivers;
+  }
+
+  int Nlocated = 0;
+  for(int n=0;n<NreceiversTotal;++n)
+    if(globalOwner[n]<mesh->size) ++Nlocated;
+  if(mesh->rank==0)
+    printf("RECEIVERS: located %d of %d receivers in %s\n", Nlocated, NreceiversTotal, fileName.c_str());
+
+  acoustics->receiverBufferSteps = 100;
+  newOptions.getArgs("RECEIVER BUFFER STEPS", acoustics->receiverBufferSteps);
+
+  if(acoustics->Nreceivers){
+    size_t sampleBytes = acoustics->receiverBufferSteps*acoustics->Nreceivers*acoustics->Nensemble*sizeof(dfloat);
+
+    acoustics->o_receiverElementIds =
+      mesh->device.malloc(acoustics->Nreceivers*sizeof(dlong), receiverElementIds);
+    acoustics->o_receiverInterp =
+      mesh->device.malloc(acoustics->Nreceivers*mesh->Np*sizeof(dfloat), receiverInterp);
+
+    acoustics->o_receiverSamples = mesh->device.malloc(sampleBytes);
+    acoustics->receiverSamples = (dfloat*) occaHostMallocPinned(mesh->device, sampleBytes, NULL, acoustics->o_receiverSamplesH);
+    acoustics->receiverTimes = (dfloat*) calloc(acoustics->receiverBufferSteps, sizeof(dfloat));
+
+    acoustics->receiverKernel =
+      mesh->device.buildKernel(DACOUSTICS "/okl/acousticsReceivers.okl",
+                               "acousticsReceivers",
+                               kernelInfo);
+
+    // binary trace file: header [Nreceivers, Nensemble, (id, x, y, z) per receiver]
+    // then one record [time, samples[receiver][member]] per recorded step
+    char traceName[BUFSIZ];
+    sprintf(traceName, "receivers_%04d.bin", mesh->rank);
+    acoustics->receiverFile = fopen(traceName, "wb");
+
+    fwrite(&(acoustics->Nreceivers), sizeof(int), 1, acoustics->receiverFile);
+    fwrite(&(acoustics->Nensemble), sizeof(int), 1, acoustics->receiverFile);
+    for(int n=0;n<acoustics->Nreceivers;++n){
+      int id = acoustics->receiverIds[n];
+      fwrite(&id, sizeof(int), 1, acoustics->receiverFile);
+      fwrite(xyz+3*id, sizeof(dfloat), 3, acoustics->receiverFile);
+    }
+  }
+
+  free(xyz); free(invV);
+  free(owner); free(globalOwner); free(elementIds); free(rst);
+  free(receiverElementIds); free(receiverInterp);
+}
+
+// gather the receiver samples of o_q into the next ring buffer slot
+void acousticsReceiversRecord(acoustics_t *acoustics, dfloat time){
+
+  if(!acoustics->Nreceivers) return;
+
+  acoustics->receiverKernel(acoustics->Nreceivers,
+                            acoustics->receiverNsamples,
+                            acoustics->o_receiverElementIds,
+                            acoustics->o_receiverInterp,
+                            acoustics->o_q,
+                            acoustics->o_receiverSamples);
+
+  acoustics->receiverTimes[acoustics->receiverNsamples++] = time;
+
+  if(acoustics->receiverNsamples==acoustics->receiverBufferSteps)
+    acousticsReceiversFlush(acoustics);
+}
+
+// copy the buffered samples to the host in one transfer and append them to the trace file
+void acousticsReceiversFlush(acoustics_t *acoustics){
+
+  if(!acoustics->Nreceivers || !acoustics->receiverNsamples) return;
+
+  const int Nsamples = acoustics->Nreceivers*acoustics->Nensemble;
+
+  acoustics->o_receiverSamples.copyTo(acoustics->receiverSamples,
+                                      acoustics->receiverNsamples*Nsamples*sizeof(dfloat), 0);
+
+  for(int n=0;n<acoustics->receiverNsamples;++n){
+    fwrite(acoustics->receiverTimes+n, sizeof(dfloat), 1, acoustics->receiverFile);
+    fwrite(acoustics->receiverSamples+n*Nsamples, sizeof(dfloat), Nsamples, acoustics->receiverFile);
+  }
+  fflush(acoustics->receiverFile);
+
+  acoustics->receiverNsamples = 0;
+}
@@ -33,6 +33,10 @@ void acousticsReport(acoustics_t *acoustics, dfloat time, setupAide &newOptions)
   // copy data back to host
   acoustics->o_q.copyTo(acoustics->q);
 
+  // evaluate BB coefficients at the nodes
+  if(acoustics->bernFlag)
+    meshApplyElementMatrixFields(mesh, acoustics->Nfields, mesh->VB, acoustics->q, acoustics->q);
+
   // do error stuff on host
   acousticsError(acoustics, time);
 
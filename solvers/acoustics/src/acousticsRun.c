@@ -39,6 +39,8 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
   timer.tic("Run");
   
   if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+
+    dopri_t *dopri = acoustics->dopri;
     
     // hard code this for the moment
     dfloat outputInterval;
@@ -56,7 +58,7 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
 
       acoustics->advSwitch = 1;
       
-      if (mesh->dt<acoustics->dtMIN){
+      if (mesh->dt<dopri->dtMIN){
         printf("ERROR: Time step became too small at time step=%d\n", tstep);
         exit (-1);
       }
@@ -72,64 +74,44 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
       }
 
       // try a step with the current time step
-      acousticsDopriStep(acoustics, newOptions, time);
+      dopriStep(dopri, time, mesh->dt, acoustics->o_q);
 
       // compute Dopri estimator
-      dfloat err = acousticsDopriEstimate(acoustics);
+      dfloat err = dopriEstimate(dopri);
 					 
       // build controller
-      dfloat fac1 = pow(err,acoustics->exp1);
-      dfloat fac = fac1/pow(acoustics->facold,acoustics->beta);
-
-      fac = mymax(acoustics->invfactor2, mymin(acoustics->invfactor1,fac/acoustics->safe));
-      dfloat dtnew = mesh->dt/fac;
+      dfloat dtnew = dopriController(dopri, err, mesh->dt);
 
       if (err<1.0) { //dt is accepted
 
-	// check for output during this step and do a mini-step
+	// check for output during this step and interpolate to it
 	if(time<nextOutputTime && time+mesh->dt>nextOutputTime){
-	  dfloat savedt = mesh->dt;
-	  
-	  // save rkq
-	  acoustics->o_saveq.copyFrom(acoustics->o_rkq);
-
-	  // change dt to match output
-	  mesh->dt = nextOutputTime-time;
 
-	  // print
-	  printf("Taking output mini step: %g\n", mesh->dt);
-	  
-	  // time step to output
-	  acousticsDopriStep(acoustics, newOptions, time);	  
+	  dopriOutputStep(dopri, time, mesh->dt, nextOutputTime, acoustics->o_q, acoustics->o_saveq);
 
 	  // shift for output
-	  acoustics->o_rkq.copyTo(acoustics->o_q);
+	  acoustics->o_saveq.copyTo(acoustics->o_q);
 	  
-	  // output  (print from rkq)
+	  // output  (print from saveq)
 	  acousticsReport(acoustics, nextOutputTime, newOptions);
 
-	  // restore time step
-	  mesh->dt = savedt;
+	  // batch the buffered receiver samples to the host at output times
+	  acousticsReceiversFlush(acoustics);
 
 	  // increment next output time
 	  nextOutputTime += outputInterval;
-
-	  // accept saved rkq
-	  acoustics->o_q.copyFrom(acoustics->o_saveq);
-	}
-	else{
-	  // accept rkq
-	  acoustics->o_q.copyFrom(acoustics->o_rkq);
 	}
 
+	// accept rkq
+	dopriAccept(dopri, acoustics->o_q);
+
         time += mesh->dt;
 
-        acoustics->facold = mymax(err,1E-4); // hard coded factor ?
+	acousticsReceiversRecord(acoustics, time);
 
 	printf("\r time = %g (%d), dt = %g accepted                      ", time, allStep,  mesh->dt);
         tstep++;
       } else {
-        dtnew = mesh->dt/(mymax(acoustics->invfactor1,fac1/acoustics->safe));
 	printf("\r time = %g (%d), dt = %g rejected, trying %g", time, allStep, mesh->dt, dtnew);
 
 	done = 0;
@@ -153,6 +135,8 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
 
       acousticsLserkStep(acoustics, newOptions, time);
 
+      acousticsReceiversRecord(acoustics, time+mesh->dt);
+
 #if 0
       if(((tstep+1)%mesh->errorStep)==0){
 	time += mesh->dt;
@@ -160,6 +144,39 @@ void acousticsRun(acoustics_t *acoustics, setupAide &newOptions){
       }
 #endif
     }
+  } else if (newOptions.compareArgs("TIME INTEGRATOR","MRAB")) {
+
+    // each MRAB step advances every level to the same time
+    dfloat dtMRAB = mesh->dt*pow(2,mesh->MRABNlevels-1);
+
+    for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
+
+      dfloat time = tstep*dtMRAB;
+
+      mrabStep(acoustics->mrab, time, acoustics->o_q);
+
+      acousticsReceiversRecord(acoustics, time+dtMRAB);
+
+      // all levels are synchronized at the end of a coarse step
+      if(((tstep+1)%mesh->errorStep)==0){
+	time += dtMRAB;
+        acousticsReport(acoustics, time, newOptions);
+	acousticsReceiversFlush(acoustics);
+      }
+    }
+
+    mesh->device.finish();
+
+    double elapsed  = timer.toc("Run");
+
+    if(mesh->rank==0)
+      printf("run took %lg seconds for %d MRAB steps on %d levels\n", elapsed, mesh->NtimeSteps, mesh->MRABNlevels);
+  }
+
+  acousticsReceiversFlush(acoustics);
+
+  if(acoustics->receiverFile){
+    fclose(acoustics->receiverFile);
+    acoustics->receiverFile = NULL;
   }
-  
 }
@@ -26,6 +26,103 @@ SOFTWARE.
 
 #include "acoustics.h"
 
+// WADG wave speed: c2 at the cubature nodes of each element or, with the low
+// storage option, at its vertices (corners of tensor product elements) with a
+// (multi)linear interpolation to the cubature nodes
+static void acousticsWADGSetup(acoustics_t *acoustics){
+
+  mesh_t *mesh = acoustics->mesh;
+
+  int tensorFlag = (acoustics->elementType==QUADRILATERALS || acoustics->elementType==HEXAHEDRA);
+
+  dlong Nc2 = 0;
+  dfloat *c2 = NULL;
+
+  if(acoustics->wadgLowStorageFlag){
+    int Ncorners = (tensorFlag) ? (1<<acoustics->dim) : mesh->Nverts;
+    Nc2 = Ncorners;
+
+    c2 = (dfloat*) calloc(mesh->Nelements*Ncorners, sizeof(dfloat));
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int v=0;v<Ncorners;++v){
+        dfloat x, y, z = 0;
+        if(tensorFlag){
+          // corner node (a,b,c) of the GLL grid
+          int a = v%2, b = (v/2)%2, c = v/4;
+          dlong id = e*mesh->Np + (mesh->Nq-1)*(a + b*mesh->Nq + c*mesh->Nq*mesh->Nq);
+          x = mesh->x[id]; y = mesh->y[id]; z = mesh->z[id];
+        } else {
+          dlong id = e*mesh->Nverts + v;
+          x = mesh->EX[id]; y = mesh->EY[id];
+          if(acoustics->dim==3) z = mesh->EZ[id];
+        }
+        c2[e*Ncorners+v] = acousticsWaveSpeed2(x, y, z);
+      }
+    }
+
+    dfloat *c2Interp;
+    if(tensorFlag){
+      // 1D linear shape functions at the 1D cubature nodes
+      c2Interp = (dfloat*) calloc(2*mesh->cubNq, sizeof(dfloat));
+      for(int m=0;m<mesh->cubNq;++m){
+        c2Interp[0*mesh->cubNq+m] = 0.5*(1-mesh->cubr[m]);
+        c2Interp[1*mesh->cubNq+m] = 0.5*(1+mesh->cubr[m]);
+      }
+      acoustics->o_c2Interp = mesh->device.malloc(2*mesh->cubNq*sizeof(dfloat), c2Interp);
+    } else {
+      // barycentric coordinates of the cubature nodes
+      c2Interp = (dfloat*) calloc(mesh->Nverts*mesh->cubNp, sizeof(dfloat));
+      for(int m=0;m<mesh->cubNp;++m){
+        dfloat r = mesh->cubr[m], s = mesh->cubs[m];
+        dfloat t = (acoustics->dim==3) ? mesh->cubt[m] : -1;
+        c2Interp[0*mesh->cubNp+m] = -0.5*(1+r+s+t);
+        c2Interp[1*mesh->cubNp+m] =  0.5*(1+r);
+        c2Interp[2*mesh->cubNp+m] =  0.5*(1+s);
+        if(acoustics->dim==3)
+          c2Interp[3*mesh->cubNp+m] = 0.5*(1+t);
+      }
+      acoustics->o_c2Interp = mesh->device.malloc(mesh->Nverts*mesh->cubNp*sizeof(dfloat), c2Interp);
+    }
+    free(c2Interp);
+
+  } else {
+    Nc2 = mesh->cubNp;
+
+    c2 = (dfloat*) calloc(mesh->Nelements*mesh->cubNp, sizeof(dfloat));
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int m=0;m<mesh->cubNp;++m){
+        // interpolate the node coordinates to the cubature node
+        dfloat xm = 0, ym = 0, zm = 0;
+        for(int n=0;n<mesh->Np;++n){
+          dfloat Imn;
+          if(tensorFlag){
+            int a = m%mesh->cubNq, b = (m/mesh->cubNq)%mesh->cubNq, c = m/(mesh->cubNq*mesh->cubNq);
+            int i = n%mesh->Nq, j = (n/mesh->Nq)%mesh->Nq, k = n/(mesh->Nq*mesh->Nq);
+            Imn = mesh->cubInterp[a*mesh->Nq+i]*mesh->cubInterp[b*mesh->Nq+j];
+            if(acoustics->dim==3) Imn *= mesh->cubInterp[c*mesh->Nq+k];
+          } else {
+            Imn = mesh->cubInterp[m*mesh->Np+n];
+          }
+          xm += Imn*mesh->x[e*mesh->Np+n];
+          ym += Imn*mesh->y[e*mesh->Np+n];
+          zm += Imn*mesh->z[e*mesh->Np+n];
+        }
+        c2[e*mesh->cubNp+m] = acousticsWaveSpeed2(xm, ym, zm);
+      }
+    }
+
+    // not used without the low storage option
+    acoustics->o_c2Interp = mesh->device.malloc(sizeof(dfloat));
+  }
+
+  acoustics->o_c2 = mesh->device.malloc(mesh->Nelements*Nc2*sizeof(dfloat), c2);
+  free(c2);
+
+  if(mesh->rank==0)
+    printf("WADG: c2 uses %d dfloats per element (solution uses %d)\n",
+           Nc2, mesh->Np*acoustics->Nfields*acoustics->Nensemble);
+}
+
 acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryHeaderFileName){
 	
   acoustics_t *acoustics = (acoustics_t*) calloc(1, sizeof(acoustics_t));
@@ -38,104 +135,45 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   
   acoustics->mesh = mesh;
 
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  acoustics->Nblock = (Ntotal+blockSize-1)/blockSize;
-  
-  hlong localElements = (hlong) mesh->Nelements;
-  MPI_Allreduce(&localElements, &(acoustics->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
-
-  // viscosity
-  int check;
-
-  // compute samples of q at interpolation nodes
-  acoustics->q = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-				sizeof(dfloat));
-  acoustics->rhsq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
-				sizeof(dfloat));
-  
-  if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
-    acoustics->resq = (dfloat*) calloc(mesh->Nelements*mesh->Np*mesh->Nfields,
-		  		sizeof(dfloat));
+  acoustics->bernFlag = newOptions.compareArgs("BASIS","BERN");
+  if(acoustics->bernFlag && acoustics->elementType!=TETRAHEDRA){
+    if(mesh->rank==0) printf("ERROR: BERN basis is only available for tetrahedra\n");
+    MPI_Finalize();
+    exit(-1);
   }
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    int NrkStages = 7;
-    acoustics->rkq  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    acoustics->rkrhsq = (dfloat*) calloc(NrkStages*mesh->Nelements*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    acoustics->rkerr  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-
-    acoustics->errtmp = (dfloat*) calloc(acoustics->Nblock, sizeof(dfloat));
-
-    // Dormand Prince -order (4) 5 with PID timestep control
-    int Nrk = 7;
-    dfloat rkC[7] = {0.0, 0.2, 0.3, 0.8, 8.0/9.0, 1.0, 1.0};
-    dfloat rkA[7*7] ={             0.0,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                                   0.2,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                              3.0/40.0,        9.0/40.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                             44.0/45.0,      -56.0/15.0,       32.0/9.0,          0.0,             0.0,       0.0, 0.0,
-                        19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0,             0.0,       0.0, 0.0,
-                         9017.0/3168.0,     -355.0/33.0, 46732.0/5247.0,   49.0/176.0, -5103.0/18656.0,       0.0, 0.0, 
-                            35.0/384.0,             0.0,   500.0/1113.0,  125.0/192.0,  -2187.0/6784.0, 11.0/84.0, 0.0 };
-    dfloat rkE[7] = {71.0/57600.0,  0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0 }; 
-
-    acoustics->Nrk = Nrk;
-    acoustics->rkC = (dfloat*) calloc(acoustics->Nrk, sizeof(dfloat));
-    acoustics->rkE = (dfloat*) calloc(acoustics->Nrk, sizeof(dfloat));
-    acoustics->rkA = (dfloat*) calloc(acoustics->Nrk*acoustics->Nrk, sizeof(dfloat));
-
-    memcpy(acoustics->rkC, rkC, acoustics->Nrk*sizeof(dfloat));
-    memcpy(acoustics->rkE, rkE, acoustics->Nrk*sizeof(dfloat));
-    memcpy(acoustics->rkA, rkA, acoustics->Nrk*acoustics->Nrk*sizeof(dfloat));
-    
-    acoustics->dtMIN = 1E-9; //minumum allowed timestep
-    acoustics->ATOL = 1E-6;  //absolute error tolerance
-    acoustics->RTOL = 1E-6;  //relative error tolerance
-    acoustics->safe = 0.8;   //safety factor
-
-    //error control parameters
-    acoustics->beta = 0.05;
-    acoustics->factor1 = 0.2;
-    acoustics->factor2 = 10.0;
-
-
-    acoustics->exp1 = 0.2 - 0.75*acoustics->beta;
-    acoustics->invfactor1 = 1.0/acoustics->factor1;
-    acoustics->invfactor2 = 1.0/acoustics->factor2;
-    acoustics->facold = 1E-4;
-    
+  acoustics->Nensemble = 1;
+  newOptions.getArgs("ENSEMBLE MEMBERS", acoustics->Nensemble);
+  if(acoustics->Nensemble>1 &&
+     (acoustics->bernFlag || (acoustics->elementType!=TRIANGLES && acoustics->elementType!=TETRAHEDRA))){
+    if(mesh->rank==0) printf("ERROR: ENSEMBLE MEMBERS > 1 is only available for nodal triangles and tetrahedra\n");
+    MPI_Finalize();
+    exit(-1);
   }
 
-  // fix this later (initial conditions)
-  for(dlong e=0;e<mesh->Nelements;++e){
-    for(int n=0;n<mesh->Np;++n){
-      dfloat t = 0;
-      dfloat x = mesh->x[n + mesh->Np*e];
-      dfloat y = mesh->y[n + mesh->Np*e];
-      dfloat z = mesh->z[n + mesh->Np*e];
+  acoustics->wadgFlag = newOptions.compareArgs("ACOUSTICS FORMULATION","WADG");
+  acoustics->wadgLowStorageFlag = acoustics->wadgFlag && newOptions.compareArgs("ACOUSTICS FORMULATION","LOWSTORAGE");
+  if(acoustics->wadgFlag && (acoustics->bernFlag || mesh->cubNp<mesh->Np)){
+    if(mesh->rank==0) printf("ERROR: WADG needs a nodal basis and cubature with at least Np nodes\n");
+    MPI_Finalize();
+    exit(-1);
+  }
 
-      dlong qbase = e*mesh->Np*mesh->Nfields + n;
+  // entries per element for all members
+  const int Nentries = mesh->Np*mesh->Nfields*acoustics->Nensemble;
 
-      dfloat u = 0, v = 0, w = 0, r = 0;
-      
-      acousticsGaussianPulse(x, y, z, t, &r, &u, &v, &w);
-      acoustics->q[qbase+0*mesh->Np] = r;
-      acoustics->q[qbase+1*mesh->Np] = u;
-      acoustics->q[qbase+2*mesh->Np] = v;
-      if(acoustics->dim==3)
-	acoustics->q[qbase+3*mesh->Np] = w;
-    }
-  }
+  hlong localElements = (hlong) mesh->Nelements;
+  MPI_Allreduce(&localElements, &(acoustics->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
 
   // set penalty parameter
   mesh->Lambda2 = 0.5;
   
   // set time step
   dfloat hmin = 1e9;
+  dfloat *EToh = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
   for(dlong e=0;e<mesh->Nelements;++e){  
 
+    EToh[e] = 1e9;
     for(int f=0;f<mesh->Nfaces;++f){
       dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
       dfloat sJ   = mesh->sgeo[sid + SJID];
@@ -149,6 +187,7 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
       dfloat hest = .5/(sJ*invJ);
 
       hmin = mymin(hmin, hest);
+      EToh[e] = mymin(EToh[e], hest);
     }
   }
 
@@ -158,17 +197,84 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   dfloat dtAdv  = hmin/((mesh->N+1.)*(mesh->N+1.));
   dfloat dt = cfl*dtAdv;
   
-  // MPI_Allreduce to get global minimum dt
-  MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
-  
   //
   newOptions.getArgs("FINAL TIME", mesh->finalTime);
 
-  mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+  if (newOptions.compareArgs("TIME INTEGRATOR","MRAB")){
+    // local time step of each element, sorts the elements into MRAB levels
+    // and regroups (or repartitions) the mesh so the levels are contiguous
+    dfloat *EToDT = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
+    for(dlong e=0;e<mesh->Nelements;++e)
+      EToDT[e] = cfl*EToh[e]/((mesh->N+1.)*(mesh->N+1.));
+
+    int maxLevels = 1;
+    newOptions.getArgs("MAX MRAB LEVELS", maxLevels);
+
+    if(acoustics->dim==3)
+      mesh->dt = meshMRABSetup3D(mesh, EToDT, maxLevels, mesh->finalTime);
+    else
+      mesh->dt = meshMRABSetup2D(mesh, EToDT, maxLevels, mesh->finalTime);
+
+    mesh->NtimeSteps = mesh->finalTime/(pow(2,mesh->MRABNlevels-1)*mesh->dt);
+
+    free(EToDT);
+  } else {
+    // MPI_Allreduce to get global minimum dt
+    MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+
+    mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+    if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
+      mesh->dt = mesh->finalTime/mesh->NtimeSteps;
+    }
+  }
+  free(EToh);
+
+  // viscosity
+  int check;
+
+  // compute samples of q at interpolation nodes
+  acoustics->q = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*Nentries,
+				sizeof(dfloat));
+  acoustics->rhsq = (dfloat*) calloc(mesh->Nelements*Nentries,
+				sizeof(dfloat));
+  
   if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
-    mesh->dt = mesh->finalTime/mesh->NtimeSteps;
+    acoustics->resq = (dfloat*) calloc(mesh->Nelements*Nentries,
+		  		sizeof(dfloat));
+  }
+
+  // ensemble members differ in the position of the initial pulse
+  dfloat sourceShift = 0;
+  newOptions.getArgs("ENSEMBLE SOURCE SHIFT", sourceShift);
+
+
+  // fix this later (initial conditions)
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      dfloat t = 0;
+      dfloat x = mesh->x[n + mesh->Np*e];
+      dfloat y = mesh->y[n + mesh->Np*e];
+      dfloat z = mesh->z[n + mesh->Np*e];
+
+      for(int k=0;k<acoustics->Nensemble;++k){
+        dlong qbase = e*Nentries + k*mesh->Np*mesh->Nfields + n;
+
+        dfloat u = 0, v = 0, w = 0, r = 0;
+      
+        acousticsGaussianPulse(x-k*sourceShift, y, z, t, &r, &u, &v, &w);
+        acoustics->q[qbase+0*mesh->Np] = r;
+        acoustics->q[qbase+1*mesh->Np] = u;
+        acoustics->q[qbase+2*mesh->Np] = v;
+        if(acoustics->dim==3)
+	  acoustics->q[qbase+3*mesh->Np] = w;
+      }
+    }
   }
 
+  // convert nodal initial conditions to BB coefficients
+  if(acoustics->bernFlag)
+    meshApplyElementMatrixFields(mesh, acoustics->Nfields, mesh->invVB, acoustics->q, acoustics->q);
+
   if (mesh->rank ==0) printf("dtAdv = %lg (before cfl), dt = %lg\n",
    dtAdv, dt);
 
@@ -195,45 +301,30 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   kernelInfo["includes"] += boundaryHeaderFileName;
  
   acoustics->o_q =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->q);
+    mesh->device.malloc((mesh->totalHaloPairs+mesh->Nelements)*Nentries*sizeof(dfloat), acoustics->q);
 
   acoustics->o_saveq =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->q);
+    mesh->device.malloc((mesh->totalHaloPairs+mesh->Nelements)*Nentries*sizeof(dfloat), acoustics->q);
   
   acoustics->o_rhsq =
-    mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->rhsq);
+    mesh->device.malloc(mesh->Nelements*Nentries*sizeof(dfloat), acoustics->rhsq);
 
   cout << "TIME INTEGRATOR (" << newOptions.getArgs("TIME INTEGRATOR") << ")" << endl;
   
   if (newOptions.compareArgs("TIME INTEGRATOR","LSERK4")){
     acoustics->o_resq =
-      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->resq);
+      mesh->device.malloc(mesh->Nelements*Nentries*sizeof(dfloat), acoustics->resq);
   }
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    printf("setting up DOPRI5\n");
-    int NrkStages = 7;
-    acoustics->o_rkq =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->rkq);
-    acoustics->o_rkrhsq =
-      mesh->device.malloc(NrkStages*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), acoustics->rkrhsq);
-    acoustics->o_rkerr =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), acoustics->rkerr);
-  
-    acoustics->o_errtmp = mesh->device.malloc(acoustics->Nblock*sizeof(dfloat), acoustics->errtmp);
-
-    acoustics->o_rkA = mesh->device.malloc(acoustics->Nrk*acoustics->Nrk*sizeof(dfloat), acoustics->rkA);
-    acoustics->o_rkE = mesh->device.malloc(  acoustics->Nrk*sizeof(dfloat), acoustics->rkE);
-  }
 
   
   if(mesh->totalHaloPairs>0){
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
-      mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*mesh->Nfields*sizeof(dfloat));
+      mesh->device.malloc(mesh->totalHaloPairs*Nentries*sizeof(dfloat));
 
-    // MPI send buffer
-    acoustics->haloBytes = mesh->totalHaloPairs*mesh->Np*acoustics->Nfields*sizeof(dfloat);
+    // MPI send buffer, one message per neighbor carries all ensemble members
+    acoustics->haloBytes = mesh->totalHaloPairs*Nentries*sizeof(dfloat);
 
     acoustics->o_haloBuffer = mesh->device.malloc(acoustics->haloBytes);
 
@@ -253,6 +344,7 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   // p_half, p_two, p_third, p_Nstresses
   
   kernelInfo["defines/" "p_Nfields"]= mesh->Nfields;
+  kernelInfo["defines/" "p_Nensemble"]= acoustics->Nensemble;
   const dfloat p_one = 1.0, p_two = 2.0, p_half = 1./2., p_third = 1./3., p_zero = 0;
 
   kernelInfo["defines/" "p_two"]= p_two;
@@ -270,6 +362,10 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   int NblockS = 1024/maxNodes; // works for CUDA
   kernelInfo["defines/" "p_NblockS"]= NblockS;
 
+  // ensemble surface kernels keep the @shared flux storage of the single field kernels
+  int NblockSEnsemble = mymax(1, NblockS/acoustics->Nensemble);
+  kernelInfo["defines/" "p_NblockSEnsemble"]= NblockSEnsemble;
+
   int cubMaxNodes = mymax(mesh->Np, (mesh->intNfp*mesh->Nfaces));
   kernelInfo["defines/" "p_cubMaxNodes"]= cubMaxNodes;
   int cubMaxNodes1 = mymax(mesh->Np, (mesh->intNfp));
@@ -279,6 +375,9 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   kernelInfo["defines/" "p_blockSize"]= blockSize;
 
+  kernelInfo["defines/" "p_Nverts"]= mesh->Nverts;
+  kernelInfo["defines/" "p_WADGLowStorage"]= acoustics->wadgLowStorageFlag;
+
 
   kernelInfo["parser/" "automate-add-barriers"] =  "disabled";
 
@@ -298,7 +397,12 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   // kernels from volume file
   sprintf(fileName, DACOUSTICS "/okl/acousticsVolume%s.okl", suffix);
-  sprintf(kernelName, "acousticsVolume%s", suffix);
+  if(acoustics->bernFlag)
+    sprintf(kernelName, "acousticsBBVolume%s", suffix);
+  else if(acoustics->Nensemble>1)
+    sprintf(kernelName, "acousticsEnsembleVolume%s", suffix);
+  else
+    sprintf(kernelName, "acousticsVolume%s", suffix);
 
   printf("fileName=[ %s ] \n", fileName);
   printf("kernelName=[ %s ] \n", kernelName);
@@ -307,7 +411,12 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   // kernels from surface file
   sprintf(fileName, DACOUSTICS "/okl/acousticsSurface%s.okl", suffix);
-  sprintf(kernelName, "acousticsSurface%s", suffix);
+  if(acoustics->bernFlag)
+    sprintf(kernelName, "acousticsBBSurface%s", suffix);
+  else if(acoustics->Nensemble>1)
+    sprintf(kernelName, "acousticsEnsembleSurface%s", suffix);
+  else
+    sprintf(kernelName, "acousticsSurface%s", suffix);
   
   acoustics->surfaceKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
 
@@ -317,19 +426,17 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "acousticsUpdate",
 				       kernelInfo);
 
-  acoustics->rkUpdateKernel =
-    mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
-				       "acousticsRkUpdate",
-				       kernelInfo);
-  acoustics->rkStageKernel =
-    mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
-				       "acousticsRkStage",
-				       kernelInfo);
+  if(acoustics->wadgFlag){
+    acousticsWADGSetup(acoustics);
 
-  acoustics->rkErrorEstimateKernel =
-    mesh->device.buildKernel(DACOUSTICS "/okl/acousticsUpdate.okl",
-				       "acousticsErrorEstimate",
-				       kernelInfo);
+    if(acoustics->elementType==TRIANGLES || acoustics->elementType==TETRAHEDRA)
+      sprintf(kernelName, "acousticsWADGSimplex");
+    else
+      sprintf(kernelName, "acousticsWADG%s", suffix);
+
+    acoustics->wadgKernel =
+      mesh->device.buildKernel(DACOUSTICS "/okl/acousticsWADG.okl", kernelName, kernelInfo);
+  }
 
   // fix this later
   mesh->haloExtractKernel =
@@ -337,5 +444,19 @@ acoustics_t *acousticsSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "meshHaloExtract3D",
 				       kernelInfo);
 
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
+    printf("setting up DOPRI5\n");
+    dlong N = mesh->Nelements*Nentries;
+    dlong Nhalo = mesh->totalHaloPairs*Nentries;
+    acoustics->dopri = dopriSetup(mesh, N, Nhalo, kernelInfo, acoustics, acousticsRhs);
+  }
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","MRAB")){
+    acoustics->mrab = mrabSetup(mesh, acoustics->Nfields*acoustics->Nensemble, mesh->dt, kernelInfo, acoustics, acousticsMRABRhs);
+    mrabReset(acoustics->mrab, acoustics->o_q);
+  }
+
+  acousticsReceiversSetup(acoustics, newOptions, kernelInfo);
+
   return acoustics;
 }
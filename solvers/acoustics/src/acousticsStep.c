@@ -26,87 +26,106 @@ SOFTWARE.
 
 #include "acoustics.h"
 
-void acousticsDopriStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time){
+// rhsq = F(time, q) on the first Nelements elements, q needs room for the halo
+static void acousticsRhsElements(acoustics_t *acoustics, dfloat time, dlong Nelements,
+                                 occa::memory &o_q, occa::memory &o_rhsq){
 
   mesh_t *mesh = acoustics->mesh;
-  
-  //RK step
-  for(int rk=0;rk<acoustics->Nrk;++rk){
-    
-    // t_rk = t + C_rk*dt
-    dfloat currentTime = time + acoustics->rkC[rk]*mesh->dt;
-    
-    //compute RK stage 
-    // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    acoustics->rkStageKernel(mesh->Nelements,
-		       rk,
-		       mesh->dt,
-		       acoustics->o_rkA,
-		       acoustics->o_q,
-		       acoustics->o_rkrhsq,
-		       acoustics->o_rkq);
-    
-    //compute RHS
-    // rhsq = F(currentTIme, rkq)
-
-    // extract q halo on DEVICE
-    if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*acoustics->Nfields;          
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, acoustics->o_rkq, acoustics->o_haloBuffer);
-      
-      // copy extracted halo to HOST 
-      acoustics->o_haloBuffer.copyTo(acoustics->sendBuffer);      
-      
-      // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*acoustics->Nfields*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
-    }
-
-    acoustics->volumeKernel(mesh->Nelements, 
-		      mesh->o_vgeo, 
-		      mesh->o_Dmatrices,
-		      acoustics->o_rkq, 
-		      acoustics->o_rhsq);
-
-    // wait for q halo data to arrive
-    if(mesh->totalHaloPairs>0){
-      meshHaloExchangeFinish(mesh);
-          
-      // copy halo data to DEVICE
-      size_t offset = mesh->Np*acoustics->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
-      acoustics->o_rkq.copyFrom(acoustics->recvBuffer, acoustics->haloBytes, offset);
-    }
-
-    acoustics->surfaceKernel(mesh->Nelements, 
-			     mesh->o_sgeo, 
-			     mesh->o_LIFTT, 
-			     mesh->o_vmapM, 
-			     mesh->o_vmapP, 
-			     mesh->o_EToB,
-			     currentTime, 
-			     mesh->o_x, 
-			     mesh->o_y,
-			     mesh->o_z, 
-			     acoustics->o_rkq, 
-			     acoustics->o_rhsq);
-    
-    // update solution using Runge-Kutta
-    // rkrhsq_rk = rhsq
-    // if rk==6 
-    //   q = q + dt*sum_{i=0}^{rk} rkA_{rk,i}*rkrhs_i
-    //   rkerr = dt*sum_{i=0}^{rk} rkE_{rk,i}*rkrhs_i
-    acoustics->rkUpdateKernel(mesh->Nelements, 
-			rk,
-			mesh->dt, 
-			acoustics->o_rkA, 
-			acoustics->o_rkE, 
-			acoustics->o_q,
-			acoustics->o_rhsq, 
-			acoustics->o_rkrhsq, 
-			acoustics->o_rkq,
-			acoustics->o_rkerr);
+
+  // extract q halo on DEVICE
+  if(mesh->totalHaloPairs>0){
+    int Nentries = mesh->Np*acoustics->Nfields*acoustics->Nensemble;
+    mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, o_q, acoustics->o_haloBuffer);
+
+    // copy extracted halo to HOST 
+    acoustics->o_haloBuffer.copyTo(acoustics->sendBuffer);      
+
+    // start halo exchange
+    meshHaloExchangeStart(mesh, Nentries*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
+  }
+
+  if(acoustics->bernFlag)
+    acoustics->volumeKernel(Nelements, 
+                            mesh->o_vgeo, 
+                            mesh->o_D0ids,
+                            mesh->o_D1ids,
+                            mesh->o_D2ids,
+                            mesh->o_D3ids,
+                            mesh->o_Dvals,
+                            o_q, 
+                            o_rhsq);
+  else
+    acoustics->volumeKernel(Nelements, 
+                            mesh->o_vgeo, 
+                            mesh->o_Dmatrices,
+                            o_q, 
+                            o_rhsq);
+
+  // wait for q halo data to arrive
+  if(mesh->totalHaloPairs>0){
+    meshHaloExchangeFinish(mesh);
+
+    // copy halo data to DEVICE
+    size_t offset = mesh->Np*acoustics->Nfields*acoustics->Nensemble*mesh->Nelements*sizeof(dfloat); // offset for halo data
+    o_q.copyFrom(acoustics->recvBuffer, acoustics->haloBytes, offset);
   }
+
+  if(acoustics->bernFlag)
+    acoustics->surfaceKernel(Nelements, 
+                             mesh->o_sgeo, 
+                             mesh->o_L0ids, 
+                             mesh->o_L0vals, 
+                             mesh->o_ELids, 
+                             mesh->o_ELvals, 
+                             mesh->o_vmapM, 
+                             mesh->o_vmapP, 
+                             mesh->o_EToB,
+                             time, 
+                             mesh->o_x, 
+                             mesh->o_y,
+                             mesh->o_z, 
+                             o_q, 
+                             o_rhsq);
+  else
+    acoustics->surfaceKernel(Nelements, 
+                             mesh->o_sgeo, 
+                             mesh->o_LIFTT, 
+                             mesh->o_vmapM, 
+                             mesh->o_vmapP, 
+                             mesh->o_EToB,
+                             time, 
+                             mesh->o_x, 
+                             mesh->o_y,
+                             mesh->o_z, 
+                             o_q, 
+                             o_rhsq);
+
+  // weight-adjusted inverse mass matrix for the variable wave speed
+  if(acoustics->wadgFlag)
+    acoustics->wadgKernel(Nelements,
+                          mesh->o_cubInterpT,
+                          mesh->o_cubProjectT,
+                          acoustics->o_c2Interp,
+                          acoustics->o_c2,
+                          o_rhsq);
+}
+
+
+// rhsq = F(time, q), q needs room for the halo
+void acousticsRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq){
+
+  acoustics_t *acoustics = (acoustics_t*) solver;
+
+  acousticsRhsElements(acoustics, time, acoustics->mesh->Nelements, o_q, o_rhsq);
 }
 
+// rhsq = F(time, q) on the elements of MRAB levels 0,..,lev-1
+void acousticsMRABRhs(void *solver, dfloat time, int lev, occa::memory &o_q, occa::memory &o_rhsq){
+
+  acoustics_t *acoustics = (acoustics_t*) solver;
+
+  acousticsRhsElements(acoustics, time, acoustics->mrab->NlevelElements[lev], o_q, o_rhsq);
+}
 
 void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOptions, const dfloat time){
 
@@ -116,48 +135,8 @@ void acousticsLserkStep(acoustics_t *acoustics, setupAide &newOptions, const dfl
   for(int rk=0;rk<mesh->Nrk;++rk){
       
     dfloat currentTime = time + mesh->rkc[rk]*mesh->dt;
-      
-    // extract q halo on DEVICE
-    if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*acoustics->Nfields;
-        
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, acoustics->o_q, acoustics->o_haloBuffer);
-        
-      // copy extracted halo to HOST 
-      acoustics->o_haloBuffer.copyTo(acoustics->sendBuffer);      
-        
-      // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*acoustics->Nfields*sizeof(dfloat), acoustics->sendBuffer, acoustics->recvBuffer);
-    }
-
-    acoustics->volumeKernel(mesh->Nelements, 
-		      mesh->o_vgeo, 
-		      mesh->o_Dmatrices,
-		      acoustics->o_q, 
-		      acoustics->o_rhsq);
-    
-    
-    // wait for q halo data to arrive
-    if(mesh->totalHaloPairs>0){
-      meshHaloExchangeFinish(mesh);
-      
-      // copy halo data to DEVICE
-      size_t offset = mesh->Np*acoustics->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
-      acoustics->o_q.copyFrom(acoustics->recvBuffer, acoustics->haloBytes, offset);
-    }
-
-    acoustics->surfaceKernel(mesh->Nelements, 
-		       mesh->o_sgeo, 
-		       mesh->o_LIFTT, 
-		       mesh->o_vmapM, 
-		       mesh->o_vmapP, 
-		       mesh->o_EToB,
-		       currentTime, 
-		       mesh->o_x, 
-		       mesh->o_y,
-		       mesh->o_z, 
-		       acoustics->o_q, 
-		       acoustics->o_rhsq);
+
+    acousticsRhs(acoustics, currentTime, acoustics->o_q, acoustics->o_rhsq);
         
     // update solution using Runge-Kutta
     acoustics->updateKernel(mesh->Nelements, 
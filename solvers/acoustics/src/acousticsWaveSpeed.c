@@ -24,35 +24,12 @@ SOFTWARE.
 
 */
 
-#include "cns.h"
-
-dfloat cnsDopriEstimate(cns_t *cns){
-  
-  mesh_t *mesh = cns->mesh;
-  
-  // should insert err = cnsDopriEstimate2D() here
-  //Error estimation 
-  //E. HAIRER, S.P. NORSETT AND G. WANNER, SOLVING ORDINARY
-  //      DIFFERENTIAL EQUATIONS I. NONSTIFF PROBLEMS. 2ND EDITION.
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  cns->rkErrorEstimateKernel(Ntotal, 
-			     cns->ATOL,
-			     cns->RTOL,
-			     cns->o_q,
-			     cns->o_rkq,
-			     cns->o_rkerr,
-			     cns->o_errtmp);
-  
-  cns->o_errtmp.copyTo(cns->errtmp);
-  dfloat localerr = 0;
-  dfloat err = 0;
-  for(dlong n=0;n<cns->Nblock;++n){
-    localerr += cns->errtmp[n];
-  }
-  MPI_Allreduce(&localerr, &err, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
-
-  err = sqrt(err/(mesh->Np*cns->totalElements*cns->Nfields));
-  
-  return err;
+#include <math.h>
+#include "mesh.h"
+
+// squared wave speed of a smoothly layered medium (used by the WADG formulations)
+dfloat acousticsWaveSpeed2(dfloat x, dfloat y, dfloat z){
+
+  return 1. + 0.5*tanh(4.*y);
+
 }
-  
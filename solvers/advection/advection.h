@@ -33,6 +33,7 @@ SOFTWARE.
 #include "mesh.h"
 #include "mesh2D.h"
 #include "mesh3D.h"
+#include "dopri.h"
 
 // block size for reduction (hard coded)
 #define blockSize 256
@@ -45,24 +46,21 @@ typedef struct{
   int Nfields;
 
   hlong totalElements;
-  dlong Nblock;
 
   dfloat *q, *rhsq, *resq;
 
   dfloat *Vort;
 
-  dfloat *rkq, *rkrhsq, *rkerr;
-  dfloat *errtmp;
   int frame;
 
+  // ADVECTION FORMULATION used by the DOPRI5 right hand side
+  int nodalFlag, cubatureFlag;
+
   mesh_t *mesh;
 
   occa::kernel volumeKernel;
   occa::kernel surfaceKernel;
   occa::kernel updateKernel;
-  occa::kernel rkStageKernel;
-  occa::kernel rkUpdateKernel;
-  occa::kernel rkErrorEstimateKernel;
 
   occa::kernel combinedKernel;
 
@@ -82,6 +80,11 @@ typedef struct{
 
   occa::memory o_cubAdvectionVelocityJW;
 
+  // WADG weights for the cubature volume kernels: cubvgeo, or with
+  // WADG+LOWSTORAGE the 1D linear shape functions at the GLL [2][Nq] and
+  // cubature [2][cubNq] nodes followed by the 8 corner values of 1/J per element
+  occa::memory o_wadgWeights;
+
   // [Jsurf*Wsurf/(Jvol*Wvol)*(c.n + |c.n|)/2
   occa::memory o_advectionVelocityM;
 
@@ -90,9 +93,6 @@ typedef struct{
 
   occa::memory o_diagInvMassMatrix;
   
-  occa::memory o_rkq, o_rkrhsq, o_rkerr;
-  occa::memory o_errtmp;
-  
   //halo data
   dlong haloBytes;
   dfloat *sendBuffer;
@@ -103,13 +103,7 @@ typedef struct{
 
   // DOPRI5 RK data
   int advSwitch;
-  int Nrk;
-  dfloat ATOL, RTOL;
-  dfloat factor1, invfactor1;
-  dfloat factor2, invfactor2;
-  dfloat exp1, facold,  dtMIN, safe, beta;
-  dfloat *rkA, *rkC, *rkE;
-  occa::memory o_rkA, o_rkC, o_rkE;
+  dopri_t *dopri;
   
 }advection_t;
 
@@ -127,12 +121,10 @@ void advectionReport(advection_t *advection, dfloat time, setupAide &newOptions)
 
 void advectionPlotVTU(advection_t *advection, char *fileName);
 
-void advectionDopriStep(advection_t *advection, setupAide &newOptions, const dfloat time);
+void advectionRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq);
 
 void advectionLserkStep(advection_t *advection, setupAide &newOoptions, const dfloat time);
 
-dfloat advectionDopriEstimate(advection_t *advection);
-
 #define TRIANGLES 3
 #define QUADRILATERALS 4
 #define TETRAHEDRA 6
@@ -47,6 +47,8 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
   occa::streamTag start = mesh->device.tagStream();
   
   if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+
+    dopri_t *dopri = advection->dopri;
     
     // hard code this for the moment
     dfloat outputInterval;
@@ -63,7 +65,7 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
 
       advection->advSwitch = 1;
       
-      if (mesh->dt<advection->dtMIN){
+      if (mesh->dt<dopri->dtMIN){
         printf("ERROR: Time step became too small at time step=%d\n", tstep);
         exit (-1);
       }
@@ -79,65 +81,40 @@ void advectionRun(advection_t *advection, setupAide &newOptions){
       }
 
       // try a step with the current time step
-      advectionDopriStep(advection, newOptions, time);
+      dopriStep(dopri, time, mesh->dt, advection->o_q);
 
       // compute Dopri estimator
-      dfloat err = advectionDopriEstimate(advection);
+      dfloat err = dopriEstimate(dopri);
 					 
       // build controller
-      dfloat fac1 = pow(err,advection->exp1);
-      dfloat fac = fac1/pow(advection->facold,advection->beta);
-
-      fac = mymax(advection->invfactor2, mymin(advection->invfactor1,fac/advection->safe));
-      dfloat dtnew = mesh->dt/fac;
+      dfloat dtnew = dopriController(dopri, err, mesh->dt);
 
       if (err<1.0) { //dt is accepted
 
-	// check for output during this step and do a mini-step
+	// check for output during this step and interpolate to it
 	if(time<nextOutputTime && time+mesh->dt>nextOutputTime){
-	  dfloat savedt = mesh->dt;
-	  
-	  // save rkq
-	  advection->o_saveq.copyFrom(advection->o_rkq);
 
-	  // change dt to match output
-	  mesh->dt = nextOutputTime-time;
-
-	  // print
-	  printf("Taking output mini step: %g\n", mesh->dt);
-	  
-	  // time step to output
-	  advectionDopriStep(advection, newOptions, time);	  
+	  dopriOutputStep(dopri, time, mesh->dt, nextOutputTime, advection->o_q, advection->o_saveq);
 
 	  // shift for output
-	  advection->o_rkq.copyTo(advection->o_q);
+	  advection->o_saveq.copyTo(advection->o_q);
 	  
-	  // output  (print from rkq)
+	  // output  (print from saveq)
 	  advectionReport(advection, nextOutputTime, newOptions);
 
-	  // restore time step
-	  mesh->dt = savedt;
-
 	  // increment next output time
 	  nextOutputTime += outputInterval;
-
-	  // accept saved rkq
-	  advection->o_q.copyFrom(advection->o_saveq);
-	}
-	else{
-	  // accept rkq
-	  advection->o_q.copyFrom(advection->o_rkq);
 	}
 
+	// accept rkq
+	dopriAccept(dopri, advection->o_q);
+
         time += mesh->dt;
 
-        advection->facold = mymax(err,1E-4); // hard coded factor ?
 	if(!(tstep%1000))
 	  printf("\r time = %g (%d), dt = %g accepted                      ", time, allStep,  mesh->dt);
         tstep++;
       } else {
-        dtnew = mesh->dt/(mymax(advection->invfactor1,fac1/advection->safe));
-
 	if(!(tstep%1000))
 	  printf("\r time = %g (%d), dt = %g rejected, trying %g", time, allStep, mesh->dt, dtnew);
 
@@ -40,8 +40,8 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   advection->mesh = mesh;
 
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  advection->Nblock = (Ntotal+blockSize-1)/blockSize;
+  advection->nodalFlag    = newOptions.compareArgs("ADVECTION FORMULATION", "NODAL");
+  advection->cubatureFlag = newOptions.compareArgs("ADVECTION FORMULATION", "CUBATURE");
 
   hlong localElements = (hlong) mesh->Nelements;
   MPI_Allreduce(&localElements, &(advection->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
@@ -60,55 +60,6 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 		  		sizeof(dfloat));
   }
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    int NrkStages = 7;
-    advection->rkq  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    advection->rkrhsq = (dfloat*) calloc(NrkStages*mesh->Nelements*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    advection->rkerr  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-
-    advection->errtmp = (dfloat*) calloc(advection->Nblock, sizeof(dfloat));
-
-    // Dormand Prince -order (4) 5 with PID timestep control
-    int Nrk = 7;
-    dfloat rkC[7] = {0.0, 0.2, 0.3, 0.8, 8.0/9.0, 1.0, 1.0};
-    dfloat rkA[7*7] ={             0.0,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                                   0.2,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                              3.0/40.0,        9.0/40.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                             44.0/45.0,      -56.0/15.0,       32.0/9.0,          0.0,             0.0,       0.0, 0.0,
-                        19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0,             0.0,       0.0, 0.0,
-                         9017.0/3168.0,     -355.0/33.0, 46732.0/5247.0,   49.0/176.0, -5103.0/18656.0,       0.0, 0.0,
-                            35.0/384.0,             0.0,   500.0/1113.0,  125.0/192.0,  -2187.0/6784.0, 11.0/84.0, 0.0 };
-    dfloat rkE[7] = {71.0/57600.0,  0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0 };
-
-    advection->Nrk = Nrk;
-    advection->rkC = (dfloat*) calloc(advection->Nrk, sizeof(dfloat));
-    advection->rkE = (dfloat*) calloc(advection->Nrk, sizeof(dfloat));
-    advection->rkA = (dfloat*) calloc(advection->Nrk*advection->Nrk, sizeof(dfloat));
-
-    memcpy(advection->rkC, rkC, advection->Nrk*sizeof(dfloat));
-    memcpy(advection->rkE, rkE, advection->Nrk*sizeof(dfloat));
-    memcpy(advection->rkA, rkA, advection->Nrk*advection->Nrk*sizeof(dfloat));
-
-    advection->dtMIN = 1E-9; //minumum allowed timestep
-    advection->ATOL = 1E-6;  //absolute error tolerance
-    advection->RTOL = 1E-6;  //relative error tolerance
-    advection->safe = 0.8;   //safety factor
-
-    //error control parameters
-    advection->beta = 0.05;
-    advection->factor1 = 0.2;
-    advection->factor2 = 10.0;
-
-
-    advection->exp1 = 0.2 - 0.75*advection->beta;
-    advection->invfactor1 = 1.0/advection->factor1;
-    advection->invfactor2 = 1.0/advection->factor2;
-    advection->facold = 1E-4;
-
-  }
 
   // fix this later (initial conditions)
   for(dlong e=0;e<mesh->Nelements;++e){
@@ -279,6 +230,47 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
     advectionCombined = 1;
   }
 
+  // low storage WADG: trilinear 1/J from its corner values instead of cubvgeo
+  int advectionWADGLowStorage =
+    (advectionMassType==1 && newOptions.compareArgs("ADVECTION FORMULATION","LOWSTORAGE"));
+  if(advectionWADGLowStorage && advection->elementType!=HEXAHEDRA){
+    if(mesh->rank==0) printf("ERROR: low storage WADG is only implemented for HEXAHEDRA\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  if(advectionWADGLowStorage){
+    int Nwadg = 2*mesh->Nq + 2*mesh->cubNq + 8*mesh->Nelements;
+    dfloat *wadgWeights = (dfloat*) calloc(Nwadg, sizeof(dfloat));
+
+    for(int n=0;n<mesh->Nq;++n){
+      wadgWeights[0*mesh->Nq+n] = 0.5*(1-mesh->gllz[n]);
+      wadgWeights[1*mesh->Nq+n] = 0.5*(1+mesh->gllz[n]);
+    }
+    for(int m=0;m<mesh->cubNq;++m){
+      wadgWeights[2*mesh->Nq+0*mesh->cubNq+m] = 0.5*(1-mesh->cubr[m]);
+      wadgWeights[2*mesh->Nq+1*mesh->cubNq+m] = 0.5*(1+mesh->cubr[m]);
+    }
+
+    dfloat *invJ = wadgWeights + 2*mesh->Nq + 2*mesh->cubNq;
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int v=0;v<8;++v){
+        // corner node (a,b,c) of the GLL grid
+        int a = v%2, b = (v/2)%2, c = v/4;
+        int n = (mesh->Nq-1)*(a + b*mesh->Nq + c*mesh->Nq*mesh->Nq);
+        invJ[8*e+v] = 1./mesh->vgeo[e*mesh->Np*mesh->Nvgeo + JID*mesh->Np + n];
+      }
+    }
+
+    advection->o_wadgWeights = mesh->device.malloc(Nwadg*sizeof(dfloat), wadgWeights);
+    free(wadgWeights);
+
+    if(mesh->rank==0)
+      printf("WADG: 8 weights per element instead of %d cubvgeo entries\n", mesh->Nvgeo*mesh->cubNp);
+  } else {
+    advection->o_wadgWeights = mesh->o_cubvgeo;
+  }
+
 
 
   // non-constant advection velocity
@@ -426,21 +418,6 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
       mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->resq);
   }
 
-  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    printf("setting up DOPRI5\n");
-    int NrkStages = 7;
-    advection->o_rkq =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->rkq);
-    advection->o_rkrhsq =
-      mesh->device.malloc(NrkStages*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), advection->rkrhsq);
-    advection->o_rkerr =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), advection->rkerr);
-
-    advection->o_errtmp = mesh->device.malloc(advection->Nblock*sizeof(dfloat), advection->errtmp);
-
-    advection->o_rkA = mesh->device.malloc(advection->Nrk*advection->Nrk*sizeof(dfloat), advection->rkA);
-    advection->o_rkE = mesh->device.malloc(  advection->Nrk*sizeof(dfloat), advection->rkE);
-  }
 
 
   if(mesh->totalHaloPairs>0){
@@ -499,6 +476,8 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 
   kernelInfo["defines/" "p_blockSize"]= blockSize;
 
+  kernelInfo["defines/" "p_WADGLowStorage"]= advectionWADGLowStorage;
+
 
   kernelInfo["parser/" "automate-add-barriers"] =  "disabled";
 
@@ -564,20 +543,6 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
 				       "advectionUpdate",
 				       kernelInfo);
 
-  advection->rkUpdateKernel =
-    mesh->device.buildKernel(DADVECTION "/okl/advectionUpdate.okl",
-				       "advectionRkUpdate",
-				       kernelInfo);
-  advection->rkStageKernel =
-    mesh->device.buildKernel(DADVECTION "/okl/advectionUpdate.okl",
-				       "advectionRkStage",
-				       kernelInfo);
-
-  advection->rkErrorEstimateKernel =
-    mesh->device.buildKernel(DADVECTION "/okl/advectionUpdate.okl",
-				       "advectionErrorEstimate",
-				       kernelInfo);
-
   // fix this later
   mesh->haloExtractKernel =
     mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
@@ -601,7 +566,13 @@ advection_t *advectionSetup(mesh_t *mesh, setupAide &newOptions, char* boundaryH
   sprintf(kernelName, "advectionCombinedNodalWeakMMDGVolume%s", suffix);
 
   advection->invertMassMatrixCombinedKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
-  
+
+  if (newOptions.compareArgs("TIME INTEGRATOR","DOPRI5")){
+    printf("setting up DOPRI5\n");
+    dlong N = mesh->Nelements*mesh->Np*mesh->Nfields;
+    dlong Nhalo = mesh->totalHaloPairs*mesh->Np*mesh->Nfields;
+    advection->dopri = dopriSetup(mesh, N, Nhalo, kernelInfo, advection, advectionRhs);
+  }
   
   return advection;
 }
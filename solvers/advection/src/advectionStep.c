@@ -26,127 +26,90 @@
 
 #include "advection.h"
 
-void advectionDopriStep(advection_t *advection, setupAide &newOptions, const dfloat time){
+// rhsq = F(time, q), q needs room for the halo
+void advectionRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq){
 
+  advection_t *advection = (advection_t*) solver;
   mesh_t *mesh = advection->mesh;
-  
-  //RK step
-  for(int rk=0;rk<advection->Nrk;++rk){
-    
-    // t_rk = t + C_rk*dt
-    dfloat currentTime = time + advection->rkC[rk]*mesh->dt;
-    
-    //compute RK stage 
-    // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    advection->rkStageKernel(mesh->Nelements,
-			     rk,
-			     mesh->dt,
-			     advection->o_rkA,
-			     advection->o_q,
-			     advection->o_rkrhsq,
-			     advection->o_rkq);
-    
-    //compute RHS
-    // rhsq = F(currentTIme, rkq)
-    // extract q halo on DEVICE
-    if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Nfp*advection->Nfields;           // NFP !
-
-      mesh->haloGetKernel(mesh->totalHaloPairs,
-			  mesh->o_haloElementList,
-			  mesh->o_haloGetNodeIds,
-			  advection->o_rkq,
-			  advection->o_haloBuffer);
-      
 
-      mesh->device.finish();
-      mesh->device.setStream(mesh->dataStream);
-      
-      // copy extracted halo to HOST 
-      advection->o_haloBuffer.copyTo(advection->sendBuffer);      
+  // extract q halo on DEVICE
+  if(mesh->totalHaloPairs>0){
+    int Nentries = mesh->Nfp*advection->Nfields;           // NFP !
 
-      mesh->device.setStream(mesh->defaultStream);
+    mesh->haloGetKernel(mesh->totalHaloPairs,
+			mesh->o_haloElementList,
+			mesh->o_haloGetNodeIds,
+			o_q,
+			advection->o_haloBuffer);
       
-    }
+    mesh->device.finish();
+    mesh->device.setStream(mesh->dataStream);
+      
+    // copy extracted halo to HOST 
+    advection->o_haloBuffer.copyTo(advection->sendBuffer);      
 
-    if(newOptions.compareArgs("ADVECTION FORMULATION", "NODAL")){
-      advection->volumeKernel(mesh->Nelements, 
-			      mesh->o_vgeo, 
-			      mesh->o_Dmatrices,
-			      advection->o_advectionVelocityJW,
-			      advection->o_rkq, 
-			      advection->o_rhsq);
-    }
-    
-    if(newOptions.compareArgs("ADVECTION FORMULATION", "CUBATURE")){
-      advection->volumeKernel(mesh->Nelements, 
-			      mesh->o_vgeo,
-			      mesh->o_cubvgeo, 
-			      mesh->o_cubDWmatrices,
-			      mesh->o_cubInterpT,
-			      mesh->o_cubProjectT,
-			      advection->o_cubAdvectionVelocityJW,
-			      advection->o_rkq, 
-			      advection->o_rhsq);
-    }
+    mesh->device.setStream(mesh->defaultStream);
+  }
 
+  if(advection->nodalFlag){
+    advection->volumeKernel(mesh->Nelements, 
+			    mesh->o_vgeo, 
+			    mesh->o_Dmatrices,
+			    advection->o_advectionVelocityJW,
+			    o_q, 
+			    o_rhsq);
+  }
+    
+  if(advection->cubatureFlag){
+    advection->volumeKernel(mesh->Nelements, 
+			    mesh->o_vgeo,
+			    advection->o_wadgWeights, 
+			    mesh->o_cubDWmatrices,
+			    mesh->o_cubInterpT,
+			    mesh->o_cubProjectT,
+			    advection->o_cubAdvectionVelocityJW,
+			    o_q, 
+			    o_rhsq);
+  }
     
-    // wait for q halo data to arrive
-    if(mesh->totalHaloPairs>0){
-      mesh->device.setStream(mesh->dataStream);
-      mesh->device.finish();
+  // wait for q halo data to arrive
+  if(mesh->totalHaloPairs>0){
+    mesh->device.setStream(mesh->dataStream);
+    mesh->device.finish();
       
-      // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Nfp*advection->Nfields*sizeof(dfloat), advection->sendBuffer, advection->recvBuffer); // NFP !
+    // start halo exchange
+    meshHaloExchangeStart(mesh, mesh->Nfp*advection->Nfields*sizeof(dfloat), advection->sendBuffer, advection->recvBuffer); // NFP !
 
-      meshHaloExchangeFinish(mesh);
+    meshHaloExchangeFinish(mesh);
       
-      // copy halo data to DEVICE
-      advection->o_haloBuffer.copyFrom(advection->recvBuffer, "async: true");
+    // copy halo data to DEVICE
+    advection->o_haloBuffer.copyFrom(advection->recvBuffer, "async: true");
 
-      mesh->device.finish(); // finish copy to device
-      
-      mesh->haloPutKernel(mesh->totalHaloPairs,
-			  mesh->Nelements,
-			  mesh->o_haloPutNodeIds,
-			  advection->o_haloBuffer,
-			  advection->o_rkq);
+    mesh->device.finish(); // finish copy to device
       
+    mesh->haloPutKernel(mesh->totalHaloPairs,
+			mesh->Nelements,
+			mesh->o_haloPutNodeIds,
+			advection->o_haloBuffer,
+			o_q);
 
-      mesh->device.setStream(mesh->defaultStream);
-    }
-    
-    advection->surfaceKernel(mesh->Nelements, 
-			     mesh->o_sgeo, 
-			     mesh->o_LIFTT, 
-			     mesh->o_vmapM, 
-			     mesh->o_vmapP, 
-			     mesh->o_EToB,
-			     currentTime, 
-			     mesh->o_x, 
-			     mesh->o_y,
-			     mesh->o_z,
-			     advection->o_advectionVelocityM,
-			     advection->o_advectionVelocityP,
-			     advection->o_rkq, 
-			     advection->o_rhsq);
-    
-    // update solution using Runge-Kutta
-    // rkrhsq_rk = rhsq
-    // if rk==6 
-    //   q = q + dt*sum_{i=0}^{rk} rkA_{rk,i}*rkrhs_i
-    //   rkerr = dt*sum_{i=0}^{rk} rkE_{rk,i}*rkrhs_i
-    advection->rkUpdateKernel(mesh->Nelements, 
-			      rk,
-			      mesh->dt, 
-			      advection->o_rkA, 
-			      advection->o_rkE, 
-			      advection->o_q,
-			      advection->o_rhsq, 
-			      advection->o_rkrhsq, 
-			      advection->o_rkq,
-			      advection->o_rkerr);
+    mesh->device.setStream(mesh->defaultStream);
   }
+    
+  advection->surfaceKernel(mesh->Nelements, 
+			   mesh->o_sgeo, 
+			   mesh->o_LIFTT, 
+			   mesh->o_vmapM, 
+			   mesh->o_vmapP, 
+			   mesh->o_EToB,
+			   time, 
+			   mesh->o_x, 
+			   mesh->o_y,
+			   mesh->o_z,
+			   advection->o_advectionVelocityM,
+			   advection->o_advectionVelocityP,
+			   o_q, 
+			   o_rhsq);
 }
 
 
@@ -204,7 +167,7 @@ void advectionLserkStep(advection_t *advection, setupAide &newOptions, const dfl
       if(cubatureFlag){
 	advection->volumeKernel(mesh->Nelements, 
 				mesh->o_vgeo,
-				mesh->o_cubvgeo, 
+				advection->o_wadgWeights, 
 				mesh->o_cubDWmatrices,
 				mesh->o_cubInterpT,
 				mesh->o_cubProjectT,
@@ -38,6 +38,7 @@ SOFTWARE.
 // #include "mesh.h"
 #include "mesh2D.h"
 #include "mesh3D.h"
+#include "dopri.h"
 
 // Block size of reduction 
 #define blockSize 256
@@ -49,7 +50,6 @@ typedef struct{
   int Nfields; // Number of fields
 
   hlong totalElements; 
-  dlong Nblock;
 	
   int NrkStages; 
   int frame; 
@@ -82,9 +82,14 @@ typedef struct{
   int writeRestartFile, readRestartFile; 
 
   int pmlFlag;
+  int bernFlag;    // BASIS is BERN, q holds Bernstein-Bezier coefficients
   int errorStep;   // number of steps between error calculations
   int reportStep;  // number of steps between error calculations
 
+  int loadBalanceStep;          // number of steps between load balance checks (0: off)
+  dfloat loadBalanceTolerance;  // repartition when max/avg rank kernel time exceeds this
+  double loadBalancePmlTime, loadBalanceNonPmlTime; // kernel timer totals at the last check
+
   int procid; 
 
   dfloat RT, sqrtRT, tauInv, Ma, Re, nu; // Flow parameters
@@ -158,15 +163,18 @@ typedef struct{
   int Nvort;     // Number of vorticity fields i.e. 3 or 4 
   dfloat *Vort, *VortMag; 
   occa::memory o_Vort, o_VortMag;
+  occa::memory o_qN; // nodal values of a BERN solution for output
 
 
-  dfloat *rkq, *rkrhsq, *rkerr, *errtmp;
+  dfloat *rkq, *rkrhsq, *rkerr;
   dfloat *rkqx, *rkrhsqx;
   dfloat *rkqy, *rkrhsqy;
   dfloat *rkqz, *rkrhsqz;
 
   occa::memory o_rkq, o_rkrhsq, o_rkerr;
-  occa::memory o_errtmp;
+
+  // embedded error estimate and step size controller for SARK
+  dopri_t *dopri;
 
   // IMEXRK 
   occa::memory o_rhsqim, o_rhsqex, o_rkrhsqim, o_rkrhsqex;
@@ -225,7 +233,6 @@ typedef struct{
   occa::kernel updateStageKernel;
   occa::kernel pmlUpdateStageKernel;
 
-  occa::kernel errorEstimateKernel;
 
   occa::kernel dotMultiplyKernel; 
         
@@ -239,13 +246,17 @@ typedef struct{
 
 bns_t *bnsSetup(mesh_t *mesh, setupAide &options);
 
+// set up again on a repartitioned mesh, reusing the device and kernels of bns
+bns_t *bnsRebuild(bns_t *bns, setupAide &options);
+
 // Pml setup for single rate time discretization
 void bnsPmlSetup(bns_t *bns, setupAide &options);
 
 // Pml setup for multi rate time discretization
 void bnsMRABPmlSetup(bns_t *bns, setupAide &options);
 
-void bnsRun(bns_t *bns, setupAide &options);
+// returns the solver in use at the end of the run (load balancing replaces it)
+bns_t *bnsRun(bns_t *bns, setupAide &options);
 void bnsReport(bns_t *bns, dfloat time, setupAide &options);
 void bnsError(bns_t *bns, dfloat time, setupAide &options);
 void bnsForces(bns_t *bns, dfloat time, setupAide &options);
@@ -256,6 +267,9 @@ void bnsIsoWeldPlotVTU(bns_t *bns, char *fileName);
 //
 void bnsRestartWrite(bns_t *bns, setupAide &options, dfloat time); 
 void bnsRestartRead(bns_t *bns, setupAide &options); 
+
+// measured-cost load balancing, returns a rebuilt solver (and frees bns) if the mesh was repartitioned
+bns_t *bnsLoadBalance(bns_t *bns, int tstep, setupAide &options);
 // void bnsRestartSetup(bns_t *bns);
 
 
@@ -280,6 +294,9 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
 void bnsSARKStep(bns_t *bns, dfloat time, int haloBytes,
 		 dfloat * sendBuffer, dfloat *recvBuffer, setupAide &options);
 
+void bnsIMEXStep(bns_t *bns, dfloat time, int haloBytes,
+		 dfloat * sendBuffer, dfloat *recvBuffer, setupAide &options);
+
 void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
 		    dfloat *recvBuffer, setupAide &options);
 
@@ -35,6 +35,9 @@ void bnsError(bns_t *bns, dfloat time, setupAide &options){
 
   mesh_t *mesh = bns->mesh; 
 
+  if(bns->bernFlag)
+    meshApplyElementMatrixFields(mesh, bns->Nfields, mesh->VB, bns->q, bns->q);
+
   // dfloat time = 0.0; 
 
   // if(options.compareArgs("TIME INTEGRATOR","MRSAAB"))
@@ -0,0 +1,198 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "bns.h"
+
+// complete an IMEX Runge-Kutta step: advection explicit, relaxation solved
+// implicitly per node, leaves the new solution in rkq and the error in rkerr
+void bnsIMEXStep(bns_t *bns, dfloat time, int haloBytes,
+		 dfloat * sendBuffer, dfloat *recvBuffer, setupAide &options){
+
+  mesh_t *mesh = bns->mesh; 
+
+  dlong offset = mesh->Nelements*mesh->Np*bns->Nfields;
+
+  const dlong  dzero = 0.0; 
+  const int    izero = 0; 
+
+  for(int rk=0;rk<bns->NrkStages;++rk){
+
+    // intermediate stage time
+    dfloat currentTime = time + bns->rkCex[rk]*bns->dt;
+
+    occaTimerTic(mesh->device, "RKStageKernel");  
+    bns->updateStageKernel(mesh->nonPmlNelements,
+			   mesh->o_nonPmlElementIds,
+			   offset,
+			   rk,
+			   bns->dt,
+			   bns->o_rkAex,
+			   bns->o_rkAim,
+			   bns->o_q,
+			   bns->o_rkrhsqex,
+			   bns->o_rkrhsqim,
+			   bns->o_rkq);
+    occaTimerToc(mesh->device, "RKStageKernel");  
+
+    // equilibrium part of the relaxation from the conserved fields of the stage
+    occaTimerTic(mesh->device, "RelaxationKernel");
+    bns->relaxationKernel(mesh->nonPmlNelements,
+			  mesh->o_nonPmlElementIds,
+			  mesh->o_vgeo,
+			  mesh->o_cubvgeo,
+			  dzero, // 0
+			  izero, //0
+			  mesh->o_cubInterpT,
+			  mesh->o_cubProjectT,
+			  bns->o_rkq,
+			  bns->o_rhsqim);  
+    occaTimerToc(mesh->device, "RelaxationKernel");
+
+    occaTimerTic(mesh->device, "ImplicitSolveKernel");
+    bns->implicitSolveKernel(mesh->nonPmlNelements,
+			     mesh->o_nonPmlElementIds,
+			     offset,
+			     rk,
+			     bns->dt,
+			     bns->o_rkAim,
+			     bns->o_rhsqim,
+			     bns->o_rkq,
+			     bns->o_rkrhsqim);
+    occaTimerToc(mesh->device, "ImplicitSolveKernel");
+
+    if(mesh->totalHaloPairs>0){
+      int Nentries = mesh->Np*bns->Nfields;
+      mesh->haloExtractKernel(mesh->totalHaloPairs,
+			      Nentries,
+			      mesh->o_haloElementList,
+			      bns->o_rkq,
+			      mesh->o_haloBuffer);
+      // copy extracted halo to HOST
+      mesh->o_haloBuffer.copyTo(sendBuffer);
+      // start halo exchange
+      meshHaloExchangeStart(mesh, bns->Nfields*mesh->Np*sizeof(dfloat), sendBuffer, recvBuffer);
+    }
+
+    dfloat fx, fy, fz, intfx, intfy, intfz;
+    bnsBodyForce(currentTime , &fx, &fy, &fz, &intfx, &intfy, &intfz);
+
+    occaTimerTic(mesh->device, "VolumeKernel");    
+    if(bns->bernFlag)
+      bns->volumeKernel(mesh->nonPmlNelements,
+			mesh->o_nonPmlElementIds,
+			dzero,
+			izero,
+			fx,fy, fz,
+			mesh->o_vgeo,
+			mesh->o_x,
+			mesh->o_y,
+			mesh->o_z,
+			mesh->o_D0ids,
+			mesh->o_D1ids,
+			mesh->o_D2ids,
+			mesh->o_D3ids,
+			mesh->o_Dvals,
+			bns->o_rkq,
+			bns->o_rhsq);
+    else
+      bns->volumeKernel(mesh->nonPmlNelements,
+			mesh->o_nonPmlElementIds,
+			dzero,
+			izero,
+			fx,fy, fz,
+			mesh->o_vgeo,
+			mesh->o_x,
+			mesh->o_y,
+			mesh->o_z,
+			mesh->o_Dmatrices,
+			bns->o_rkq,
+			bns->o_rhsq);
+    occaTimerToc(mesh->device, "VolumeKernel");    
+
+    if(mesh->totalHaloPairs>0){
+      meshHaloExchangeFinish(mesh);
+      // copy halo data to DEVICE
+      size_t offset = mesh->Np*bns->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
+      bns->o_rkq.copyFrom(recvBuffer, haloBytes, offset);
+    }
+
+    occaTimerTic(mesh->device,"SurfaceKernel");
+    if(bns->bernFlag)
+      bns->surfaceKernel(mesh->nonPmlNelements,
+			 mesh->o_nonPmlElementIds,
+			 currentTime,
+			 intfx, intfy, intfz,
+			 mesh->o_sgeo,
+			 mesh->o_L0ids,
+			 mesh->o_L0vals,
+			 mesh->o_ELids,
+			 mesh->o_ELvals,
+			 mesh->o_vmapM,
+			 mesh->o_vmapP,
+			 mesh->o_EToB,
+			 mesh->o_x,
+			 mesh->o_y,
+			 mesh->o_z,
+			 bns->o_rkq,
+			 bns->o_rhsq);
+    else
+      bns->surfaceKernel(mesh->nonPmlNelements,
+			 mesh->o_nonPmlElementIds,
+			 currentTime,
+			 intfx, intfy, intfz,
+			 mesh->o_sgeo,
+			 mesh->o_LIFTT,
+			 mesh->o_vmapM,
+			 mesh->o_vmapP,
+			 mesh->o_EToB,
+			 mesh->o_x,
+			 mesh->o_y,
+			 mesh->o_z,
+			 bns->o_rkq,
+			 bns->o_rhsq);
+    occaTimerToc(mesh->device,"SurfaceKernel");
+
+    if(bns->elementType==QUADRILATERALS && mesh->dim==3){
+      bns->constrainKernel(mesh->Nelements, mesh->o_x, mesh->o_y, mesh->o_z, bns->o_rhsq);
+    } 
+
+    occaTimerTic(mesh->device,"UpdateKernel");
+    bns->updateKernel(mesh->nonPmlNelements,
+		      mesh->o_nonPmlElementIds,
+		      offset,
+		      rk,
+		      bns->dt,
+		      bns->o_rkBex,
+		      bns->o_rkEex,
+		      bns->o_q,
+		      bns->o_rhsq,
+		      bns->o_rkrhsqex,
+		      bns->o_rkrhsqim,
+		      bns->o_rkq,
+		      bns->o_rkerr);
+    occaTimerToc(mesh->device,"UpdateKernel");    
+  }
+}
@@ -130,18 +130,36 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
     // compute volume contribution to DG boltzmann RHS added d/dt (ramp(qbar)) to RHS
     if(mesh->nonPmlNelements){
       occaTimerTic(mesh->device,"NonPmlVolumeKernel");
-      bns->volumeKernel(mesh->nonPmlNelements,
-			mesh->o_nonPmlElementIds,
-			offset, 
-			shift,
-			fx, fy, fz,
-			mesh->o_vgeo,
-			mesh->o_x,
-			mesh->o_y,
-			mesh->o_z,
-			mesh->o_Dmatrices,
-			bns->o_q,
-			bns->o_rhsq);
+      if(bns->bernFlag)
+        bns->volumeKernel(mesh->nonPmlNelements,
+			  mesh->o_nonPmlElementIds,
+			  offset, 
+			  shift,
+			  fx, fy, fz,
+			  mesh->o_vgeo,
+			  mesh->o_x,
+			  mesh->o_y,
+			  mesh->o_z,
+			  mesh->o_D0ids,
+			  mesh->o_D1ids,
+			  mesh->o_D2ids,
+			  mesh->o_D3ids,
+			  mesh->o_Dvals,
+			  bns->o_q,
+			  bns->o_rhsq);
+      else
+        bns->volumeKernel(mesh->nonPmlNelements,
+			  mesh->o_nonPmlElementIds,
+			  offset, 
+			  shift,
+			  fx, fy, fz,
+			  mesh->o_vgeo,
+			  mesh->o_x,
+			  mesh->o_y,
+			  mesh->o_z,
+			  mesh->o_Dmatrices,
+			  bns->o_q,
+			  bns->o_rhsq);
       occaTimerToc(mesh->device,"NonPmlVolumeKernel");
     }
     occaTimerToc(mesh->device, "VolumeKernel");    
@@ -270,20 +288,39 @@ void bnsLSERKStep(bns_t *bns, int tstep, int haloBytes,
 
     if(mesh->nonPmlNelements){
       occaTimerTic(mesh->device,"NonPmlSurfaceKernel");
-      bns->surfaceKernel(mesh->nonPmlNelements,
-			 mesh->o_nonPmlElementIds,
-			 t,
-			 intfx, intfy, intfz,
-			 mesh->o_sgeo,
-			 mesh->o_LIFTT,
-			 mesh->o_vmapM,
-			 mesh->o_vmapP,
-			 mesh->o_EToB,
-			 mesh->o_x,
-			 mesh->o_y,
-			 mesh->o_z,
-			 bns->o_q,
-			 bns->o_rhsq);
+      if(bns->bernFlag)
+        bns->surfaceKernel(mesh->nonPmlNelements,
+			   mesh->o_nonPmlElementIds,
+			   t,
+			   intfx, intfy, intfz,
+			   mesh->o_sgeo,
+			   mesh->o_L0ids,
+			   mesh->o_L0vals,
+			   mesh->o_ELids,
+			   mesh->o_ELvals,
+			   mesh->o_vmapM,
+			   mesh->o_vmapP,
+			   mesh->o_EToB,
+			   mesh->o_x,
+			   mesh->o_y,
+			   mesh->o_z,
+			   bns->o_q,
+			   bns->o_rhsq);
+      else
+        bns->surfaceKernel(mesh->nonPmlNelements,
+			   mesh->o_nonPmlElementIds,
+			   t,
+			   intfx, intfy, intfz,
+			   mesh->o_sgeo,
+			   mesh->o_LIFTT,
+			   mesh->o_vmapM,
+			   mesh->o_vmapP,
+			   mesh->o_EToB,
+			   mesh->o_x,
+			   mesh->o_y,
+			   mesh->o_z,
+			   bns->o_q,
+			   bns->o_rhsq);
       occaTimerToc(mesh->device,"NonPmlSurfaceKernel");
     }
     occaTimerToc(mesh->device,"SurfaceKernel");
@@ -0,0 +1,384 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "bns.h"
+
+// kernel timer keys recorded by the time steppers
+static const char *bnsPmlKernelKeys[] = {
+  "PmlVolumeKernel", "PmlRelaxationKernel", "PmlSurfaceKernel",
+  "PmlUpdateKernel", "PmlTraceUpdateKernel"};
+
+static const char *bnsNonPmlKernelKeys[] = {
+  "NonPmlVolumeKernel", "NonPmlRelaxationKernel", "NonPmlSurfaceKernel",
+  "NonPmlUpdateKernel", "NonPmlTraceUpdateKernel"};
+
+static double bnsKernelTime(const char **keys, int Nkeys){
+  double time = 0.;
+  for(int n=0;n<Nkeys;++n)
+    time += occa::queryTime(keys[n]);
+  return time;
+}
+
+// local pml id of each element (-1 for non-pml elements)
+static dlong *bnsPmlIdMap(bns_t *bns, setupAide &options){
+
+  mesh_t *mesh = bns->mesh;
+
+  dlong *pmlIdMap = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  for(dlong e=0;e<mesh->Nelements;++e)
+    pmlIdMap[e] = -1;
+
+  if(!bns->pmlFlag) return pmlIdMap;
+
+  if(options.compareArgs("TIME INTEGRATOR","MRSAAB")){
+    for(int lev=0;lev<mesh->MRABNlevels;++lev)
+      for(dlong m=0;m<mesh->MRABpmlNelements[lev];++m)
+        pmlIdMap[mesh->MRABpmlElementIds[lev][m]] = mesh->MRABpmlIds[lev][m];
+  }
+  else{
+    for(dlong m=0;m<mesh->pmlNelements;++m)
+      pmlIdMap[mesh->pmlElementIds[m]] = mesh->pmlIds[m];
+  }
+
+  return pmlIdMap;
+}
+
+// release the partition dependent data of a solver (host, device and the
+// mesh lists it set up); the device and the kernels are left alone
+static void bnsFreePartitionData(bns_t *bns, setupAide &options){
+
+  mesh_t *mesh = bns->mesh;
+
+  const int mrab = options.compareArgs("TIME INTEGRATOR","MRSAAB");
+
+  free(bns->q);       bns->o_q.free();
+  free(bns->rhsq);    bns->o_rhsq.free();
+  free(bns->Vort);    bns->o_Vort.free();
+  free(bns->VortMag); bns->o_VortMag.free();
+
+  if(mrab){
+    free(bns->fQM);
+    bns->o_fQM.free();
+    mesh->o_mapP.free();
+  }
+  else{
+    free(bns->resq);
+    bns->o_resq.free();
+  }
+
+  // pinned halo buffers
+  if(mesh->totalHaloPairs){
+    bns->o_sendBufferPinned.free();
+    bns->o_recvBufferPinned.free();
+  }
+
+  if(mesh->pmlNelements){
+    free(bns->pmlSigmaX); free(bns->pmlSigmaY); free(bns->pmlSigmaZ);
+    free(bns->pmlqx);     free(bns->pmlqy);     free(bns->pmlqz);
+    free(bns->pmlrhsqx);  free(bns->pmlrhsqy);  free(bns->pmlrhsqz);
+    free(bns->pmlresqx);  free(bns->pmlresqy);  free(bns->pmlresqz);
+
+    bns->o_pmlSigmaX.free(); bns->o_pmlSigmaY.free(); bns->o_pmlSigmaZ.free();
+    bns->o_pmlqx.free();     bns->o_pmlqy.free();     bns->o_pmlqz.free();
+    bns->o_pmlrhsqx.free();  bns->o_pmlrhsqy.free();  bns->o_pmlrhsqz.free();
+    if(!mrab){
+      bns->o_pmlresqx.free(); bns->o_pmlresqy.free(); bns->o_pmlresqz.free();
+    }
+  }
+
+  if(mrab){
+    free(bns->MRSAAB_A); free(bns->MRSAAB_B); free(bns->MRSAAB_C);
+    free(bns->MRAB_A);   free(bns->MRAB_B);   free(bns->MRAB_C);
+
+    for(int lev=0;lev<mesh->MRABNlevels;++lev){
+      if(mesh->MRABNelements[lev])     mesh->o_MRABelementIds[lev].free();
+      if(mesh->MRABNhaloElements[lev]) mesh->o_MRABhaloIds[lev].free();
+
+      if(mesh->pmlNelements){
+        if(mesh->MRABpmlNelements[lev]){
+          mesh->o_MRABpmlElementIds[lev].free();
+          mesh->o_MRABpmlIds[lev].free();
+        }
+        if(mesh->MRABpmlNhaloElements[lev]){
+          mesh->o_MRABpmlHaloElementIds[lev].free();
+          mesh->o_MRABpmlHaloIds[lev].free();
+        }
+      }
+
+      free(mesh->MRABpmlElementIds[lev]);
+      free(mesh->MRABpmlIds[lev]);
+      free(mesh->MRABpmlHaloElementIds[lev]);
+      free(mesh->MRABpmlHaloIds[lev]);
+
+      free(mesh->MRABelementIds[lev]);
+      free(mesh->MRABhaloIds[lev]);
+    }
+
+    delete [] mesh->o_MRABelementIds;        mesh->o_MRABelementIds = NULL;
+    delete [] mesh->o_MRABhaloIds;           mesh->o_MRABhaloIds = NULL;
+    if(mesh->pmlNelements){
+      delete [] mesh->o_MRABpmlElementIds;     mesh->o_MRABpmlElementIds = NULL;
+      delete [] mesh->o_MRABpmlIds;            mesh->o_MRABpmlIds = NULL;
+      delete [] mesh->o_MRABpmlHaloElementIds; mesh->o_MRABpmlHaloElementIds = NULL;
+      delete [] mesh->o_MRABpmlHaloIds;        mesh->o_MRABpmlHaloIds = NULL;
+    }
+
+    free(mesh->MRABpmlNelements);      free(mesh->MRABpmlNhaloElements);
+    free(mesh->MRABpmlElementIds);     free(mesh->MRABpmlIds);
+    free(mesh->MRABpmlHaloElementIds); free(mesh->MRABpmlHaloIds);
+
+    // meshMRABSetup allocates the levels and level lists again
+    free(mesh->MRABlevel);      mesh->MRABlevel = NULL;
+    free(mesh->MRABelementIds); free(mesh->MRABhaloIds);
+    free(mesh->MRABNelements);  free(mesh->MRABNhaloElements);
+  }
+  else{
+    if(mesh->nonPmlNelements) mesh->o_nonPmlElementIds.free();
+    free(mesh->nonPmlElementIds);
+
+    if(mesh->pmlNelements){
+      mesh->o_pmlElementIds.free();
+      mesh->o_pmlIds.free();
+      free(mesh->pmlElementIds);
+      free(mesh->pmlIds);
+    }
+  }
+
+  // gather scatter lists of the 3D solvers, the ogs itself is swapped by bnsRebuild
+  if(bns->dim==3){
+    free(mesh->globalGatherElementList);
+    free(mesh->localGatherElementList);
+  }
+}
+
+/* ---------------------------------------------------------
+
+Measured-cost load balancing.
+
+Every loadBalanceStep steps the Pml/NonPml kernel times each
+rank accumulated in the occa timer since the last check are
+compared. If max/avg exceeds loadBalanceTolerance:
+
+  - the measured cost per RHS evaluation of pml and non-pml
+    elements on each rank gives every element a weight (times
+    its RHS evaluations per step for MRAB), and for MRAB the
+    element count of each level is added as a constraint
+  - the mesh is repartitioned with these weights
+  - the old solver's partition data is freed and the solver is
+    set up again on the new partition with the same device and
+    kernels
+  - q, the pml fields and (MRAB) the RHS histories move with
+    their elements. This happens after the rebuild, since the
+    MRAB setup reorders the local elements again (the final
+    migration sources follow that reorder)
+
+Supports the LSERK and MRSAAB integrators.
+
+------------------------------------------------------------ */
+bns_t *bnsLoadBalance(bns_t *bns, int tstep, setupAide &options){
+
+  mesh_t *mesh = bns->mesh;
+
+  const int NpmlKeys    = sizeof(bnsPmlKernelKeys)/sizeof(char*);
+  const int NnonPmlKeys = sizeof(bnsNonPmlKernelKeys)/sizeof(char*);
+
+  // kernel time on this rank since the last check
+  double pmlTime    = bnsKernelTime(bnsPmlKernelKeys, NpmlKeys);
+  double nonPmlTime = bnsKernelTime(bnsNonPmlKernelKeys, NnonPmlKeys);
+
+  double windowPmlTime    = pmlTime    - bns->loadBalancePmlTime;
+  double windowNonPmlTime = nonPmlTime - bns->loadBalanceNonPmlTime;
+
+  bns->loadBalancePmlTime    = pmlTime;
+  bns->loadBalanceNonPmlTime = nonPmlTime;
+
+  double localTime = windowPmlTime + windowNonPmlTime, maxTime, sumTime;
+  MPI_Allreduce(&localTime, &maxTime, 1, MPI_DOUBLE, MPI_MAX, mesh->comm);
+  MPI_Allreduce(&localTime, &sumTime, 1, MPI_DOUBLE, MPI_SUM, mesh->comm);
+
+  double imbalance = (sumTime>0) ? maxTime*mesh->size/sumTime : 1.0;
+
+  if(mesh->rank==0)
+    printf("Load balance check at step %d: kernel time imbalance %5.3f (tolerance %5.3f)\n",
+           tstep, imbalance, bns->loadBalanceTolerance);
+
+  if(imbalance<=bns->loadBalanceTolerance) return bns;
+
+  const int mrab = options.compareArgs("TIME INTEGRATOR","MRSAAB");
+
+  if(!mrab && !options.compareArgs("TIME INTEGRATOR","LSERK")){
+    if(mesh->rank==0) printf("Load balancing is only supported for LSERK and MRSAAB\n");
+    return bns;
+  }
+
+  if(mesh->rank==0) printf("Repartitioning for measured load...\n");
+
+  dlong *pmlIdMap = bnsPmlIdMap(bns, options);
+
+  // measured cost of one RHS evaluation of a pml and a non-pml element
+  double pmlWork = 0, nonPmlWork = 0;
+  for(dlong e=0;e<mesh->Nelements;++e){
+    double rate = (mrab) ? (1<<(mesh->MRABNlevels-1-mesh->MRABlevel[e])) : 1;
+    if(pmlIdMap[e]>=0) pmlWork += rate;
+    else               nonPmlWork += rate;
+  }
+  double pmlCost    = (pmlWork>0)    ? windowPmlTime/pmlWork       : 0;
+  double nonPmlCost = (nonPmlWork>0) ? windowNonPmlTime/nonPmlWork : 0;
+
+  // measured cost, plus the element count of each MRAB level
+  int Nconstraints = 1;
+  if(mrab) Nconstraints = mymin(1+mesh->MRABNlevels, meshMaxPartitionConstraints);
+
+  dfloat *weights = (dfloat*) calloc(mesh->Nelements*Nconstraints+1, sizeof(dfloat));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    double rate = (mrab) ? (1<<(mesh->MRABNlevels-1-mesh->MRABlevel[e])) : 1;
+    weights[e*Nconstraints+0] = rate*((pmlIdMap[e]>=0) ? pmlCost : nonPmlCost);
+    if(mrab && 1+mesh->MRABlevel[e]<Nconstraints)
+      weights[e*Nconstraints+1+mesh->MRABlevel[e]] = 1;
+  }
+
+  // pack the solver state of each element
+  const int Nhist = (mrab) ? bns->Nrhs : 0;
+  const dlong NpNf = mesh->Np*bns->Nfields;
+  const int NpmlFields = (bns->pmlFlag) ? bns->dim : 0;
+  const dlong Nrecord = NpNf*(1+Nhist)*(1+NpmlFields);
+
+  const dlong offset    = mesh->Nelements*NpNf;
+  const dlong pmloffset = mesh->pmlNelements*NpNf;
+
+  bns->o_q.copyTo(bns->q);
+  if(mrab) bns->o_rhsq.copyTo(bns->rhsq);
+
+  dfloat *pmlq[3] = {bns->pmlqx, bns->pmlqy, bns->pmlqz};
+  dfloat *pmlrhsq[3] = {bns->pmlrhsqx, bns->pmlrhsqy, bns->pmlrhsqz};
+  if(mesh->pmlNelements){
+    bns->o_pmlqx.copyTo(bns->pmlqx);
+    bns->o_pmlqy.copyTo(bns->pmlqy);
+    if(bns->dim==3) bns->o_pmlqz.copyTo(bns->pmlqz);
+    if(mrab){
+      bns->o_pmlrhsqx.copyTo(bns->pmlrhsqx);
+      bns->o_pmlrhsqy.copyTo(bns->pmlrhsqy);
+      if(bns->dim==3) bns->o_pmlrhsqz.copyTo(bns->pmlrhsqz);
+    }
+  }
+
+  dfloat *oldState = (dfloat*) calloc(mesh->Nelements*Nrecord+1, sizeof(dfloat));
+  for(dlong e=0;e<mesh->Nelements;++e){
+    dfloat *record = oldState + e*Nrecord;
+
+    // history is stored in logical order (shift index 0 after the rebuild)
+    int shift = (mrab) ? mesh->MRABshiftIndex[mesh->MRABlevel[e]] : 0;
+
+    memcpy(record, bns->q + e*NpNf, NpNf*sizeof(dfloat));
+    for(int k=0;k<Nhist;++k)
+      memcpy(record + (1+k)*NpNf, bns->rhsq + ((shift+k)%Nhist)*offset + e*NpNf, NpNf*sizeof(dfloat));
+
+    dlong pmlId = pmlIdMap[e];
+    if(pmlId>=0){
+      for(int d=0;d<NpmlFields;++d){
+        dfloat *pmlRecord = record + (1+d)*(1+Nhist)*NpNf;
+        memcpy(pmlRecord, pmlq[d] + pmlId*NpNf, NpNf*sizeof(dfloat));
+        for(int k=0;k<Nhist;++k)
+          memcpy(pmlRecord + (1+k)*NpNf, pmlrhsq[d] + ((shift+k)%Nhist)*pmloffset + pmlId*NpNf,
+                 NpNf*sizeof(dfloat));
+      }
+    }
+  }
+
+  // repartition and rebuild the host mesh
+  if(bns->dim==2)
+    meshRepartition2D(mesh, Nconstraints, weights);
+  else
+    meshRepartition3D(mesh, Nconstraints, weights);
+
+  // release the old solver and set it up again on the new partition
+  bnsFreePartitionData(bns, options);
+
+  bns_t *newBns = bnsRebuild(bns, options);
+
+  // move the state to the final element order of the rebuilt mesh
+  dfloat *newState = (dfloat*) calloc(mesh->Nelements*Nrecord+1, sizeof(dfloat));
+  meshMigrateElementData(mesh, Nrecord*sizeof(dfloat), oldState, newState);
+
+  newBns->startTime  = bns->startTime;
+  newBns->dt         = bns->dt;
+  newBns->NtimeSteps = bns->NtimeSteps;
+  newBns->frame      = bns->frame;
+  newBns->loadBalancePmlTime    = pmlTime;
+  newBns->loadBalanceNonPmlTime = nonPmlTime;
+
+  // copy the migrated state in
+  dlong *newPmlIdMap = bnsPmlIdMap(newBns, options);
+
+  const dlong newOffset    = mesh->Nelements*NpNf;
+  const dlong newPmloffset = mesh->pmlNelements*NpNf;
+
+  dfloat *newPmlq[3] = {newBns->pmlqx, newBns->pmlqy, newBns->pmlqz};
+  dfloat *newPmlrhsq[3] = {newBns->pmlrhsqx, newBns->pmlrhsqy, newBns->pmlrhsqz};
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    dfloat *record = newState + e*Nrecord;
+
+    memcpy(newBns->q + e*NpNf, record, NpNf*sizeof(dfloat));
+    for(int k=0;k<Nhist;++k)
+      memcpy(newBns->rhsq + k*newOffset + e*NpNf, record + (1+k)*NpNf, NpNf*sizeof(dfloat));
+
+    dlong pmlId = newPmlIdMap[e];
+    if(pmlId>=0){
+      for(int d=0;d<NpmlFields;++d){
+        dfloat *pmlRecord = record + (1+d)*(1+Nhist)*NpNf;
+        memcpy(newPmlq[d] + pmlId*NpNf, pmlRecord, NpNf*sizeof(dfloat));
+        for(int k=0;k<Nhist;++k)
+          memcpy(newPmlrhsq[d] + k*newPmloffset + pmlId*NpNf, pmlRecord + (1+k)*NpNf,
+                 NpNf*sizeof(dfloat));
+      }
+    }
+  }
+
+  newBns->o_q.copyFrom(newBns->q);
+  if(mrab) newBns->o_rhsq.copyFrom(newBns->rhsq);
+  if(mesh->pmlNelements){
+    newBns->o_pmlqx.copyFrom(newBns->pmlqx);
+    newBns->o_pmlqy.copyFrom(newBns->pmlqy);
+    if(newBns->dim==3) newBns->o_pmlqz.copyFrom(newBns->pmlqz);
+    if(mrab){
+      newBns->o_pmlrhsqx.copyFrom(newBns->pmlrhsqx);
+      newBns->o_pmlrhsqy.copyFrom(newBns->pmlrhsqy);
+      if(newBns->dim==3) newBns->o_pmlrhsqz.copyFrom(newBns->pmlrhsqz);
+    }
+  }
+
+  free(pmlIdMap);
+  free(newPmlIdMap);
+  free(weights);
+  free(oldState);
+  free(newState);
+
+  // the kernels live on in newBns
+  free(bns);
+
+  return newBns;
+}
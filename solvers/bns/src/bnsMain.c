@@ -80,7 +80,7 @@ int main(int argc, char **argv){
    }  
 
    bnsPlotVTU(bns, "foo.vtu");
-   bnsRun(bns,options);
+   bns = bnsRun(bns,options);
    
   // close down MPI
   MPI_Finalize();
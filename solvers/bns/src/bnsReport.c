@@ -30,10 +30,19 @@ void bnsReport(bns_t *bns, dfloat time, setupAide &options){
 
 mesh_t *mesh = bns->mesh; 
 
+  // vorticity and output act on nodal values
+  occa::memory o_q = bns->o_q;
+  if(bns->bernFlag){
+    bns->o_q.copyTo(bns->q);
+    meshApplyElementMatrixFields(mesh, bns->Nfields, mesh->VB, bns->q, bns->q);
+    bns->o_qN.copyFrom(bns->q, mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat));
+    o_q = bns->o_qN;
+  }
+
   bns->vorticityKernel(mesh->Nelements,
                        mesh->o_vgeo,
                        mesh->o_Dmatrices,
-                       bns->o_q,
+                       o_q,
                        bns->o_Vort,
                        bns->o_VortMag);
 
@@ -57,7 +66,7 @@ mesh_t *mesh = bns->mesh;
   if(options.compareArgs("OUTPUT FILE FORMAT","PPM")){
 
     // copy data back to host
-    bns->o_q.copyTo(bns->q);
+    o_q.copyTo(bns->q);
     bns->o_Vort.copyTo(bns->Vort);
     bns->o_VortMag.copyTo(bns->VortMag);
    
@@ -72,7 +81,7 @@ mesh_t *mesh = bns->mesh;
   if(options.compareArgs("OUTPUT FILE FORMAT","VTU")){
 
     // copy data back to host
-    bns->o_q.copyTo(bns->q);
+    o_q.copyTo(bns->q);
     bns->o_Vort.copyTo(bns->Vort);
     bns->o_VortMag.copyTo(bns->VortMag);
    
@@ -102,7 +111,7 @@ mesh_t *mesh = bns->mesh;
                               mesh->o_x,
                               mesh->o_y,
                               mesh->o_z,
-                              bns->o_q,
+                              o_q,
                               bns->o_Vort,
                               bns->o_VortMag,
                               bns->o_plotInterp,
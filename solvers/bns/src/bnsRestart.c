@@ -52,7 +52,8 @@ void bnsRestartWrite(bns_t *bns, setupAide &options, dfloat time){
 
   // 
  if(options.compareArgs("TIME INTEGRATOR", "LSERK") || 
-    options.compareArgs("TIME INTEGRATOR", "SARK")){
+    options.compareArgs("TIME INTEGRATOR", "SARK")  ||
+    options.compareArgs("TIME INTEGRATOR", "IMEXRK")){
   // Write only q works check for MRAB, write history
   for(dlong e = 0; e<mesh->Nelements; e++){
     for(int n=0; n<mesh->Np; n++ ){
@@ -26,13 +26,12 @@ SOFTWARE.
 
 #include "bns.h"
 
-void bnsRun(bns_t *bns, setupAide &options){
+// pinned halo buffers sized for the integrator, returns the halo size in bytes
+static int bnsHaloBufferSetup(bns_t *bns, setupAide &options,
+                              dfloat **sendBuffer, dfloat **recvBuffer){
 
-  mesh_t  *mesh = bns->mesh; 
+  mesh_t *mesh = bns->mesh;
 
-  // MPI send buffer
-  dfloat *sendBuffer;
-  dfloat *recvBuffer;
   int haloBytes;
 
   if(options.compareArgs("TIME INTEGRATOR","MRSAAB"))
@@ -41,26 +40,43 @@ void bnsRun(bns_t *bns, setupAide &options){
     haloBytes = mesh->totalHaloPairs*mesh->Np*bns->Nfields*sizeof(dfloat);
 
   if (haloBytes) {
-#if 0
-    occa::memory o_sendBufferPinned = mesh->device.mappedAlloc(haloBytes, NULL);
-    occa::memory o_recvBufferPinned = mesh->device.mappedAlloc(haloBytes, NULL);
-    sendBuffer = (dfloat*) o_sendBufferPinned.getMappedPointer();
-    recvBuffer = (dfloat*) o_recvBufferPinned.getMappedPointer();
-#endif
-    
-    sendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, bns->o_sendBufferPinned);
-    recvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, bns->o_recvBufferPinned);
+    *sendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, bns->o_sendBufferPinned);
+    *recvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, bns->o_recvBufferPinned);
   }
 
-  if(options.compareArgs("TIME INTEGRATOR","MRSAAB")){
-    printf("Populating trace values\n");
-    // Populate Trace Buffer
-    dlong offset = mesh->Np*mesh->Nelements*bns->Nfields;
-    for (int l=0; l<mesh->MRABNlevels; l++) {  
-      const int id = 3*mesh->MRABNlevels*3 + 3*l;
-      if (mesh->MRABNelements[l])
-        bns->traceUpdateKernel(mesh->MRABNelements[l],
-                               mesh->o_MRABelementIds[l],
+  return haloBytes;
+}
+
+// populate the MRSAAB trace buffer from q and the rhs history
+static void bnsMRSAABTraceSetup(bns_t *bns){
+
+  mesh_t *mesh = bns->mesh;
+
+  printf("Populating trace values\n");
+  // Populate Trace Buffer
+  dlong offset = mesh->Np*mesh->Nelements*bns->Nfields;
+  for (int l=0; l<mesh->MRABNlevels; l++) {  
+    const int id = 3*mesh->MRABNlevels*3 + 3*l;
+    if (mesh->MRABNelements[l])
+      bns->traceUpdateKernel(mesh->MRABNelements[l],
+                             mesh->o_MRABelementIds[l],
+                             offset,
+                             mesh->MRABshiftIndex[l],
+                             bns->MRSAAB_C[l-1], //
+                             bns->MRAB_B[id+0], //
+                             bns->MRAB_B[id+1],
+                             bns->MRAB_B[id+2], //
+                             bns->MRSAAB_B[id+0], //
+                             bns->MRSAAB_B[id+1],
+                             bns->MRSAAB_B[id+2],
+                             mesh->o_vmapM,
+                             bns->o_q,
+                             bns->o_rhsq,
+                             bns->o_fQM);
+    // if(bns->pmlFlag){
+      if (mesh->MRABpmlNelements[l])
+        bns->traceUpdateKernel(mesh->MRABpmlNelements[l],
+                               mesh->o_MRABpmlElementIds[l],
                                offset,
                                mesh->MRABshiftIndex[l],
                                bns->MRSAAB_C[l-1], //
@@ -74,26 +90,21 @@ void bnsRun(bns_t *bns, setupAide &options){
                                bns->o_q,
                                bns->o_rhsq,
                                bns->o_fQM);
-      // if(bns->pmlFlag){
-        if (mesh->MRABpmlNelements[l])
-          bns->traceUpdateKernel(mesh->MRABpmlNelements[l],
-                                 mesh->o_MRABpmlElementIds[l],
-                                 offset,
-                                 mesh->MRABshiftIndex[l],
-                                 bns->MRSAAB_C[l-1], //
-                                 bns->MRAB_B[id+0], //
-                                 bns->MRAB_B[id+1],
-                                 bns->MRAB_B[id+2], //
-                                 bns->MRSAAB_B[id+0], //
-                                 bns->MRSAAB_B[id+1],
-                                 bns->MRSAAB_B[id+2],
-                                 mesh->o_vmapM,
-                                 bns->o_q,
-                                 bns->o_rhsq,
-                                 bns->o_fQM);
-      // }
-    }
+    // }
   }
+}
+
+bns_t *bnsRun(bns_t *bns, setupAide &options){
+
+  mesh_t  *mesh = bns->mesh; 
+
+  // MPI send buffer
+  dfloat *sendBuffer = NULL;
+  dfloat *recvBuffer = NULL;
+  int haloBytes = bnsHaloBufferSetup(bns, options, &sendBuffer, &recvBuffer);
+
+  if(options.compareArgs("TIME INTEGRATOR","MRSAAB"))
+    bnsMRSAABTraceSetup(bns);
 
   if(mesh->rank==0) printf("N: %d Nsteps: %d dt: %.5e \n", mesh->N, bns->NtimeSteps, bns->dt);
 
@@ -199,6 +210,18 @@ void bnsRun(bns_t *bns, setupAide &options){
       */
 
       elp_sol += (MPI_Wtime() - tic_sol);
+
+      // repartition on measured kernel cost and carry on with the rebuilt solver
+      if(bns->loadBalanceStep && ((tstep+1)%bns->loadBalanceStep)==0 && tstep+1<bns->NtimeSteps){
+        bns_t *newBns = bnsLoadBalance(bns, tstep+1, options);
+        if(newBns!=bns){
+          bns  = newBns;
+          mesh = bns->mesh;
+          haloBytes = bnsHaloBufferSetup(bns, options, &sendBuffer, &recvBuffer);
+          if(options.compareArgs("TIME INTEGRATOR","MRSAAB"))
+            bnsMRSAABTraceSetup(bns);
+        }
+      }
     }
   }else if( options.compareArgs("TIME INTEGRATOR", "SARK")){
 
@@ -206,6 +229,12 @@ void bnsRun(bns_t *bns, setupAide &options){
     bnsRunEmbedded(bns, haloBytes, sendBuffer, recvBuffer, options);
     occaTimerToc(mesh->device, "SARK_TOTAL");
 
+  }else if( options.compareArgs("TIME INTEGRATOR", "IMEXRK")){
+
+    occaTimerTic(mesh->device, "IMEXRK_TOTAL");
+    bnsRunEmbedded(bns, haloBytes, sendBuffer, recvBuffer, options);
+    occaTimerToc(mesh->device, "IMEXRK_TOTAL");
+
   }else{
     printf("Wrong time stepper\n");
     exit(EXIT_FAILURE); 
@@ -234,6 +263,8 @@ void bnsRun(bns_t *bns, setupAide &options){
   //bnsReport(bns, bns->NtimeSteps,options);
 
   occa::printTimer();
+
+  return bns;
 }
 
 
@@ -26,20 +26,20 @@ SOFTWARE.
 
 #include "bns.h"
 
+// one embedded step of the adaptive integrator, leaves the new solution in rkq
+static void bnsEmbeddedStep(bns_t *bns, int haloBytes, dfloat *sendBuffer,
+                            dfloat *recvBuffer, setupAide &options){
+  if(options.compareArgs("TIME INTEGRATOR","IMEXRK"))
+    bnsIMEXStep(bns, bns->time, haloBytes, sendBuffer, recvBuffer, options);
+  else
+    bnsSARKStep(bns, bns->time, haloBytes, sendBuffer, recvBuffer, options);
+}
+
 void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
 		    dfloat *recvBuffer, setupAide &options){
 
   mesh_t *mesh = bns->mesh;
-
-  dfloat safe  = 0.95;   //safety factor
-  //error control parameters
-  dfloat beta       = 0.05; 
-  dfloat factor1    = 0.25;
-  dfloat factor2    = 10.0;
-  dfloat exp1       = 1.0/bns->rkp -0.75*beta; 
-  dfloat invfactor1 = 1.0/factor1;
-  dfloat invfactor2 = 1.0/factor2;
-  dfloat facold     = 1E-4;
+  dopri_t *dopri = bns->dopri;
 
   dfloat hmin = 1e9;
   for(dlong e=0;e<mesh->Nelements;++e){  
@@ -66,8 +66,10 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
   bns->atstep = 0; 
   bns->rtstep = 0;  
 
-  // Compute Coefficients before starting loop
-  bnsSAADRKCoefficients(bns, options);
+  // Compute Coefficients before starting loop, the semi-analytic ones depend on dt
+  int sarkFlag = options.compareArgs("TIME INTEGRATOR","SARK");
+  if(sarkFlag)
+    bnsSAADRKCoefficients(bns, options);
 
   if(bns->reportFlag)
     bnsReport(bns, bns->time, options);
@@ -92,44 +94,20 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
     }
 
     occaTimerTic(mesh->device, "SARK_STEP"); 
-    bnsSARKStep(bns, bns->time, haloBytes, sendBuffer, recvBuffer, options);
+    bnsEmbeddedStep(bns, haloBytes, sendBuffer, recvBuffer, options);
     occaTimerToc(mesh->device, "SARK_STEP"); 
     
     
 
     occaTimerTic(mesh->device, "SARK_ERROR"); 
     //Error estimation 
-    dlong Ntotal = mesh->Nelements*mesh->Np*bns->Nfields;
-    // printf("Ntotal: %d \t %d\n", Ntotal, bns->Nblock);
-    bns->errorEstimateKernel(Ntotal, 
-                            bns->ATOL,
-                            bns->RTOL,
-                            bns->o_q,
-                            bns->o_rkq,
-                            bns->o_rkerr,
-                            bns->o_errtmp);
-
-    bns->o_errtmp.copyTo(bns->errtmp);
-    
-    // printf("Max err:\t%.5e\n",maxerr);
-    dfloat localerr = 0, err = 0;
-
-    for(int n=0;n<bns->Nblock;++n){
-      localerr += bns->errtmp[n];
-    }
+    dopriErrorEstimate(dopri, bns->o_q, bns->o_rkq, bns->o_rkerr);
 
-    MPI_Allreduce(&localerr, &err, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
-   
-    // printf("Error\t:\t%.5e\t%.5e\t\n", err, bns->dt);
-    err = sqrt(err/(bns->totalElements*mesh->Np*bns->Nfields));
+    dfloat err = dopriEstimate(dopri);
     
     occaTimerToc(mesh->device, "SARK_ERROR"); 
 
-    dfloat fac1 = pow(err,exp1);
-    dfloat fac  = fac1/pow(facold,beta);
-
-    fac = mymax(invfactor2, mymin(invfactor1,fac/safe));
-    dfloat dtnew = bns->dt/fac;
+    dfloat dtnew = dopriController(dopri, err, bns->dt);
 
     if(err<1.0){
 
@@ -156,10 +134,11 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
           if(mesh->rank==0) printf("Taking output mini step: %g\n", bns->dt);
           
           // Compute new coefficients
-          bnsSAADRKCoefficients(bns, options);
+          if(sarkFlag)
+            bnsSAADRKCoefficients(bns, options);
 
           // if(options.compareArgs("TIME INTEGRATOR","SARK"))  // SA Adaptive RK 
-          bnsSARKStep(bns, bns->time, haloBytes, sendBuffer, recvBuffer, options);
+          bnsEmbeddedStep(bns, haloBytes, sendBuffer, recvBuffer, options);
           // shift for output
           bns->o_rkq.copyTo(bns->o_q);
           // output  (print from rkq)
@@ -176,7 +155,8 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
           bns->dt = savedt;
 
           // Go back to old coefficients
-          bnsSAADRKCoefficients(bns, options);
+          if(sarkFlag)
+            bnsSAADRKCoefficients(bns, options);
 
           // increment next output time
           nextOutputTime += outputInterval;
@@ -222,12 +202,13 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
       if(bns->outputForceStep){
         if(bns->tstep%bns->outputForceStep){
           bns->o_q.copyTo(bns->q);
+          if(bns->bernFlag)
+            meshApplyElementMatrixFields(mesh, bns->Nfields, mesh->VB, bns->q, bns->q);
           bnsForces(bns,bns->time,options);
         }
       }
       
 
-      facold = mymax(err,1E-4);
       bns->time += bns->dt;
 
       if(mesh->rank==0) printf("\r time = %g (%d), dt = %g accepted (ratio dt/hmin = %g)               ", bns->time, bns->atstep, bns->dt, bns->dt/hmin);
@@ -235,7 +216,6 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
     }
     else{
       bns->rtstep++; 
-      dtnew = bns->dt/(mymax(invfactor1,fac1/safe));
       if(mesh->rank==0) printf("\r time = %g (%d), dt = %g rejected (ratio dt/min = %g), trying %g", bns->time,bns->atstep, bns->dt, bns->dt/hmin, dtnew);
       done =0;
     }
@@ -246,7 +226,8 @@ void bnsRunEmbedded(bns_t *bns, int haloBytes, dfloat * sendBuffer,
 
 
 
-    bnsSAADRKCoefficients(bns, options);
+    if(sarkFlag)
+      bnsSAADRKCoefficients(bns, options);
     #if 0
     char fname[BUFSIZ]; sprintf(fname, "boltzmannAddaptiveDt.dat");
     FILE *fp; fp = fopen(fname, "a");
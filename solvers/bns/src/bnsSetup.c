@@ -26,7 +26,10 @@
 
 #include "bns.h"
 
-bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
+/* set up the solver on mesh. A donor solver (set up earlier on the same
+   mesh, which has since been repartitioned) lends its device, streams and
+   kernels so only the partition dependent data is rebuilt */
+static bns_t *bnsSetupSolver(mesh_t *mesh, setupAide &options, bns_t *donor){
   
   // BNS build
   bns_t *bns = (bns_t*) calloc(1, sizeof(bns_t));
@@ -107,13 +110,34 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   
   bns->writeRestartFile = 0; 
   options.getArgs("WRITE RESTART FILE", bns->writeRestartFile);
+
+  // runtime load balancing (off by default)
+  bns->loadBalanceStep = 0;
+  options.getArgs("LOAD BALANCE STEPS", bns->loadBalanceStep);
+
+  bns->loadBalanceTolerance = 1.2;
+  options.getArgs("LOAD BALANCE TOLERANCE", bns->loadBalanceTolerance);
   
   if(options.compareArgs("PML INTEGRATION", "COLLOCATION"))
     bns->pmlcubature = 0;
   else
     bns->pmlcubature = 1; 
 
+  // Bernstein-Bezier basis for single rate tetrahedral runs without PML
+  bns->bernFlag = options.compareArgs("BASIS", "BERN");
+  if(bns->bernFlag && (bns->elementType!=TETRAHEDRA || bns->pmlFlag 
+                       || options.compareArgs("TIME INTEGRATOR", "MRSAAB"))){
+    printf("BERN basis requires tetrahedra, no PML and a single rate integrator\n");
+    exit(EXIT_FAILURE);
+  }
+
   
+  // IMEX stages solve the relaxation pointwise on the unsplit equations only
+  if(options.compareArgs("TIME INTEGRATOR", "IMEXRK") && bns->pmlFlag){
+    printf("IMEXRK integrator does not support PML\n");
+    exit(EXIT_FAILURE);
+  }
+
   // Set time discretization scheme:fully explicit or not
   bns->fexplicit = 0; 
   if(options.compareArgs("TIME INTEGRATOR", "LSERK") ) // fully explicit schemes
@@ -327,8 +351,8 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     bns->emethod = 0; // 0 PID / 1 PI / 2 P / 3 I    
     bns->rkp     = 5; // order of embedded scheme + 1 
 
-    dlong localElements =  mesh->Nelements;
-    MPI_Allreduce(&localElements, &(bns->totalElements), 1, MPI_LONG, MPI_SUM, mesh->comm);
+    hlong localElements =  mesh->Nelements;
+    MPI_Allreduce(&localElements, &(bns->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
 
     // compute samples of q at interpolation nodes
     bns->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
@@ -339,11 +363,30 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     bns->rkq      = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
     bns->rkrhsq   = (dfloat*) calloc(bns->NrkStages*mesh->Nelements*mesh->Np*bns->Nfields, sizeof(dfloat));
     bns->rkerr    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
-    
-    dlong Ntotal  = mesh->Nelements*mesh->Np*bns->Nfields;
-    bns->Nblock   = (Ntotal+blockSize-1)/blockSize;
-    // printf("blockSize: %d %d \n", blockSize, bns->Nblock);
-    bns->errtmp  =  (dfloat*) calloc(bns->Nblock, sizeof(dfloat)); 
+  }
+
+  // Initialize
+  if (options.compareArgs("TIME INTEGRATOR","IMEXRK")){ // IMEX RK with implicit relaxation, adaptive time stepping
+    bns->Nrhs  = 1;
+    bns->ATOL    = 1.0; options.getArgs("ABSOLUTE TOLERANCE",   bns->ATOL); 
+    bns->RTOL    = 1.0; options.getArgs("RELATIVE TOLERANCE",   bns->RTOL);
+    bns->dtMIN   = 1.0; options.getArgs("MINUMUM TIME STEP SIZE",   bns->dtMIN); 
+    bns->emethod = 0; // 0 PID / 1 PI / 2 P / 3 I    
+    bns->rkp     = 3; // order of embedded scheme + 1 
+
+    hlong localElements =  mesh->Nelements;
+    MPI_Allreduce(&localElements, &(bns->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+    bns->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
+    bns->rhsq = (dfloat*) calloc(mesh->Nelements*mesh->Np*bns->Nfields, sizeof(dfloat));
+
+    bns->NrkStages = 4; // ARK3(2)4L[2]SA
+
+    bns->rkq      = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
+    bns->rkerr    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*bns->Nfields, sizeof(dfloat));
+    bns->rhsqim   = (dfloat*) calloc(mesh->Nelements*mesh->Np*bns->Nfields, sizeof(dfloat));
+    bns->rkrhsqex = (dfloat*) calloc(bns->NrkStages*mesh->Nelements*mesh->Np*bns->Nfields, sizeof(dfloat));
+    bns->rkrhsqim = (dfloat*) calloc(bns->NrkStages*mesh->Nelements*mesh->Np*bns->Nfields, sizeof(dfloat));
   }
 
  
@@ -413,6 +456,10 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     }
   }
 
+
+  // convert nodal initial conditions to BB coefficients
+  if(bns->bernFlag)
+    meshApplyElementMatrixFields(mesh, bns->Nfields, mesh->invVB, bns->q, bns->q);
   
   // Write Problem Info 
   if(mesh->rank==0){
@@ -443,14 +490,48 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   kernelInfo["header"].asArray();
   kernelInfo["flags"].asObject();
   
-  if(bns->dim==3){
-    if(bns->elementType != QUADRILATERALS)
-      meshOccaSetup3D(mesh, options, kernelInfo);
+  if(donor){
+    // the device is already configured, only copy the new partition to it
+    if(bns->dim==3){
+      if(bns->elementType != QUADRILATERALS)
+        meshOccaPopulateDevice3D(mesh, options, kernelInfo);
+      else
+        meshOccaPopulateDeviceQuad3D(mesh, options, kernelInfo);
+    }
     else
-      meshOccaSetupQuad3D(mesh, options, kernelInfo);
+      meshOccaPopulateDevice2D(mesh, options, kernelInfo);
+  }
+  else{
+    if(bns->dim==3){
+      if(bns->elementType != QUADRILATERALS)
+        meshOccaSetup3D(mesh, options, kernelInfo);
+      else
+        meshOccaSetupQuad3D(mesh, options, kernelInfo);
+    }
+    else
+      meshOccaSetup2D(mesh, options, kernelInfo);
+  }
+
+  if(bns->bernFlag){
+    // relaxation kernels interpolate from BB coefficients to cubature and
+    // project back onto BB coefficients
+    dfloat *cubInterpT  = (dfloat*) calloc(mesh->cubNp*mesh->Np, sizeof(dfloat));
+    dfloat *cubProjectT = (dfloat*) calloc(mesh->cubNp*mesh->Np, sizeof(dfloat));
+    for(int n=0;n<mesh->Np;++n){
+      for(int m=0;m<mesh->cubNp;++m){
+        dfloat Imn = 0, Pnm = 0;
+        for(int k=0;k<mesh->Np;++k){
+          Imn += mesh->cubInterp[m*mesh->Np+k]*mesh->VB[k*mesh->Np+n];
+          Pnm += mesh->invVB[n*mesh->Np+k]*mesh->cubProject[k*mesh->cubNp+m];
+        }
+        cubInterpT[m+n*mesh->cubNp] = Imn;
+        cubProjectT[n+m*mesh->Np]   = Pnm;
+      }
+    }
+    mesh->o_cubInterpT.copyFrom(cubInterpT);
+    mesh->o_cubProjectT.copyFrom(cubProjectT);
+    free(cubInterpT); free(cubProjectT);
   }
-  else
-    meshOccaSetup2D(mesh, options, kernelInfo);
   
   kernelInfo["parser/" "automate-add-barriers"] =  "disabled";   
 
@@ -636,22 +717,47 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
       mesh->device.malloc(bns->NrkStages*mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->rkrhsq);
     bns->o_rkerr =
       mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*bns->Nfields*sizeof(dfloat), bns->rkerr);
-  
-    // dlong Ntotal    = mesh->Nelements*mesh->Np*bns->Nfields;
-    // printf("blockSize: %d  %d %d \n", Ntotal, blockSize, bns->Nblock);
-    bns->o_errtmp = mesh->device.malloc(bns->Nblock*sizeof(dfloat), bns->errtmp);
 
     bns->o_rkA = mesh->device.malloc(bns->NrkStages*bns->NrkStages*sizeof(dfloat), bns->rkA);
     bns->o_rkE = mesh->device.malloc(bns->NrkStages*sizeof(dfloat), bns->rkE);
 
   }
 
+  if(options.compareArgs("TIME INTEGRATOR","IMEXRK")){
+
+    bns->o_q =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*bns->Nfields*sizeof(dfloat), bns->q);
+    bns->o_rhsq = 
+      mesh->device.malloc(bns->Nrhs*mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->rhsq); 
+  
+    bns->o_rkq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*bns->Nfields*sizeof(dfloat), bns->rkq);
+
+    bns->o_saveq =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*bns->Nfields*sizeof(dfloat), bns->rkq);
+
+    bns->o_rkerr =
+      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*bns->Nfields*sizeof(dfloat), bns->rkerr);
+
+    // relaxation source of the current stage, zeroed again by the implicit solve
+    bns->o_rhsqim =
+      mesh->device.malloc(mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->rhsqim);
+
+    bns->o_rkrhsqex =
+      mesh->device.malloc(bns->NrkStages*mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->rkrhsqex);
+    bns->o_rkrhsqim =
+      mesh->device.malloc(bns->NrkStages*mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->rkrhsqim);
+  }
+
   bns->Vort      = (dfloat*) calloc(bns->Nvort*mesh->Nelements*mesh->Np, sizeof(dfloat));
   bns->VortMag   = (dfloat*) calloc(mesh->Nelements*mesh->Np, sizeof(dfloat));
   
   bns->o_Vort    = mesh->device.malloc(bns->Nvort*mesh->Nelements*mesh->Np*sizeof(dfloat), bns->Vort);
   bns->o_VortMag = mesh->device.malloc(mesh->Nelements*mesh->Np*sizeof(dfloat), bns->VortMag);
 
+  if(bns->bernFlag)
+    bns->o_qN = mesh->device.malloc(mesh->Np*mesh->Nelements*bns->Nfields*sizeof(dfloat), bns->q);
+
   int maxNodes = mymax(mesh->Np, (mesh->Nfp*mesh->Nfaces));
   int maxCubNodes = mymax(maxNodes,mesh->cubNp);
 
@@ -782,13 +888,16 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
   kernelInfo["includes"] += (char*)boundaryHeaderFileName.c_str();
 
   char fileName[BUFSIZ], kernelName[BUFSIZ];
-  for (int r=0;r<mesh->size;r++){
+  for (int r=0;r<mesh->size && !donor;r++){
 
     if (r==mesh->rank) {
 
       // Volume kernels
       sprintf(fileName, DBNS "/okl/bnsVolume%s.okl", suffix);
-      sprintf(kernelName, "bnsVolume%s", suffix);
+      if(bns->bernFlag)
+        sprintf(kernelName, "bnsBBVolume%s", suffix);
+      else
+        sprintf(kernelName, "bnsVolume%s", suffix);
       bns->volumeKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
 
       if(bns->pmlFlag){
@@ -832,7 +941,10 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
           bns->pmlSurfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
         }
         }else{
-          sprintf(kernelName, "bnsSurface%s", suffix);
+          if(bns->bernFlag)
+            sprintf(kernelName, "bnsBBSurface%s", suffix);
+          else
+            sprintf(kernelName, "bnsSurface%s", suffix);
           bns->surfaceKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
 
         if(bns->pmlFlag){
@@ -868,10 +980,15 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
         sprintf(kernelName, "bnsSARKPmlUpdate%s", suffixUpdate);
         bns->pmlUpdateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
       }
-      sprintf(fileName, DBNS "/okl/bnsErrorEstimate.okl");
-      sprintf(kernelName, "bnsErrorEstimate");
-      bns->errorEstimateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      } else if(options.compareArgs("TIME INTEGRATOR","IMEXRK")){
+        sprintf(kernelName, "bnsIMEXUpdateStage%s", suffixUpdate);
+        bns->updateStageKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
 
+        sprintf(kernelName, "bnsIMEXImplicitSolve%s", suffixUpdate);
+        bns->implicitSolveKernel = mesh->device.buildKernel(fileName,kernelName, kernelInfo);
+
+        sprintf(kernelName, "bnsIMEXUpdate%s", suffixUpdate);
+        bns->updateKernel = mesh->device.buildKernel(fileName, kernelName,kernelInfo);
       } else if(options.compareArgs("TIME INTEGRATOR","MRSAAB")){
       
         sprintf(kernelName, "bnsMRSAABTraceUpdate%s", suffixUpdate);
@@ -934,18 +1051,75 @@ bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
     MPI_Barrier(mesh->comm);
   }
 
+  if(donor){
+    // kernels do not depend on the partition, reuse the donor's
+    bns->volumeKernel          = donor->volumeKernel;
+    bns->surfaceKernel         = donor->surfaceKernel;
+    bns->updateKernel          = donor->updateKernel;
+    bns->traceUpdateKernel     = donor->traceUpdateKernel;
+    bns->relaxationKernel      = donor->relaxationKernel;
+    bns->pmlVolumeKernel       = donor->pmlVolumeKernel;
+    bns->pmlSurfaceKernel      = donor->pmlSurfaceKernel;
+    bns->pmlRelaxationKernel   = donor->pmlRelaxationKernel;
+    bns->pmlUpdateKernel       = donor->pmlUpdateKernel;
+    bns->pmlTraceUpdateKernel  = donor->pmlTraceUpdateKernel;
+    bns->updateStageKernel     = donor->updateStageKernel;
+    bns->pmlUpdateStageKernel  = donor->pmlUpdateStageKernel;
+    bns->implicitSolveKernel   = donor->implicitSolveKernel;
+    bns->vorticityKernel       = donor->vorticityKernel;
+    bns->isoSurfaceKernel      = donor->isoSurfaceKernel;
+    bns->constrainKernel       = donor->constrainKernel;
+    bns->dotMultiplyKernel     = donor->dotMultiplyKernel;
+  }
 
+  if(options.compareArgs("TIME INTEGRATOR","SARK") || options.compareArgs("TIME INTEGRATOR","IMEXRK")){
+    // SARK and IMEXRK form their own stages, only the error norm and controller are shared
+    dlong Ntotal = mesh->Nelements*mesh->Np*bns->Nfields;
+    bns->dopri = dopriSetup(mesh, Ntotal, 0, kernelInfo, bns, NULL);
+
+    dopri_t *dopri = bns->dopri;
+    dopri->ATOL  = bns->ATOL;
+    dopri->RTOL  = bns->RTOL;
+    dopri->dtMIN = bns->dtMIN;
+
+    dopri->safe       = 0.95;   //safety factor
+    //error control parameters
+    dopri->beta       = 0.05; 
+    dopri->factor1    = 0.25;
+    dopri->factor2    = 10.0;
+    dopri->exp1       = 1.0/bns->rkp -0.75*dopri->beta; 
+    dopri->invfactor1 = 1.0/dopri->factor1;
+    dopri->invfactor2 = 1.0/dopri->factor2;
+    dopri->facold     = 1E-4;
+  }
 
   // Setup GatherScatter
   if(bns->dim==3){
     int verbose = 1;
     dlong Ntotal = mesh->Np*mesh->Nelements;
+    ogs_t *donorOgs = (donor) ? mesh->ogs : NULL;
     meshParallelGatherScatterSetup(mesh, Ntotal, mesh->globalIds, mesh->comm, verbose);
+
+    // free the old gather scatter once the new one holds the ogs kernels
+    if(donorOgs) ogsFree(donorOgs);
   }
 
   return bns; 
 }
 
+bns_t *bnsSetup(mesh_t *mesh, setupAide &options){
+
+  return bnsSetupSolver(mesh, options, NULL);
+}
+
+/* set up the solver again after its mesh has been repartitioned, keeping
+   the device and the kernels of the old solver. The caller releases the
+   partition dependent data of the old solver first */
+bns_t *bnsRebuild(bns_t *bns, setupAide &options){
+
+  return bnsSetupSolver(bns->mesh, options, bns);
+}
+
 
 
 
@@ -230,4 +230,52 @@ void bnsTimeStepperCoefficients(bns_t *bns, setupAide &options){
   bnsSAADRKCoefficients(bns, options);
   }
 
+  if(options.compareArgs("TIME INTEGRATOR","IMEXRK")){
+    // Kennedy-Carpenter ARK3(2)4L[2]SA: explicit advection, ESDIRK relaxation
+    // with constant diagonal gamma, both halves share the weights b
+    const dfloat g = 1767732205903.0/4055673282236.0;
+
+    const dfloat b1 =  1471266399579.0/7840856788654.0;
+    const dfloat b2 = -4482444167858.0/7529755066697.0;
+    const dfloat b3 = 11266239266428.0/11593286722821.0;
+    const dfloat b4 = g;
+
+    // second order embedded weights
+    const dfloat bh1 =   2756255671327.0/12835298489170.0;
+    const dfloat bh2 = -10771552573575.0/22201958757719.0;
+    const dfloat bh3 =   9247589265047.0/10645013368117.0;
+    const dfloat bh4 =   2193209047091.0/5459859503100.0;
+
+    dfloat rkC[4]   = {0.0, 2.0*g, 3.0/5.0, 1.0};
+    dfloat rkAex[4*4]
+      = {                              0.0,                                0.0,                               0.0, 0.0,
+            1767732205903.0/2027836641118.0,                                0.0,                               0.0, 0.0,
+            5535828885825.0/10492691773637.0,   788022342437.0/10882634858940.0,                               0.0, 0.0,
+            6485989280629.0/16251701735622.0, -4246266847089.0/9704473918619.0, 10755448449292.0/10357097424841.0, 0.0};
+    dfloat rkAim[4*4]
+      = {                              0.0,                                0.0,  0.0, 0.0,
+                                          g,                                  g,  0.0, 0.0,
+            2746238789719.0/10658868560708.0, -640167445237.0/6845629431997.0,   g, 0.0,
+                                         b1,                                 b2,  b3,  g};
+    dfloat rkB[4]   = {b1, b2, b3, b4};
+    dfloat rkE[4]   = {b1-bh1, b2-bh2, b3-bh3, b4-bh4};
+
+    bns->rkCex = (dfloat*) calloc(bns->NrkStages, sizeof(dfloat));
+    bns->rkAex = (dfloat*) calloc(bns->NrkStages*bns->NrkStages, sizeof(dfloat));
+    bns->rkBex = (dfloat*) calloc(bns->NrkStages, sizeof(dfloat));
+    bns->rkEex = (dfloat*) calloc(bns->NrkStages, sizeof(dfloat));
+    bns->rkAim = (dfloat*) calloc(bns->NrkStages*bns->NrkStages, sizeof(dfloat));
+
+    memcpy(bns->rkCex, rkC,   bns->NrkStages*sizeof(dfloat));
+    memcpy(bns->rkAex, rkAex, bns->NrkStages*bns->NrkStages*sizeof(dfloat));
+    memcpy(bns->rkBex, rkB,   bns->NrkStages*sizeof(dfloat));
+    memcpy(bns->rkEex, rkE,   bns->NrkStages*sizeof(dfloat));
+    memcpy(bns->rkAim, rkAim, bns->NrkStages*bns->NrkStages*sizeof(dfloat));
+
+    bns->o_rkAex = mesh->device.malloc(bns->NrkStages*bns->NrkStages*sizeof(dfloat), bns->rkAex);
+    bns->o_rkBex = mesh->device.malloc(bns->NrkStages*sizeof(dfloat), bns->rkBex);
+    bns->o_rkEex = mesh->device.malloc(bns->NrkStages*sizeof(dfloat), bns->rkEex);
+    bns->o_rkAim = mesh->device.malloc(bns->NrkStages*bns->NrkStages*sizeof(dfloat), bns->rkAim);
+  }
+
   }
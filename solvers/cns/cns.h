@@ -33,6 +33,8 @@ SOFTWARE.
 #include "mesh.h"
 #include "mesh2D.h"
 #include "mesh3D.h"
+#include "dopri.h"
+#include "mrab.h"
 
 // block size for reduction (hard coded)
 #define blockSize 256
@@ -46,15 +48,12 @@ typedef struct{
   int Nfields;
 
   hlong totalElements;
-  dlong Nblock;
 
   dfloat *q, *rhsq, *resq;
 
   dfloat *viscousStresses;
   dfloat *Vort;
 
-  dfloat *rkq, *rkrhsq, *rkerr;
-  dfloat *errtmp;
   int frame;
 
   dfloat mu;
@@ -65,6 +64,11 @@ typedef struct{
   dfloat wbar;
 
   int outputForceStep;
+
+  int cubatureFlag; // ADVECTION TYPE is CUBATURE
+  int fusedStage;   // FUSED STAGE is TRUE
+  int haloTrace;    // HALO EXCHANGE is TRACE
+  int haloNodes;    // nodes sent per halo pair, Nfp for traces and Np for volumes
   
   
   mesh_t *mesh;
@@ -74,12 +78,9 @@ typedef struct{
   occa::kernel cubatureVolumeKernel;
   occa::kernel cubatureSurfaceKernel;
   occa::kernel updateKernel;
-  occa::kernel rkStageKernel;
-  occa::kernel rkUpdateKernel;
-  occa::kernel rkOutputKernel;
-  occa::kernel rkErrorEstimateKernel;
 
   occa::kernel stressesVolumeKernel;
+  occa::kernel stageStressesVolumeKernel;
   occa::kernel stressesSurfaceKernel;
   
   occa::kernel vorticityKernel;
@@ -92,9 +93,6 @@ typedef struct{
   occa::memory o_Vort;
   occa::memory o_viscousStresses;
   occa::memory o_saveq;
-  
-  occa::memory o_rkq, o_rkrhsq, o_rkerr;
-  occa::memory o_errtmp;
 
   
   //halo data
@@ -114,13 +112,10 @@ typedef struct{
 
   // DOPRI5 RK data
   int advSwitch;
-  int Nrk;
-  dfloat ATOL, RTOL;
-  dfloat factor1, invfactor1;
-  dfloat factor2, invfactor2;
-  dfloat exp1, facold,  dtMIN, dtMAX, safe, beta;
-  dfloat *rkA, *rkC, *rkE, *rkoutB;
-  occa::memory o_rkA, o_rkC, o_rkE, o_rkoutB;
+  dopri_t *dopri;
+
+  // multirate Adams Bashforth data
+  mrab_t *mrab;
   
 }cns_t;
 
@@ -142,12 +137,15 @@ void cnsReport(cns_t *cns, dfloat time, setupAide &options);
 
 void cnsPlotVTU(cns_t *cns, char *fileName);
 
-void cnsDopriStep(cns_t *cns, setupAide &options, const dfloat time);
-void cnsDopriOutputStep(cns_t *cns, const dfloat time, const dfloat dt, const dfloat outTime, occa::memory o_outq);
+void cnsRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq);
 
-void cnsLserkStep(cns_t *cns, setupAide &newOoptions, const dfloat time);
+void cnsMRABRhs(void *solver, dfloat time, int lev, occa::memory &o_q, occa::memory &o_rhsq);
 
-dfloat cnsDopriEstimate(cns_t *cns);
+void cnsHaloExchangeMode(cns_t *cns, int trace);
+
+void cnsHaloCheck(cns_t *cns);
+
+void cnsLserkStep(cns_t *cns, setupAide &newOoptions, const dfloat time);
 
 void cnsBodyForce(dfloat t, dfloat *fx, dfloat *fy, dfloat *fz,
 		  dfloat *intfx, dfloat *intfy, dfloat *intfz);
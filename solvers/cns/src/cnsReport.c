@@ -37,7 +37,7 @@ void cnsReport(cns_t *cns, dfloat time, setupAide &options){
                        cns->o_Vort);
 
   // copy data back to host
-  cns->o_q.copyTo(cns->q);
+  meshFieldCopyTo(mesh, cns->Nfields, cns->o_q, cns->q);
   cns->o_Vort.copyTo(cns->Vort);
 
   // do error stuff on host
@@ -49,7 +49,7 @@ void cnsReport(cns_t *cns, dfloat time, setupAide &options){
   if(options.compareArgs("OUTPUT FILE FORMAT","PPM")){
 
     // copy data back to host
-    cns->o_q.copyTo(cns->q);
+    meshFieldCopyTo(mesh, cns->Nfields, cns->o_q, cns->q);
     cns->o_Vort.copyTo(cns->Vort);
    
     //
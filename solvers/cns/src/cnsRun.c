@@ -32,6 +32,9 @@ void cnsRun(cns_t *cns, setupAide &options){
 
   cnsReport(cns, 0, options);
 
+  if(options.compareArgs("HALO CHECK","TRUE"))
+    cnsHaloCheck(cns);
+
   occa::timer timer;
   
   timer.initTimer(mesh->device);
@@ -39,6 +42,8 @@ void cnsRun(cns_t *cns, setupAide &options){
   timer.tic("Run");
   
   if (options.compareArgs("TIME INTEGRATOR","DOPRI5")) {
+
+    dopri_t *dopri = cns->dopri;
     int Nregect = 0;
 
     // hard code this for the moment
@@ -61,7 +66,7 @@ void cnsRun(cns_t *cns, setupAide &options){
 
       cns->advSwitch = 1;
       
-      if (mesh->dt<cns->dtMIN){
+      if (mesh->dt<dopri->dtMIN){
         printf("ERROR: Time step became too small at time step=%d\n", tstep);
         exit (-1);
       }
@@ -77,23 +82,19 @@ void cnsRun(cns_t *cns, setupAide &options){
       }
 
       // try a step with the current time step
-      cnsDopriStep(cns, options, time);
+      dopriStep(dopri, time, mesh->dt, cns->o_q);
 
       // compute Dopri estimator
-      dfloat err = cnsDopriEstimate(cns);
+      dfloat err = dopriEstimate(dopri);
                                          
       // build controller
-      dfloat fac1 = pow(err,cns->exp1);
-      dfloat fac = fac1/pow(cns->facold,cns->beta);
-
-      fac = mymax(cns->invfactor2, mymin(cns->invfactor1,fac/cns->safe));
-      dfloat dtnew = mymin(cns->dtMAX, mesh->dt/fac);
+      dfloat dtnew = dopriController(dopri, err, mesh->dt);
 
       if (err<1.0) { //dt is accepted
 
         // check for time interval output during this step
         if(timeIntervalFlag && time<nextOutputTime && time+mesh->dt>=nextOutputTime){
-          cnsDopriOutputStep(cns, time,mesh->dt,nextOutputTime, cns->o_saveq);
+          dopriOutputStep(dopri, time, mesh->dt, nextOutputTime, cns->o_q, cns->o_saveq);
 
           cns->o_saveq.copyTo(cns->o_q);
           
@@ -105,7 +106,7 @@ void cnsRun(cns_t *cns, setupAide &options){
         }
         
         // accept rkq
-        cns->o_q.copyFrom(cns->o_rkq);
+        dopriAccept(dopri, cns->o_q);
 
         time += mesh->dt;
         tstep++;
@@ -126,7 +127,7 @@ void cnsRun(cns_t *cns, setupAide &options){
 	  }
 	  
 	  dfloat *maxQ = (dfloat*) calloc(mesh->Nfields, sizeof(dfloat));
-	  cns->o_q.copyTo(cns->q);
+	  meshFieldCopyTo(mesh, cns->Nfields, cns->o_q, cns->q);
 	  for(int e=0;e<mesh->Nelements;++e){
 	    for(int fld=0;fld<mesh->Nfields;++fld){
 	      for(int n=0;n<mesh->Np;++n){
@@ -143,18 +144,16 @@ void cnsRun(cns_t *cns, setupAide &options){
 	
 	if(cns->outputForceStep){
 	  if(tstep%cns->outputForceStep){
-	    cns->o_q.copyTo(cns->q);
+	    meshFieldCopyTo(mesh, cns->Nfields, cns->o_q, cns->q);
 	    cns->mesh->device.finish();
 	    cnsForces(cns,time);
 	    
 	  }
 	}
 	
-	cns->facold = mymax(err,1E-4); // hard coded factor ?
-	
 	// check for time step interval output during this step
 	if(tstepIntervalFlag && (tstep%outputTstepInterval==0)){
-	  cns->o_q.copyTo(cns->q);//  ?????
+	  meshFieldCopyTo(mesh, cns->Nfields, cns->o_q, cns->q);//  ?????
           
 	// output  (print from rkq)
 	cnsReport(cns, nextOutputTime, options);
@@ -163,7 +162,6 @@ void cnsRun(cns_t *cns, setupAide &options){
 	nextOutputTime += outputInterval;
       }
     } else {
-      dtnew = mesh->dt/(mymax(cns->invfactor1,fac1/cns->safe));
       Nregect++;
 
       done = 0;
@@ -194,6 +192,29 @@ void cnsRun(cns_t *cns, setupAide &options){
       cnsReport(cns, time, options);
     }
   }
+} else if (options.compareArgs("TIME INTEGRATOR","MRAB")) {
+
+  // each MRAB step advances every level to the same time
+  dfloat dtMRAB = mesh->dt*pow(2,mesh->MRABNlevels-1);
+
+  for(int tstep=0;tstep<mesh->NtimeSteps;++tstep){
+
+    dfloat time = tstep*dtMRAB;
+
+    mrabStep(cns->mrab, time, cns->o_q);
+
+    if(((tstep+1)%mesh->errorStep)==0){
+      time += dtMRAB;
+      cnsReport(cns, time, options);
+    }
+  }
+
+  mesh->device.finish();
+
+  double elapsed  = timer.toc("Run");
+
+  if(mesh->rank==0)
+    printf("\nRun took %lg seconds for %d MRAB steps on %d levels\n", elapsed, mesh->NtimeSteps, mesh->MRABNlevels);
  }
   
 }
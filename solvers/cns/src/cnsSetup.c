@@ -39,9 +39,13 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   cns->Nstresses = (cns->dim==3) ? 6:3;
   cns->mesh = mesh;
 
-  dlong Ntotal = mesh->Nelements*mesh->Np*mesh->Nfields;
-  cns->Nblock = (Ntotal+blockSize-1)/blockSize;
-  
+  cns->cubatureFlag = options.compareArgs("ADVECTION TYPE","CUBATURE");
+
+  // form DOPRI5 stages in the stresses volume kernel
+  cns->fusedStage = options.compareArgs("TIME INTEGRATOR","DOPRI5")
+                 && options.compareArgs("FUSED STAGE","TRUE");
+
+
   hlong localElements = (hlong) mesh->Nelements;
   MPI_Allreduce(&localElements, &(cns->totalElements), 1, MPI_HLONG, MPI_SUM, mesh->comm);
 
@@ -83,6 +87,73 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   
   options.getArgs("TSTEPS FOR FORCE OUTPUT",   cns->outputForceStep);
   
+  // set penalty parameter
+  mesh->Lambda2 = 0.5;
+  
+  // set time step
+  dfloat hmin = 1e9;
+  dfloat *EToh = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
+  for(dlong e=0;e<mesh->Nelements;++e){  
+
+    EToh[e] = 1e9;
+    for(int f=0;f<mesh->Nfaces;++f){
+      dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
+      dfloat sJ   = mesh->sgeo[sid + SJID];
+      dfloat invJ = mesh->sgeo[sid + IJID];
+
+      if(invJ<0) printf("invJ = %g\n", invJ);
+      
+      // sJ = L/2, J = A/2,   sJ/J = L/A = L/(0.5*h*L) = 2/h
+      // h = 0.5/(sJ/J)
+      
+      dfloat hest = .5/(sJ*invJ);
+
+      hmin = mymin(hmin, hest);
+      EToh[e] = mymin(EToh[e], hest);
+    }
+  }
+
+  // need to change cfl and defn of dt
+  dfloat cfl = 0.5; // depends on the stability region size
+
+  dfloat dtAdv  = hmin/((mesh->N+1.)*(mesh->N+1.)*sqrt(cns->RT));
+  dfloat dtVisc = pow(hmin, 2)/(pow(mesh->N+1,4)*cns->mu);
+
+  dfloat dt = cfl*mymin(dtAdv, dtVisc);
+  dt = cfl*dtAdv;
+  
+  //
+  options.getArgs("FINAL TIME", mesh->finalTime);
+
+  if (options.compareArgs("TIME INTEGRATOR","MRAB")){
+    // local time step of each element, sorts the elements into MRAB levels
+    // and regroups (or repartitions) the mesh so the levels are contiguous
+    dfloat *EToDT = (dfloat*) calloc(mesh->Nelements, sizeof(dfloat));
+    for(dlong e=0;e<mesh->Nelements;++e)
+      EToDT[e] = cfl*EToh[e]/((mesh->N+1.)*(mesh->N+1.)*sqrt(cns->RT));
+
+    int maxLevels = 1;
+    options.getArgs("MAX MRAB LEVELS", maxLevels);
+
+    if(cns->dim==3)
+      mesh->dt = meshMRABSetup3D(mesh, EToDT, maxLevels, mesh->finalTime);
+    else
+      mesh->dt = meshMRABSetup2D(mesh, EToDT, maxLevels, mesh->finalTime);
+
+    mesh->NtimeSteps = mesh->finalTime/(pow(2,mesh->MRABNlevels-1)*mesh->dt);
+
+    free(EToDT);
+  } else {
+    // MPI_Allreduce to get global minimum dt
+    MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+
+    mesh->NtimeSteps = mesh->finalTime/mesh->dt;
+    if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
+      mesh->dt = mesh->finalTime/mesh->NtimeSteps;
+    }
+  }
+  free(EToh);
+
   // compute samples of q at interpolation nodes
   //  mesh->q    = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
   //                                sizeof(dfloat));
@@ -98,59 +169,6 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
                                 sizeof(dfloat));
   }
 
-  if (options.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    int NrkStages = 7;
-    cns->rkq  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    cns->rkrhsq = (dfloat*) calloc(NrkStages*mesh->Nelements*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-    cns->rkerr  = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*mesh->Nfields,
-          sizeof(dfloat));
-
-    cns->errtmp = (dfloat*) calloc(cns->Nblock, sizeof(dfloat));
-
-    // Dormand Prince -order (4) 5 with PID timestep control
-    int Nrk = 7;
-    dfloat rkC[7] = {0.0, 0.2, 0.3, 0.8, 8.0/9.0, 1.0, 1.0};
-    dfloat rkA[7*7] ={             0.0,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                                   0.2,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                              3.0/40.0,        9.0/40.0,            0.0,          0.0,             0.0,       0.0, 0.0,
-                             44.0/45.0,      -56.0/15.0,       32.0/9.0,          0.0,             0.0,       0.0, 0.0,
-                        19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0,             0.0,       0.0, 0.0,
-                         9017.0/3168.0,     -355.0/33.0, 46732.0/5247.0,   49.0/176.0, -5103.0/18656.0,       0.0, 0.0, 
-                            35.0/384.0,             0.0,   500.0/1113.0,  125.0/192.0,  -2187.0/6784.0, 11.0/84.0, 0.0 };
-    dfloat rkE[7] = {71.0/57600.0,  0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0 }; 
-
-    cns->Nrk = Nrk;
-    cns->rkC = (dfloat*) calloc(cns->Nrk, sizeof(dfloat));
-    cns->rkE = (dfloat*) calloc(cns->Nrk, sizeof(dfloat));
-    cns->rkA = (dfloat*) calloc(cns->Nrk*cns->Nrk, sizeof(dfloat));
-
-    cns->rkoutB = (dfloat*) calloc(cns->Nrk, sizeof(dfloat));
-
-    memcpy(cns->rkC, rkC, cns->Nrk*sizeof(dfloat));
-    memcpy(cns->rkE, rkE, cns->Nrk*sizeof(dfloat));
-    memcpy(cns->rkA, rkA, cns->Nrk*cns->Nrk*sizeof(dfloat));
-
-    cns->ATOL    = 1.0; options.getArgs("ABSOLUTE TOLERANCE",   cns->ATOL); 
-    cns->RTOL    = 1.0; options.getArgs("RELATIVE TOLERANCE",   cns->RTOL);
-    cns->dtMIN   = 1.0; options.getArgs("MINUMUM TIME STEP SIZE",   cns->dtMIN);
-    cns->dtMAX   = 1.0; options.getArgs("MAXIMUM TIME STEP SIZE",   cns->dtMAX); 
-
-    cns->safe = 0.9;   //safety factor
-
-    //error control parameters
-    cns->beta = 0.05;
-    cns->factor1 = 0.2;
-    cns->factor2 = 10.0;
-
-
-    cns->exp1 = 0.2 - 0.75*cns->beta;
-    cns->invfactor1 = 1.0/cns->factor1;
-    cns->invfactor2 = 1.0/cns->factor2;
-    cns->facold = 1E-4;
-    
-  }
 
   cns->viscousStresses = (dfloat*) calloc((mesh->totalHaloPairs+mesh->Nelements)*mesh->Np*cns->Nstresses,
                                            sizeof(dfloat));
@@ -194,49 +212,6 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     }
   }
 
-  // set penalty parameter
-  mesh->Lambda2 = 0.5;
-  
-  // set time step
-  dfloat hmin = 1e9;
-  for(dlong e=0;e<mesh->Nelements;++e){  
-
-    for(int f=0;f<mesh->Nfaces;++f){
-      dlong sid = mesh->Nsgeo*(mesh->Nfaces*e + f);
-      dfloat sJ   = mesh->sgeo[sid + SJID];
-      dfloat invJ = mesh->sgeo[sid + IJID];
-
-      if(invJ<0) printf("invJ = %g\n", invJ);
-      
-      // sJ = L/2, J = A/2,   sJ/J = L/A = L/(0.5*h*L) = 2/h
-      // h = 0.5/(sJ/J)
-      
-      dfloat hest = .5/(sJ*invJ);
-
-      hmin = mymin(hmin, hest);
-    }
-  }
-
-  // need to change cfl and defn of dt
-  dfloat cfl = 0.5; // depends on the stability region size
-
-  dfloat dtAdv  = hmin/((mesh->N+1.)*(mesh->N+1.)*sqrt(cns->RT));
-  dfloat dtVisc = pow(hmin, 2)/(pow(mesh->N+1,4)*cns->mu);
-
-  dfloat dt = cfl*mymin(dtAdv, dtVisc);
-  dt = cfl*dtAdv;
-  
-  // MPI_Allreduce to get global minimum dt
-  MPI_Allreduce(&dt, &(mesh->dt), 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
-  
-  //
-  options.getArgs("FINAL TIME", mesh->finalTime);
-
-  mesh->NtimeSteps = mesh->finalTime/mesh->dt;
-  if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
-    mesh->dt = mesh->finalTime/mesh->NtimeSteps;
-  }
-
   if (mesh->rank ==0) printf("dtAdv = %lg (before cfl), dtVisc = %lg (before cfl), dt = %lg\n",
    dtAdv, dtVisc, dt);
 
@@ -271,45 +246,41 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
   string boundaryHeaderFileName; 
   options.getArgs("DATA FILE", boundaryHeaderFileName);
   kernelInfo["includes"] += (char*)boundaryHeaderFileName.c_str();
- 
-  cns->o_q =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->q);
 
-  cns->o_saveq =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->q);
+  // state vector layout on the device, host arrays stay element-major
+  meshFieldLayoutSetup(mesh, options, kernelInfo);
 
-  
-  cns->o_viscousStresses =
-    mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*cns->Nstresses*sizeof(dfloat),
-                        cns->viscousStresses);
-  
-  cns->o_rhsq =
-    mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->rhsq);
+  if(mesh->fieldLayout!=FIELD_LAYOUT_AOS && options.compareArgs("TIME INTEGRATOR","MRAB")){
+    if(mesh->rank==0) printf("ERROR: MRAB requires FIELD LAYOUT AOS\n");
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  const dlong NfieldEntries = meshFieldNentries(mesh, mesh->Nfields);
+  const dlong NstressEntries = meshFieldNentries(mesh, cns->Nstresses);
+
+  // zero fill, the halo and padding entries are never written by the host
+  dfloat *zeros = (dfloat*) calloc(mymax(NfieldEntries, NstressEntries), sizeof(dfloat));
+
+  cns->o_q = mesh->device.malloc(NfieldEntries*sizeof(dfloat), zeros);
+  meshFieldCopyFrom(mesh, mesh->Nfields, cns->q, cns->o_q);
+
+  cns->o_saveq = mesh->device.malloc(NfieldEntries*sizeof(dfloat), zeros);
+  cns->o_saveq.copyFrom(cns->o_q);
+
+  cns->o_viscousStresses = mesh->device.malloc(NstressEntries*sizeof(dfloat), zeros);
+
+  cns->o_rhsq = mesh->device.malloc(NfieldEntries*sizeof(dfloat), zeros);
 
   if (mesh->rank==0)
     cout << "TIME INTEGRATOR (" << options.getArgs("TIME INTEGRATOR") << ")" << endl;
   
   if (options.compareArgs("TIME INTEGRATOR","LSERK4")){
-    cns->o_resq =
-      mesh->device.malloc(mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->resq);
+    cns->o_resq = mesh->device.malloc(NfieldEntries*sizeof(dfloat), zeros);
   }
 
-  if (options.compareArgs("TIME INTEGRATOR","DOPRI5")){
-    int NrkStages = 7;
-    cns->o_rkq =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->rkq);
-    cns->o_rkrhsq =
-      mesh->device.malloc(NrkStages*mesh->Np*mesh->Nelements*mesh->Nfields*sizeof(dfloat), cns->rkrhsq);
-    cns->o_rkerr =
-      mesh->device.malloc(mesh->Np*(mesh->totalHaloPairs+mesh->Nelements)*mesh->Nfields*sizeof(dfloat), cns->rkerr);
-  
-    cns->o_errtmp = mesh->device.malloc(cns->Nblock*sizeof(dfloat), cns->errtmp);
+  free(zeros);
 
-    cns->o_rkA = mesh->device.malloc(cns->Nrk*cns->Nrk*sizeof(dfloat), cns->rkA);
-    cns->o_rkE = mesh->device.malloc(  cns->Nrk*sizeof(dfloat), cns->rkE);
-
-    cns->o_rkoutB = mesh->device.malloc(cns->Nrk*sizeof(dfloat), cns->rkoutB);
-  }
 
   
   cns->o_Vort = mesh->device.malloc(3*mesh->Np*mesh->Nelements*sizeof(dfloat), cns->Vort); // 3 components
@@ -323,22 +294,31 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     cns->o_haloStressesBuffer =
       mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*cns->Nstresses*sizeof(dfloat));
   
-    // MPI send buffer
-    cns->haloBytes = mesh->totalHaloPairs*mesh->Np*cns->Nfields*sizeof(dfloat);
-    cns->haloStressesBytes = mesh->totalHaloPairs*mesh->Np*cns->Nstresses*sizeof(dfloat);
+    // MPI send buffer, sized for whole halo elements so either exchange fits
+    size_t haloBytes = mesh->totalHaloPairs*mesh->Np*cns->Nfields*sizeof(dfloat);
+    size_t haloStressesBytes = mesh->totalHaloPairs*mesh->Np*cns->Nstresses*sizeof(dfloat);
     
-    cns->o_haloBuffer = mesh->device.malloc(cns->haloBytes);
-    cns->o_haloStressesBuffer = mesh->device.malloc(cns->haloStressesBytes);
+    cns->o_haloBuffer = mesh->device.malloc(haloBytes);
+    cns->o_haloStressesBuffer = mesh->device.malloc(haloStressesBytes);
     
-    cns->sendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, cns->haloBytes, NULL, cns->o_sendBuffer);
-    cns->recvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, cns->haloBytes, NULL, cns->o_recvBuffer);
-    cns->sendStressesBuffer = (dfloat*) occaHostMallocPinned(mesh->device, cns->haloStressesBytes, NULL, cns->o_sendStressesBuffer);
-    cns->recvStressesBuffer = (dfloat*) occaHostMallocPinned(mesh->device, cns->haloStressesBytes, NULL, cns->o_recvStressesBuffer);
+    cns->sendBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, cns->o_sendBuffer);
+    cns->recvBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloBytes, NULL, cns->o_recvBuffer);
+    cns->sendStressesBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloStressesBytes, NULL, cns->o_sendStressesBuffer);
+    cns->recvStressesBuffer = (dfloat*) occaHostMallocPinned(mesh->device, haloStressesBytes, NULL, cns->o_recvStressesBuffer);
   }
+
+  // the surface kernels only read halo elements at their face nodes through
+  // vmapP, so by default only those traces are exchanged
+  cnsHaloExchangeMode(cns, !options.compareArgs("HALO EXCHANGE","VOLUME"));
   
   kernelInfo["defines/" "p_Nfields"]= mesh->Nfields;
   kernelInfo["defines/" "p_Nstresses"]= cns->Nstresses;
 
+  // DOPRI stage derivatives are stored back to back, one state vector apart
+  const dlong NrkEntries = (mesh->fieldLayout==FIELD_LAYOUT_AOS) ?
+    mesh->Nelements*mesh->Np*mesh->Nfields : NfieldEntries;
+  kernelInfo["defines/" "p_rkOffset"]= NrkEntries;
+
   kernelInfo["defines/" "p_RT"]= cns->RT;
 
   dfloat sqrtRT = sqrt(cns->RT);
@@ -415,6 +395,11 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
       sprintf(kernelName, "cnsStressesVolume%s", suffix);
       cns->stressesVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
 
+      if (cns->fusedStage) {
+        sprintf(kernelName, "cnsStageStressesVolume%s", suffix);
+        cns->stageStressesVolumeKernel = mesh->device.buildKernel(fileName, kernelName, kernelInfo);
+      }
+
       // kernels from surface file
       sprintf(fileName, DCNS "/okl/cnsSurface%s.okl", suffix);
       sprintf(kernelName, "cnsSurface%s", suffix);
@@ -451,25 +436,6 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
                                            "cnsUpdate",
                                            kernelInfo);
 
-      cns->rkUpdateKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
-                                           "cnsRkUpdate",
-                                           kernelInfo);
-      cns->rkStageKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
-                                           "cnsRkStage",
-                                           kernelInfo);
-
-      cns->rkOutputKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
-                                           "cnsRkOutput",
-                                           kernelInfo);
-
-      cns->rkErrorEstimateKernel =
-        mesh->device.buildKernel(DCNS "/okl/cnsUpdate.okl",
-                                           "cnsErrorEstimate",
-                                           kernelInfo);
-
       // fix this later
       mesh->haloExtractKernel =
         mesh->device.buildKernel(DHOLMES "/okl/meshHaloExtract3D.okl",
@@ -485,6 +451,34 @@ cns_t *cnsSetup(mesh_t *mesh, setupAide &options){
     MPI_Barrier(mesh->comm);
   }
 
+  if (options.compareArgs("TIME INTEGRATOR","DOPRI5")){
+    // the SOA and AOSOA layouts interleave halo and padding with the local
+    // elements, so the whole state vector is integrated and the padding
+    // (which has zero derivative) is left out of the error norm
+    dlong N = NrkEntries;
+    dlong Nhalo = (mesh->fieldLayout==FIELD_LAYOUT_AOS) ?
+      mesh->totalHaloPairs*mesh->Np*mesh->Nfields : 0;
+    cns->dopri = dopriSetup(mesh, N, Nhalo, kernelInfo, cns, cnsRhs);
+
+    dopri_t *dopri = cns->dopri;
+
+    hlong localN = mesh->Nelements*mesh->Np*mesh->Nfields;
+    MPI_Allreduce(&localN, &(dopri->Nglobal), 1, MPI_HLONG, MPI_SUM, mesh->comm);
+    dopri->ATOL    = 1.0; options.getArgs("ABSOLUTE TOLERANCE",   dopri->ATOL); 
+    dopri->RTOL    = 1.0; options.getArgs("RELATIVE TOLERANCE",   dopri->RTOL);
+    dopri->dtMIN   = 1.0; options.getArgs("MINUMUM TIME STEP SIZE",   dopri->dtMIN);
+    dopri->dtMAX   = 1.0; options.getArgs("MAXIMUM TIME STEP SIZE",   dopri->dtMAX); 
+
+    dopri->safe = 0.9;   //safety factor
+
+    dopri->fusedStage = cns->fusedStage;
+  }
+
+  if (options.compareArgs("TIME INTEGRATOR","MRAB")){
+    cns->mrab = mrabSetup(mesh, cns->Nfields, mesh->dt, kernelInfo, cns, cnsMRABRhs);
+    mrabReset(cns->mrab, cns->o_q);
+  }
+
   printf("done building kernels\n");
   
   return cns;
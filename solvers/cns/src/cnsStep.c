@@ -28,293 +28,307 @@ SOFTWARE.
 
 #define USE_OLD_HALO 1
 
-void cnsDopriStep(cns_t *cns, setupAide &newOptions, const dfloat time){
+// pack the halo of an Nfields state vector, just the face traces when
+// HALO EXCHANGE is TRACE
+static void cnsHaloExtract(cns_t *cns, int Nfields, occa::memory &o_q, occa::memory &o_haloBuffer){
 
   mesh_t *mesh = cns->mesh;
-  
-  //RK step
-  for(int rk=0;rk<cns->Nrk;++rk){
 
+  if(cns->haloTrace)
+    meshFieldHaloTraceExtract(mesh, 1, &Nfields, &o_q, o_haloBuffer);
+  else
+    meshFieldHaloExtract(mesh, Nfields, o_q, o_haloBuffer);
+}
 
-    mesh->device.setStream(mesh->defaultStream);
-    
-    // t_rk = t + C_rk*dt
-    dfloat currentTime = time + cns->rkC[rk]*mesh->dt;
+// place a received halo in an Nfields state vector
+static void cnsHaloPut(cns_t *cns, int Nfields, dfloat *recvBuffer,
+                       occa::memory &o_haloBuffer, occa::memory &o_q){
 
-    dfloat fx, fy, fz, intfx, intfy, intfz;
-    cnsBodyForce(currentTime , &fx, &fy, &fz, &intfx, &intfy, &intfz);
+  mesh_t *mesh = cns->mesh;
 
-    //compute RK stage 
-    // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
-    cns->rkStageKernel(mesh->Nelements,
-                       rk,
-                       mesh->dt,
-                       cns->o_rkA,
-                       cns->o_q,
-                       cns->o_rkrhsq,
-                       cns->o_rkq);
-    
-    //compute RHS
-    // rhsq = F(currentTIme, rkq)
+  if(cns->haloTrace)
+    meshFieldHaloTracePut(mesh, 1, &Nfields, recvBuffer, o_haloBuffer, &o_q);
+  else
+    meshFieldHaloScatter(mesh, Nfields, recvBuffer, o_haloBuffer, o_q);
+}
 
-    // extract q halo on DEVICE
-    if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*cns->Nfields;
+// exchange face traces (trace=1) or whole halo elements (trace=0)
+void cnsHaloExchangeMode(cns_t *cns, int trace){
+
+  mesh_t *mesh = cns->mesh;
+
+  cns->haloTrace = trace;
+  cns->haloNodes = (trace) ? mesh->Nfp : mesh->Np;
+  cns->haloBytes = mesh->totalHaloPairs*cns->haloNodes*cns->Nfields*sizeof(dfloat);
+  cns->haloStressesBytes = mesh->totalHaloPairs*cns->haloNodes*cns->Nstresses*sizeof(dfloat);
+}
+
+// rhsq = F(time, q) on the first Nelements elements, q needs room for the halo.
+// The viscous stresses are formed on the first NstressesElements elements,
+// which must include the neighbours of the first Nelements elements
+static void cnsRhsElements(cns_t *cns, dfloat time, dlong NstressesElements, dlong Nelements,
+                           occa::memory &o_q, occa::memory &o_rhsq){
+
+  mesh_t *mesh = cns->mesh;
+
+  mesh->device.setStream(mesh->defaultStream);
+
+  dfloat fx, fy, fz, intfx, intfy, intfz;
+  cnsBodyForce(time , &fx, &fy, &fz, &intfx, &intfy, &intfz);
+
+  // form the DOPRI5 stage state while computing the viscous stresses, the
+  // halo can only be extracted once the stage state is in o_q
+  dopri_t *dopri = cns->dopri;
+  const int fusedStage = cns->fusedStage && dopri->rk>0;
+
+  if(fusedStage){
+    occa::memory o_rkA = dopri->o_rkA + dopri->rk*dopri->Nrk*sizeof(dfloat);
+
+    cns->stageStressesVolumeKernel(NstressesElements, 
+                                   mesh->o_vgeo, 
+                                   mesh->o_Dmatrices,
+                                   cns->mu,
+                                   dopri->rk,
+                                   dopri->stageDt,
+                                   o_rkA,
+                                   dopri->o_q,
+                                   dopri->o_rkrhsq,
+                                   o_q, 
+                                   cns->o_viscousStresses);
+  }
+
+  // extract q halo on DEVICE
+  if(mesh->totalHaloPairs>0){
 
 #if (USE_OLD_HALO)
 
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_rkq, cns->o_haloBuffer);
-      
-      // copy extracted halo to HOST 
-      cns->o_haloBuffer.copyTo(cns->sendBuffer);      
-      
-      // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
+    cnsHaloExtract(cns, cns->Nfields, o_q, cns->o_haloBuffer);
+    
+    // copy extracted halo to HOST 
+    cns->o_haloBuffer.copyTo(cns->sendBuffer, cns->haloBytes);      
+    
+    // start halo exchange
+    meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
 #else
 
-      // make sure rkq is updated
-      mesh->device.finish();  
-      
-      // launch haloExtractKernel on 2nd stream
-      mesh->device.setStream(mesh->dataStream);         
+    // make sure rkq is updated
+    mesh->device.finish();  
+    
+    // launch haloExtractKernel on 2nd stream
+    mesh->device.setStream(mesh->dataStream);         
 
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_rkq, cns->o_haloBuffer);
+    cnsHaloExtract(cns, cns->Nfields, o_q, cns->o_haloBuffer);
 
-      // launch async copy on 2nd stream
-      cns->o_haloBuffer.copyTo(cns->sendBuffer,"async: true");
+    // launch async copy on 2nd stream
+    cns->o_haloBuffer.copyTo(cns->sendBuffer, cns->haloBytes, 0, "async: true");
 
-      // switch to stream0 for Volume kernel
-      mesh->device.setStream(mesh->defaultStream);      
+    // switch to stream0 for Volume kernel
+    mesh->device.setStream(mesh->defaultStream);      
 #endif
-    }
+  }
 
-    //    printf("calling stress vol kernel with viscosity %g\n", cns->mu);
-    
-    // now compute viscous stresses
-    cns->stressesVolumeKernel(mesh->Nelements, 
+  //    printf("calling stress vol kernel with viscosity %g\n", cns->mu);
+  
+  // now compute viscous stresses
+  if(!fusedStage)
+    cns->stressesVolumeKernel(NstressesElements, 
                               mesh->o_vgeo, 
                               mesh->o_Dmatrices,
                               cns->mu,
-                              cns->o_rkq, 
+                              o_q, 
                               cns->o_viscousStresses);
 
-    // wait for q halo data to arrive
-    if(mesh->totalHaloPairs>0){
+  // wait for q halo data to arrive
+  if(mesh->totalHaloPairs>0){
 
 #if (!USE_OLD_HALO)
-      // switch dev->currentStream
-      mesh->device.setStream(mesh->dataStream);
+    // switch dev->currentStream
+    mesh->device.setStream(mesh->dataStream);
 
-      // flush 2nd stream, ensure send buffer is loaded
-      mesh->device.finish();
+    // flush 2nd stream, ensure send buffer is loaded
+    mesh->device.finish();
 
-      // run remaining work on stream0
-      mesh->device.setStream(mesh->defaultStream);  
+    // run remaining work on stream0
+    mesh->device.setStream(mesh->defaultStream);  
 
-      // start halo exchange on default stream
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
+    // start halo exchange on default stream
+    meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
 #endif
-      
-      meshHaloExchangeFinish(mesh);
-      
-      // offset for halo daat
-      size_t offset = mesh->Np*cns->Nfields*mesh->Nelements*sizeof(dfloat); 
-      cns->o_rkq.copyFrom(cns->recvBuffer, cns->haloBytes, offset);
+    
+    meshHaloExchangeFinish(mesh);
+    
+    // place halo data in o_q
+    cnsHaloPut(cns, cns->Nfields, cns->recvBuffer, cns->o_haloBuffer, o_q);
 
-    }
+  }
 
-    cns->stressesSurfaceKernel(mesh->Nelements, 
-                               mesh->o_sgeo, 
-                               mesh->o_LIFTT,
-                               mesh->o_vmapM, 
-                               mesh->o_vmapP, 
-                               mesh->o_EToB, 
-                               currentTime,
-                               mesh->o_x, 
-                               mesh->o_y,
-                               mesh->o_z, 
-                               cns->mu,
+  cns->stressesSurfaceKernel(NstressesElements, 
+                             mesh->o_sgeo, 
+                             mesh->o_LIFTT,
+                             mesh->o_vmapM, 
+                             mesh->o_vmapP, 
+                             mesh->o_EToB, 
+                             time,
+                             mesh->o_x, 
+                             mesh->o_y,
+                             mesh->o_z, 
+                             cns->mu,
 			       intfx, intfy, intfz,
-                               cns->o_rkq, 
-                               cns->o_viscousStresses);
+                             o_q, 
+                             cns->o_viscousStresses);
 
-    // extract stresses halo on DEVICE
-    if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*cns->Nstresses;
+  // extract stresses halo on DEVICE
+  if(mesh->totalHaloPairs>0){
 
 #if (USE_OLD_HALO)
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_viscousStresses, cns->o_haloStressesBuffer);
-      
-      // copy extracted halo to HOST 
-      cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer);      
-      
-      // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
+    cnsHaloExtract(cns, cns->Nstresses, cns->o_viscousStresses, cns->o_haloStressesBuffer);
+    
+    // copy extracted halo to HOST 
+    cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer, cns->haloStressesBytes);      
+    
+    // start halo exchange
+    meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
 #else
-      // launch haloExtractKernel on 2nd stream
-      mesh->device.setStream(mesh->dataStream);                       
+    // launch haloExtractKernel on 2nd stream
+    mesh->device.setStream(mesh->dataStream);                       
 
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_viscousStresses, cns->o_haloStressesBuffer);
+    cnsHaloExtract(cns, cns->Nstresses, cns->o_viscousStresses, cns->o_haloStressesBuffer);
 
-      // launch async copy on 2nd stream
-      cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer,"async: true");
-      
-      // switch to stream0 for Volume kernel
-      mesh->device.setStream(mesh->defaultStream);                   
+    // launch async copy on 2nd stream
+    cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer, cns->haloStressesBytes, 0, "async: true");
+    
+    // switch to stream0 for Volume kernel
+    mesh->device.setStream(mesh->defaultStream);                   
 #endif
 				 
 
-      
-    }
+    
+  }
 
-    // compute volume contribution to DG cns RHS
-    if (newOptions.compareArgs("ADVECTION TYPE","CUBATURE")) {
-      cns->cubatureVolumeKernel(mesh->Nelements, 
-                                cns->advSwitch,
+  // compute volume contribution to DG cns RHS
+  if (cns->cubatureFlag) {
+    cns->cubatureVolumeKernel(Nelements, 
+                              cns->advSwitch,
 				fx, fy, fz,
-                                mesh->o_vgeo,
+                              mesh->o_vgeo,
 				mesh->o_x, 
 				mesh->o_y,
 				mesh->o_z, 
-                                mesh->o_cubvgeo, 
-                                mesh->o_cubDWmatrices,
-                                mesh->o_cubInterpT,
-                                mesh->o_cubProjectT,
-                                cns->o_viscousStresses, 
-                                cns->o_rkq, 
-                                cns->o_rhsq);
-    } else
-      {
-      cns->volumeKernel(mesh->Nelements, 
-                        cns->advSwitch,
+                              mesh->o_cubvgeo, 
+                              mesh->o_cubDWmatrices,
+                              mesh->o_cubInterpT,
+                              mesh->o_cubProjectT,
+                              cns->o_viscousStresses, 
+                              o_q, 
+                              o_rhsq);
+  } else
+    {
+    cns->volumeKernel(Nelements, 
+                      cns->advSwitch,
 			fx, fy, fz,
-                        mesh->o_vgeo,
+                      mesh->o_vgeo,
 			mesh->o_x, 
 			mesh->o_y,
 			mesh->o_z, 
-                        mesh->o_Dmatrices,
-                        cns->o_viscousStresses, 
-                        cns->o_rkq, 
-                        cns->o_rhsq);
-    }
+                      mesh->o_Dmatrices,
+                      cns->o_viscousStresses, 
+                      o_q, 
+                      o_rhsq);
+  }
 
-    // wait for halo stresses data to arrive
-    if(mesh->totalHaloPairs>0){
+  // wait for halo stresses data to arrive
+  if(mesh->totalHaloPairs>0){
 #if (!USE_OLD_HALO)
-      // switch dev->currentStream
-      mesh->device.setStream(mesh->dataStream);
+    // switch dev->currentStream
+    mesh->device.setStream(mesh->dataStream);
 
-      // flush 2nd stream, ensure send buffer is loaded
-      mesh->device.finish();
+    // flush 2nd stream, ensure send buffer is loaded
+    mesh->device.finish();
 
-      // run remaining work on stream0
-      mesh->device.setStream(mesh->defaultStream);  
-      
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
+    // run remaining work on stream0
+    mesh->device.setStream(mesh->defaultStream);  
+    
+    meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
 #endif
 
-      meshHaloExchangeFinish(mesh);
+    meshHaloExchangeFinish(mesh);
 	    
-      // copy halo data to DEVICE
-      size_t offset = mesh->Np*cns->Nstresses*mesh->Nelements*sizeof(dfloat); // offset for halo data
-      cns->o_viscousStresses.copyFrom(cns->recvStressesBuffer, cns->haloStressesBytes, offset);
-      
-    }
+    // copy halo data to DEVICE
+    cnsHaloPut(cns, cns->Nstresses, cns->recvStressesBuffer, cns->o_haloStressesBuffer, cns->o_viscousStresses);
+    
+  }
 
-    // compute surface contribution to DG cns RHS (LIFTT ?)
-    // THIS ?
+  // compute surface contribution to DG cns RHS (LIFTT ?)
+  // THIS ?
 #if 1
-    if (newOptions.compareArgs("ADVECTION TYPE","CUBATURE")) {
-      cns->cubatureSurfaceKernel(mesh->Nelements, 
-                                 cns->advSwitch,
-                                 mesh->o_vgeo, 
-                                 mesh->o_cubsgeo, 
-                                 mesh->o_vmapM, 
-                                 mesh->o_vmapP, 
-                                 mesh->o_EToB,
+  if (cns->cubatureFlag) {
+    cns->cubatureSurfaceKernel(Nelements, 
+                               cns->advSwitch,
+                               mesh->o_vgeo, 
+                               mesh->o_cubsgeo, 
+                               mesh->o_vmapM, 
+                               mesh->o_vmapP, 
+                               mesh->o_EToB,
 				 mesh->o_cubInterpT,
 				 mesh->o_cubProjectT,
 				 //                                 mesh->o_intInterpT,
 				 //                                 mesh->o_intLIFTT, 
-                                 currentTime, 
-                                 mesh->o_intx, 
-                                 mesh->o_inty,
-                                 mesh->o_intz, 
-                                 cns->mu,
+                               time, 
+                               mesh->o_intx, 
+                               mesh->o_inty,
+                               mesh->o_intz, 
+                               cns->mu,
 				 intfx, intfy, intfz,
-                                 cns->o_rkq, 
-                                 cns->o_viscousStresses, 
-                                 cns->o_rhsq);
-    } else
+                               o_q, 
+                               cns->o_viscousStresses, 
+                               o_rhsq);
+  } else
 #endif
-      {
-      cns->surfaceKernel(mesh->Nelements, 
-                         cns->advSwitch, 
-                         mesh->o_sgeo, 
-                         mesh->o_LIFTT, 
-                         mesh->o_vmapM, 
-                         mesh->o_vmapP, 
-                         mesh->o_EToB,
-                         currentTime, 
-                         mesh->o_x, 
-                         mesh->o_y,
-                         mesh->o_z, 
-                         cns->mu,
+    {
+    cns->surfaceKernel(Nelements, 
+                       cns->advSwitch, 
+                       mesh->o_sgeo, 
+                       mesh->o_LIFTT, 
+                       mesh->o_vmapM, 
+                       mesh->o_vmapP, 
+                       mesh->o_EToB,
+                       time, 
+                       mesh->o_x, 
+                       mesh->o_y,
+                       mesh->o_z, 
+                       cns->mu,
 			 intfx, intfy, intfz,
-                         cns->o_rkq, 
-                         cns->o_viscousStresses, 
-                         cns->o_rhsq);
-    }
+                       o_q, 
+                       cns->o_viscousStresses, 
+                       o_rhsq);
+  }
 
-    if(cns->elementType==QUADRILATERALS && mesh->dim==3){
-      cns->constrainKernel(mesh->Nelements, mesh->o_x, mesh->o_y, mesh->o_z, cns->o_rhsq);
-    }
-    // update solution using Runge-Kutta
-    // rkrhsq_rk = rhsq
-    // if rk==6 
-    //   q = q + dt*sum_{i=0}^{rk} rkA_{rk,i}*rkrhs_i
-    //   rkerr = dt*sum_{i=0}^{rk} rkE_{rk,i}*rkrhs_i
-    cns->rkUpdateKernel(mesh->Nelements, 
-                        rk,
-                        mesh->dt, 
-                        cns->o_rkA, 
-                        cns->o_rkE, 
-                        cns->o_q,
-                        cns->o_rhsq, 
-                        cns->o_rkrhsq, 
-                        cns->o_rkq,
-                        cns->o_rkerr);
+  if(cns->elementType==QUADRILATERALS && mesh->dim==3){
+    cns->constrainKernel(Nelements, mesh->o_x, mesh->o_y, mesh->o_z, o_rhsq);
   }
-  
 }
 
-void cnsDopriOutputStep(cns_t *cns, const dfloat time, const dfloat dt, const dfloat outTime, occa::memory o_outq){
+// rhsq = F(time, q), q needs room for the halo
+void cnsRhs(void *solver, dfloat time, occa::memory &o_q, occa::memory &o_rhsq){
 
+  cns_t *cns = (cns_t*) solver;
   mesh_t *mesh = cns->mesh;
 
-  dfloat theta = (outTime-time)/dt; //should have 0<theta<=1
+  cnsRhsElements(cns, time, mesh->Nelements, mesh->Nelements, o_q, o_rhsq);
+}
 
-  dfloat *rkB = cns->rkA + 6*cns->Nrk; //the b array is just the last row of A for DOPRI5
+// rhsq = F(time, q) on the elements of MRAB levels 0,..,lev-1. Their level
+// lev neighbours need viscous stresses too, so the stresses are formed on all
+// of level lev. Level lev elements away from level lev-1 still hold q from the
+// start of their step, which lags the stress lifting on their faces
+void cnsMRABRhs(void *solver, dfloat time, int lev, occa::memory &o_q, occa::memory &o_rhsq){
 
-  cns->rkoutB[0] = theta*theta*theta*(3-2*theta)*rkB[0] - theta*theta*(theta-1)*(theta-1)*5*((2558722523-31403016*theta)/11282082432) + theta*(theta-1)*(theta-1);
-  cns->rkoutB[1] = 0.;
-  cns->rkoutB[2] = theta*theta*theta*(3-2*theta)*rkB[2] + theta*theta*(theta-1)*(theta-1)*100*((882725551-15701508*theta)/32700410799);
-  cns->rkoutB[3] = theta*theta*theta*(3-2*theta)*rkB[3] - theta*theta*(theta-1)*(theta-1)*25*((2558722523-31403016*theta)/11282082432);
-  cns->rkoutB[4] = theta*theta*theta*(3-2*theta)*rkB[4] + theta*theta*(theta-1)*(theta-1)*32805*((23143187-3489224*theta)/199316789632);
-  cns->rkoutB[5] = theta*theta*theta*(3-2*theta)*rkB[5] - theta*theta*(theta-1)*(theta-1)*55*((29972135-7076736*theta)/822651844);
-  
-  cns->rkoutB[6] = theta*theta*(theta-1) + theta*theta*(theta-1)*(theta-1)*10*((7414447-829305*theta)/29380423);
+  cns_t *cns = (cns_t*) solver;
+  mrab_t *mrab = cns->mrab;
 
+  dlong NstressesElements = mrab->NlevelElements[mymin(lev+1, mrab->Nlevels)];
 
-  cns->o_rkoutB.copyFrom(cns->rkoutB);
-
-  cns->rkOutputKernel(mesh->Nelements, 
-                      cns->Nrk,
-                      mesh->dt, 
-                      cns->o_rkoutB, 
-                      cns->o_q,
-                      cns->o_rkrhsq, 
-                      o_outq);
+  cnsRhsElements(cns, time, NstressesElements, mrab->NlevelElements[lev], o_q, o_rhsq);
 }
 
 
@@ -334,15 +348,14 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
     
     // extract q halo on DEVICE
     if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*cns->Nfields;
         
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_q, cns->o_haloBuffer);
+      cnsHaloExtract(cns, cns->Nfields, cns->o_q, cns->o_haloBuffer);
         
       // copy extracted halo to HOST 
-      cns->o_haloBuffer.copyTo(cns->sendBuffer);      
+      cns->o_haloBuffer.copyTo(cns->sendBuffer, cns->haloBytes);      
         
       // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
+      meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nfields*sizeof(dfloat), cns->sendBuffer, cns->recvBuffer);
     }
       
     // now compute viscous stresses
@@ -358,8 +371,7 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
       meshHaloExchangeFinish(mesh);
         
       // copy halo data to DEVICE
-      size_t offset = mesh->Np*cns->Nfields*mesh->Nelements*sizeof(dfloat); // offset for halo data
-      cns->o_q.copyFrom(cns->recvBuffer, cns->haloBytes, offset);
+      cnsHaloPut(cns, cns->Nfields, cns->recvBuffer, cns->o_haloBuffer, cns->o_q);
     }
       
     cns->stressesSurfaceKernel(mesh->Nelements, 
@@ -379,15 +391,14 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
       
     // extract stresses halo on DEVICE
     if(mesh->totalHaloPairs>0){
-      int Nentries = mesh->Np*cns->Nstresses;
           
-      mesh->haloExtractKernel(mesh->totalHaloPairs, Nentries, mesh->o_haloElementList, cns->o_viscousStresses, cns->o_haloStressesBuffer);
+      cnsHaloExtract(cns, cns->Nstresses, cns->o_viscousStresses, cns->o_haloStressesBuffer);
         
       // copy extracted halo to HOST 
-      cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer);      
+      cns->o_haloStressesBuffer.copyTo(cns->sendStressesBuffer, cns->haloStressesBytes);      
           
       // start halo exchange
-      meshHaloExchangeStart(mesh, mesh->Np*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
+      meshHaloExchangeStart(mesh, cns->haloNodes*cns->Nstresses*sizeof(dfloat), cns->sendStressesBuffer, cns->recvStressesBuffer);
     }
       
     // compute volume contribution to DG cns RHS
@@ -427,8 +438,7 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
       meshHaloExchangeFinish(mesh);
         
       // copy halo data to DEVICE
-      size_t offset = mesh->Np*cns->Nstresses*mesh->Nelements*sizeof(dfloat); // offset for halo data
-      cns->o_viscousStresses.copyFrom(cns->recvStressesBuffer, cns->haloStressesBytes, offset);
+      cnsHaloPut(cns, cns->Nstresses, cns->recvStressesBuffer, cns->o_haloStressesBuffer, cns->o_viscousStresses);
     }
       
     // compute surface contribution to DG cns RHS (LIFTT ?)
@@ -481,3 +491,44 @@ void cnsLserkStep(cns_t *cns, setupAide &newOptions, const dfloat time){
                       cns->o_q);
   }
 }
+
+// evaluate the RHS at o_q with trace and with volume halo exchanges and
+// count the entries that differ, the two must agree bitwise
+void cnsHaloCheck(cns_t *cns){
+
+  mesh_t *mesh = cns->mesh;
+
+  const int trace = cns->haloTrace;
+  const dlong Nentries = meshFieldNentries(mesh, cns->Nfields);
+  const dlong Nlocal = mesh->Nelements*mesh->Np*cns->Nfields;
+
+  dfloat *rhsTrace  = (dfloat*) calloc(Nlocal, sizeof(dfloat));
+  dfloat *rhsVolume = (dfloat*) calloc(Nlocal, sizeof(dfloat));
+
+  occa::memory o_rhsCheck = mesh->device.malloc(Nentries*sizeof(dfloat));
+  o_rhsCheck.copyFrom(cns->o_rhsq);
+
+  cnsHaloExchangeMode(cns, 1);
+  cnsRhs(cns, 0, cns->o_q, o_rhsCheck);
+  meshFieldCopyTo(mesh, cns->Nfields, o_rhsCheck, rhsTrace);
+
+  cnsHaloExchangeMode(cns, 0);
+  cnsRhs(cns, 0, cns->o_q, o_rhsCheck);
+  meshFieldCopyTo(mesh, cns->Nfields, o_rhsCheck, rhsVolume);
+
+  cnsHaloExchangeMode(cns, trace);
+
+  hlong localDiff = 0, globalDiff = 0;
+  for(dlong n=0;n<Nlocal;++n)
+    if(memcmp(rhsTrace+n, rhsVolume+n, sizeof(dfloat))) ++localDiff;
+
+  MPI_Allreduce(&localDiff, &globalDiff, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  if(mesh->rank==0)
+    printf("HALO CHECK: %lld RHS entries differ between trace and volume halo exchange\n",
+           (long long) globalDiff);
+
+  o_rhsCheck.free();
+  free(rhsTrace);
+  free(rhsVolume);
+}
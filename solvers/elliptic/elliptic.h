@@ -109,12 +109,14 @@ typedef struct {
   occa::memory o_Ry;
 
   occa::memory o_EXYZ; // element vertices for reconstructing geofacs (trilinear hexes only)
+  occa::memory o_XYZ; // element node coordinates for recomputing geofacs (isoparametric hexes only)
   occa::memory o_gllzw; // GLL nodes and weights
 
   occa::kernel AxKernel;
   occa::kernel partialAxKernel;
   occa::kernel partialFloatAxKernel;
   occa::kernel partialCubatureAxKernel;
+  occa::kernel partialStoredAxKernel; // stored-ggeo Ax kept to benchmark the on-the-fly geofacs
   
   occa::kernel rhsBCKernel;
   occa::kernel addBCKernel;
@@ -149,6 +151,7 @@ elliptic_t *ellipticSetup(mesh2D *mesh, dfloat lambda, occa::properties &kernelI
 
 void ellipticPreconditioner(elliptic_t *elliptic, dfloat lambda, occa::memory &o_r, occa::memory &o_z);
 void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda);
+void ellipticPreconditionerUpdate(elliptic_t *elliptic, dfloat lambda);
 
 int  ellipticSolve(elliptic_t *elliptic, dfloat lambda, dfloat tol, occa::memory &o_r, occa::memory &o_x);
 void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &kernelInfo);
@@ -180,6 +183,9 @@ void ellipticBuildJacobi(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagA)
 void ellipticBuildLocalPatches(elliptic_t *elliptic, dfloat lambda, dfloat rateTolerance,
                                dlong *Npataches, dlong **patchesIndex, dfloat **patchesInvA);
 
+int  ellipticFDMSupported(elliptic_t *elliptic);
+void ellipticBuildFDM(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagP);
+
 // //smoother setups
 // void ellipticSetupSmoother(elliptic_t *elliptic, precon_t *precon, dfloat lambda);
 // void ellipticSetupSmootherDampedJacobi    (elliptic_t *elliptic, precon_t *precon, agmgLevel *level, dfloat lambda);
@@ -190,6 +196,10 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
 
 void ellipticSEMFEMSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambda);
 
+int  ellipticSEMFEMMatrixFreeSupported(elliptic_t *elliptic);
+void ellipticSEMFEMOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq);
+void ellipticBuildSEMFEMJacobi(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagA);
+
 dfloat ellipticUpdatePCG(elliptic_t *elliptic, occa::memory &o_p, occa::memory &o_Ap, dfloat alpha,
 			 occa::memory &o_x, occa::memory &o_r);
 
@@ -28,9 +28,11 @@ SOFTWARE.
 #define ELLIPTIC_MGLEVEL_HPP
 
 typedef enum {RICHARDSON=1,
-              CHEBYSHEV=2} SmoothType;
+              CHEBYSHEV=2,
+              CHEBYSHEV4=3} SmoothType;
 typedef enum {JACOBI=1,
-              LOCALPATCH=2} SmootherType;
+              LOCALPATCH=2,
+              FDM=3} SmootherType;
 
 class MGLevel: public parAlmond::multigridLevel {
 
@@ -42,6 +44,9 @@ public:
 
   int degree;
 
+  //smooth with the matrix-free low-order SEMFEM operator
+  bool SEMFEM;
+
   //coarsener
   dfloat *R;
   occa::memory o_R;
@@ -71,7 +76,8 @@ public:
 
   //build a single level
   MGLevel(elliptic_t *ellipticBase, dfloat lambda_, int Nc,
-           setupAide options_, parAlmond::KrylovType ktype_, MPI_Comm comm_);
+           setupAide options_, parAlmond::KrylovType ktype_, MPI_Comm comm_,
+           bool SEMFEM_=false);
   //build a level and connect it to the previous one
   MGLevel(elliptic_t *ellipticBase, //finest level
                    mesh_t **meshLevels,
@@ -103,14 +109,17 @@ public:
 
   void smoothRichardson(occa::memory &o_r, occa::memory &o_x, bool xIsZero);
   void smoothChebyshev (occa::memory &o_r, occa::memory &o_x, bool xIsZero);
+  void smoothFourthKindChebyshev(occa::memory &o_r, occa::memory &o_x, bool xIsZero);
 
   void smootherLocalPatch(occa::memory &o_r, occa::memory &o_Sr);
   void smootherJacobi    (occa::memory &o_r, occa::memory &o_Sr);
+  void smootherFDM       (occa::memory &o_r, occa::memory &o_Sr);
 
   void Report();
 
   void setupSmoother();
   dfloat maxEigSmoothAx();
+  void eigBoundsSmoothAx(dfloat *lmin, dfloat *lmax);
 
   void buildCoarsenerTriTet(mesh_t **meshLevels, int Nf, int Nc);
   void buildCoarsenerQuadHex(mesh_t **meshLevels, int Nf, int Nc);
@@ -37,6 +37,8 @@ typedef struct {
 
   long long int preconBytes;
 
+  dfloat lambda; //operator coefficient the preconditioner was built for
+
   ogs_t *ogs;
   ogs_t *FEMogs;
 
@@ -81,6 +83,11 @@ typedef struct {
   occa::kernel facePatchGatherKernel;
   occa::kernel CGLocalPatchKernel;
 
+  // fast diagonalization Schwarz smoother
+  occa::kernel fdmExtendKernel;
+  occa::kernel fdmSolveKernel;
+  occa::kernel fdmRestrictKernel;
+
   occa::memory o_rFEM;
   occa::memory o_zFEM;
   occa::memory o_GrFEM;
@@ -89,6 +96,9 @@ typedef struct {
   occa::kernel SEMFEMInterpKernel;
   occa::kernel SEMFEMAnterpKernel;
 
+  // matrix-free low-order SEMFEM operator (quads/hexes)
+  occa::kernel SEMFEMAxKernel;
+
   ogs_t *ogsP, *ogsDg;
 
   occa::memory o_diagA;
@@ -0,0 +1,221 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+// find the reference coordinate held fixed on face f, and whether it sits at 0 or N
+static void ellipticFDMFaceDirection(mesh_t *mesh, int f, int *dir, int *side){
+
+  const int Nq = mesh->N+1;
+
+  for(int d=0;d<mesh->dim;++d){
+    int stride = (d==0) ? 1 : ((d==1) ? Nq : Nq*Nq);
+
+    int n0 = mesh->faceNodes[f*mesh->Nfp];
+    int c0 = (n0/stride)%Nq;
+
+    int fixed = 1;
+    for(int m=1;m<mesh->Nfp;++m){
+      int n = mesh->faceNodes[f*mesh->Nfp+m];
+      if((n/stride)%Nq != c0) {fixed = 0; break;}
+    }
+
+    if(fixed){
+      *dir = d;
+      *side = (c0==0) ? 0 : 1;
+      return;
+    }
+  }
+
+  printf("ERROR: face %d of reference element is not a coordinate plane\n", f);
+  exit(-1);
+}
+
+int ellipticFDMSupported(elliptic_t *elliptic){
+
+  return (elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS")
+          && (elliptic->elementType==HEXAHEDRA
+              || (elliptic->elementType==QUADRILATERALS && elliptic->dim==2)));
+}
+
+// gather-scatter of the extended element patches. It only depends on the mesh
+static void ellipticFDMSetupPatches(elliptic_t *elliptic){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+  setupAide options = elliptic->options;
+
+  const int dim = mesh->dim;
+  const int Nq = mesh->N+1;
+  const int NqP = Nq+2;
+  const int NpP = (dim==3) ? NqP*NqP*NqP : NqP*NqP;
+
+  const dlong Nlocal = mesh->Nelements*mesh->Np;
+  const dlong NlocalP = mesh->Nelements*NpP;
+
+  // masked global node ids for local and halo elements
+  hlong *ids = (hlong*) calloc((mesh->Nelements+mesh->totalHaloPairs)*mesh->Np, sizeof(hlong));
+  memcpy(ids, mesh->maskedGlobalIds, Nlocal*sizeof(hlong));
+
+  hlong *sendBuffer = (hlong*) calloc(mesh->totalHaloPairs*mesh->Np+1, sizeof(hlong));
+  meshHaloExchange(mesh, mesh->Np*sizeof(hlong), ids, sendBuffer, ids+Nlocal);
+  free(sendBuffer);
+
+  // global ids of the extended patch nodes (0 for corners and boundaries)
+  hlong *patchIds = (hlong*) calloc(NlocalP, sizeof(hlong));
+
+  const int strideP[3] = {1, NqP, NqP*NqP};
+  const int stride[3]  = {1, Nq, Nq*Nq};
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    for(int n=0;n<mesh->Np;++n){
+      int idP = 0;
+      for(int d=0;d<dim;++d) idP += ((n/stride[d])%Nq + 1)*strideP[d];
+      patchIds[e*NpP+idP] = ids[e*mesh->Np+n];
+    }
+
+    for(int f=0;f<mesh->Nfaces;++f){
+      int dir, side;
+      ellipticFDMFaceDirection(mesh, f, &dir, &side);
+
+      for(int m=0;m<mesh->Nfp;++m){
+        dlong idM = mesh->vmapM[e*mesh->Nfaces*mesh->Nfp + f*mesh->Nfp + m];
+        dlong idN = mesh->vmapP[e*mesh->Nfaces*mesh->Nfp + f*mesh->Nfp + m];
+
+        dlong eP = idN/mesh->Np;
+        if(eP==e) continue; //boundary face
+
+        // position of this face node's outward neighbor in the patch
+        int n = idM%mesh->Np;
+        int idP = 0;
+        for(int d=0;d<dim;++d){
+          int c = (d==dir) ? (side ? NqP-1 : 0) : (n/stride[d])%Nq + 1;
+          idP += c*strideP[d];
+        }
+
+        // step one node into the neighbor away from the shared face
+        int fP = mesh->EToF[e*mesh->Nfaces+f];
+        int dirP, sideP;
+        ellipticFDMFaceDirection(mesh, fP, &dirP, &sideP);
+
+        int nP = idN%mesh->Np;
+        nP += (sideP ? -1 : 1)*stride[dirP];
+
+        patchIds[e*NpP+idP] = ids[eP*mesh->Np+nP];
+      }
+    }
+  }
+
+  int verbose = options.compareArgs("VERBOSE","TRUE") ? 1:0;
+  precon->ogsP = ogsSetup(NlocalP, patchIds, mesh->comm, 0, verbose, mesh->device);
+
+  precon->o_oasForward = mesh->device.malloc(NqP*NqP*sizeof(dfloat), mesh->oasForward);
+  precon->o_oasBack    = mesh->device.malloc(NqP*NqP*sizeof(dfloat), mesh->oasBack);
+
+  precon->o_zP = mesh->device.malloc(NlocalP*sizeof(dfloat));
+
+  free(ids); free(patchIds);
+}
+
+
+/* Set up the fast diagonalization (FDM) overlapping Schwarz smoother. Each element
+   is extended by one node layer from each face neighbor, and the patch operator is
+   inverted with the 1D generalized eigenbases from the reference node file, scaled
+   by the element's edge lengths. Overlapping patch values are exchanged with ogs.
+   If the patches already exist only the lambda-dependent eigenvalues are rebuilt. */
+void ellipticBuildFDM(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagP){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+
+  const int dim = mesh->dim;
+  const int Nq = mesh->N+1;
+  const int NqP = Nq+2;
+  const int NpP = (dim==3) ? NqP*NqP*NqP : NqP*NqP;
+
+  const dlong NlocalP = mesh->Nelements*NpP;
+
+  const int strideP[3] = {1, NqP, NqP*NqP};
+
+  if (!precon->ogsP) ellipticFDMSetupPatches(elliptic);
+
+  // per-element inverse eigenvalues, using the mean edge length in each direction
+  *invDiagP = (dfloat*) calloc(NlocalP, sizeof(dfloat));
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+    dfloat h[3] = {0,0,0};
+
+    int Nedges = (dim==3) ? 4 : 2;
+    int v0[3][4], v1[3][4];
+    if(dim==2){
+      int r0[2] = {0,3}, r1[2] = {1,2}, s0[2] = {0,1}, s1[2] = {3,2};
+      for(int n=0;n<2;++n){
+        v0[0][n] = r0[n]; v1[0][n] = r1[n];
+        v0[1][n] = s0[n]; v1[1][n] = s1[n];
+      }
+    } else {
+      int r0[4] = {0,3,4,7}, r1[4] = {1,2,5,6};
+      int s0[4] = {0,1,4,5}, s1[4] = {3,2,7,6};
+      int t0[4] = {0,1,2,3}, t1[4] = {4,5,6,7};
+      for(int n=0;n<4;++n){
+        v0[0][n] = r0[n]; v1[0][n] = r1[n];
+        v0[1][n] = s0[n]; v1[1][n] = s1[n];
+        v0[2][n] = t0[n]; v1[2][n] = t1[n];
+      }
+    }
+
+    for(int d=0;d<dim;++d){
+      for(int n=0;n<Nedges;++n){
+        dlong a = e*mesh->Nverts+v0[d][n];
+        dlong b = e*mesh->Nverts+v1[d][n];
+        dfloat dx = mesh->EX[b]-mesh->EX[a];
+        dfloat dy = mesh->EY[b]-mesh->EY[a];
+        dfloat dz = (dim==3) ? mesh->EZ[b]-mesh->EZ[a] : 0;
+        h[d] += sqrt(dx*dx+dy*dy+dz*dz)/Nedges;
+      }
+    }
+
+    dfloat J = 1.0;
+    dfloat g[3];
+    for(int d=0;d<dim;++d){
+      J *= 0.5*h[d];
+      g[d] = 4.0/(h[d]*h[d]);
+    }
+
+    for(int n=0;n<NpP;++n){
+      dfloat eig = lambda;
+      for(int d=0;d<dim;++d) eig += g[d]*mesh->oasDiagOp[(n/strideP[d])%NqP];
+      eig *= J;
+
+      (*invDiagP)[e*NpP+n] = (fabs(eig)>1e-12) ? 1.0/eig : 0.0;
+    }
+  }
+
+  if (precon->o_oasDiagInvOp.size())
+    precon->o_oasDiagInvOp.copyFrom(*invDiagP);
+  else
+    precon->o_oasDiagInvOp = mesh->device.malloc(NlocalP*sizeof(dfloat), *invDiagP);
+}
@@ -227,11 +227,29 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   // global nodes
   meshParallelConnectNodes(mesh);
 
+  // keep the nodal coordinates on the device to recompute geofacs in Ax
+  if(elliptic->elementType==HEXAHEDRA
+     && options.compareArgs("DISCRETIZATION","CONTINUOUS")
+     && !options.compareArgs("ELEMENT MAP", "TRILINEAR")
+     && options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+    dlong Nxyz = mesh->Nelements*mesh->dim*mesh->Np;
+    dfloat *XYZ = (dfloat*) calloc(Nxyz, sizeof(dfloat));
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int n=0;n<mesh->Np;++n){
+        XYZ[e*mesh->dim*mesh->Np + n              ] = mesh->x[e*mesh->Np+n];
+        XYZ[e*mesh->dim*mesh->Np + n +   mesh->Np] = mesh->y[e*mesh->Np+n];
+        XYZ[e*mesh->dim*mesh->Np + n + 2*mesh->Np] = mesh->z[e*mesh->Np+n];
+      }
+    }
+    elliptic->o_XYZ = mesh->device.malloc(Nxyz*sizeof(dfloat), XYZ);
+    free(XYZ);
+  }
+
   //dont need these once vmap is made
-  free(mesh->x);
-  free(mesh->y);
+  free(mesh->x); mesh->x = NULL;
+  free(mesh->y); mesh->y = NULL;
   if (elliptic->dim==3) {
-    free(mesh->z);
+    free(mesh->z); mesh->z = NULL;
   }
   free(sendBuffer);
 
@@ -619,9 +637,15 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
       mesh->device.malloc(mesh->Nelements*mesh->Nfaces*mesh->Nfp*mesh->Nsgeo*sizeof(dfloat),
                           mesh->sgeo);
 
-    mesh->o_ggeo =
-      mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
-                          mesh->ggeo);
+    // the on-the-fly Ax rebuilds the geofacs from o_XYZ, so only stream ggeo otherwise
+    if(options.compareArgs("DISCRETIZATION","CONTINUOUS")
+       && !options.compareArgs("ELEMENT MAP", "TRILINEAR")
+       && options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY"))
+      mesh->o_ggeo = mesh->device.malloc(sizeof(dfloat)); // dummy
+    else
+      mesh->o_ggeo =
+        mesh->device.malloc(mesh->Nelements*mesh->Np*mesh->Nggeo*sizeof(dfloat),
+                            mesh->ggeo);
 
     mesh->o_cubggeo =
       mesh->device.malloc(mesh->Nelements*mesh->cubNp*mesh->Nggeo*sizeof(dfloat),
@@ -743,6 +767,9 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
   elliptic->ogs = ogsSetup(Ntotal, mesh->maskedGlobalIds, mesh->comm, 0, verbose, mesh->device);
   elliptic->o_invDegree = elliptic->ogs->o_invDegree;
 
+  if (options.compareArgs("GATHER SCATTER", "BLOCKED"))
+    ogsSetupBlocks(elliptic->ogs, verbose);
+
 
 
   // info for kernel construction
@@ -917,6 +944,8 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
       else{
         if(elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")){
           sprintf(kernelName, "ellipticPartialAxTrilinear%s", suffix);
+        }else if(elliptic->options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+          sprintf(kernelName, "ellipticPartialAxOnTheFly%s", suffix);
         }else{
           sprintf(kernelName, "ellipticPartialAx%s", suffix);
         }
@@ -1040,13 +1069,30 @@ elliptic_t *ellipticBuildMultigridLevel(elliptic_t *baseElliptic, int Nc, int Nf
       sprintf(fileName, DELLIPTIC "/okl/ellipticPreconProlongate%s.okl", suffix);
       sprintf(kernelName, "ellipticPreconProlongate%s", suffix);
       elliptic->precon->prolongateKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+      if (options.compareArgs("MULTIGRID SMOOTHER","FDM") && ellipticFDMSupported(elliptic)) {
+        int NqFDM = mesh->N+3;
+        kernelInfo["defines/" "p_NqFDM"]= NqFDM;
+        kernelInfo["defines/" "p_NpFDM"]= (elliptic->dim==3) ? NqFDM*NqFDM*NqFDM : NqFDM*NqFDM;
+
+        sprintf(fileName, DELLIPTIC "/okl/ellipticFDM%s.okl", suffix);
+        sprintf(kernelName, "ellipticFDMExtend%s", suffix);
+        elliptic->precon->fdmExtendKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+        sprintf(kernelName, "ellipticFDMSolve%s", suffix);
+        elliptic->precon->fdmSolveKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+        sprintf(kernelName, "ellipticFDMRestrict%s", suffix);
+        elliptic->precon->fdmRestrictKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      }
     }
     MPI_Barrier(mesh->comm);
   }
 
   if(elliptic->elementType==HEXAHEDRA){
     if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
-      if(options.compareArgs("ELEMENT MAP", "TRILINEAR")){
+      if(options.compareArgs("ELEMENT MAP", "TRILINEAR")
+         || options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
 
         // pack gllz, gllw, and elementwise EXYZ
         dfloat *gllzw = (dfloat*) calloc(2*mesh->Nq, sizeof(dfloat));
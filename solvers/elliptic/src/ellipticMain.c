@@ -87,16 +87,22 @@ int main(int argc, char **argv){
         ellipticOperator(elliptic, lambda, elliptic->o_x, elliptic->o_Ax, dfloatString); // standard precision
 
       if(options.compareArgs("BENCHMARK", "BK5")){
-        if(!options.compareArgs("ELEMENT MAP", "TRILINEAR")){
+        if(options.compareArgs("ELEMENT MAP", "TRILINEAR")){
           elliptic->partialAxKernel(mesh->NlocalGatherElements,
                                     mesh->o_localGatherElementList,
-                                    mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
+                                    elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
+                                    lambda, elliptic->o_x, elliptic->o_Ax);
+        }
+        else if(elliptic->elementType==HEXAHEDRA && options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+          elliptic->partialAxKernel(mesh->NlocalGatherElements,
+                                    mesh->o_localGatherElementList,
+                                    elliptic->o_XYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
                                     lambda, elliptic->o_x, elliptic->o_Ax);
         }
         else{
           elliptic->partialAxKernel(mesh->NlocalGatherElements,
                                     mesh->o_localGatherElementList,
-                                    elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
+                                    mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
                                     lambda, elliptic->o_x, elliptic->o_Ax);
         }
       }
@@ -120,6 +126,33 @@ int main(int argc, char **argv){
            mesh->Nelements*mesh->Np/elapsedAx,
            (char*) options.getArgs("DISCRETIZATION").c_str());
 
+    // compare against the same Ax streaming the stored geometric factors
+    if(options.compareArgs("BENCHMARK", "BK5") && elliptic->elementType==HEXAHEDRA &&
+       !options.compareArgs("ELEMENT MAP", "TRILINEAR") &&
+       options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+
+      occa::streamTag startStored = mesh->device.tagStream();
+
+      for(int it=0;it<NAx;++it)
+        elliptic->partialStoredAxKernel(mesh->NlocalGatherElements,
+                                        mesh->o_localGatherElementList,
+                                        mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM,
+                                        lambda, elliptic->o_x, elliptic->o_Ax);
+
+      occa::streamTag stopStored = mesh->device.tagStream();
+
+      mesh->device.finish();
+
+      double elapsedStored = mesh->device.timeBetween(startStored, stopStored)/NAx;
+
+      if (mesh->rank==0)
+        printf("%d, %d, %g, %g, %g; \%\%elemental: N, dofs, elapsed stored ggeo, elapsed on-the-fly, speedup\n",
+               mesh->N,
+               mesh->NlocalGatherElements*mesh->Np,
+               elapsedStored,
+               elapsedAx,
+               elapsedStored/elapsedAx);
+    }
   }
   else{
 
@@ -226,6 +259,25 @@ int main(int argc, char **argv){
     else
       meshPlotVTU2D(mesh, fname, 0);
 #endif
+
+    // refresh the preconditioner for a new lambda and back again, re-solving
+    // each time (exercises ellipticPreconditionerUpdate on every level)
+    dfloat refreshLambda;
+    if(options.getArgs("LAMBDA REFRESH", refreshLambda)){
+      dfloat refreshLambdas[2] = {refreshLambda, lambda};
+      dfloat *zero = (dfloat*) calloc(mesh->Np*(mesh->Nelements+mesh->totalHaloPairs), sizeof(dfloat));
+
+      for(int r=0;r<2;++r){
+        ellipticPreconditionerUpdate(elliptic, refreshLambdas[r]);
+
+        elliptic->o_x.copyFrom(zero);
+        int itRefresh = ellipticSolve(elliptic, refreshLambdas[r], tol, elliptic->o_r, elliptic->o_x);
+
+        if (mesh->rank==0)
+          printf("refreshed lambda = %g: %d iterations\n", refreshLambdas[r], itRefresh);
+      }
+      free(zero);
+    }
   }
 
 #if 0
@@ -27,13 +27,19 @@ SOFTWARE.
 #include "elliptic.h"
 
 void MGLevel::Ax(occa::memory o_x, occa::memory o_Ax) {
-  ellipticOperator(elliptic,lambda,
-                    o_x,o_Ax, dfloatString); // "float" ); // hard coded for testing (should make an option)
+  if (SEMFEM)
+    ellipticSEMFEMOperator(elliptic,lambda,o_x,o_Ax);
+  else
+    ellipticOperator(elliptic,lambda,
+                      o_x,o_Ax, dfloatString); // "float" ); // hard coded for testing (should make an option)
 }
 
 void MGLevel::residual(occa::memory o_rhs, occa::memory o_x, occa::memory o_res) {
-  ellipticOperator(elliptic,lambda,
-                    o_x,o_res, dfloatString); // "float" ); // hard coded for testing (should make an option)
+  if (SEMFEM)
+    ellipticSEMFEMOperator(elliptic,lambda,o_x,o_res);
+  else
+    ellipticOperator(elliptic,lambda,
+                      o_x,o_res, dfloatString); // "float" ); // hard coded for testing (should make an option)
 
   // subtract r = b - A*x
   ellipticScaledAdd(elliptic, 1.f, o_rhs, -1.f, o_res);
@@ -60,6 +66,8 @@ void MGLevel::smooth(occa::memory o_rhs, occa::memory o_x, bool x_is_zero) {
     this->smoothRichardson(o_rhs, o_x, x_is_zero);
   } else if (stype==CHEBYSHEV) {
     this->smoothChebyshev(o_rhs, o_x, x_is_zero);
+  } else if (stype==CHEBYSHEV4) {
+    this->smoothFourthKindChebyshev(o_rhs, o_x, x_is_zero);
   }
 }
 
@@ -68,6 +76,8 @@ void MGLevel::smoother(occa::memory o_x, occa::memory o_Sx) {
     this->smootherJacobi(o_x, o_Sx);
   } else if (smtype==LOCALPATCH) {
     this->smootherLocalPatch(o_x, o_Sx);
+  } else if (smtype==FDM) {
+    this->smootherFDM(o_x, o_Sx);
   }
 }
 
@@ -146,6 +156,55 @@ void MGLevel::smoothChebyshev (occa::memory &o_r, occa::memory &o_x, bool xIsZer
   elliptic->scaledAddKernel(Nrows, one, o_d, one, o_x);
 }
 
+// fourth-kind Chebyshev smoothing (Lottes), only needs rho = lambda1
+void MGLevel::smoothFourthKindChebyshev (occa::memory &o_r, occa::memory &o_x, bool xIsZero) {
+
+  const dfloat invRho = 1.0/lambda1;
+
+  dfloat one = 1., mone = -1., zero = 0.0;
+
+  occa::memory o_res = o_smootherResidual;
+  occa::memory o_Ad  = o_smootherResidual2;
+  occa::memory o_d   = o_smootherUpdate;
+
+  if(xIsZero){ //skip the Ax if x is zero
+    //res = Sr
+    this->smoother(o_r, o_res);
+  } else {
+    //res = S(r-Ax)
+    this->Ax(o_x,o_res);
+    elliptic->scaledAddKernel(Nrows, one, o_r, mone, o_res);
+    this->smoother(o_res, o_res);
+  }
+
+  //d = 4/(3 rho)*res
+  dfloat c0 = (4./3.)*invRho;
+  elliptic->scaledAddKernel(Nrows, c0, o_res, zero, o_d);
+
+  for (int k=1;k<=ChebyshevIterations;k++) {
+    //x_k+1 = x_k + d_k
+    if (xIsZero&&(k==1))
+      elliptic->scaledAddKernel(Nrows, one, o_d, zero, o_x);
+    else
+      elliptic->scaledAddKernel(Nrows, one, o_d, one, o_x);
+
+    //r_k+1 = r_k - SAd_k
+    this->Ax(o_d,o_Ad);
+    this->smoother(o_Ad, o_Ad);
+    elliptic->scaledAddKernel(Nrows, mone, o_Ad, one, o_res);
+
+    //d_k+1 = (2k-1)/(2k+3)*d_k + (8k+4)/((2k+3) rho)*r_k+1
+    dfloat a = (2.*k-1.)/(2.*k+3.);
+    dfloat b = (8.*k+4.)/(2.*k+3.)*invRho;
+    elliptic->scaledAddKernel(Nrows, b, o_res, a, o_d);
+  }
+  //x_k+1 = x_k + d_k
+  if (xIsZero&&(ChebyshevIterations==0))
+    elliptic->scaledAddKernel(Nrows, one, o_d, zero, o_x);
+  else
+    elliptic->scaledAddKernel(Nrows, one, o_d, one, o_x);
+}
+
 void MGLevel::smootherLocalPatch(occa::memory &o_r, occa::memory &o_Sr) {
 
   elliptic->precon->approxBlockJacobiSolverKernel(mesh->Nelements,
@@ -160,3 +219,23 @@ void MGLevel::smootherJacobi(occa::memory &o_r, occa::memory &o_Sr) {
   elliptic->dotMultiplyKernel(mesh->Np*mesh->Nelements,o_invDiagA,o_r,o_Sr);
 }
 
+void MGLevel::smootherFDM(occa::memory &o_r, occa::memory &o_Sr) {
+
+  precon_t *precon = elliptic->precon;
+
+  // extend each element with its neighbors' first interior layer
+  precon->fdmExtendKernel(mesh->Nelements, elliptic->o_invDegree, o_r, precon->o_zP);
+  ogsGatherScatter(precon->o_zP, ogsDfloat, ogsAdd, precon->ogsP);
+
+  precon->fdmSolveKernel(mesh->Nelements,
+                         precon->o_oasForward,
+                         precon->o_oasDiagInvOp,
+                         precon->o_oasBack,
+                         precon->o_zP);
+
+  // sum the overlapping patch solutions
+  ogsGatherScatter(precon->o_zP, ogsDfloat, ogsAdd, precon->ogsP);
+  precon->fdmRestrictKernel(mesh->Nelements, precon->o_zP, o_Sr);
+
+  if (elliptic->Nmasked) mesh->maskKernel(elliptic->Nmasked, elliptic->o_maskIds, o_Sr);
+}
@@ -32,9 +32,21 @@ occa::memory MGLevel::o_smootherResidual;
 occa::memory MGLevel::o_smootherResidual2;
 occa::memory MGLevel::o_smootherUpdate;
 
+//copy into a device array of the right size, allocate it otherwise.
+// Lets setupSmoother rerun when only the level's lambda changed
+static void MGLevelUpload(occa::device &device, occa::memory &o_a, size_t bytes, void *a){
+  if (o_a.size()==bytes) {
+    if (bytes) o_a.copyFrom(a, bytes);
+    return;
+  }
+  if (o_a.size()) o_a.free();
+  o_a = device.malloc(bytes, a);
+}
+
 //build a single level
 MGLevel::MGLevel(elliptic_t *ellipticBase, dfloat lambda_, int Nc,
-                setupAide options_, parAlmond::KrylovType ktype_, MPI_Comm comm_):
+                setupAide options_, parAlmond::KrylovType ktype_, MPI_Comm comm_,
+                bool SEMFEM_):
   multigridLevel(ellipticBase->mesh->Nelements*ellipticBase->mesh->Np,
                 (ellipticBase->mesh->Nelements+ellipticBase->mesh->totalHaloPairs)*ellipticBase->mesh->Np,
                 ktype_,
@@ -45,6 +57,7 @@ MGLevel::MGLevel(elliptic_t *ellipticBase, dfloat lambda_, int Nc,
   options = options_;
   lambda = lambda_;
   degree = Nc;
+  SEMFEM = SEMFEM_;
   weighted = false;
 
   //use weighted inner products
@@ -77,6 +90,7 @@ MGLevel::MGLevel(elliptic_t *ellipticBase, //finest level
   options = options_;
   lambda = lambda_;
   degree = Nc;
+  SEMFEM = false;
   weighted = false;
 
   //use weighted inner products
@@ -102,7 +116,7 @@ MGLevel::MGLevel(elliptic_t *ellipticBase, //finest level
 void MGLevel::setupSmoother() {
 
   //set up the fine problem smoothing
-  if(options.compareArgs("MULTIGRID SMOOTHER","LOCALPATCH")){
+  if(!SEMFEM && options.compareArgs("MULTIGRID SMOOTHER","LOCALPATCH")){
     smtype = LOCALPATCH;
 
     dfloat *invAP;
@@ -119,25 +133,26 @@ void MGLevel::setupSmoother() {
     //initialize the full inverse operators on each 4 element patch
     ellipticBuildLocalPatches(elliptic, lambda, rateTolerance, &Npatches, &patchesIndex, &invAP);
 
-    o_invAP = mesh->device.malloc(Npatches*mesh->Np*mesh->Np*sizeof(dfloat),invAP);
-    o_patchesIndex = mesh->device.malloc(mesh->Nelements*sizeof(dlong), patchesIndex);
+    MGLevelUpload(mesh->device, o_invAP, Npatches*mesh->Np*mesh->Np*sizeof(dfloat), invAP);
+    MGLevelUpload(mesh->device, o_patchesIndex, mesh->Nelements*sizeof(dlong), patchesIndex);
 
     dfloat *invDegree = (dfloat*) calloc(mesh->Nelements,sizeof(dfloat));
     for (dlong e=0;e<mesh->Nelements;e++) invDegree[e] = 1.0;
 
-    o_invDegreeAP = mesh->device.malloc(mesh->Nelements*sizeof(dfloat),invDegree);
+    MGLevelUpload(mesh->device, o_invDegreeAP, mesh->Nelements*sizeof(dfloat), invDegree);
 
     if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
-      stype = CHEBYSHEV;
+      stype = options.compareArgs("MULTIGRID SMOOTHER","FOURTHKIND") ? CHEBYSHEV4 : CHEBYSHEV;
 
       if (!options.getArgs("MULTIGRID CHEBYSHEV DEGREE", ChebyshevIterations))
         ChebyshevIterations = 2; //default to degree 2
 
-      //estimate the max eigenvalue of S*A
-      dfloat rho = this->maxEigSmoothAx();
+      //estimate the spectral bounds of S*A
+      dfloat lmin, rho;
+      this->eigBoundsSmoothAx(&lmin, &rho);
 
       lambda1 = rho;
-      lambda0 = rho/10.;
+      lambda0 = parAlmond::chebyshevLowerBound(lmin, rho); //unused by the fourth-kind polynomial
     } else {
       stype = RICHARDSON;
 
@@ -155,24 +170,66 @@ void MGLevel::setupSmoother() {
     }
     free(invDegree); free(invAP); free(patchesIndex);
 
-  } else if (options.compareArgs("MULTIGRID SMOOTHER","DAMPEDJACOBI")) { //default to damped jacobi
-    smtype = JACOBI;
-    dfloat *invDiagA;
-    ellipticBuildJacobi(elliptic,lambda, &invDiagA);
+  } else if (!SEMFEM && options.compareArgs("MULTIGRID SMOOTHER","FDM") && ellipticFDMSupported(elliptic)) {
+    smtype = FDM;
 
-    o_invDiagA = mesh->device.malloc(mesh->Np*mesh->Nelements*sizeof(dfloat), invDiagA);
+    //fast diagonalization solves on overlapping extended element patches
+    dfloat *invDiagP;
+    ellipticBuildFDM(elliptic, lambda, &invDiagP);
 
     if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
-      stype = CHEBYSHEV;
+      stype = options.compareArgs("MULTIGRID SMOOTHER","FOURTHKIND") ? CHEBYSHEV4 : CHEBYSHEV;
 
       if (!options.getArgs("MULTIGRID CHEBYSHEV DEGREE", ChebyshevIterations))
         ChebyshevIterations = 2; //default to degree 2
 
+      //estimate the spectral bounds of S*A
+      dfloat lmin, rho;
+      this->eigBoundsSmoothAx(&lmin, &rho);
+
+      lambda1 = rho;
+      lambda0 = parAlmond::chebyshevLowerBound(lmin, rho); //unused by the fourth-kind polynomial
+    } else {
+      stype = RICHARDSON;
+
       //estimate the max eigenvalue of S*A
       dfloat rho = this->maxEigSmoothAx();
 
+      //set the stabilty weight (jacobi-type interation)
+      lambda0 = (4./3.)/rho;
+
+      dlong NlocalP = mesh->Nelements*((mesh->dim==3) ? (mesh->N+3)*(mesh->N+3)*(mesh->N+3) : (mesh->N+3)*(mesh->N+3));
+      for (dlong n=0;n<NlocalP;n++)
+        invDiagP[n] *= lambda0;
+
+      //update patch eigenvalues with weight
+      elliptic->precon->o_oasDiagInvOp.copyFrom(invDiagP);
+    }
+    free(invDiagP);
+
+  } else if (SEMFEM || options.compareArgs("MULTIGRID SMOOTHER","DAMPEDJACOBI")
+             || options.compareArgs("MULTIGRID SMOOTHER","FDM")) { //default to damped jacobi (FDM needs C0 quads/hexes)
+    smtype = JACOBI;
+    dfloat *invDiagA;
+    if (SEMFEM) //the SEMFEM level only has the low-order operator's diagonal
+      ellipticBuildSEMFEMJacobi(elliptic,lambda, &invDiagA);
+    else
+      ellipticBuildJacobi(elliptic,lambda, &invDiagA);
+
+    MGLevelUpload(mesh->device, o_invDiagA, mesh->Np*mesh->Nelements*sizeof(dfloat), invDiagA);
+
+    if (options.compareArgs("MULTIGRID SMOOTHER","CHEBYSHEV")) {
+      stype = options.compareArgs("MULTIGRID SMOOTHER","FOURTHKIND") ? CHEBYSHEV4 : CHEBYSHEV;
+
+      if (!options.getArgs("MULTIGRID CHEBYSHEV DEGREE", ChebyshevIterations))
+        ChebyshevIterations = 2; //default to degree 2
+
+      //estimate the spectral bounds of S*A
+      dfloat lmin, rho;
+      this->eigBoundsSmoothAx(&lmin, &rho);
+
       lambda1 = rho;
-      lambda0 = rho/10.;
+      lambda0 = parAlmond::chebyshevLowerBound(lmin, rho); //unused by the fourth-kind polynomial
     } else {
       stype = RICHARDSON;
 
@@ -212,14 +269,25 @@ void MGLevel::Report() {
     strcpy(smootherString, "Damped Jacobi   ");
   else if (stype==CHEBYSHEV&&smtype==JACOBI)
     strcpy(smootherString, "Chebyshev       ");
+  else if (stype==CHEBYSHEV4&&smtype==JACOBI)
+    strcpy(smootherString, "Chebyshev (4th) ");
   else if (stype==RICHARDSON&&smtype==LOCALPATCH)
     strcpy(smootherString, "Local Patch     ");
   else if (stype==RICHARDSON&&smtype==LOCALPATCH)
     strcpy(smootherString, "Local Patch+Cheb");
+  else if (stype==RICHARDSON&&smtype==FDM)
+    strcpy(smootherString, "FDM Schwarz     ");
+  else if (stype==CHEBYSHEV&&smtype==FDM)
+    strcpy(smootherString, "FDM Schwarz+Cheb");
+  else if (stype==CHEBYSHEV4&&smtype==FDM)
+    strcpy(smootherString, "FDM Schwarz+Ch4 ");
 
   if (mesh->rank==0){
     printf(     "|    pMG     |    %10d  |   Matrix-free   |   %s|\n",minNrows, smootherString);
-    printf("     |            |    %10d  |     Degree %2d   |                   |\n", maxNrows, degree);
+    if (SEMFEM)
+      printf("     |            |    %10d  |  SEMFEM deg %2d  |                   |\n", maxNrows, degree);
+    else
+      printf("     |            |    %10d  |     Degree %2d   |                   |\n", maxNrows, degree);
     printf("     |            |    %10d  |                 |                   |\n", (int) avgNrows);
   }
 }
@@ -326,35 +394,16 @@ void MGLevel::buildCoarsenerQuadHex(mesh_t **meshLevels, int Nf, int Nc) {
 }
 
 
-static void eig(const int Nrows, double *A, double *WR, double *WI){
-
-  int NB  = 256;
-  char JOBVL  = 'V';
-  char JOBVR  = 'V';
-  int     N = Nrows;
-  int   LDA = Nrows;
-  int  LWORK  = (NB+2)*N;
-
-  double *WORK  = new double[LWORK];
-  double *VL  = new double[Nrows*Nrows];
-  double *VR  = new double[Nrows*Nrows];
-
-  int INFO = -999;
-
-  dgeev_ (&JOBVL, &JOBVR, &N, A, &LDA, WR, WI,
-    VL, &LDA, VR, &LDA, WORK, &LWORK, &INFO);
-
+dfloat MGLevel::maxEigSmoothAx(){
 
-  assert(INFO == 0);
+  dfloat lmin, lmax;
+  this->eigBoundsSmoothAx(&lmin, &lmax);
 
-  delete [] VL;
-  delete [] VR;
-  delete [] WORK;
+  return lmax;
 }
 
-dfloat MGLevel::maxEigSmoothAx(){
+void MGLevel::eigBoundsSmoothAx(dfloat *lmin, dfloat *lmax){
 
-  const dlong N = Nrows;
   const dlong M = Ncols;
 
   int k = 10;
@@ -364,23 +413,45 @@ dfloat MGLevel::maxEigSmoothAx(){
   MPI_Allreduce(&Nlocal, &Ntotal, 1, MPI_HLONG, MPI_SUM, mesh->comm);
   if(k > Ntotal) k = (int) Ntotal;
 
-  // do an arnoldi
+  // the bounds only depend on the operator and the smoother, so reuse them
+  // when a solver is rebuilt for the same level and lambda
+  hlong Nmasked = (hlong) elliptic->Nmasked, NmaskedTotal = 0;
+  MPI_Allreduce(&Nmasked, &NmaskedTotal, 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  // moments of the element vertices tell different meshes of the same size apart
+  // (coarse levels have already released their node coordinates)
+  dfloat moments[6] = {0., 0., 0., 0., 0., 0.}, totalMoments[6];
+  for (dlong n=0;n<mesh->Nelements*mesh->Nverts;n++) {
+    dfloat x = mesh->EX[n], y = mesh->EY[n], z = (mesh->EZ) ? mesh->EZ[n] : 0.;
+    moments[0] += x;   moments[1] += y;   moments[2] += z;
+    moments[3] += x*x; moments[4] += y*y; moments[5] += z*z;
+  }
+  MPI_Allreduce(moments, totalMoments, 6, MPI_DFLOAT, MPI_SUM, mesh->comm);
 
-  // allocate memory for Hessenberg matrix
-  double *H = (double *) calloc(k*k,sizeof(double));
+  char key[BUFSIZ];
+  sprintf(key, "pMG elementType=%d N=%d SEMFEM=%d rows=%lld masked=%lld allNeumann=%d lambda=%.15e smoother=%d"
+          " geometry=%.15e %.15e %.15e %.15e %.15e %.15e",
+          elliptic->elementType, degree, (int) SEMFEM, (long long int) Ntotal,
+          (long long int) NmaskedTotal, elliptic->allNeumann, lambda, (int) smtype,
+          totalMoments[0], totalMoments[1], totalMoments[2],
+          totalMoments[3], totalMoments[4], totalMoments[5]);
 
-  // allocate memory for basis
-  dfloat *Vx = (dfloat*) calloc(M, sizeof(dfloat));
-  occa::memory *o_V = (occa::memory *) calloc(k+1, sizeof(occa::memory));
+  if (parAlmond::spectralBoundsLookup(key, lmin, lmax)) return;
+
+  // run k steps of CG on A preconditioned with the smoother S from a random rhs
+  // and read the spectral bounds of S*A off the implied Lanczos matrix
+  dfloat *alpha = (dfloat *) calloc(k, sizeof(dfloat));
+  dfloat *beta  = (dfloat *) calloc(k, sizeof(dfloat));
 
-  occa::memory o_Vx  = mesh->device.malloc(M*sizeof(dfloat),Vx);
-  occa::memory o_AVx = mesh->device.malloc(M*sizeof(dfloat),Vx);
+  dfloat *Vx = (dfloat*) calloc(M, sizeof(dfloat));
 
-  for(int i=0; i<=k; i++)
-    o_V[i] = mesh->device.malloc(M*sizeof(dfloat),Vx);
+  occa::memory o_r  = mesh->device.malloc(M*sizeof(dfloat),Vx);
+  occa::memory o_z  = mesh->device.malloc(M*sizeof(dfloat),Vx);
+  occa::memory o_p  = mesh->device.malloc(M*sizeof(dfloat),Vx);
+  occa::memory o_Ap = mesh->device.malloc(M*sizeof(dfloat),Vx);
 
-  // generate a random vector for initial basis vector
-  for (dlong i=0;i<N;i++) Vx[i] = (dfloat) drand48();
+  // generate a random vector for the rhs
+  for (dlong i=0;i<Nrows;i++) Vx[i] = (dfloat) drand48();
 
   //gather-scatter
   if (options.compareArgs("DISCRETIZATION","CONTINUOUS")) {
@@ -389,65 +460,71 @@ dfloat MGLevel::maxEigSmoothAx(){
     for (dlong i=0;i<elliptic->Nmasked;i++) Vx[elliptic->maskIds[i]] = 0.;
   }
 
-  o_Vx.copyFrom(Vx); //copy to device
-  dfloat norm_vo = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_Vx, o_Vx);
-  norm_vo = sqrt(norm_vo);
+  o_r.copyFrom(Vx); //copy to device
 
-  ellipticScaledAdd(elliptic, 1./norm_vo, o_Vx, 0. , o_V[0]);
+  // z = S*r, p = z
+  this->smoother(o_r, o_z);
+  ellipticScaledAdd(elliptic, 1., o_z, 0., o_p);
 
+  dfloat rdotz = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_z);
+
+  int Nsteps = 0;
   for(int j=0; j<k; j++){
-    // v[j+1] = invD*(A*v[j])
-    this->Ax(o_V[j],o_AVx);
-    this->smoother(o_AVx, o_V[j+1]);
 
-    // modified Gram-Schmidth
-    for(int i=0; i<=j; i++){
-      // H(i,j) = v[i]'*A*v[j]
-      dfloat hij = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_V[i], o_V[j+1]);
+    this->Ax(o_p, o_Ap);
 
-      // v[j+1] = v[j+1] - hij*v[i]
-      ellipticScaledAdd(elliptic, -hij, o_V[i], 1., o_V[j+1]);
+    dfloat pAp = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_p, o_Ap);
+    if (pAp<=0.0 || rdotz<=0.0) break; //breakdown
 
-      H[i + j*k] = (double) hij;
-    }
+    alpha[j] = rdotz/pAp;
+    Nsteps++;
 
-    if(j+1 < k){
-      // v[j+1] = v[j+1]/||v[j+1]||
-      dfloat norm_vj = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_V[j+1], o_V[j+1]);
-      norm_vj = sqrt(norm_vj);
-      ellipticScaledAdd(elliptic, 1/norm_vj, o_V[j+1], 0., o_V[j+1]);
+    // r = r - alpha*A*p, z = S*r
+    ellipticScaledAdd(elliptic, -alpha[j], o_Ap, 1., o_r);
+    this->smoother(o_r, o_z);
 
-      H[j+1+ j*k] = (double) norm_vj;
-    }
-  }
+    dfloat rdotzNew = ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_r, o_z);
+    beta[j] = rdotzNew/rdotz;
+    rdotz = rdotzNew;
 
-  double *WR = (double *) calloc(k,sizeof(double));
-  double *WI = (double *) calloc(k,sizeof(double));
+    // p = z + beta*p
+    ellipticScaledAdd(elliptic, 1., o_z, beta[j], o_p);
+  }
 
-  eig(k, H, WR, WI);
+  if (Nsteps) {
+    parAlmond::lanczosBounds(Nsteps, alpha, beta, lmin, lmax);
+  } else {
+    // CG broke down on the first step: fall back to a power estimate of
+    // the spectral radius with no usable lower bound
+    o_p.copyFrom(Vx);
 
-  double rho = 0.;
+    dfloat rho = 0.;
+    for (int j=0; j<k; j++) {
+      dfloat pnorm = sqrt(ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_p, o_p));
+      if (pnorm==0.0) break;
+      ellipticScaledAdd(elliptic, 0., o_p, 1.0/pnorm, o_p);
 
-  for(int i=0; i<k; i++){
-    double rho_i  = sqrt(WR[i]*WR[i] + WI[i]*WI[i]);
+      this->Ax(o_p, o_Ap);
+      this->smoother(o_Ap, o_z);
 
-    if(rho < rho_i) {
-      rho = rho_i;
+      rho = sqrt(ellipticWeightedInnerProduct(elliptic, elliptic->o_invDegree, o_z, o_z));
+      ellipticScaledAdd(elliptic, 1., o_z, 0., o_p);
     }
+
+    *lmin = 0.;
+    *lmax = (rho>0.) ? rho : 1.;
   }
+  parAlmond::spectralBoundsStore(key, *lmin, *lmax);
 
   // free memory
-  free(H);
-  free(WR);
-  free(WI);
+  free(alpha);
+  free(beta);
 
   free(Vx);
-  o_Vx.free();
-  o_AVx.free();
-  for(int i=0; i<=k; i++) o_V[i].free();
-  free((void*)o_V);
-
-  // if((mesh->rank==0)&&(options.compareArgs("VERBOSE","TRUE"))) printf("weight = %g \n", rho);
+  o_r.free();
+  o_z.free();
+  o_p.free();
+  o_Ap.free();
 
-  return rho;
+  // if((mesh->rank==0)&&(options.compareArgs("VERBOSE","TRUE"))) printf("weight = %g \n", *lmax);
 }
@@ -54,7 +54,15 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
   int numMGLevels;
   int *levelDegree;
 
-  if (options.compareArgs("MULTIGRID COARSENING","ALLDEGREES")) {
+  //matrix-free SEMFEM: smooth the low-order operator on the fine level and hand the degree 1 problem to AMG
+  bool SEMFEM = options.compareArgs("PRECONDITIONER","SEMFEM");
+
+  if (SEMFEM) {
+    numMGLevels = (mesh->N>1) ? 2 : 1;
+    levelDegree= (int *) calloc(numMGLevels,sizeof(int));
+    levelDegree[0] = mesh->N;
+    levelDegree[numMGLevels-1] = 1;
+  } else if (options.compareArgs("MULTIGRID COARSENING","ALLDEGREES")) {
     numMGLevels = mesh->N;
     levelDegree= (int *) calloc(numMGLevels,sizeof(int));
     for (int n=0;n<numMGLevels;n++) levelDegree[n] = mesh->N - n; //all degrees
@@ -102,7 +110,7 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
   //set up the finest level
   if (Nmax>Nmin) {
     levels[0] = new MGLevel(elliptic, lambda, Nmax, options,
-                            precon->parAlmond->ktype, mesh->comm);
+                            precon->parAlmond->ktype, mesh->comm, SEMFEM);
     MGLevelAllocateStorage((MGLevel*) levels[0], 0,
                             precon->parAlmond->ctype);
     precon->parAlmond->numLevels++;
@@ -170,6 +178,10 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
   }
   free(coarseA);
 
+  //IPDG rows are numbered element by element, use them as the block Jacobi blocks
+  if (options.compareArgs("DISCRETIZATION","IPDG") && !precon->parAlmond->blockJacobiSize)
+    precon->parAlmond->blockJacobiSize = basisNp;
+
   // build amg starting at level N=1
   parAlmond::AMGSetup(precon->parAlmond,
                        coarseGlobalStarts,
@@ -197,7 +209,7 @@ void ellipticMultiGridSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambd
                                        precon->parAlmond->ktype, mesh->comm);
   } else {
     levels[numMGLevels-1] = new MGLevel(ellipticCoarse, lambda, Nmin, options,
-                                       precon->parAlmond->ktype, mesh->comm);
+                                       precon->parAlmond->ktype, mesh->comm, SEMFEM);
   }
   MGLevelAllocateStorage((MGLevel*) levels[numMGLevels-1], numMGLevels-1,
                             precon->parAlmond->ctype);
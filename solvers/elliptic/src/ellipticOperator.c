@@ -52,6 +52,9 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
     int mapType = (elliptic->elementType==HEXAHEDRA &&
                    options.compareArgs("ELEMENT MAP", "TRILINEAR")) ? 1:0;
 
+    if (mapType==0 && elliptic->elementType==HEXAHEDRA &&
+        options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")) mapType = 2;
+
     int integrationType = (elliptic->elementType==HEXAHEDRA &&
                    options.compareArgs("ELLIPTIC INTEGRATION", "CUBATURE")) ? 1:0;
     
@@ -63,9 +66,12 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
 	if(mapType==0)
 	  partialAxKernel(mesh->NglobalGatherElements, mesh->o_globalGatherElementList,
 			  mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-	else
+	else if(mapType==1)
 	  partialAxKernel(mesh->NglobalGatherElements, mesh->o_globalGatherElementList,
 			  elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
+	else
+	  partialAxKernel(mesh->NglobalGatherElements, mesh->o_globalGatherElementList,
+			  elliptic->o_XYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
       }
       else{
 	elliptic->partialCubatureAxKernel(mesh->NglobalGatherElements,
@@ -89,9 +95,12 @@ void ellipticOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, oc
 	if(mapType==0)
 	  partialAxKernel(mesh->NlocalGatherElements, mesh->o_localGatherElementList,
 			  mesh->o_ggeo, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
-	else
+	else if(mapType==1)
 	  partialAxKernel(mesh->NlocalGatherElements, mesh->o_localGatherElementList,
 			  elliptic->o_EXYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
+	else
+	  partialAxKernel(mesh->NlocalGatherElements, mesh->o_localGatherElementList,
+			  elliptic->o_XYZ, elliptic->o_gllzw, mesh->o_Dmatrices, mesh->o_Smatrices, mesh->o_MM, lambda, o_q, o_Aq);
       }
       else{
 
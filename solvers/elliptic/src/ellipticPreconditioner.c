@@ -83,7 +83,9 @@ void ellipticPreconditioner(elliptic_t *elliptic, dfloat lambda,
 
   } else if (options.compareArgs("PRECONDITIONER", "SEMFEM")) {
 
-    if (elliptic->elementType==TRIANGLES||elliptic->elementType==TETRAHEDRA) {
+    if (ellipticSEMFEMMatrixFreeSupported(elliptic)) {
+      parAlmond::Precon(precon->parAlmond, o_z, o_r);
+    } else if (elliptic->elementType==TRIANGLES||elliptic->elementType==TETRAHEDRA) {
       o_z.copyFrom(o_r);
       elliptic->dotMultiplyKernel(mesh->Nelements*mesh->Np, elliptic->o_invDegree, o_z, o_z);
       precon->SEMFEMInterpKernel(mesh->Nelements,mesh->o_SEMFEMAnterp,o_z,precon->o_rFEM);
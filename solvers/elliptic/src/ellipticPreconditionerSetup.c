@@ -32,6 +32,8 @@ void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda
   precon_t *precon = elliptic->precon;
   setupAide options = elliptic->options;
 
+  precon->lambda = lambda;
+
   if(options.compareArgs("PRECONDITIONER", "FULLALMOND")){ //build full A matrix and pass to Almond
     dlong nnz;
     nonZero_t *A;
@@ -61,6 +63,11 @@ void ellipticPreconditionerSetup(elliptic_t *elliptic, ogs_t *ogs, dfloat lambda
     free(A);
 
     precon->parAlmond = parAlmond::Init(mesh->device, mesh->comm, options);
+
+    //IPDG rows are numbered element by element, use them as the block Jacobi blocks
+    if (options.compareArgs("DISCRETIZATION", "IPDG") && !precon->parAlmond->blockJacobiSize)
+      precon->parAlmond->blockJacobiSize = basisNp;
+
     parAlmond::AMGSetup(precon->parAlmond,
                        globalStarts,
                        nnz,
@@ -0,0 +1,127 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+//assemble the matrix of ellipticA at the new lambda and refresh the values of the AMG hierarchy built from it
+static void ellipticRefreshAMG(elliptic_t *elliptic, elliptic_t *ellipticA,
+                               parAlmond::solver_t *M, dfloat lambda){
+
+  mesh_t *mesh = ellipticA->mesh;
+  setupAide options = elliptic->options;
+
+  dlong nnz;
+  nonZero_t *A;
+  ogs_t *ogs = NULL;
+
+  hlong *globalStarts = (hlong*) calloc(mesh->size+1, sizeof(hlong));
+
+  int basisNp = mesh->Np;
+  dfloat *basis = NULL;
+
+  if (options.compareArgs("BASIS", "BERN")) basis = mesh->VB;
+
+  if (options.compareArgs("DISCRETIZATION", "IPDG")) {
+    ellipticBuildIpdg(ellipticA, basisNp, basis, lambda, &A, &nnz, globalStarts);
+  } else if (options.compareArgs("DISCRETIZATION", "CONTINUOUS")) {
+    ellipticBuildContinuous(ellipticA, lambda, &A, &nnz, &ogs, globalStarts);
+  }
+
+  hlong *Rows = (hlong *) calloc(nnz, sizeof(hlong));
+  hlong *Cols = (hlong *) calloc(nnz, sizeof(hlong));
+  dfloat *Vals = (dfloat*) calloc(nnz,sizeof(dfloat));
+
+  for (dlong n=0;n<nnz;n++) {
+    Rows[n] = A[n].row;
+    Cols[n] = A[n].col;
+    Vals[n] = A[n].val;
+  }
+  free(A);
+
+  parAlmond::AMGRefresh(M,
+                        globalStarts,
+                        nnz,
+                        Rows,
+                        Cols,
+                        Vals,
+                        elliptic->allNeumann,
+                        elliptic->allNeumannPenalty);
+  free(Rows); free(Cols); free(Vals);
+  free(globalStarts);
+}
+
+/* Update the preconditioner after the operator coefficient lambda changed (e.g. a
+   new time step size). All structure built by ellipticPreconditionerSetup is kept:
+   the diagonal inverses, patch solves, Chebyshev bounds and the AMG coarse matrices
+   are recomputed in place, the AMG aggregates and prolongators are reused. */
+void ellipticPreconditionerUpdate(elliptic_t *elliptic, dfloat lambda){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+  setupAide options = elliptic->options;
+
+  if (lambda==precon->lambda) return;
+  precon->lambda = lambda;
+
+  if(options.compareArgs("PRECONDITIONER", "FULLALMOND")){
+
+    ellipticRefreshAMG(elliptic, elliptic, precon->parAlmond, lambda);
+
+  } else if (options.compareArgs("PRECONDITIONER", "MASSMATRIX")){
+
+    //independent of lambda
+
+  } else if(options.compareArgs("PRECONDITIONER", "MULTIGRID")
+            || (options.compareArgs("PRECONDITIONER", "SEMFEM")
+                && ellipticSEMFEMMatrixFreeSupported(elliptic))){
+
+    parAlmond::solver_t *M = precon->parAlmond;
+
+    //the pMG levels rebuild their smoothers in place
+    for (int n=0;n<=M->AMGstartLev;n++) {
+      MGLevel *level = (MGLevel*) M->levels[n];
+      level->lambda = lambda;
+      level->setupSmoother();
+    }
+
+    //the degree 1 level is the matrix handed to AMG
+    elliptic_t *ellipticCoarse = ((MGLevel*) M->levels[M->AMGstartLev])->elliptic;
+    ellipticRefreshAMG(elliptic, ellipticCoarse, M, lambda);
+
+  } else if(options.compareArgs("PRECONDITIONER", "SEMFEM")) {
+
+    //the assembled SEMFEM matrix is not kept, the preconditioner stays at the setup lambda
+    if (mesh->rank==0)
+      printf("ellipticPreconditionerUpdate: assembled SEMFEM keeps the setup lambda\n");
+
+  } else if(options.compareArgs("PRECONDITIONER", "JACOBI")) {
+
+    dfloat *invDiagA;
+    ellipticBuildJacobi(elliptic,lambda,&invDiagA);
+    precon->o_invDiagA.copyFrom(invDiagA);
+    free(invDiagA);
+  }
+}
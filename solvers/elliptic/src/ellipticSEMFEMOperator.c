@@ -0,0 +1,218 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "elliptic.h"
+
+int ellipticSEMFEMMatrixFreeSupported(elliptic_t *elliptic){
+
+  return (elliptic->options.compareArgs("SEMFEM SOLVER","MATRIXFREE")
+          && elliptic->options.compareArgs("DISCRETIZATION","CONTINUOUS")
+          && (elliptic->elementType==HEXAHEDRA
+              || (elliptic->elementType==QUADRILATERALS && elliptic->dim==2)));
+}
+
+/* Apply the low-order SEMFEM operator, i.e. the bilinear/trilinear FEM operator
+   on the sub-mesh of GLL nodes, without assembling it. Matches the matrix built
+   by BuildFEMMatrixQuad2D/Hex3D up to the masking of Dirichlet nodes. */
+void ellipticSEMFEMOperator(elliptic_t *elliptic, dfloat lambda, occa::memory &o_q, occa::memory &o_Aq){
+
+  mesh_t *mesh = elliptic->mesh;
+  precon_t *precon = elliptic->precon;
+  ogs_t *ogs = elliptic->ogs;
+
+  dfloat alpha = 0., alphaG = 0.;
+  dlong Nblock = elliptic->Nblock;
+  dfloat *tmp = elliptic->tmp;
+  occa::memory &o_tmp = elliptic->o_tmp;
+
+  if(mesh->NglobalGatherElements)
+    precon->SEMFEMAxKernel(mesh->NglobalGatherElements, mesh->o_globalGatherElementList,
+                           mesh->o_x, mesh->o_y, mesh->o_z, lambda, o_q, o_Aq);
+
+  ogsGatherScatterStart(o_Aq, ogsDfloat, ogsAdd, ogs);
+
+  if(mesh->NlocalGatherElements)
+    precon->SEMFEMAxKernel(mesh->NlocalGatherElements, mesh->o_localGatherElementList,
+                           mesh->o_x, mesh->o_y, mesh->o_z, lambda, o_q, o_Aq);
+
+  ogsGatherScatterFinish(o_Aq, ogsDfloat, ogsAdd, ogs);
+
+  if(elliptic->allNeumann) {
+    elliptic->innerProductKernel(mesh->Nelements*mesh->Np, elliptic->o_invDegree, o_q, o_tmp);
+    o_tmp.copyTo(tmp);
+
+    for(dlong n=0;n<Nblock;++n)
+      alpha += tmp[n];
+
+    MPI_Allreduce(&alpha, &alphaG, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    alphaG *= elliptic->allNeumannPenalty*elliptic->allNeumannScale*elliptic->allNeumannScale;
+
+    mesh->addScalarKernel(mesh->Nelements*mesh->Np, alphaG, o_Aq);
+  }
+
+  //post-mask
+  if (elliptic->Nmasked)
+    mesh->maskKernel(elliptic->Nmasked, elliptic->o_maskIds, o_Aq);
+}
+
+// diagonal of a bilinear sub-element operator, vertices in tensor order v = a + 2*b
+static void SEMFEMSubElementDiagQuad2D(dfloat *xv, dfloat *yv, dfloat lambda, dfloat *diag){
+
+  for(int v=0;v<4;++v) diag[v] = 0.;
+
+  for(int k=0;k<4;++k){
+    const int k0r = k&2, k1r = k|1;
+    const int k0s = k&1, k1s = k|2;
+
+    const dfloat xr = 0.5*(xv[k1r]-xv[k0r]), yr = 0.5*(yv[k1r]-yv[k0r]);
+    const dfloat xs = 0.5*(xv[k1s]-xv[k0s]), ys = 0.5*(yv[k1s]-yv[k0s]);
+
+    const dfloat J = xr*ys - xs*yr;
+
+    const dfloat G00 =  (ys*ys + xs*xs)/J;
+    const dfloat G01 = -(ys*yr + xs*xr)/J;
+    const dfloat G11 =  (yr*yr + xr*xr)/J;
+
+    // vertex k couples to itself and to its neighbors along r and s
+    diag[k]     += 0.25*(G00 + G11) + 0.5*((k&1)?1.:-1.)*((k&2)?1.:-1.)*G01 + lambda*J;
+    diag[k^1]   += 0.25*G00;
+    diag[k^2]   += 0.25*G11;
+  }
+}
+
+// diagonal of a trilinear sub-element operator, vertices in tensor order v = a + 2*b + 4*c
+static void SEMFEMSubElementDiagHex3D(dfloat *xv, dfloat *yv, dfloat *zv, dfloat lambda, dfloat *diag){
+
+  for(int v=0;v<8;++v) diag[v] = 0.;
+
+  for(int k=0;k<8;++k){
+    const int k0r = k&6, k1r = k|1;
+    const int k0s = k&5, k1s = k|2;
+    const int k0t = k&3, k1t = k|4;
+
+    const dfloat xr = 0.5*(xv[k1r]-xv[k0r]), yr = 0.5*(yv[k1r]-yv[k0r]), zr = 0.5*(zv[k1r]-zv[k0r]);
+    const dfloat xs = 0.5*(xv[k1s]-xv[k0s]), ys = 0.5*(yv[k1s]-yv[k0s]), zs = 0.5*(zv[k1s]-zv[k0s]);
+    const dfloat xt = 0.5*(xv[k1t]-xv[k0t]), yt = 0.5*(yv[k1t]-yv[k0t]), zt = 0.5*(zv[k1t]-zv[k0t]);
+
+    const dfloat J = xr*(ys*zt-zs*yt) - yr*(xs*zt-zs*xt) + zr*(xs*yt-ys*xt);
+
+    const dfloat Jrx =  (ys*zt - zs*yt), Jry = -(xs*zt - zs*xt), Jrz =  (xs*yt - ys*xt);
+    const dfloat Jsx = -(yr*zt - zr*yt), Jsy =  (xr*zt - zr*xt), Jsz = -(xr*yt - yr*xt);
+    const dfloat Jtx =  (yr*zs - zr*ys), Jty = -(xr*zs - zr*xs), Jtz =  (xr*ys - yr*xs);
+
+    const dfloat G00 = (Jrx*Jrx + Jry*Jry + Jrz*Jrz)/J;
+    const dfloat G01 = (Jrx*Jsx + Jry*Jsy + Jrz*Jsz)/J;
+    const dfloat G02 = (Jrx*Jtx + Jry*Jty + Jrz*Jtz)/J;
+    const dfloat G11 = (Jsx*Jsx + Jsy*Jsy + Jsz*Jsz)/J;
+    const dfloat G12 = (Jsx*Jtx + Jsy*Jty + Jsz*Jtz)/J;
+    const dfloat G22 = (Jtx*Jtx + Jty*Jty + Jtz*Jtz)/J;
+
+    const dfloat sr = (k&1) ? 1. : -1.;
+    const dfloat ss = (k&2) ? 1. : -1.;
+    const dfloat st = (k&4) ? 1. : -1.;
+
+    // vertex k couples to itself and to its neighbors along r, s, and t
+    diag[k]   += 0.25*(G00 + G11 + G22) + 0.5*(sr*ss*G01 + sr*st*G02 + ss*st*G12) + lambda*J;
+    diag[k^1] += 0.25*G00;
+    diag[k^2] += 0.25*G11;
+    diag[k^4] += 0.25*G22;
+  }
+}
+
+/* Inverse diagonal of the low-order SEMFEM operator for Jacobi smoothing */
+void ellipticBuildSEMFEMJacobi(elliptic_t *elliptic, dfloat lambda, dfloat **invDiagA){
+
+  mesh_t *mesh = elliptic->mesh;
+
+  const int Nq = mesh->N+1;
+  const int NqNq = Nq*Nq;
+
+  if(mesh->rank==0) printf("Building SEMFEM diagonal...");fflush(stdout);
+
+  dfloat *diagA = (dfloat*) calloc(mesh->Np*mesh->Nelements, sizeof(dfloat));
+
+  if (elliptic->elementType==QUADRILATERALS) {
+    #pragma omp parallel for
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int j=0;j<mesh->N;++j){
+        for(int i=0;i<mesh->N;++i){
+          dlong id[4];
+          dfloat xv[4], yv[4], diag[4];
+          for(int v=0;v<4;++v){
+            const int a = v&1, b = (v>>1)&1;
+            id[v] = e*mesh->Np + (i+a) + (j+b)*Nq;
+            xv[v] = mesh->x[id[v]];
+            yv[v] = mesh->y[id[v]];
+          }
+
+          SEMFEMSubElementDiagQuad2D(xv, yv, lambda, diag);
+
+          for(int v=0;v<4;++v) diagA[id[v]] += diag[v];
+        }
+      }
+    }
+  } else if (elliptic->elementType==HEXAHEDRA) {
+    #pragma omp parallel for
+    for(dlong e=0;e<mesh->Nelements;++e){
+      for(int k=0;k<mesh->N;++k){
+        for(int j=0;j<mesh->N;++j){
+          for(int i=0;i<mesh->N;++i){
+            dlong id[8];
+            dfloat xv[8], yv[8], zv[8], diag[8];
+            for(int v=0;v<8;++v){
+              const int a = v&1, b = (v>>1)&1, c = (v>>2)&1;
+              id[v] = e*mesh->Np + (i+a) + (j+b)*Nq + (k+c)*NqNq;
+              xv[v] = mesh->x[id[v]];
+              yv[v] = mesh->y[id[v]];
+              zv[v] = mesh->z[id[v]];
+            }
+
+            SEMFEMSubElementDiagHex3D(xv, yv, zv, lambda, diag);
+
+            for(int v=0;v<8;++v) diagA[id[v]] += diag[v];
+          }
+        }
+      }
+    }
+  }
+
+  ogsGatherScatter(diagA, ogsDfloat, ogsAdd, elliptic->ogs);
+
+  //add the rank boost for the allNeumann Poisson problem
+  if (elliptic->allNeumann) {
+    for(dlong n=0;n<mesh->Np*mesh->Nelements;++n)
+      diagA[n] += elliptic->allNeumannPenalty*elliptic->allNeumannScale*elliptic->allNeumannScale;
+  }
+
+  *invDiagA = (dfloat*) calloc(mesh->Np*mesh->Nelements, sizeof(dfloat));
+  for (dlong n=0;n<mesh->Nelements*mesh->Np;n++) {
+    (*invDiagA)[n] = 1/diagA[n];
+  }
+
+  if(mesh->rank==0) printf("done.\n");
+
+  free(diagA);
+}
@@ -98,6 +98,13 @@ void ellipticSEMFEMSetup(elliptic_t *elliptic, precon_t* precon, dfloat lambda)
     exit(0);
   }
 
+  //quads and hexes share their sub-mesh nodes with the SEM nodes, so the
+  //low-order operator can be applied matrix-free as a multigrid smoother
+  if (ellipticSEMFEMMatrixFreeSupported(elliptic)) {
+    ellipticMultiGridSetup(elliptic, precon, lambda);
+    return;
+  }
+
   mesh_t* mesh = elliptic->mesh; //original mesh
 
   mesh_t* pmesh = (mesh_t*) calloc (1,sizeof(mesh_t)); //partially assembled fem mesh (result of projecting sem element to larger space)
@@ -97,6 +97,43 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
 
 	free(EXYZ);
 	free(gllzw);
+      } else if(options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+
+	// pack gllz, gllw, and elementwise nodal coordinates [x y z]
+	dlong Nxyz = mesh->Nelements*mesh->dim*mesh->Np;
+	dfloat *XYZ = (dfloat*) calloc(Nxyz, sizeof(dfloat));
+	dfloat *gllzw = (dfloat*) calloc(2*mesh->Nq, sizeof(dfloat));
+
+	int sk = 0;
+	for(int n=0;n<mesh->Nq;++n)
+	  gllzw[sk++] = mesh->gllz[n];
+	for(int n=0;n<mesh->Nq;++n)
+	  gllzw[sk++] = mesh->gllw[n];
+
+	for(dlong e=0;e<mesh->Nelements;++e){
+	  for(int n=0;n<mesh->Np;++n){
+	    XYZ[e*mesh->dim*mesh->Np + n              ] = mesh->x[e*mesh->Np+n];
+	    XYZ[e*mesh->dim*mesh->Np + n +   mesh->Np] = mesh->y[e*mesh->Np+n];
+	    XYZ[e*mesh->dim*mesh->Np + n + 2*mesh->Np] = mesh->z[e*mesh->Np+n];
+	  }
+	}
+
+	elliptic->o_XYZ = mesh->device.malloc(Nxyz*sizeof(dfloat), XYZ);
+	elliptic->o_gllzw = mesh->device.malloc(2*mesh->Nq*sizeof(dfloat), gllzw);
+
+	free(XYZ);
+	free(gllzw);
+
+	// bytes of geometric data the Ax kernel streams per application
+	const long long int dfloatBytes = sizeof(dfloat);
+	long long int localBytes[2] = {dfloatBytes*mesh->Nelements*mesh->Np*mesh->Nggeo,
+				       dfloatBytes*Nxyz};
+	long long int globalBytes[2];
+	MPI_Allreduce(localBytes, globalBytes, 2, MPI_LONG_LONG_INT, MPI_SUM, mesh->comm);
+	if(mesh->rank==0)
+	  printf("Ax geometric data: stored ggeo = %lld bytes, on-the-fly nodal coordinates = %lld bytes (%4.2f%%)\n",
+		 globalBytes[0], globalBytes[1],
+		 100.*globalBytes[1]/(double)globalBytes[0]);
       }
     }
   }
@@ -367,6 +404,17 @@ elliptic_t *ellipticSetup(mesh_t *mesh, dfloat lambda, occa::properties &kernelI
     
   }
 
+  // the on-the-fly Ax no longer needs the stored ggeo once the rhs is built; keep
+  // it only for the BK5 stored-ggeo comparison
+  if(elliptic->elementType==HEXAHEDRA
+     && options.compareArgs("DISCRETIZATION","CONTINUOUS")
+     && !options.compareArgs("ELEMENT MAP", "TRILINEAR")
+     && options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")
+     && !options.compareArgs("BENCHMARK", "BK5")){
+    mesh->o_ggeo.free();
+    mesh->o_ggeo = mesh->device.malloc(sizeof(dfloat)); // dummy
+  }
+
   // gather-scatter
  if(options.compareArgs("DISCRETIZATION","CONTINUOUS")){
     ogsGatherScatter(elliptic->o_r, ogsDfloat, ogsAdd, mesh->ogs);
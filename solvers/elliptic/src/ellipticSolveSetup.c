@@ -276,6 +276,9 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
   elliptic->ogs = ogsSetup(Ntotal, mesh->maskedGlobalIds, mesh->comm, 0, verbose, mesh->device);
   elliptic->o_invDegree = elliptic->ogs->o_invDegree;
 
+  if (options.compareArgs("GATHER SCATTER", "BLOCKED"))
+    ogsSetupBlocks(elliptic->ogs, verbose);
+
   /*preconditioner setup */
   elliptic->precon = (precon_t*) calloc(1, sizeof(precon_t));
 
@@ -453,6 +456,8 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
       else{
         if(elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")){
           sprintf(kernelName, "ellipticPartialAxTrilinear%s", suffix);
+        }else if(elliptic->options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+          sprintf(kernelName, "ellipticPartialAxOnTheFly%s", suffix);
         }else{
           sprintf(kernelName, "ellipticPartialAx%s", suffix);
         }
@@ -461,6 +466,13 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
       elliptic->partialAxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
       elliptic->partialFloatAxKernel = mesh->device.buildKernel(fileName,kernelName,floatKernelInfo);
 
+      if(elliptic->elementType==HEXAHEDRA
+         && !elliptic->options.compareArgs("ELEMENT MAP", "TRILINEAR")
+         && elliptic->options.compareArgs("GEOMETRIC FACTORS", "ONTHEFLY")){
+        sprintf(kernelName, "ellipticPartialAx%s", suffix);
+        elliptic->partialStoredAxKernel = mesh->device.buildKernel(fileName,kernelName,dfloatKernelInfo);
+      }
+
       // only for Hex3D - cubature Ax
       if(elliptic->elementType==HEXAHEDRA){
 	printf("BUILDING partialCubatureAxKernel\n");
@@ -542,6 +554,28 @@ void ellipticSolveSetup(elliptic_t *elliptic, dfloat lambda, occa::properties &k
       sprintf(kernelName, "ellipticApproxBlockJacobiSolver");
       elliptic->precon->approxBlockJacobiSolverKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
 
+      if (options.compareArgs("MULTIGRID SMOOTHER","FDM") && ellipticFDMSupported(elliptic)) {
+        int NqFDM = mesh->N+3;
+        kernelInfo["defines/" "p_NqFDM"]= NqFDM;
+        kernelInfo["defines/" "p_NpFDM"]= (elliptic->dim==3) ? NqFDM*NqFDM*NqFDM : NqFDM*NqFDM;
+
+        sprintf(fileName, DELLIPTIC "/okl/ellipticFDM%s.okl", suffix);
+        sprintf(kernelName, "ellipticFDMExtend%s", suffix);
+        elliptic->precon->fdmExtendKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+        sprintf(kernelName, "ellipticFDMSolve%s", suffix);
+        elliptic->precon->fdmSolveKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+
+        sprintf(kernelName, "ellipticFDMRestrict%s", suffix);
+        elliptic->precon->fdmRestrictKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      }
+
+      if (options.compareArgs("PRECONDITIONER","SEMFEM") && ellipticSEMFEMMatrixFreeSupported(elliptic)) {
+        sprintf(fileName, DELLIPTIC "/okl/ellipticSEMFEMAx%s.okl", suffix);
+        sprintf(kernelName, "ellipticPartialSEMFEMAx%s", suffix);
+        elliptic->precon->SEMFEMAxKernel = mesh->device.buildKernel(fileName,kernelName,kernelInfo);
+      }
+
       if (   elliptic->elementType == TRIANGLES
           || elliptic->elementType == TETRAHEDRA) {
         elliptic->precon->SEMFEMInterpKernel =
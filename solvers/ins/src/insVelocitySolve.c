@@ -110,6 +110,13 @@ void insVelocitySolve(ins_t *ins, dfloat time, int stage,  occa::memory o_rhsU,
 
   }
   
+  //lambda changes with the time step (order ramp, adaptive dt), refresh the
+  //preconditioner values instead of rebuilding it
+  ellipticPreconditionerUpdate(usolver, ins->lambda);
+  ellipticPreconditionerUpdate(vsolver, ins->lambda);
+  if (ins->dim==3)
+    ellipticPreconditionerUpdate(wsolver, ins->lambda);
+
   occaTimerTic(mesh->device,"Ux-Solve");
   ins->NiterU = ellipticSolve(usolver, ins->lambda, ins->velTOL, o_rhsU, ins->o_UH);
   occaTimerToc(mesh->device,"Ux-Solve"); 
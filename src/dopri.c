@@ -0,0 +1,287 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "dopri.h"
+
+dopri_t *dopriSetup(mesh_t *mesh, dlong N, dlong Nhalo, occa::properties kernelInfo,
+                    void *solver, dopriRhs_t rhs){
+
+  dopri_t *dopri = (dopri_t*) calloc(1, sizeof(dopri_t));
+
+  dopri->mesh = mesh;
+  dopri->N = N;
+  dopri->Nhalo = Nhalo;
+  dopri->solver = solver;
+  dopri->rhs = rhs;
+
+  hlong localN = N;
+  MPI_Allreduce(&localN, &(dopri->Nglobal), 1, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  // Dormand Prince -order (4) 5 with PID timestep control
+  int Nrk = 7;
+  dfloat rkC[7] = {0.0, 0.2, 0.3, 0.8, 8.0/9.0, 1.0, 1.0};
+  dfloat rkA[7*7] ={             0.0,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
+                                 0.2,             0.0,            0.0,          0.0,             0.0,       0.0, 0.0,
+                            3.0/40.0,        9.0/40.0,            0.0,          0.0,             0.0,       0.0, 0.0,
+                           44.0/45.0,      -56.0/15.0,       32.0/9.0,          0.0,             0.0,       0.0, 0.0,
+                      19372.0/6561.0, -25360.0/2187.0, 64448.0/6561.0, -212.0/729.0,             0.0,       0.0, 0.0,
+                       9017.0/3168.0,     -355.0/33.0, 46732.0/5247.0,   49.0/176.0, -5103.0/18656.0,       0.0, 0.0,
+                          35.0/384.0,             0.0,   500.0/1113.0,  125.0/192.0,  -2187.0/6784.0, 11.0/84.0, 0.0 };
+  dfloat rkE[7] = {71.0/57600.0,  0.0, -71.0/16695.0, 71.0/1920.0, -17253.0/339200.0, 22.0/525.0, -1.0/40.0 };
+
+  dopri->Nrk = Nrk;
+  dopri->rkC = (dfloat*) calloc(Nrk, sizeof(dfloat));
+  dopri->rkE = (dfloat*) calloc(Nrk, sizeof(dfloat));
+  dopri->rkA = (dfloat*) calloc(Nrk*Nrk, sizeof(dfloat));
+  dopri->rkoutB = (dfloat*) calloc(Nrk, sizeof(dfloat));
+
+  memcpy(dopri->rkC, rkC, Nrk*sizeof(dfloat));
+  memcpy(dopri->rkE, rkE, Nrk*sizeof(dfloat));
+  memcpy(dopri->rkA, rkA, Nrk*Nrk*sizeof(dfloat));
+
+  dopri->dtMIN = 1E-9; //minumum allowed timestep
+  dopri->dtMAX = 1E9;  //maximum allowed timestep
+  dopri->ATOL = 1E-6;  //absolute error tolerance
+  dopri->RTOL = 1E-6;  //relative error tolerance
+  dopri->safe = 0.8;   //safety factor
+
+  //error control parameters
+  dopri->beta = 0.05;
+  dopri->factor1 = 0.2;
+  dopri->factor2 = 10.0;
+
+  dopri->exp1 = 0.2 - 0.75*dopri->beta;
+  dopri->invfactor1 = 1.0/dopri->factor1;
+  dopri->invfactor2 = 1.0/dopri->factor2;
+  dopri->facold = 1E-4;
+
+  dopri->o_rkA = mesh->device.malloc(Nrk*Nrk*sizeof(dfloat), dopri->rkA);
+  dopri->o_rkE = mesh->device.malloc(Nrk*sizeof(dfloat), dopri->rkE);
+  dopri->o_rkoutB = mesh->device.malloc(Nrk*sizeof(dfloat), dopri->rkoutB);
+
+  // solvers without their own stages only need the error reduction
+  if(rhs){
+    dopri->o_rkq = mesh->device.malloc((N+Nhalo)*sizeof(dfloat));
+    dopri->o_rkrhsq = mesh->device.malloc(Nrk*N*sizeof(dfloat));
+  }
+
+  dopri->Nblock = (N+DOPRI_BLOCKSIZE-1)/DOPRI_BLOCKSIZE;
+  dlong Nsum = (dopri->Nblock+DOPRI_BLOCKSIZE-1)/DOPRI_BLOCKSIZE;
+  dopri->o_errtmp = mesh->device.malloc(mymax(dopri->Nblock,1)*sizeof(dfloat));
+  dopri->o_errsum = mesh->device.malloc(mymax(Nsum,1)*sizeof(dfloat));
+
+  dopri->fsal = 0;
+
+  kernelInfo["defines/" "p_blockSize"]= DOPRI_BLOCKSIZE;
+  kernelInfo["defines/" "p_Nrk"]= Nrk;
+
+  for (int r=0;r<mesh->size;r++) {
+    if (r==mesh->rank) {
+      dopri->stageKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/dopri.okl", "dopriStage", kernelInfo);
+      dopri->errorEstimateKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/dopri.okl", "dopriErrorEstimate", kernelInfo);
+      dopri->embeddedErrorEstimateKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/dopri.okl", "dopriEmbeddedErrorEstimate", kernelInfo);
+      dopri->outputKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/dopri.okl", "dopriOutput", kernelInfo);
+      dopri->sumKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/sum.okl", "sum", kernelInfo);
+    }
+    MPI_Barrier(mesh->comm);
+  }
+
+  return dopri;
+}
+
+// reduce the block partial sums on the DEVICE, then over all ranks
+static void dopriErrorReduce(dopri_t *dopri){
+
+  occa::memory o_a = dopri->o_errtmp;
+  occa::memory o_b = dopri->o_errsum;
+
+  dlong Nentries = dopri->Nblock;
+  while(Nentries>1){
+    dopri->sumKernel(Nentries, o_a, o_b);
+    Nentries = (Nentries+DOPRI_BLOCKSIZE-1)/DOPRI_BLOCKSIZE;
+
+    occa::memory o_tmp = o_a;
+    o_a = o_b;
+    o_b = o_tmp;
+  }
+
+  dopri->localErr = 0;
+  if(Nentries)
+    o_a.copyTo(&(dopri->localErr), sizeof(dfloat));
+
+  MPI_Allreduce(&(dopri->localErr), &(dopri->globalErr), 1, MPI_DFLOAT, MPI_SUM,
+                dopri->mesh->comm);
+}
+
+void dopriStep(dopri_t *dopri, dfloat time, dfloat dt, occa::memory &o_q){
+
+  const size_t Nbytes = dopri->N*sizeof(dfloat);
+
+  dopri->o_q = o_q;
+  dopri->stageDt = dt;
+
+  // rhsq_0 = F(time, q), reused from the last stage of an accepted step
+  if(!dopri->fsal){
+    dopri->rk = 0;
+    dopri->rhs(dopri->solver, time, o_q, dopri->o_rkrhsq);
+    dopri->fsal = 1;
+  }
+
+  for(int rk=1;rk<dopri->Nrk;++rk){
+
+    // t_rk = t + C_rk*dt
+    dfloat currentTime = time + dopri->rkC[rk]*dt;
+
+    // rkq = q + dt sum_{i=0}^{rk-1} a_{rk,i}*rhsq_i
+    dopri->rk = rk;
+    if(!dopri->fusedStage)
+      dopri->stageKernel(dopri->N,
+                         rk,
+                         dt,
+                         dopri->o_rkA,
+                         o_q,
+                         dopri->o_rkrhsq,
+                         dopri->o_rkq);
+
+    // rhsq_rk = F(currentTime, rkq)
+    occa::memory o_rhsq = dopri->o_rkrhsq + rk*Nbytes;
+    dopri->rhs(dopri->solver, currentTime, dopri->o_rkq, o_rhsq);
+  }
+
+  // the last stage of DOPRI5 is the new solution, so the error
+  //   rkerr = dt*sum_{i=0}^{6} rkE_i*rhsq_i
+  // is only formed inside the block reduction
+  dopri->errorEstimateKernel(dopri->N,
+                             dt,
+                             dopri->ATOL,
+                             dopri->RTOL,
+                             dopri->o_rkE,
+                             o_q,
+                             dopri->o_rkq,
+                             dopri->o_rkrhsq,
+                             dopri->o_errtmp);
+
+  dopriErrorReduce(dopri);
+}
+
+void dopriErrorEstimate(dopri_t *dopri, occa::memory &o_q, occa::memory &o_rkq, occa::memory &o_rkerr){
+
+  dopri->embeddedErrorEstimateKernel(dopri->N,
+                                     dopri->ATOL,
+                                     dopri->RTOL,
+                                     o_q,
+                                     o_rkq,
+                                     o_rkerr,
+                                     dopri->o_errtmp);
+
+  dopriErrorReduce(dopri);
+}
+
+dfloat dopriEstimate(dopri_t *dopri){
+
+  //Error estimation
+  //E. HAIRER, S.P. NORSETT AND G. WANNER, SOLVING ORDINARY
+  //      DIFFERENTIAL EQUATIONS I. NONSTIFF PROBLEMS. 2ND EDITION.
+  return sqrt(dopri->globalErr/dopri->Nglobal);
+}
+
+dfloat dopriController(dopri_t *dopri, dfloat err, dfloat dt){
+
+  dfloat fac1 = pow(err,dopri->exp1);
+
+  if (err<1.0) { //dt is accepted
+    dfloat fac = fac1/pow(dopri->facold,dopri->beta);
+
+    fac = mymax(dopri->invfactor2, mymin(dopri->invfactor1,fac/dopri->safe));
+
+    dopri->facold = mymax(err,1E-4); // hard coded factor ?
+
+    return mymin(dopri->dtMAX, dt/fac);
+  }
+
+  return dt/(mymax(dopri->invfactor1,fac1/dopri->safe));
+}
+
+void dopriAccept(dopri_t *dopri, occa::memory &o_q){
+
+  const size_t Nbytes = dopri->N*sizeof(dfloat);
+
+  o_q.copyFrom(dopri->o_rkq, Nbytes);
+
+  // first same as last
+  dopri->o_rkrhsq.copyFrom(dopri->o_rkrhsq + (dopri->Nrk-1)*Nbytes, Nbytes);
+}
+
+void dopriOutputStep(dopri_t *dopri, dfloat time, dfloat dt, dfloat outTime,
+                     occa::memory &o_q, occa::memory &o_outq){
+
+  double theta = (outTime-time)/dt; //should have 0<theta<=1
+
+  dfloat *rkB = dopri->rkA + 6*dopri->Nrk; //the b array is just the last row of A for DOPRI5
+
+  // continuous extension of DOPRI5, Hairer, Norsett and Wanner II.6
+  const double c = theta*theta*(3-2*theta);
+  const double d = theta*theta*(theta-1)*(theta-1);
+
+  double b[7];
+  b[0] = c*rkB[0] - d*5*((2558722523-31403016*theta)/11282082432) + theta*(theta-1)*(theta-1);
+  b[1] = 0.;
+  b[2] = c*rkB[2] + d*100*((882725551-15701508*theta)/32700410799);
+  b[3] = c*rkB[3] - d*25*((443332067-31403016*theta)/1880347072);
+  b[4] = c*rkB[4] + d*32805*((23143187-3489224*theta)/199316789632);
+  b[5] = c*rkB[5] - d*55*((29972135-7076736*theta)/822651844);
+  b[6] = theta*theta*(theta-1) + d*10*((7414447-829305*theta)/29380423);
+
+  // consistency, the weights must sum to theta
+  double bsum = 0;
+  for(int i=0;i<7;++i){
+    bsum += b[i];
+    dopri->rkoutB[i] = b[i];
+  }
+
+  if(fabs(bsum-theta)>1e-12){
+    printf("ERROR: DOPRI5 dense output weights sum to %g, expected %g\n", bsum, theta);
+    MPI_Abort(dopri->mesh->comm, -1);
+  }
+
+  dopri->o_rkoutB.copyFrom(dopri->rkoutB);
+
+  dopri->outputKernel(dopri->N,
+                      dt,
+                      dopri->o_rkoutB,
+                      o_q,
+                      dopri->o_rkrhsq,
+                      o_outq);
+}
+
+void dopriReset(dopri_t *dopri){
+  dopri->fsal = 0;
+}
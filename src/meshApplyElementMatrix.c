@@ -39,4 +39,23 @@ void meshApplyElementMatrix(mesh_t *mesh, dfloat *A, dfloat *q, dfloat *Aq) {
     for (int n=0;n<mesh->Np;n++) Aq[n+e*mesh->Np] = Aqn[n];
   }
   free(Aqn);
-}
\ No newline at end of file
+}
+
+// same for Nfields fields stored per element as [e][fld][n]
+void meshApplyElementMatrixFields(mesh_t *mesh, int Nfields, dfloat *A, dfloat *q, dfloat *Aq) {
+
+  dfloat *Aqn = (dfloat*) calloc(mesh->Np,sizeof(dfloat));
+  for (dlong e=0;e<mesh->Nelements;e++) {
+    for (int fld=0;fld<Nfields;fld++) {
+      const dlong base = e*mesh->Np*Nfields + fld*mesh->Np;
+      for (int n=0;n<mesh->Np;n++) {
+        Aqn[n] = 0;
+        for (int k=0;k<mesh->Np;k++) {
+          Aqn[n] += A[k+n*mesh->Np]*q[base+k];
+        }
+      }
+      for (int n=0;n<mesh->Np;n++) Aq[base+n] = Aqn[n];
+    }
+  }
+  free(Aqn);
+}
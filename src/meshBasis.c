@@ -28,6 +28,7 @@ SOFTWARE.
 #include <stdlib.h>
 #include "mpi.h"
 #include <math.h>
+#include "mesh.h"
 
 extern "C"
 {
@@ -43,7 +44,8 @@ void readDfloatArray(FILE *fp, const char *label, dfloat **A, int *Nrows, int* N
 void readIntArray(FILE *fp, const char *label, int **A, int *Nrows, int* Ncols);
 
 void meshMassMatrix(int Np, dfloat *V, dfloat **MM);
-int meshVandermonde1D(int N, int Npoints, dfloat *r, dfloat **V, dfloat **Vr);
+
+// the orthonormal bases and Vandermonde matrices come from meshVandermonde.c
 
 dfloat mygamma(dfloat x){
 
@@ -174,317 +176,6 @@ int meshJacobiGL(dfloat alpha, dfloat beta, int N, dfloat **x, dfloat **w){
 
 
 
-dfloat meshJacobiP(dfloat a, dfloat alpha, dfloat beta, int N){
-  
-  dfloat ax = a; 
-
-  dfloat *P = (dfloat *) calloc((N+1), sizeof(dfloat));
-
-  // Zero order
-  dfloat gamma0 = pow(2,(alpha+beta+1))/(alpha+beta+1)*mygamma(1+alpha)*mygamma(1+beta)/mygamma(1+alpha+beta);
-  dfloat p0     = 1.0/sqrt(gamma0);
-
-  if (N==0){ free(P); return p0;}
-  P[0] = p0; 
-
-  // first order
-  dfloat gamma1 = (alpha+1)*(beta+1)/(alpha+beta+3)*gamma0;
-  dfloat p1     = ((alpha+beta+2)*ax/2 + (alpha-beta)/2)/sqrt(gamma1);
-  if (N==1){free(P); return p1;} 
-
-  P[1] = p1;
-
-  /// Repeat value in recurrence.
-  dfloat aold = 2/(2+alpha+beta)*sqrt((alpha+1.)*(beta+1.)/(alpha+beta+3.));
-  /// Forward recurrence using the symmetry of the recurrence.
-  for(int i=1;i<=N-1;++i){
-    dfloat h1 = 2.*i+alpha+beta;
-    dfloat anew = 2./(h1+2.)*sqrt( (i+1.)*(i+1.+alpha+beta)*(i+1+alpha)*(i+1+beta)/(h1+1)/(h1+3));
-    dfloat bnew = -(alpha*alpha-beta*beta)/h1/(h1+2);
-    P[i+1] = 1./anew*( -aold*P[i-1] + (ax-bnew)*P[i]);
-    aold =anew;
-  }
-  
-  dfloat pN = P[N]; 
-  free(P);
-  return pN;
-
-}
-
-dfloat meshGradJacobiP(dfloat a, dfloat alpha, dfloat beta, int N){
-
-  dfloat PNr = 0;
-
-  if(N>0)
-    PNr = sqrt(N*(N+alpha+beta+1.))*meshJacobiP(a, alpha+1.0, beta+1.0, N-1);
-
-  return PNr;
-}
-
-
-void meshOrthonormalBasis1D(dfloat a, int i, dfloat *P, dfloat *Pr){
-  // 
-  dfloat p1 = meshJacobiP(a,0,0,i);
-  dfloat p1a = meshGradJacobiP(a,0,0,i);
-
-  *P = p1;
-  *Pr = p1a;
-}
-
-
-void meshOrthonormalBasisTri2D(dfloat a, dfloat b, int i, int j, dfloat *P, dfloat *Pr, dfloat *Ps){
-  // 
-  dfloat p1 = meshJacobiP(a,0,0,i);
-  dfloat p2 = meshJacobiP(b,2*i+1,0,j);
-
-  dfloat p1a = meshGradJacobiP(a,0,0,i);
-  dfloat p2b = meshGradJacobiP(b,2*i+1,0,j);
-
-  *P = sqrt(2.0)*p1*p2*pow(1.0-b,i);
-
-  *Pr = p1a*p2;
-  if(i>0)
-    *Pr *= pow(0.5*(1.0-b),i-1);
-
-  *Ps = p1a*p2*0.5*(1.0+a);
-  if(i>0)
-    *Ps *= pow(0.5*(1.0-b),i-1);
-
-  dfloat tmp = p2b*pow(0.5*(1.0-b), i);
-  if(i>0)
-    tmp -= 0.5*i*p2*pow(0.5*(1.0-b), i-1);
-
-  *Ps += p1*tmp;
-
-  // normalize
-  *Pr *= pow(2.0, i+0.5);
-  *Ps *= pow(2.0, i+0.5);
-  
-}
-
-void meshOrthonormalBasisQuad2D(dfloat a, dfloat b, int i, int j, dfloat *P, dfloat *Pr, dfloat *Ps){
-  // 
-  dfloat p1 = meshJacobiP(a,0,0,i);
-  dfloat p2 = meshJacobiP(b,0,0,j);
-  dfloat p1a = meshGradJacobiP(a,0,0,i);
-  dfloat p2b = meshGradJacobiP(b,0,0,j);
-
-  *P = p1*p2;
-  *Pr = p1a*p2;
-  *Ps = p1*p2b;
-  
-}
-
-// TW: check normalization
-void meshOrthonormalBasisTet3D(dfloat a, dfloat b, dfloat c, int i, int j, int k, dfloat *P, dfloat *Pr, dfloat *Ps, dfloat *Pt){
-  // 
-  dfloat p1 = meshJacobiP(a,0,0,i);
-  dfloat p2 = meshJacobiP(b,2*i+1,0,j);
-  dfloat p3 = meshJacobiP(c,2*(i+j)+2,0,k);
-
-  dfloat p1a = meshGradJacobiP(a,0,0,i);
-  dfloat p2b = meshGradJacobiP(b,2*i+1,0,j);
-  dfloat p3c = meshGradJacobiP(c,2*(i+j)+2,0,k);
-
-  *P = 2.*sqrt(2.0)*p1*p2*p3*pow(1.0-b,i)*pow(1.0-c,i+j);
-
-  *Pr = p1a*p2*p3;
-  if(i>0)
-    *Pr *= pow(0.5*(1.0-b), i-1);
-  if(i+j>0)
-    *Pr *= pow(0.5*(1.0-c), i+j-1);
-
-  *Ps = 0.5*(1.0+a)*(*Pr);
-  dfloat tmp = p2b*pow(0.5*(1.0-b), i);
-  if(i>0)
-    tmp += -0.5*i*p2*pow(0.5*(1.0-b), i-1);
-  if(i+j>0)
-    tmp *= pow(0.5*(1.0-c), i+j-1);
-  tmp *= p1*p3;
-  *Ps += tmp;
-
-  *Pt = 0.5*(1.0+a)*(*Pr) + 0.5*(1.0+b)*tmp;
-  tmp = p3c*pow(0.5*(1-c), i+j);
-  if(i+j>0)
-    tmp -= 0.5*(i+j)*(p3*pow(0.5*(1.0-c), i+j-1));
-  tmp *= p1*p2*pow(0.5*(1-b), i);
-  *Pt += tmp;
-
-  *Pr *= pow(2, 2*i+j+1.5);
-  *Ps *= pow(2, 2*i+j+1.5);
-  *Pt *= pow(2, 2*i+j+1.5);
-
-}
-
-void meshOrthonormalBasisHex3D(dfloat a, dfloat b, dfloat c, int i, int j, int k, dfloat *P, dfloat *Pr, dfloat *Ps, dfloat *Pt){
-  // 
-  dfloat p1 = meshJacobiP(a,0,0,i);
-  dfloat p2 = meshJacobiP(b,0,0,j);
-  dfloat p3 = meshJacobiP(c,0,0,k);
-  dfloat p1a = meshGradJacobiP(a,0,0,i);
-  dfloat p2b = meshGradJacobiP(b,0,0,j);
-  dfloat p3c = meshGradJacobiP(c,0,0,k);
-
-  *P = p1*p2*p3;
-  *Pr = p1a*p2*p3;
-  *Ps = p1*p2b*p3;
-  *Pt = p1*p2*p3c;
-  
-}
-
-
-int meshVandermonde1D(int N, int Npoints, dfloat *r, dfloat **V, dfloat **Vr){
-
-  int Np = (N+1);
-  
-  *V  = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vr = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-
-  for(int n=0; n<Npoints; n++){
-
-    int sk = 0;
-    for(int i=0; i<=N; i++){
-      int id = n*Np+sk;
-      meshOrthonormalBasis1D(r[n], i, V[0]+id, Vr[0]+id);
-      sk++;
-    }
-  }
-  
-  return Np;
-}
-
-
-
-int meshVandermondeTri2D(int N, int Npoints, dfloat *r, dfloat *s, dfloat **V, dfloat **Vr, dfloat **Vs){
-
-  int Np = (N+1)*(N+2)/2;
-  
-  *V  = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vr = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vs = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-
-  for(int n=0; n<Npoints; n++){
-
-    dfloat a, b;
-    
-    // First convert to ab coordinates
-    if(fabs(s[n]-1.0)>1e-8)
-      a = 2.0*(1.+r[n])/(1.0-s[n])-1.0;
-    else
-      a = -1.0; 
-    
-    b = s[n];
-    
-    int sk=0;
-    for(int i=0; i<=N; i++){
-      for(int j=0; j<=N-i; j++){
-	int id = n*Np+sk;
-	meshOrthonormalBasisTri2D(a, b, i, j, V[0]+id,Vr[0]+id, Vs[0]+id);
-	sk++;
-      }
-    }
-  }
-
-  return Np;
-}
-
-
-int meshVandermondeQuad2D(int N, int Npoints, dfloat *r, dfloat *s, dfloat **V, dfloat **Vr, dfloat **Vs){
-
-  int Np = (N+1)*(N+1);
-  
-  *V  = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vr = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vs = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-
-  for(int n=0; n<Npoints; n++){
-
-    int sk = 0;
-    for(int i=0; i<=N; i++){
-      for(int j=0; j<=N; j++){
-	int id = n*Np+sk;
-	meshOrthonormalBasisQuad2D(r[n], s[n], i, j, V[0]+id, Vr[0]+id, Vs[0]+id);
-	sk++;
-      }
-    }
-  }
-
-  return Np;
-}
-
-
-
-int meshVandermondeTet3D(int N, int Npoints, dfloat *r, dfloat *s, dfloat *t,
-			  dfloat **V, dfloat **Vr, dfloat **Vs, dfloat **Vt){
-
-  int Np = (N+1)*(N+2)*(N+3)/6; 
-
-  *V  = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vr = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vs = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vt = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  
-  for(int n=0; n<Npoints; n++){
-    // First convert to abc coordinates
-    dfloat a, b, c;
-    
-    if(fabs(s[n]+t[n])>1e-8)
-      a = 2.0*(1.+r[n])/(-s[n]-t[n])-1.0;
-    else
-      a = -1.0; 
-
-    if(fabs(t[n]-1)>1e-8)
-      b = 2.0*(1+s[n])/(1.-t[n])-1.0;
-    else
-      b = -1.;
-    
-    c = t[n];
-
-    int sk=0;
-    for(int i=0; i<=N; i++){
-      for(int j=0; j<=N-i; j++){
-	for(int k=0; k<=N-i-j; k++){
-	  int id = n*Np+sk;	
-	  meshOrthonormalBasisTet3D(a, b, c, i, j, k, V[0]+id, Vr[0]+id, Vs[0]+id, Vt[0]+id);
-	  sk++;
-	}
-      }
-    }
-  }
-
-  return Np;
-}
-
-
-int meshVandermondeHex3D(int N, int Npoints, dfloat *r, dfloat *s, dfloat *t, dfloat **V, dfloat **Vr, dfloat **Vs, dfloat **Vt){
-
-  int Np = (N+1)*(N+1)*(N+1);
-  
-  *V  = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vr = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vs = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-  *Vt = (dfloat *) calloc(Npoints*Np, sizeof(dfloat));
-
-  for(int n=0; n<Npoints; n++){
-
-    int sk = 0;
-    for(int i=0; i<=N; i++){
-      for(int j=0; j<=N; j++){
-	for(int k=0; k<=N; k++){
-	  int id = n*Np+sk;
-	  meshOrthonormalBasisHex3D(r[n], s[n], t[n], i, j, k, V[0]+id, Vr[0]+id, Vs[0]+id, Vt[0]+id);
-	  sk++;
-	}
-      }
-    }
-  }
-
-  return Np;
-}
-
-
-// C = A/B  = trans(trans(B)\trans(A))
-// assume row major
 void matrixRightSolve(int NrowsA, int NcolsA, dfloat *A, int NrowsB, int NcolsB, dfloat *B, dfloat *C){
 
   int info;
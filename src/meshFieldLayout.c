@@ -0,0 +1,185 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "mesh.h"
+
+void meshFieldLayoutSetup(mesh_t *mesh, setupAide &options, occa::properties &kernelInfo){
+
+  const dlong Ntotal = mesh->Nelements + mesh->totalHaloPairs;
+
+  mesh->fieldLayout = FIELD_LAYOUT_AOS;
+  mesh->fieldBlock  = 1;
+
+  if(options.compareArgs("FIELD LAYOUT", "AOSOA")){
+    mesh->fieldLayout = FIELD_LAYOUT_AOSOA;
+    mesh->fieldBlock  = 8;
+    options.getArgs("FIELD BLOCK", mesh->fieldBlock);
+    if(mesh->fieldBlock<1) mesh->fieldBlock = 1;
+  } else if(options.compareArgs("FIELD LAYOUT", "SOA")){
+    mesh->fieldLayout = FIELD_LAYOUT_SOA;
+  }
+
+  // elements stored per field, a partial last block is padded
+  mesh->fieldNelements = mesh->fieldBlock*((Ntotal+mesh->fieldBlock-1)/mesh->fieldBlock);
+
+  if(mesh->fieldLayout==FIELD_LAYOUT_SOA)
+    mesh->fieldStride = mesh->fieldNelements*mesh->Np;
+  else if(mesh->fieldLayout==FIELD_LAYOUT_AOSOA)
+    mesh->fieldStride = mesh->fieldBlock*mesh->Np;
+  else
+    mesh->fieldStride = mesh->Np;
+
+  kernelInfo["defines/" "p_fieldLayout"]= mesh->fieldLayout;
+  kernelInfo["defines/" "p_fieldBlock"]= mesh->fieldBlock;
+  kernelInfo["defines/" "p_fieldStride"]= mesh->fieldStride;
+  kernelInfo["includes"] += DHOLMES "/okl/meshFieldLayout.h";
+
+  mesh->fieldHaloExtractKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshFieldHalo.okl", "meshFieldHaloExtract", kernelInfo);
+
+  mesh->fieldHaloScatterKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshFieldHalo.okl", "meshFieldHaloScatter", kernelInfo);
+
+  mesh->fieldHaloTraceExtractKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshFieldHalo.okl", "meshFieldHaloTraceExtract", kernelInfo);
+
+  mesh->fieldHaloTracePutKernel =
+    mesh->device.buildKernel(DHOLMES "/okl/meshFieldHalo.okl", "meshFieldHaloTracePut", kernelInfo);
+}
+
+dlong meshFieldId(mesh_t *mesh, int Nfields, dlong e, int fld, int n){
+
+  if(mesh->fieldLayout==FIELD_LAYOUT_SOA)
+    return e*mesh->Np + n + fld*mesh->fieldStride;
+
+  if(mesh->fieldLayout==FIELD_LAYOUT_AOSOA)
+    return (e/mesh->fieldBlock)*mesh->fieldBlock*mesh->Np*Nfields
+      + (e%mesh->fieldBlock)*mesh->Np + n + fld*mesh->fieldStride;
+
+  return e*mesh->Np*Nfields + fld*mesh->Np + n;
+}
+
+dlong meshFieldNentries(mesh_t *mesh, int Nfields){
+  return mesh->fieldNelements*mesh->Np*Nfields;
+}
+
+void meshFieldCopyTo(mesh_t *mesh, int Nfields, occa::memory &o_q, dfloat *q){
+
+  if(mesh->fieldLayout==FIELD_LAYOUT_AOS){
+    o_q.copyTo(q, mesh->Nelements*mesh->Np*Nfields*sizeof(dfloat), 0);
+    return;
+  }
+
+  dfloat *qL = (dfloat*) calloc(meshFieldNentries(mesh, Nfields), sizeof(dfloat));
+  o_q.copyTo(qL, meshFieldNentries(mesh, Nfields)*sizeof(dfloat), 0);
+
+  for(dlong e=0;e<mesh->Nelements;++e)
+    for(int fld=0;fld<Nfields;++fld)
+      for(int n=0;n<mesh->Np;++n)
+        q[e*mesh->Np*Nfields + fld*mesh->Np + n] = qL[meshFieldId(mesh, Nfields, e, fld, n)];
+
+  free(qL);
+}
+
+void meshFieldCopyFrom(mesh_t *mesh, int Nfields, dfloat *q, occa::memory &o_q){
+
+  if(mesh->fieldLayout==FIELD_LAYOUT_AOS){
+    o_q.copyFrom(q, mesh->Nelements*mesh->Np*Nfields*sizeof(dfloat), 0);
+    return;
+  }
+
+  // keep the halo and padding entries of o_q
+  dfloat *qL = (dfloat*) calloc(meshFieldNentries(mesh, Nfields), sizeof(dfloat));
+  o_q.copyTo(qL, meshFieldNentries(mesh, Nfields)*sizeof(dfloat), 0);
+
+  for(dlong e=0;e<mesh->Nelements;++e)
+    for(int fld=0;fld<Nfields;++fld)
+      for(int n=0;n<mesh->Np;++n)
+        qL[meshFieldId(mesh, Nfields, e, fld, n)] = q[e*mesh->Np*Nfields + fld*mesh->Np + n];
+
+  o_q.copyFrom(qL, meshFieldNentries(mesh, Nfields)*sizeof(dfloat), 0);
+
+  free(qL);
+}
+
+void meshFieldHaloExtract(mesh_t *mesh, int Nfields, occa::memory &o_q, occa::memory &o_haloBuffer){
+
+  if(mesh->totalHaloPairs)
+    mesh->fieldHaloExtractKernel(mesh->totalHaloPairs, Nfields, mesh->o_haloElementList,
+                                 o_q, o_haloBuffer);
+}
+
+void meshFieldHaloScatter(mesh_t *mesh, int Nfields, dfloat *recvBuffer,
+                          occa::memory &o_haloBuffer, occa::memory &o_q){
+
+  if(!mesh->totalHaloPairs) return;
+
+  size_t haloBytes = mesh->totalHaloPairs*mesh->Np*Nfields*sizeof(dfloat);
+
+  // element-major halo elements follow the local elements
+  if(mesh->fieldLayout==FIELD_LAYOUT_AOS){
+    o_q.copyFrom(recvBuffer, haloBytes, mesh->Nelements*mesh->Np*Nfields*sizeof(dfloat));
+    return;
+  }
+
+  o_haloBuffer.copyFrom(recvBuffer, haloBytes, 0);
+  mesh->fieldHaloScatterKernel(mesh->totalHaloPairs, Nfields, mesh->Nelements,
+                               o_haloBuffer, o_q);
+}
+
+void meshFieldHaloTraceExtract(mesh_t *mesh, int Narrays, int *Nfields,
+                               occa::memory *o_q, occa::memory &o_haloBuffer){
+
+  if(!mesh->totalHaloPairs) return;
+
+  int Nmessage = 0;
+  for(int a=0;a<Narrays;++a) Nmessage += Nfields[a];
+
+  int fieldOffset = 0;
+  for(int a=0;a<Narrays;++a){
+    mesh->fieldHaloTraceExtractKernel(mesh->totalHaloPairs, Nfields[a], fieldOffset, Nmessage,
+                                      mesh->o_haloGetNodeIds, o_q[a], o_haloBuffer);
+    fieldOffset += Nfields[a];
+  }
+}
+
+void meshFieldHaloTracePut(mesh_t *mesh, int Narrays, int *Nfields, dfloat *recvBuffer,
+                           occa::memory &o_haloBuffer, occa::memory *o_q){
+
+  if(!mesh->totalHaloPairs) return;
+
+  int Nmessage = 0;
+  for(int a=0;a<Narrays;++a) Nmessage += Nfields[a];
+
+  o_haloBuffer.copyFrom(recvBuffer, mesh->totalHaloPairs*mesh->Nfp*Nmessage*sizeof(dfloat), 0);
+
+  int fieldOffset = 0;
+  for(int a=0;a<Narrays;++a){
+    mesh->fieldHaloTracePutKernel(mesh->totalHaloPairs, Nfields[a], fieldOffset, Nmessage,
+                                  mesh->o_haloPutNodeIds, o_haloBuffer, o_q[a]);
+    fieldOffset += Nfields[a];
+  }
+}
@@ -124,22 +124,29 @@ void meshHaloSetup(mesh_t *mesh){
   for(dlong i=0;i<mesh->totalHaloPairs;++i){
     dlong e = haloElements[i].element;
     int fM = haloElements[i].face;
-    int fP = haloElements[i].faceN;
     for(int n=0;n<mesh->Nfp;++n){
       mesh->haloGetNodeIds[cnt] = e*mesh->Np + mesh->faceNodes[fM*mesh->Nfp+n];
-      mesh->haloPutNodeIds[cnt] = (mesh->Nelements+i)*mesh->Np + mesh->faceNodes[fP*mesh->Nfp+n];
       ++cnt;
     }
   }
+
   // reconnect elements to ghost elements
   // (ghost elements appended to end of local element list)
+  // incoming traces arrive in this local order, so the ghost element in
+  // slot cnt receives the trace of the neighbour face EToF[ef]
   cnt = mesh->Nelements;
   for(int r=0;r<size;++r){
     for(dlong e=0;e<mesh->Nelements;++e){
       for(int f=0;f<mesh->Nfaces;++f){
         dlong ef = e*mesh->Nfaces+f;
-        if(mesh->EToP[ef]==r)
+        if(mesh->EToP[ef]==r){
+          const dlong i = cnt-mesh->Nelements;
+          const int fP = mesh->EToF[ef];
+          for(int n=0;n<mesh->Nfp;++n)
+            mesh->haloPutNodeIds[i*mesh->Nfp+n] = cnt*mesh->Np + mesh->faceNodes[fP*mesh->Nfp+n];
+
           mesh->EToE[ef] = cnt++;
+        }
       }
     }
   }
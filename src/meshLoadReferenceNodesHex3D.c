@@ -34,12 +34,7 @@ void meshLoadReferenceNodesHex3D(mesh3D *mesh, int N){
   char fname[BUFSIZ];
   sprintf(fname, DHOLMES "/nodes/hexN%02d.dat", N);
 
-  FILE *fp = fopen(fname, "r");
-
-  if (!fp) {
-    printf("ERROR: Cannot open file: '%s'\n", fname);
-    exit(-1);
-  }
+  referenceData_t *fp = meshReferenceDataLoad(fname);
 
   mesh->N = N;
   mesh->Nq = N+1;
@@ -134,8 +129,6 @@ void meshLoadReferenceNodesHex3D(mesh3D *mesh, int N){
   readDfloatArray(fp, "GLL to Gauss Legendre differentiation matrix", &(mesh->gjD), &Nrows, &Ncols);   
   readDfloatArray(fp, "Gauss Legendre to Gauss Legendre differentiation matrix", &(mesh->gjD2), &Nrows, &Ncols);   
 
-  fclose(fp);
-
   // find node indices of vertex nodes
   dfloat NODETOL = 1e-6;
   mesh->vertexNodes = (int*) calloc(mesh->Nverts, sizeof(int));
@@ -33,12 +33,7 @@ void meshLoadReferenceNodesQuad2D(mesh2D *mesh, int N){
   char fname[BUFSIZ];
   sprintf(fname, DHOLMES "/nodes/quadrilateralN%02d.dat", N);
 
-  FILE *fp = fopen(fname, "r");
-
-  if (!fp) {
-    printf("ERROR: Cannot open file: '%s'\n", fname);
-    exit(-1);
-  }
+  referenceData_t *fp = meshReferenceDataLoad(fname);
 
   mesh->N = N;
   mesh->Nfp = N+1;
@@ -111,8 +106,6 @@ void meshLoadReferenceNodesQuad2D(mesh2D *mesh, int N){
   mesh->NelFEM = Nrows;
   mesh->NpFEM = mesh->Np;
 
-  fclose(fp);
-
   // find node indices of vertex nodes
   dfloat NODETOL = 1e-6;
   mesh->vertexNodes = (int*) calloc(mesh->Nverts, sizeof(int));
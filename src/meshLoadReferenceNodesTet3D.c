@@ -33,12 +33,7 @@ void meshLoadReferenceNodesTet3D(mesh3D *mesh, int N){
   char fname[BUFSIZ];
   sprintf(fname, DHOLMES "/nodes/tetN%02d.dat", N);
 
-  FILE *fp = fopen(fname, "r");
-
-  if (!fp) {
-    printf("ERROR: Cannot open file: '%s'\n", fname);
-    exit(-1);
-  }
+  referenceData_t *fp = meshReferenceDataLoad(fname);
 
   mesh->N = N;
   mesh->Np = ((N+1)*(N+2)*(N+3))/6;
@@ -144,7 +139,6 @@ void meshLoadReferenceNodesTet3D(mesh3D *mesh, int N){
   readDfloatArray(fp, "SEMFEM interpolation matrix", &(mesh->SEMFEMInterp),&Nrows,&Ncols);
 
 
-  fclose(fp);
 
   // find node indices of vertex nodes
   dfloat NODETOL = 1e-6;
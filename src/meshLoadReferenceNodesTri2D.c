@@ -34,12 +34,7 @@ void meshLoadReferenceNodesTri2D(mesh2D *mesh, int N){
   char fname[BUFSIZ];
   sprintf(fname, DHOLMES "/nodes/triangleN%02d.dat", N);
 
-  FILE *fp = fopen(fname, "r");
-
-  if (!fp) {
-    printf("ERROR: Cannot open file: '%s'\n", fname);
-    exit(-1);
-  }
+  referenceData_t *fp = meshReferenceDataLoad(fname);
 
   mesh->N = N;
   mesh->Nfp = N+1;
@@ -133,8 +128,6 @@ void meshLoadReferenceNodesTri2D(mesh2D *mesh, int N){
   readDfloatArray(fp, "Sparse differentiation Sss values", &(mesh->sparseSssT), &Nrows, &Ncols);
   mesh->SparseNnzPerRow = Nrows;
 
-  fclose(fp);
-
   // find node indices of vertex nodes
   dfloat NODETOL = 1e-6;
   mesh->vertexNodes = (int*) calloc(mesh->Nverts, sizeof(int));
@@ -0,0 +1,184 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+
+typedef struct {
+  dlong element;
+  int degree;
+}reorderElement_t;
+
+static int compareReorderDegree(const void *a, const void *b){
+
+  reorderElement_t *ea = (reorderElement_t*) a;
+  reorderElement_t *eb = (reorderElement_t*) b;
+
+  if(ea->degree < eb->degree) return -1;
+  if(ea->degree > eb->degree) return +1;
+
+  if(ea->element < eb->element) return -1;
+  if(ea->element > eb->element) return +1;
+
+  return 0;
+}
+
+static void meshPermuteElementArray(void *v, size_t bytesPerElement,
+                                    dlong Nelements, dlong *newToOld){
+
+  if(!v) return;
+
+  char *vc  = (char*) v;
+  char *tmp = (char*) calloc(Nelements*bytesPerElement, sizeof(char));
+
+  for(dlong e=0;e<Nelements;++e)
+    memcpy(tmp+e*bytesPerElement, vc+newToOld[e]*bytesPerElement, bytesPerElement);
+
+  memcpy(vc, tmp, Nelements*bytesPerElement);
+
+  free(tmp);
+}
+
+/* reorder the elements on this rank for cache locality:
+   - reverse Cuthill-McKee ordering of the local element face graph
+   - elements with no face on another rank are placed first, halo adjacent
+     elements last (keeping their relative RCM order)
+   - if MRAB levels have been assigned the elements are grouped by level
+     (lowest level first) before the interior/halo split
+   must be called after meshParallelConnect; the parallel connectivity is
+   rebuilt for the new ordering so it is consistent across ranks */
+void meshLocalReorder(mesh_t *mesh){
+
+  dlong Nelements = mesh->Nelements;
+  int Nfaces = mesh->Nfaces;
+
+  if(Nelements==0) return;
+
+  int *degree = (int*) calloc(Nelements, sizeof(int));
+  int *isHalo = (int*) calloc(Nelements, sizeof(int));
+
+  for(dlong e=0;e<Nelements;++e){
+    for(int f=0;f<Nfaces;++f){
+      dlong eN = mesh->EToE[e*Nfaces+f];
+      int   rN = mesh->EToP[e*Nfaces+f];
+      if(rN!=-1)
+        isHalo[e] = 1;
+      else if(eN!=-1)
+        ++degree[e];
+    }
+  }
+
+  // BFS start candidates ordered by increasing degree
+  reorderElement_t *candidates =
+    (reorderElement_t*) calloc(Nelements, sizeof(reorderElement_t));
+  for(dlong e=0;e<Nelements;++e){
+    candidates[e].element = e;
+    candidates[e].degree  = degree[e];
+  }
+  qsort(candidates, Nelements, sizeof(reorderElement_t), compareReorderDegree);
+
+  int   *visited = (int*)   calloc(Nelements, sizeof(int));
+  dlong *cmOrder = (dlong*) calloc(Nelements, sizeof(dlong));
+  reorderElement_t *neighbors =
+    (reorderElement_t*) calloc(Nfaces, sizeof(reorderElement_t));
+
+  // Cuthill-McKee breadth first sweep over each connected component
+  dlong Nordered = 0, head = 0;
+  for(dlong c=0;c<Nelements;++c){
+    dlong start = candidates[c].element;
+    if(visited[start]) continue;
+
+    visited[start] = 1;
+    cmOrder[Nordered++] = start;
+
+    while(head<Nordered){
+      dlong e = cmOrder[head++];
+
+      int Nneighbors = 0;
+      for(int f=0;f<Nfaces;++f){
+        dlong eN = mesh->EToE[e*Nfaces+f];
+        if(mesh->EToP[e*Nfaces+f]==-1 && eN!=-1 && !visited[eN]){
+          visited[eN] = 1;
+          neighbors[Nneighbors].element = eN;
+          neighbors[Nneighbors].degree  = degree[eN];
+          ++Nneighbors;
+        }
+      }
+      qsort(neighbors, Nneighbors, sizeof(reorderElement_t), compareReorderDegree);
+
+      for(int n=0;n<Nneighbors;++n)
+        cmOrder[Nordered++] = neighbors[n].element;
+    }
+  }
+
+  // reverse, then move interior elements ahead of halo adjacent elements.
+  // Once MRAB levels are known the elements are first grouped by level, so
+  // the elements of levels 0,..,l-1 are the first elements on this rank
+  const int Nlevels = (mesh->MRABlevel) ? mesh->MRABNlevels : 1;
+
+  dlong *newToOld = (dlong*) calloc(Nelements, sizeof(dlong));
+  dlong cnt = 0;
+  for(int lev=0;lev<Nlevels;++lev){
+    for(dlong n=Nelements-1;n>=0;--n){
+      dlong e = cmOrder[n];
+      int eLevel = (mesh->MRABlevel) ? mesh->MRABlevel[e] : 0;
+      if(eLevel==lev && !isHalo[e]) newToOld[cnt++] = e;
+    }
+    for(dlong n=Nelements-1;n>=0;--n){
+      dlong e = cmOrder[n];
+      int eLevel = (mesh->MRABlevel) ? mesh->MRABlevel[e] : 0;
+      if(eLevel==lev && isHalo[e]) newToOld[cnt++] = e;
+    }
+  }
+
+  // permute element indexed arrays
+  meshPermuteElementArray(mesh->EToV, mesh->Nverts*sizeof(hlong), Nelements, newToOld);
+  meshPermuteElementArray(mesh->EX, mesh->Nverts*sizeof(dfloat), Nelements, newToOld);
+  meshPermuteElementArray(mesh->EY, mesh->Nverts*sizeof(dfloat), Nelements, newToOld);
+  meshPermuteElementArray(mesh->EZ, mesh->Nverts*sizeof(dfloat), Nelements, newToOld);
+  meshPermuteElementArray(mesh->elementInfo, sizeof(int), Nelements, newToOld);
+  meshPermuteElementArray(mesh->MRABlevel, sizeof(int), Nelements, newToOld);
+  meshPermuteElementArray(mesh->partitionWeights, mesh->NpartitionConstraints*sizeof(dfloat),
+                          Nelements, newToOld);
+  meshPermuteElementArray(mesh->migrationSourceRanks, sizeof(int), Nelements, newToOld);
+  meshPermuteElementArray(mesh->migrationSourceIds, sizeof(dlong), Nelements, newToOld);
+
+  // neighbor element indices on other ranks have changed too, so rebuild
+  free(mesh->EToE);
+  free(mesh->EToF);
+  free(mesh->EToP);
+  meshParallelConnect(mesh);
+
+  free(degree);
+  free(isHalo);
+  free(candidates);
+  free(visited);
+  free(cmOrder);
+  free(neighbors);
+  free(newToOld);
+}
@@ -110,7 +110,8 @@ dfloat meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
   printf("MRABNlevels %d \n", mesh->MRABNlevels);
 
   //now we need to perform a weighted repartitioning of the mesh to optimize MRAB
-  if (size>1) {
+  //(unless the mesh already carries a weighted partition, e.g. from runtime load balancing)
+  if (size>1 && !mesh->NpartitionConstraints) {
     //for the moment, just weigth the elements by the number or RHS evals per MRAB step
     // TODO: We should make this an input parameter later to handle other problems. 
     dfloat *weights = (dfloat *) calloc(mesh->Nelements,sizeof(dfloat));
@@ -120,6 +121,9 @@ dfloat meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
     
     if (rank==0) printf("Repartitioning for MRAB...\n");
     meshMRABWeightedPartition2D(mesh,weights,mesh->MRABNlevels, mesh->MRABlevel);
+  } else {
+    //keep the partition, but group the elements on this rank by level
+    meshReconnect2D(mesh);
   }
 
   //construct element and halo lists
@@ -184,6 +188,33 @@ dfloat meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels, dfloat finalT
   }
   MPI_Barrier(mesh->comm);
 
+  //estimated speedup over single rate time stepping: every element would
+  //take 2^(Nlevels-1) steps of size dtGmin per MRAB step, the elements of
+  //level lev only take 2^(Nlevels-1-lev) steps of size dtGmin*2^lev
+  hlong *NlevelElements = (hlong *) calloc(mesh->MRABNlevels,sizeof(hlong));
+  hlong *NglobalLevelElements = (hlong *) calloc(mesh->MRABNlevels,sizeof(hlong));
+  for (int lev=0;lev<mesh->MRABNlevels;lev++) NlevelElements[lev] = mesh->MRABNelements[lev];
+  MPI_Allreduce(NlevelElements, NglobalLevelElements, mesh->MRABNlevels, MPI_HLONG, MPI_SUM, mesh->comm);
+
+  if (rank==0) {
+    double singleRateWork = 0., multiRateWork = 0.;
+    for (int lev=0;lev<mesh->MRABNlevels;lev++) {
+      singleRateWork += NglobalLevelElements[lev]*pow(2,mesh->MRABNlevels-1);
+      multiRateWork  += NglobalLevelElements[lev]*pow(2,mesh->MRABNlevels-1-lev);
+    }
+    printf("| Level |     dt     | Nelements | RHS evaluations per MRAB step | Speedup | \n");
+    printf("------------------------------------------------------------------------\n");
+    for (int lev=0;lev<mesh->MRABNlevels;lev++) {
+      double levelWork = NglobalLevelElements[lev]*pow(2,mesh->MRABNlevels-1-lev);
+      printf("|  %d,  %10.4e,  %lld,  %g,  %g \n", lev, dtGmin*pow(2,lev),
+             (long long int) NglobalLevelElements[lev], levelWork, pow(2,lev));
+    }
+    printf("------------------------------------------------------------------------\n");
+    printf("MRAB estimated speedup over single rate stepping = %g\n", singleRateWork/multiRateWork);
+  }
+  free(NlevelElements);
+  free(NglobalLevelElements);
+
 
   return dtGmin;
 }
@@ -271,7 +302,8 @@ void meshMRABSetup2D(mesh2D *mesh, dfloat *EToDT, int maxLevels) {
   printf("MRABNlevels %d \n", mesh->MRABNlevels);
 
   //now we need to perform a weighted repartitioning of the mesh to optimize MRAB
-  if (size>1) {
+  //(unless the mesh already carries a weighted partition, e.g. from runtime load balancing)
+  if (size>1 && !mesh->NpartitionConstraints) {
     //for the moment, just weigth the elements by the number or RHS evals per MRAB step
     // TODO: We should make this an input parameter later to handle other problems. 
     dfloat *weights = (dfloat *) calloc(mesh->Nelements,sizeof(dfloat));
@@ -141,6 +141,9 @@ void meshMRABWeightedPartition2D(mesh2D *mesh, dfloat *weights,
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // group elements on each rank by MRAB level (interior first in each level)
+  meshLocalReorder(mesh);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
   
@@ -32,15 +32,7 @@ SOFTWARE.
 
 #include "mesh2D.h"
 
-void meshOccaSetup2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kernelInfo){
-
-  // conigure device
-  occaDeviceConfig(mesh, newOptions);
-
-  //make seperate stream for halo exchange
-  mesh->defaultStream = mesh->device.getStream();
-  mesh->dataStream = mesh->device.createStream();
-  mesh->device.setStream(mesh->defaultStream);
+void meshOccaPopulateDevice2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kernelInfo){
 
   // find elements that have all neighbors on this process
   dlong *internalElementIds = (dlong*) calloc(mesh->Nelements, sizeof(dlong));
@@ -514,6 +506,12 @@ void meshOccaSetup2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kern
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
       mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*mesh->Nfields*sizeof(dfloat));
+
+    // node ids 
+    mesh->o_haloGetNodeIds = 
+      mesh->device.malloc(mesh->Nfp*mesh->totalHaloPairs*sizeof(dlong), mesh->haloGetNodeIds);
+    mesh->o_haloPutNodeIds = 
+      mesh->device.malloc(mesh->Nfp*mesh->totalHaloPairs*sizeof(dlong), mesh->haloPutNodeIds);
   }
 
 
@@ -602,3 +600,17 @@ void meshOccaSetup2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kern
   kernelInfo["defines/" "p_IJWID"]= IJWID;
 
 }
+
+void meshOccaSetup2D(mesh2D *mesh, setupAide &newOptions, occa::properties &kernelInfo){
+
+  // conigure device
+  occaDeviceConfig(mesh, newOptions);
+
+  //make seperate stream for halo exchange
+  mesh->defaultStream = mesh->device.getStream();
+  mesh->dataStream = mesh->device.createStream();
+  mesh->device.setStream(mesh->defaultStream);
+
+  meshOccaPopulateDevice2D(mesh, newOptions, kernelInfo);
+
+}
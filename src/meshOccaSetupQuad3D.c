@@ -32,15 +32,7 @@ SOFTWARE.
 
 #include "mesh3D.h"
 
-void meshOccaSetupQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &kernelInfo){
-
-  // conigure device
-  occaDeviceConfig(mesh, newOptions);
-
-  //make seperate stream for halo exchange
-  mesh->defaultStream = mesh->device.getStream();
-  mesh->dataStream = mesh->device.createStream();
-  mesh->device.setStream(mesh->defaultStream);
+void meshOccaPopulateDeviceQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &kernelInfo){
 
   // find elements that have all neighbors on this process
   dlong *internalElementIds = (dlong*) calloc(mesh->Nelements, sizeof(dlong));
@@ -245,6 +237,12 @@ void meshOccaSetupQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &
     // temporary DEVICE buffer for halo (maximum size Nfields*Np for dfloat)
     mesh->o_haloBuffer =
       mesh->device.malloc(mesh->totalHaloPairs*mesh->Np*mesh->Nfields*sizeof(dfloat));
+
+    // node ids 
+    mesh->o_haloGetNodeIds = 
+      mesh->device.malloc(mesh->Nfp*mesh->totalHaloPairs*sizeof(dlong), mesh->haloGetNodeIds);
+    mesh->o_haloPutNodeIds = 
+      mesh->device.malloc(mesh->Nfp*mesh->totalHaloPairs*sizeof(dlong), mesh->haloPutNodeIds);
   }
   
   
@@ -343,3 +341,17 @@ void meshOccaSetupQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &
   kernelInfo["defines/" "p_IJWID"]= IJWID;
 
 }
+
+void meshOccaSetupQuad3D(mesh_t *mesh, setupAide &newOptions, occa::properties &kernelInfo){
+
+  // conigure device
+  occaDeviceConfig(mesh, newOptions);
+
+  //make seperate stream for halo exchange
+  mesh->defaultStream = mesh->device.getStream();
+  mesh->dataStream = mesh->device.createStream();
+  mesh->device.setStream(mesh->defaultStream);
+
+  meshOccaPopulateDeviceQuad3D(mesh, newOptions, kernelInfo);
+
+}
@@ -67,6 +67,24 @@ void meshPartitionStatistics(mesh_t *mesh){
       fflush(stdout);
     }
   }
-  
+
+  /* load imbalance (max/average over ranks) of element count and partition weights */
+  dfloat localLoad = mesh->Nelements, maxLoad, sumLoad;
+  MPI_Allreduce(&localLoad, &maxLoad, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+  MPI_Allreduce(&localLoad, &sumLoad, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+  if(rank==0 && sumLoad>0)
+    printf("load imbalance: elements %5.3f", maxLoad*size/sumLoad);
+
+  for(int c=0;c<mesh->NpartitionConstraints;++c){
+    localLoad = 0;
+    for(dlong e=0;e<mesh->Nelements;++e)
+      localLoad += mesh->partitionWeights[e*mesh->NpartitionConstraints+c];
+    MPI_Allreduce(&localLoad, &maxLoad, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+    MPI_Allreduce(&localLoad, &sumLoad, 1, MPI_DFLOAT, MPI_SUM, mesh->comm);
+    if(rank==0 && sumLoad>0)
+      printf(", weight %d %5.3f", c, maxLoad*size/sumLoad);
+  }
+  if(rank==0) printf("\n");
+
   free(comms);
 }
@@ -0,0 +1,111 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "mesh2D.h"
+
+/* weighted repartition of a 2D mesh that has already been set up
+   (e.g. after MRAB levels are known, or from a measured cost
+   profile). Rebuilds the host side connectivity, nodes, geometric
+   factors, halo and global numbering for the new partition. Any
+   OCCA buffers and solver state must be set up again by the caller */
+void meshRepartition2D(mesh2D *mesh, int Nconstraints, dfloat *weights){
+
+  meshWeightedPartition(mesh, Nconstraints, weights);
+
+  meshReconnect2D(mesh);
+}
+
+/* rebuild the host side connectivity, nodes, geometric factors, halo
+   and global numbering of a 2D mesh for its current element
+   distribution, e.g. after a repartition or to regroup the local
+   elements once their MRAB levels are known */
+void meshReconnect2D(mesh2D *mesh){
+
+  // release data derived from the old partition
+  free(mesh->EToE);  mesh->EToE = NULL;
+  free(mesh->EToF);  mesh->EToF = NULL;
+  free(mesh->EToP);  mesh->EToP = NULL;
+  free(mesh->EToB);  mesh->EToB = NULL;
+  free(mesh->x);     mesh->x = NULL;
+  free(mesh->y);     mesh->y = NULL;
+  free(mesh->z);     mesh->z = NULL;
+  free(mesh->vmapM); mesh->vmapM = NULL;
+  free(mesh->vmapP); mesh->vmapP = NULL;
+  free(mesh->mapP);  mesh->mapP = NULL;
+  free(mesh->haloElementList); mesh->haloElementList = NULL;
+  free(mesh->NhaloPairs);      mesh->NhaloPairs = NULL;
+  free(mesh->globalIds);       mesh->globalIds = NULL;
+  free(mesh->haloGetNodeIds);  mesh->haloGetNodeIds = NULL;
+  free(mesh->haloPutNodeIds);  mesh->haloPutNodeIds = NULL;
+  free(mesh->haloSendRequests); mesh->haloSendRequests = NULL;
+  free(mesh->haloRecvRequests); mesh->haloRecvRequests = NULL;
+  free(mesh->vgeo);    mesh->vgeo = NULL;
+  free(mesh->sgeo);    mesh->sgeo = NULL;
+  free(mesh->ggeo);    mesh->ggeo = NULL;
+  free(mesh->cubvgeo); mesh->cubvgeo = NULL;
+  free(mesh->cubsgeo); mesh->cubsgeo = NULL;
+  free(mesh->cubggeo); mesh->cubggeo = NULL;
+
+  // connect elements using parallel sort
+  meshParallelConnect(mesh);
+
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
+
+  // print out connectivity and load statistics
+  meshPartitionStatistics(mesh);
+
+  // connect elements to boundary faces
+  meshConnectBoundary(mesh);
+
+  if(mesh->Nverts==3){ // Tri2D
+    meshPhysicalNodesTri2D(mesh);
+    meshGeometricFactorsTri2D(mesh);
+    meshHaloSetup(mesh);
+    meshConnectFaceNodes2D(mesh);
+    meshSurfaceGeometricFactorsTri2D(mesh);
+  }
+  else{ // Quad2D
+    meshPhysicalNodesQuad2D(mesh);
+    meshGeometricFactorsQuad2D(mesh);
+    meshHaloSetup(mesh);
+    meshConnectFaceNodes2D(mesh);
+    meshSurfaceGeometricFactorsQuad2D(mesh);
+  }
+
+  // global nodes
+  meshParallelConnectNodes(mesh);
+
+  // MRAB levels are needed on the halo
+  if(mesh->MRABlevel && mesh->totalHaloPairs){
+    mesh->MRABlevel = (int *) realloc(mesh->MRABlevel,(mesh->Nelements+mesh->totalHaloPairs)*sizeof(int));
+    int *MRABsendBuffer = (int *) calloc(mesh->totalHaloPairs,sizeof(int));
+    meshHaloExchange(mesh, sizeof(int), mesh->MRABlevel, MRABsendBuffer, mesh->MRABlevel+mesh->Nelements);
+    free(MRABsendBuffer);
+  }
+}
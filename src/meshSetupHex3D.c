@@ -36,6 +36,9 @@ mesh3D *meshSetupHex3D(char *filename, int N){
   
   // connect elements using parallel sort
   meshParallelConnect(mesh);
+
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
   
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
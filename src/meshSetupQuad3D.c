@@ -40,6 +40,9 @@ mesh_t *meshSetupQuad3D(char *filename, int N, dfloat sphereRadius){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
+
 
   
   // print out connectivity statistics
@@ -37,6 +37,9 @@ mesh3D *meshSetupTet3D(char *filename, int N){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
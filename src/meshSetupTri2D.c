@@ -40,6 +40,9 @@ mesh2D *meshSetupTri2D(char *filename, int N){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
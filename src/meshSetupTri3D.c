@@ -40,6 +40,9 @@ mesh3D *meshSetupTri3D(char *filename, int N, double sphereRadius){
   // connect elements using parallel sort
   meshParallelConnect(mesh);
 
+  // reorder elements on each rank for locality (interior first)
+  meshLocalReorder(mesh);
+
   // print out connectivity statistics
   meshPartitionStatistics(mesh);
 
@@ -0,0 +1,486 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mesh.h"
+
+// spread bits of i by introducing two zeros between binary bits
+static unsigned long long int weightedBitSplitter(unsigned int i){
+
+  unsigned long long int mask = 1;
+  unsigned long long int li = i;
+  unsigned long long int lj = 0;
+
+  for(int b=0;b<20;++b){
+    lj |= ((li & mask) << 2*b); // bit b moves to bit 3b
+    mask <<= 1;
+  }
+
+  return lj;
+}
+
+// Morton index of (ix,iy,iz), iz=0 for 2D meshes
+static unsigned long long int weightedMortonIndex(unsigned int ix, unsigned int iy, unsigned int iz){
+
+  return weightedBitSplitter(ix) | (weightedBitSplitter(iy)<<1) | (weightedBitSplitter(iz)<<2);
+}
+
+// capsule for element vertices + Morton index + partition weights
+typedef struct {
+
+  unsigned long long int index;
+
+  dlong element;
+
+  int type;
+
+  int level;
+
+  int rank; // rank that owned the element before partitioning
+
+  // use 8 for maximum vertices per element
+  hlong v[8];
+
+  dfloat EX[8], EY[8], EZ[8];
+
+  dfloat weights[meshMaxPartitionConstraints];
+
+}weightedElement_t;
+
+// compare the Morton indices for two element capsules
+static int compareWeightedElements(const void *a, const void *b){
+
+  weightedElement_t *ea = (weightedElement_t*) a;
+  weightedElement_t *eb = (weightedElement_t*) b;
+
+  if(ea->index < eb->index) return -1;
+  if(ea->index > eb->index) return  1;
+
+  return 0;
+}
+
+// stub for the match function needed by parallelSort
+static void bogusMatchWeighted(void *a, void *b){ }
+
+/* ---------------------------------------------------------
+
+Weighted, multi-constraint partition of the elements.
+
+weights holds Nconstraints weights per element, stored
+weights[e*Nconstraints+c] (e.g. work per MRAB level, PML or
+cubature work, measured cost). NULL weights count elements.
+
+  - sort the elements along a Morton curve with parallelSort
+  - give each element the class of the constraint it weighs
+    most in, relative to that constraint's global total
+  - cut the curve of each class separately where its running
+    weight crosses multiples of the class total/size, so every
+    constraint (not just their sum) is split into equal slices
+  - migrate the elements to their new rank and report the
+    imbalance of each constraint before and after
+
+Migrates EToV, EX, EY, EZ, elementInfo and (if present)
+MRABlevel. The weights travel with their elements and are
+kept in mesh->partitionWeights so meshPartitionStatistics
+can report the per-constraint imbalance. The previous owner
+of each element is kept for meshMigrateElementData.
+
+------------------------------------------------------------ */
+void meshWeightedPartition(mesh_t *mesh, int Nconstraints, dfloat *weights){
+
+  int rank, size;
+  rank = mesh->rank;
+  size = mesh->size;
+
+  if(!weights) Nconstraints = 0;
+
+  if(Nconstraints>meshMaxPartitionConstraints){
+    if(rank==0)
+      printf("meshWeightedPartition: %d constraints requested, using the first %d\n",
+             Nconstraints, meshMaxPartitionConstraints);
+    Nconstraints = meshMaxPartitionConstraints;
+  }
+
+  const int Nw = mymax(Nconstraints, 1);
+
+  const dlong oldNelements = mesh->Nelements;
+
+  dlong maxNelements;
+  MPI_Allreduce(&(mesh->Nelements), &maxNelements, 1, MPI_DLONG, MPI_MAX,
+                mesh->comm);
+  maxNelements = 2*((maxNelements+1)/2);
+
+  weightedElement_t *elements
+    = (weightedElement_t*) calloc(maxNelements, sizeof(weightedElement_t));
+
+  // local bounding box of element vertices
+  dfloat minvx = 1e9, maxvx = -1e9;
+  dfloat minvy = 1e9, maxvy = -1e9;
+  dfloat minvz = 1e9, maxvz = -1e9;
+
+  for(dlong n=0;n<mesh->Nverts*mesh->Nelements;++n){
+    minvx = mymin(minvx, mesh->EX[n]);
+    maxvx = mymax(maxvx, mesh->EX[n]);
+    minvy = mymin(minvy, mesh->EY[n]);
+    maxvy = mymax(maxvy, mesh->EY[n]);
+    if(mesh->EZ){
+      minvz = mymin(minvz, mesh->EZ[n]);
+      maxvz = mymax(maxvz, mesh->EZ[n]);
+    }
+  }
+  if(!mesh->EZ){ minvz = 0; maxvz = 0; }
+
+  // find global bounding box
+  dfloat gminvx, gminvy, gminvz, gmaxvx, gmaxvy, gmaxvz;
+  MPI_Allreduce(&minvx, &gminvx, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&minvy, &gminvy, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&minvz, &gminvz, 1, MPI_DFLOAT, MPI_MIN, mesh->comm);
+  MPI_Allreduce(&maxvx, &gmaxvx, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+  MPI_Allreduce(&maxvy, &gmaxvy, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+  MPI_Allreduce(&maxvz, &gmaxvz, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+
+  dfloat maxlength = mymax(gmaxvx-gminvx, mymax(gmaxvy-gminvy, gmaxvz-gminvz));
+
+  // choose sub-range of Morton lattice coordinates to embed element centers in
+  unsigned long long int Nboxes = (((unsigned long long int)1)<<19);
+
+  for(dlong e=0;e<mesh->Nelements;++e){
+
+    // element center coordinates
+    dfloat cx = 0, cy = 0, cz = 0;
+    for(int n=0;n<mesh->Nverts;++n){
+      cx += mesh->EX[e*mesh->Nverts+n];
+      cy += mesh->EY[e*mesh->Nverts+n];
+      if(mesh->EZ) cz += mesh->EZ[e*mesh->Nverts+n];
+    }
+    cx /= mesh->Nverts;
+    cy /= mesh->Nverts;
+    cz /= mesh->Nverts;
+
+    elements[e].element = e;
+    elements[e].rank = rank;
+    elements[e].type = mesh->elementInfo[e];
+    elements[e].level = (mesh->MRABlevel) ? mesh->MRABlevel[e] : 0;
+    for(int n=0;n<mesh->Nverts;++n){
+      elements[e].v[n]  = mesh->EToV[e*mesh->Nverts+n];
+      elements[e].EX[n] = mesh->EX[e*mesh->Nverts+n];
+      elements[e].EY[n] = mesh->EY[e*mesh->Nverts+n];
+      elements[e].EZ[n] = (mesh->EZ) ? mesh->EZ[e*mesh->Nverts+n] : 0;
+    }
+    for(int c=0;c<Nw;++c)
+      elements[e].weights[c] = (Nconstraints) ? weights[e*Nconstraints+c] : 1;
+
+    unsigned long long int ix = (cx-gminvx)*Nboxes/maxlength;
+    unsigned long long int iy = (cy-gminvy)*Nboxes/maxlength;
+    unsigned long long int iz = (cz-gminvz)*Nboxes/maxlength;
+
+    elements[e].index = weightedMortonIndex(ix, iy, iz);
+  }
+
+  // pad element array with dummy elements
+  for(dlong e=mesh->Nelements;e<maxNelements;++e){
+    elements[e].element = -1;
+    elements[e].index = weightedMortonIndex(Nboxes+1, Nboxes+1, Nboxes+1);
+  }
+
+  // odd-even parallel sort of element capsules based on their Morton index
+  parallelSort(mesh->size, mesh->rank, mesh->comm,
+               maxNelements, elements, sizeof(weightedElement_t),
+               compareWeightedElements,
+               bogusMatchWeighted);
+
+  // compress
+  dlong localNelements = 0;
+  for(dlong e=0;e<maxNelements;++e){
+    if(elements[e].element != -1){
+      elements[localNelements] = elements[e];
+      ++localNelements;
+    }
+  }
+
+  // global total of each constraint
+  dfloat *localTotals  = (dfloat*) calloc(Nw, sizeof(dfloat));
+  dfloat *globalTotals = (dfloat*) calloc(Nw, sizeof(dfloat));
+  for(dlong e=0;e<localNelements;++e)
+    for(int c=0;c<Nw;++c)
+      localTotals[c] += elements[e].weights[c];
+  MPI_Allreduce(localTotals, globalTotals, Nw, MPI_DFLOAT, MPI_SUM, mesh->comm);
+
+  // class of each element: the constraint it weighs most in relative to its total
+  int *classes = (int*) calloc(localNelements+1, sizeof(int));
+  dfloat *classLoads = (dfloat*) calloc(Nw, sizeof(dfloat));
+  for(dlong e=0;e<localNelements;++e){
+    int cls = 0;
+    dfloat maxWeight = -1;
+    for(int c=0;c<Nw;++c){
+      if(globalTotals[c]>0 && elements[e].weights[c]/globalTotals[c]>maxWeight){
+        maxWeight = elements[e].weights[c]/globalTotals[c];
+        cls = c;
+      }
+    }
+    classes[e] = cls;
+    classLoads[cls] += elements[e].weights[cls];
+  }
+
+  dfloat *classOffsets = (dfloat*) calloc(Nw, sizeof(dfloat));
+  dfloat *classTotals  = (dfloat*) calloc(Nw, sizeof(dfloat));
+  MPI_Exscan(classLoads, classOffsets, Nw, MPI_DFLOAT, MPI_SUM, mesh->comm);
+  MPI_Allreduce(classLoads, classTotals, Nw, MPI_DFLOAT, MPI_SUM, mesh->comm);
+  if(rank==0)
+    for(int c=0;c<Nw;++c) classOffsets[c] = 0;
+
+  int *Nsend = (int*) calloc(size, sizeof(int));
+  int *Nrecv = (int*) calloc(size, sizeof(int));
+  int *sendOffsets = (int*) calloc(size, sizeof(int));
+  int *recvOffsets = (int*) calloc(size, sizeof(int));
+
+  // cut each class's curve at the weight midpoint of each element (monotone
+  // so each rank receives a contiguous piece of every class)
+  int *destinations = (int*) calloc(localNelements+1, sizeof(int));
+  for(dlong e=0;e<localNelements;++e){
+    int cls = classes[e];
+    dfloat weight = elements[e].weights[cls];
+    dfloat mid = classOffsets[cls] + 0.5*weight;
+    classOffsets[cls] += weight;
+
+    int r = (classTotals[cls]>0) ? (int) (size*(mid/classTotals[cls])) : 0;
+    r = mymin(mymax(r, 0), size-1);
+
+    destinations[e] = r;
+    ++Nsend[r];
+  }
+
+  // find send offsets
+  for(int r=1;r<size;++r)
+    sendOffsets[r] = sendOffsets[r-1] + Nsend[r-1];
+
+  // the classes interleave, so pack the capsules by destination rank
+  weightedElement_t *sendElements
+    = (weightedElement_t*) calloc(localNelements+1, sizeof(weightedElement_t));
+  int *Npacked = (int*) calloc(size, sizeof(int));
+  for(dlong e=0;e<localNelements;++e){
+    int r = destinations[e];
+    sendElements[sendOffsets[r] + Npacked[r]++] = elements[e];
+  }
+
+  // exchange counts
+  MPI_Alltoall(Nsend, 1, MPI_INT, Nrecv, 1, MPI_INT, mesh->comm);
+
+  dlong newNelements = 0;
+  for(int r=0;r<size;++r)
+    newNelements += Nrecv[r];
+
+  for(int r=1;r<size;++r)
+    recvOffsets[r] = recvOffsets[r-1] + Nrecv[r-1];
+
+  // Make the MPI_WEIGHTEDELEMENT_T data type
+  MPI_Datatype MPI_WEIGHTEDELEMENT_T;
+  MPI_Datatype dtype[10] = {MPI_LONG_LONG_INT, MPI_DLONG, MPI_INT, MPI_INT, MPI_INT,
+                            MPI_HLONG, MPI_DFLOAT, MPI_DFLOAT, MPI_DFLOAT, MPI_DFLOAT};
+  int blength[10] = {1, 1, 1, 1, 1, 8, 8, 8, 8, meshMaxPartitionConstraints};
+  MPI_Aint addr[10], displ[10];
+  MPI_Get_address ( &(elements[0]           ), addr+0);
+  MPI_Get_address ( &(elements[0].element   ), addr+1);
+  MPI_Get_address ( &(elements[0].type      ), addr+2);
+  MPI_Get_address ( &(elements[0].level     ), addr+3);
+  MPI_Get_address ( &(elements[0].rank      ), addr+4);
+  MPI_Get_address ( &(elements[0].v[0]      ), addr+5);
+  MPI_Get_address ( &(elements[0].EX[0]     ), addr+6);
+  MPI_Get_address ( &(elements[0].EY[0]     ), addr+7);
+  MPI_Get_address ( &(elements[0].EZ[0]     ), addr+8);
+  MPI_Get_address ( &(elements[0].weights[0]), addr+9);
+  for(int n=0;n<10;++n)
+    displ[n] = addr[n] - addr[0];
+  MPI_Datatype MPI_WEIGHTEDELEMENT_TMP;
+  MPI_Type_create_struct (10, blength, displ, dtype, &MPI_WEIGHTEDELEMENT_TMP);
+  MPI_Type_create_resized (MPI_WEIGHTEDELEMENT_TMP, 0, sizeof(weightedElement_t), &MPI_WEIGHTEDELEMENT_T);
+  MPI_Type_commit (&MPI_WEIGHTEDELEMENT_T);
+  MPI_Type_free(&MPI_WEIGHTEDELEMENT_TMP);
+
+  weightedElement_t *newElements
+    = (weightedElement_t*) calloc(newNelements+1, sizeof(weightedElement_t));
+
+  MPI_Alltoallv(sendElements, Nsend, sendOffsets, MPI_WEIGHTEDELEMENT_T,
+                newElements, Nrecv, recvOffsets, MPI_WEIGHTEDELEMENT_T, mesh->comm);
+
+  MPI_Barrier(mesh->comm);
+  MPI_Type_free(&MPI_WEIGHTEDELEMENT_T);
+
+  // reset element data from the inbound capsules
+  free(mesh->EToV);
+  free(mesh->EX);
+  free(mesh->EY);
+  free(mesh->elementInfo);
+
+  mesh->Nelements = newNelements;
+  mesh->EToV = (hlong*) calloc(newNelements*mesh->Nverts, sizeof(hlong));
+  mesh->EX = (dfloat*) calloc(newNelements*mesh->Nverts, sizeof(dfloat));
+  mesh->EY = (dfloat*) calloc(newNelements*mesh->Nverts, sizeof(dfloat));
+  mesh->elementInfo = (int*) calloc(newNelements, sizeof(int));
+  if(mesh->EZ){
+    free(mesh->EZ);
+    mesh->EZ = (dfloat*) calloc(newNelements*mesh->Nverts, sizeof(dfloat));
+  }
+  if(mesh->MRABlevel){
+    free(mesh->MRABlevel);
+    mesh->MRABlevel = (int*) calloc(newNelements, sizeof(int));
+  }
+
+  if(mesh->partitionWeights) free(mesh->partitionWeights);
+  mesh->NpartitionConstraints = Nconstraints;
+  mesh->partitionWeights = (Nconstraints) ?
+    (dfloat*) calloc(newNelements*Nconstraints, sizeof(dfloat)) : NULL;
+
+  // remember where each element came from so solver data can follow it
+  if(mesh->migrationSourceRanks) free(mesh->migrationSourceRanks);
+  if(mesh->migrationSourceIds)   free(mesh->migrationSourceIds);
+  mesh->migrationSourceRanks = (int*)   calloc(newNelements, sizeof(int));
+  mesh->migrationSourceIds   = (dlong*) calloc(newNelements, sizeof(dlong));
+
+  for(dlong e=0;e<newNelements;++e){
+    for(int n=0;n<mesh->Nverts;++n){
+      mesh->EToV[e*mesh->Nverts + n] = newElements[e].v[n];
+      mesh->EX[e*mesh->Nverts + n]   = newElements[e].EX[n];
+      mesh->EY[e*mesh->Nverts + n]   = newElements[e].EY[n];
+      if(mesh->EZ) mesh->EZ[e*mesh->Nverts + n] = newElements[e].EZ[n];
+    }
+    mesh->elementInfo[e] = newElements[e].type;
+    if(mesh->MRABlevel) mesh->MRABlevel[e] = newElements[e].level;
+    mesh->migrationSourceRanks[e] = newElements[e].rank;
+    mesh->migrationSourceIds[e]   = newElements[e].element;
+    for(int c=0;c<Nconstraints;++c)
+      mesh->partitionWeights[e*Nconstraints+c] = newElements[e].weights[c];
+  }
+
+  // imbalance (max/average over ranks) of each constraint before and after the cut
+  for(int c=0;c<Nconstraints;++c){
+    dfloat oldLoad = 0, newLoad = 0;
+    for(dlong e=0;e<oldNelements;++e)
+      oldLoad += weights[e*Nconstraints+c];
+    for(dlong e=0;e<newNelements;++e)
+      newLoad += mesh->partitionWeights[e*Nconstraints+c];
+
+    dfloat maxOldLoad, maxNewLoad;
+    MPI_Allreduce(&oldLoad, &maxOldLoad, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+    MPI_Allreduce(&newLoad, &maxNewLoad, 1, MPI_DFLOAT, MPI_MAX, mesh->comm);
+
+    if(rank==0 && globalTotals[c]>0)
+      printf("weighted partition: constraint %d imbalance %5.3f -> %5.3f\n", c,
+             maxOldLoad*size/globalTotals[c], maxNewLoad*size/globalTotals[c]);
+  }
+
+  free(elements);
+  free(sendElements);
+  free(newElements);
+  free(localTotals);
+  free(globalTotals);
+  free(classes);
+  free(classLoads);
+  free(classOffsets);
+  free(classTotals);
+  free(destinations);
+  free(Npacked);
+  free(Nsend);
+  free(Nrecv);
+  free(sendOffsets);
+  free(recvOffsets);
+}
+
+/* move per-element data (bytesPerElement each) from the partition
+   before the last meshWeightedPartition to the current one. oldData
+   is indexed by the old local element ids, newData by the new ones */
+void meshMigrateElementData(mesh_t *mesh, size_t bytesPerElement,
+                            void *oldData, void *newData){
+
+  int size = mesh->size;
+
+  int *Nrequest = (int*) calloc(size, sizeof(int));
+  int *Nreply   = (int*) calloc(size, sizeof(int));
+  int *requestOffsets = (int*) calloc(size, sizeof(int));
+  int *replyOffsets   = (int*) calloc(size, sizeof(int));
+
+  // ask the previous owner of each element for its data
+  for(dlong e=0;e<mesh->Nelements;++e)
+    ++Nrequest[mesh->migrationSourceRanks[e]];
+
+  for(int r=1;r<size;++r)
+    requestOffsets[r] = requestOffsets[r-1] + Nrequest[r-1];
+
+  dlong *requestIds  = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  dlong *requestDest = (dlong*) calloc(mesh->Nelements+1, sizeof(dlong));
+  for(int r=0;r<size;++r) Nrequest[r] = 0;
+  for(dlong e=0;e<mesh->Nelements;++e){
+    int r = mesh->migrationSourceRanks[e];
+    dlong id = requestOffsets[r] + Nrequest[r]++;
+    requestIds[id]  = mesh->migrationSourceIds[e];
+    requestDest[id] = e;
+  }
+
+  MPI_Alltoall(Nrequest, 1, MPI_INT, Nreply, 1, MPI_INT, mesh->comm);
+
+  dlong NreplyTotal = 0;
+  for(int r=0;r<size;++r)
+    NreplyTotal += Nreply[r];
+  for(int r=1;r<size;++r)
+    replyOffsets[r] = replyOffsets[r-1] + Nreply[r-1];
+
+  dlong *replyIds = (dlong*) calloc(NreplyTotal+1, sizeof(dlong));
+  MPI_Alltoallv(requestIds, Nrequest, requestOffsets, MPI_DLONG,
+                replyIds, Nreply, replyOffsets, MPI_DLONG, mesh->comm);
+
+  // pack the requested elements
+  char *oldc = (char*) oldData;
+  char *replyData = (char*) calloc((NreplyTotal+1)*bytesPerElement, sizeof(char));
+  for(dlong n=0;n<NreplyTotal;++n)
+    memcpy(replyData+n*bytesPerElement, oldc+replyIds[n]*bytesPerElement, bytesPerElement);
+
+  MPI_Datatype MPI_ELEMENTDATA_T;
+  MPI_Type_contiguous((int) bytesPerElement, MPI_BYTE, &MPI_ELEMENTDATA_T);
+  MPI_Type_commit(&MPI_ELEMENTDATA_T);
+
+  char *requestData = (char*) calloc((mesh->Nelements+1)*bytesPerElement, sizeof(char));
+  MPI_Alltoallv(replyData, Nreply, replyOffsets, MPI_ELEMENTDATA_T,
+                requestData, Nrequest, requestOffsets, MPI_ELEMENTDATA_T, mesh->comm);
+
+  MPI_Type_free(&MPI_ELEMENTDATA_T);
+
+  // unpack in the new element order
+  char *newc = (char*) newData;
+  for(dlong n=0;n<mesh->Nelements;++n)
+    memcpy(newc+requestDest[n]*bytesPerElement, requestData+n*bytesPerElement, bytesPerElement);
+
+  free(Nrequest);
+  free(Nreply);
+  free(requestOffsets);
+  free(replyOffsets);
+  free(requestIds);
+  free(requestDest);
+  free(replyIds);
+  free(replyData);
+  free(requestData);
+}
@@ -0,0 +1,186 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2017 Tim Warburton, Noel Chalmers, Jesse Chan, Ali Karakus
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+
+*/
+
+#include "mrab.h"
+
+mrab_t *mrabSetup(mesh_t *mesh, int Nfields, dfloat dt, occa::properties kernelInfo,
+                  void *solver, mrabRhs_t rhs){
+
+  mrab_t *mrab = (mrab_t*) calloc(1, sizeof(mrab_t));
+
+  mrab->mesh = mesh;
+  mrab->Nentries = mesh->Np*Nfields;
+  mrab->N = mesh->Nelements*mrab->Nentries;
+  mrab->Nhalo = mesh->totalHaloPairs*mrab->Nentries;
+  mrab->solver = solver;
+  mrab->rhs = rhs;
+
+  mrab->Nlevels = mesh->MRABNlevels;
+  mrab->dt = dt;
+
+  const int Nlevels = mrab->Nlevels;
+
+  mrab->NlevelElements = (dlong*) calloc(Nlevels+1, sizeof(dlong));
+  for(int lev=0;lev<Nlevels;++lev)
+    mrab->NlevelElements[lev+1] = mrab->NlevelElements[lev] + mesh->MRABNelements[lev];
+
+  // Adams Bashforth weights of order 1, 2 and 3 for each level
+  mrab->MRAB_A = (dfloat*) calloc(3*Nlevels*3, sizeof(dfloat));
+  mrab->MRAB_B = (dfloat*) calloc(3*Nlevels*3, sizeof(dfloat));
+
+  for(int lev=0;lev<Nlevels;++lev){
+    const dfloat h = dt*pow(2,lev);
+
+    dfloat *A = mrab->MRAB_A + lev*3;
+    dfloat *B = mrab->MRAB_B + lev*3;
+
+    // first order
+    A[0] = h;
+    B[0] = h/2.;
+
+    // second order
+    A += Nlevels*3; B += Nlevels*3;
+    A[0] =  3.*h/2.;  A[1] = -h/2.;
+    B[0] =  5.*h/8.;  B[1] = -h/8.;
+
+    // third order
+    A += Nlevels*3; B += Nlevels*3;
+    A[0] =  23.*h/12.;  A[1] = -16.*h/12.;  A[2] =  5.*h/12.;
+    B[0] =  17.*h/24.;  B[1] =  -7.*h/24.;  B[2] =  2.*h/24.;
+  }
+
+  // element lists of each level and of the level boundary elements
+  if(!mesh->o_MRABelementIds){
+    mesh->o_MRABelementIds = new occa::memory[Nlevels];
+    mesh->o_MRABhaloIds    = new occa::memory[Nlevels];
+    for(int lev=0;lev<Nlevels;++lev){
+      if(mesh->MRABNelements[lev])
+        mesh->o_MRABelementIds[lev] = mesh->device.malloc(mesh->MRABNelements[lev]*sizeof(dlong),
+                                                          mesh->MRABelementIds[lev]);
+      if(mesh->MRABNhaloElements[lev])
+        mesh->o_MRABhaloIds[lev] = mesh->device.malloc(mesh->MRABNhaloElements[lev]*sizeof(dlong),
+                                                       mesh->MRABhaloIds[lev]);
+    }
+  }
+
+  // zero the RHS history so the unused weights of the startup steps see zeros
+  dfloat *zeros = (dfloat*) calloc(2*mrab->N+mrab->Nhalo, sizeof(dfloat));
+  mrab->o_qMR    = mesh->device.malloc((mrab->N+mrab->Nhalo)*sizeof(dfloat), zeros);
+  mrab->o_rhsq   = mesh->device.malloc(mrab->N*sizeof(dfloat), zeros);
+  mrab->o_rhsqMR = mesh->device.malloc(2*mrab->N*sizeof(dfloat), zeros);
+  free(zeros);
+
+  kernelInfo["defines/" "p_blockSize"]= MRAB_BLOCKSIZE;
+
+  for (int r=0;r<mesh->size;r++) {
+    if (r==mesh->rank) {
+      mrab->updateKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/mrab.okl", "mrabUpdate", kernelInfo);
+      mrab->traceUpdateKernel =
+        mesh->device.buildKernel(DHOLMES "/okl/mrab.okl", "mrabTraceUpdate", kernelInfo);
+    }
+    MPI_Barrier(mesh->comm);
+  }
+
+  return mrab;
+}
+
+void mrabStep(mrab_t *mrab, dfloat time, occa::memory &o_q){
+
+  mesh_t *mesh = mrab->mesh;
+
+  const int Nlevels = mrab->Nlevels;
+  const int Nticks = 1<<(Nlevels-1);
+
+  for(int Ntick=0;Ntick<Nticks;++Ntick){
+
+    dfloat currentTime = time + Ntick*mrab->dt;
+
+    // levels 0,..,lev-1 start a step at this tick
+    int lev;
+    for(lev=0;lev<Nlevels;++lev)
+      if(Ntick%(1<<lev)!=0) break;
+
+    mrab->rhs(mrab->solver, currentTime, lev, mrab->o_qMR, mrab->o_rhsq);
+
+    // levels 0,..,lev-1 finish their step at the end of this tick
+    for(lev=0;lev<Nlevels;++lev)
+      if((Ntick+1)%(1<<lev)!=0) break;
+
+    for(int l=0;l<lev;++l){
+      // previous steps of this level set the order
+      const int Nprevious = mrab->Nsteps*(1<<(Nlevels-1-l)) + Ntick/(1<<l);
+      const int order = mymin(Nprevious, 2);
+      const int id = order*Nlevels*3 + l*3;
+
+      if(mesh->MRABNelements[l])
+        mrab->updateKernel(mesh->MRABNelements[l],
+                           mesh->o_MRABelementIds[l],
+                           mrab->Nentries,
+                           mrab->N,
+                           mesh->MRABshiftIndex[l],
+                           mrab->MRAB_A[id+0],
+                           mrab->MRAB_A[id+1],
+                           mrab->MRAB_A[id+2],
+                           mrab->o_rhsq,
+                           mrab->o_rhsqMR,
+                           o_q,
+                           mrab->o_qMR);
+
+      // the newest RHS took the place of the oldest
+      mesh->MRABshiftIndex[l] = (mesh->MRABshiftIndex[l]+1)%2;
+    }
+
+    // the next tick is half way through the step of level lev, predict
+    // the level lev elements next to level lev-1 elements to it
+    if(lev<Nlevels && mesh->MRABNhaloElements[lev]){
+      const int Nprevious = mrab->Nsteps*(1<<(Nlevels-1-lev)) + Ntick/(1<<lev);
+      const int order = mymin(Nprevious, 2);
+      const int id = order*Nlevels*3 + lev*3;
+
+      mrab->traceUpdateKernel(mesh->MRABNhaloElements[lev],
+                              mesh->o_MRABhaloIds[lev],
+                              mrab->Nentries,
+                              mrab->N,
+                              mesh->MRABshiftIndex[lev],
+                              mrab->MRAB_B[id+0],
+                              mrab->MRAB_B[id+1],
+                              mrab->MRAB_B[id+2],
+                              mrab->o_rhsq,
+                              mrab->o_rhsqMR,
+                              o_q,
+                              mrab->o_qMR);
+    }
+  }
+
+  mrab->Nsteps++;
+}
+
+void mrabReset(mrab_t *mrab, occa::memory &o_q){
+
+  mrab->o_qMR.copyFrom(o_q, mrab->N*sizeof(dfloat));
+  mrab->Nsteps = 0;
+}
@@ -82,3 +82,170 @@ void readIntArray(FILE *fp, const char *label, int **A, int *Nrows, int* Ncols){
   for(int n=0;n<(*Nrows)*(*Ncols);++n) //read matrix data
     status = fscanf(fp, "%d", (*A)+n);
 }
+
+#define REFERENCE_LABEL_LENGTH 256
+
+// reference node files are read once by the root rank, indexed by label,
+// and broadcast as a binary block; later loads of the same file hit the cache
+struct referenceData_t {
+
+  char fname[BUFSIZ];
+
+  int Nentries;
+  char (*labels)[REFERENCE_LABEL_LENGTH];
+  int *Nrows;
+  int *Ncols;
+  long long int *offsets;
+
+  long long int Nvalues;
+  double *values;
+
+  referenceData_t *next;
+};
+
+static referenceData_t *referenceDataCache = NULL;
+
+static void referenceDataParse(FILE *fp, referenceData_t *data){
+
+  char buf[BUFSIZ];
+
+  int maxEntries = 0;
+  long long int maxValues = 0;
+
+  data->Nentries = 0;
+  data->Nvalues = 0;
+  data->labels = NULL;
+  data->Nrows = NULL;
+  data->Ncols = NULL;
+  data->offsets = NULL;
+  data->values = NULL;
+
+  // every entry is a separator line, a label line, a "rows cols" line, then values
+  while(fgets(buf, BUFSIZ, fp)){
+    if(buf[0]!='*') continue;
+
+    char label[BUFSIZ];
+    int Nrows, Ncols;
+    if(!fgets(label, BUFSIZ, fp)) break;
+    if(fscanf(fp, "%d %d", &Nrows, &Ncols)!=2) continue;
+
+    if(data->Nentries==maxEntries){
+      maxEntries = 2*maxEntries+16;
+      data->labels  = (char (*)[REFERENCE_LABEL_LENGTH]) realloc(data->labels, maxEntries*sizeof(char[REFERENCE_LABEL_LENGTH]));
+      data->Nrows   = (int*) realloc(data->Nrows, maxEntries*sizeof(int));
+      data->Ncols   = (int*) realloc(data->Ncols, maxEntries*sizeof(int));
+      data->offsets = (long long int*) realloc(data->offsets, maxEntries*sizeof(long long int));
+    }
+
+    long long int Nentry = ((long long int) Nrows)*Ncols;
+    if(data->Nvalues+Nentry>maxValues){
+      maxValues = 2*maxValues + Nentry;
+      data->values = (double*) realloc(data->values, maxValues*sizeof(double));
+    }
+
+    int e = data->Nentries++;
+    strncpy(data->labels[e], label, REFERENCE_LABEL_LENGTH-1);
+    data->labels[e][REFERENCE_LABEL_LENGTH-1] = '\0';
+    data->Nrows[e] = Nrows;
+    data->Ncols[e] = Ncols;
+    data->offsets[e] = data->Nvalues;
+
+    for(long long int n=0;n<Nentry;++n)
+      if(fscanf(fp, "%lf", data->values+data->Nvalues+n)!=1) data->values[data->Nvalues+n] = 0;
+    data->Nvalues += Nentry;
+  }
+}
+
+referenceData_t *meshReferenceDataLoad(const char *fname){
+
+  // all ranks load the same reference files, so a hit on one is a hit on all
+  for(referenceData_t *data=referenceDataCache;data;data=data->next)
+    if(!strcmp(data->fname, fname)) return data;
+
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  referenceData_t *data = (referenceData_t*) calloc(1, sizeof(referenceData_t));
+  strcpy(data->fname, fname);
+
+  int found = 1;
+  if(rank==0){
+    FILE *fp = fopen(fname, "r");
+    if(fp){
+      referenceDataParse(fp, data);
+      fclose(fp);
+    } else {
+      found = 0;
+    }
+  }
+
+  MPI_Bcast(&found, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  if(!found){
+    if(rank==0) printf("ERROR: Cannot open file: '%s'\n", fname);
+    MPI_Finalize();
+    exit(-1);
+  }
+
+  MPI_Bcast(&(data->Nentries), 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(&(data->Nvalues), 1, MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
+
+  if(rank!=0){
+    data->labels  = (char (*)[REFERENCE_LABEL_LENGTH]) calloc(data->Nentries, sizeof(char[REFERENCE_LABEL_LENGTH]));
+    data->Nrows   = (int*) calloc(data->Nentries, sizeof(int));
+    data->Ncols   = (int*) calloc(data->Nentries, sizeof(int));
+    data->offsets = (long long int*) calloc(data->Nentries, sizeof(long long int));
+    data->values  = (double*) calloc(data->Nvalues, sizeof(double));
+  }
+
+  MPI_Bcast(data->labels, data->Nentries*REFERENCE_LABEL_LENGTH, MPI_CHAR, 0, MPI_COMM_WORLD);
+  MPI_Bcast(data->Nrows, data->Nentries, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(data->Ncols, data->Nentries, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(data->offsets, data->Nentries, MPI_LONG_LONG_INT, 0, MPI_COMM_WORLD);
+
+  // values go in chunks so very high degree files stay under the int count limit
+  const long long int chunk = 1<<26;
+  for(long long int n=0;n<data->Nvalues;n+=chunk){
+    int Nchunk = (int) ((data->Nvalues-n<chunk) ? data->Nvalues-n : chunk);
+    MPI_Bcast(data->values+n, Nchunk, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+  }
+
+  data->next = referenceDataCache;
+  referenceDataCache = data;
+
+  return data;
+}
+
+static int referenceDataFind(referenceData_t *data, const char *label){
+
+  // first entry whose label line contains label, as with the FILE* readers
+  for(int e=0;e<data->Nentries;++e)
+    if(strstr(data->labels[e], label)) return e;
+
+  printf("ERROR: Unable to find label: '%s' in node file.\n", label);
+  exit(-1);
+  return -1;
+}
+
+void readDfloatArray(referenceData_t *data, const char *label, dfloat **A, int *Nrows, int* Ncols){
+
+  int e = referenceDataFind(data, label);
+  *Nrows = data->Nrows[e];
+  *Ncols = data->Ncols[e];
+
+  double *values = data->values + data->offsets[e];
+  *A = (dfloat*) calloc((*Nrows)*(*Ncols), sizeof(dfloat));
+  for(int n=0;n<(*Nrows)*(*Ncols);++n)
+    (*A)[n] = (dfloat) values[n];
+}
+
+void readIntArray(referenceData_t *data, const char *label, int **A, int *Nrows, int* Ncols){
+
+  int e = referenceDataFind(data, label);
+  *Nrows = data->Nrows[e];
+  *Ncols = data->Ncols[e];
+
+  double *values = data->values + data->offsets[e];
+  *A = (int*) calloc((*Nrows)*(*Ncols), sizeof(int));
+  for(int n=0;n<(*Nrows)*(*Ncols);++n)
+    (*A)[n] = (int) values[n];
+}
@@ -294,6 +294,18 @@ namespace occa {
     return (a.second.selfTime > b.second.selfTime);
   }
 
+  double timer::queryTime(std::string key){
+
+    double timeTaken = 0.;
+
+    std::map<std::stack<std::string>, timerTraits>::iterator iter;
+    for(iter=times.begin(); iter!=times.end(); ++iter)
+      if(!iter->first.empty() && iter->first.top()==key)
+        timeTaken += iter->second.timeTaken;
+
+    return timeTaken;
+  }
+
   void timer::printTimer(){
 
     if(profileApplication){
@@ -473,6 +485,10 @@ namespace occa {
     globalTimer.printTimer();
   }
 
+  double queryTime(std::string key){
+    return globalTimer.queryTime(key);
+  }
+
   double currentTime() {
 #if (OCCA_OS & LINUX_OS)
 